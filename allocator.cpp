@@ -0,0 +1,119 @@
+#include "allocator.h"
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+size_t RoundUp(size_t size, size_t alignment) {
+    if (size > size_t(-1) - (alignment - 1)) {
+        throw bad_alloc();
+    }
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+size_t EffectiveAlignment(size_t alignment, PageMode pages) {
+    return pages == PageMode::Huge && alignment < kHugePageSize ? kHugePageSize : alignment;
+}
+
+} // namespace
+
+/**
+ * @brief Выделяет выровненный блок памяти
+ */
+void* AllocateAligned(size_t size, size_t alignment, PageMode pages) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw invalid_argument("AllocateAligned: выравнивание должно быть степенью двойки");
+    }
+    if (size == 0) {
+        return nullptr;
+    }
+    alignment = EffectiveAlignment(alignment, pages);
+    if (pages == PageMode::Huge) {
+        size = RoundUp(size, kHugePageSize);
+    }
+    void* p = ::operator new(size, align_val_t(alignment));
+#ifdef MADV_HUGEPAGE
+    // Только совет ядру: без поддержки прозрачных крупных страниц блок
+    // остаётся на обычных, это не ошибка.
+    if (pages == PageMode::Huge) {
+        madvise(p, size, MADV_HUGEPAGE);
+    }
+#endif
+    return p;
+}
+
+/**
+ * @brief Освобождает блок из AllocateAligned
+ */
+void FreeAligned(void* p, size_t alignment, PageMode pages) noexcept {
+    if (p) {
+        ::operator delete(p, align_val_t(EffectiveAlignment(alignment, pages)));
+    }
+}
+
+Arena::Arena(size_t blockSize, PageMode pages)
+    : current_(0), offset_(0), blockSize_(RoundUp(blockSize ? blockSize : 1, kAlignment)), pages_(pages) {}
+
+Arena::~Arena() {
+    Release();
+}
+
+/**
+ * @brief Выделяет size байт: сдвиг в текущем блоке, иначе следующий
+ * подходящий блок арены, иначе новый блок.
+ */
+void* Arena::Allocate(size_t size) {
+    size = RoundUp(size ? size : 1, kAlignment);
+    while (current_ < blocks_.size()) {
+        Block& block = blocks_[current_];
+        if (block.size - offset_ >= size) {
+            void* p = block.data + offset_;
+            offset_ += size;
+            return p;
+        }
+        ++current_;
+        offset_ = 0;
+    }
+    size_t blockSize = size > blockSize_ ? size : blockSize_;
+    blocks_.reserve(blocks_.size() + 1);
+    char* data = static_cast<char*>(AllocateAligned(blockSize, kAlignment, pages_));
+    blocks_.push_back(Block{data, blockSize});
+    current_ = blocks_.size() - 1;
+    offset_ = size;
+    return data;
+}
+
+void Arena::Release() noexcept {
+    for (const Block& block : blocks_) {
+        FreeAligned(block.data, kAlignment, pages_);
+    }
+    blocks_.clear();
+    current_ = 0;
+    offset_ = 0;
+}
+
+size_t Arena::Used() const noexcept {
+    size_t used = offset_;
+    for (size_t i = 0; i < current_ && i < blocks_.size(); ++i) {
+        used += blocks_[i].size;
+    }
+    return used;
+}
+
+size_t Arena::Capacity() const noexcept {
+    size_t capacity = 0;
+    for (const Block& block : blocks_) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+Arena& ThreadArena() {
+    thread_local Arena arena;
+    return arena;
+}
@@ -0,0 +1,273 @@
+#ifndef COMPLEX_ALLOCATOR_H
+#define COMPLEX_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "mycomplex.h"
+
+// Выровненная память и арены для рабочих буферов.
+//
+// AlignedAllocator подходит любому стандартному контейнеру (ComplexVector —
+// vector<Complex> с выравниванием на строку кэша). Arena раздаёт память
+// сдвигом указателя и освобождает всё сразу: Reset() и Rewind() стоят O(1),
+// а блоки остаются за ареной и используются снова, поэтому в установившемся
+// режиме обработка блока сигнала не обращается к malloc и не вызывает
+// отказов страниц. У каждого потока своя арена (ThreadArena()), так что
+// потоки не конкурируют за кучу.
+
+/**
+ * @brief Размер страниц выделяемой памяти.
+ */
+enum class PageMode {
+    Default,  /**< Обычные страницы.*/
+    Huge      /**< Крупные страницы (2 МБ): выравнивание и размер кратны 2 МБ; в Linux — madvise(MADV_HUGEPAGE), в других ОС — обычные страницы.*/
+};
+
+/** Выравнивание на строку кэша (как у ComplexArray). */
+const size_t kCacheLineAlignment = 64;
+/** Выравнивание на обычную страницу памяти. */
+const size_t kPageAlignment = 4096;
+/** Размер крупной страницы для PageMode::Huge. */
+const size_t kHugePageSize = size_t(2) << 20;
+
+/**
+ * @brief Выделяет выровненный блок памяти (содержимое не инициализируется)
+ * @param size Размер в байтах; 0 — nullptr
+ * @param alignment Выравнивание в байтах (степень двойки)
+ * @param pages Обычные или крупные страницы
+ * @return Указатель на блок
+ * @throws invalid_argument, если alignment не степень двойки; bad_alloc, если памяти нет
+ */
+void* AllocateAligned(size_t size, size_t alignment, PageMode pages = PageMode::Default);
+
+/**
+ * @brief Освобождает блок из AllocateAligned (с теми же alignment и pages)
+ * @param p Блок или nullptr
+ */
+void FreeAligned(void* p, size_t alignment, PageMode pages = PageMode::Default) noexcept;
+
+/**
+ * @brief Распределитель для стандартных контейнеров с выравниванием Alignment.
+ *
+ * Без состояния: любые два распределителя с одним выравниванием равны.
+ */
+template <class T, size_t Alignment = kCacheLineAlignment>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "выравнивание — степень двойки не меньше alignof(T)");
+
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept {}
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t count) {
+        if (count > size_t(-1) / sizeof(T)) {
+            throw bad_array_new_length();
+        }
+        return static_cast<T*>(AllocateAligned(count * sizeof(T), Alignment));
+    }
+
+    void deallocate(T* p, size_t) noexcept { FreeAligned(p, Alignment); }
+};
+
+template <class T, class U, size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept {
+    return true;
+}
+
+template <class T, class U, size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept {
+    return false;
+}
+
+/** vector<Complex> с данными, выровненными на строку кэша */
+using ComplexVector = vector<Complex, AlignedAllocator<Complex>>;
+
+/**
+ * @brief Арена: память раздаётся сдвигом указателя внутри крупных блоков и
+ * возвращается вся сразу.
+ *
+ * Каждое выделение выровнено на kAlignment байт. Если места в текущем блоке
+ * не хватает, арена переходит к следующему своему блоку, а когда они
+ * кончаются — заводит новый (не меньше запроса). Reset() и Rewind() только
+ * переставляют позицию: блоки сохраняются для следующих выделений.
+ * Деструкторы выделенных объектов не вызываются, поэтому Allocate<T>
+ * принимает лишь тривиально разрушаемые типы. Арена не потокобезопасна:
+ * каждому потоку — своя (ThreadArena()).
+ */
+class Arena {
+public:
+    /** Позиция арены для Rewind(). */
+    struct Marker {
+        size_t block;   /**< Номер блока.*/
+        size_t offset;  /**< Смещение в блоке.*/
+    };
+
+    /** Выравнивание каждого выделения в байтах. */
+    static const size_t kAlignment = kCacheLineAlignment;
+
+private:
+    struct Block {
+        char* data;   /**< Начало блока.*/
+        size_t size;  /**< Размер блока в байтах.*/
+    };
+
+    vector<Block> blocks_;  /**< Блоки в порядке использования.*/
+    size_t current_;        /**< Номер текущего блока.*/
+    size_t offset_;         /**< Занято байт в текущем блоке.*/
+    size_t blockSize_;      /**< Размер новых блоков по умолчанию.*/
+    PageMode pages_;        /**< Страницы блоков.*/
+
+public:
+    /**
+    * @brief Конструктор. Память выделяется при первом запросе.
+    * @param blockSize Размер блока в байтах (по умолчанию 1 МБ)
+    * @param pages Обычные или крупные страницы
+    */
+    explicit Arena(size_t blockSize = size_t(1) << 20, PageMode pages = PageMode::Default);
+
+    /**
+    * @brief Деструктор: освобождает все блоки
+    */
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+    * @brief Выделяет size байт, выровненных на kAlignment
+    * @param size Размер в байтах
+    * @return Указатель, действительный до Reset() или Rewind() к более ранней позиции
+    * @throws bad_alloc, если памяти нет
+    */
+    void* Allocate(size_t size);
+
+    /**
+    * @brief Выделяет массив из count элементов типа T (не инициализируется)
+    * @param count Число элементов
+    */
+    template <class T>
+    T* Allocate(size_t count) {
+        static_assert(is_trivially_destructible<T>::value, "арена не вызывает деструкторы");
+        static_assert(alignof(T) <= kAlignment, "выравнивание T больше выравнивания арены");
+        if (count > size_t(-1) / sizeof(T)) {
+            throw bad_array_new_length();
+        }
+        return static_cast<T*>(Allocate(count * sizeof(T)));
+    }
+
+    /**
+    * @brief Текущая позиция арены
+    */
+    Marker Mark() const noexcept { return Marker{current_, offset_}; }
+
+    /**
+    * @brief Возвращает арену к позиции Mark(): всё выделенное после неё освобождается
+    * @param marker Позиция, полученная от этой же арены
+    */
+    void Rewind(Marker marker) noexcept {
+        current_ = marker.block;
+        offset_ = marker.offset;
+    }
+
+    /**
+    * @brief Освобождает всё выделенное; блоки остаются за ареной
+    */
+    void Reset() noexcept { Rewind(Marker{0, 0}); }
+
+    /**
+    * @brief Возвращает все блоки системе; выделенное ранее, как и после
+    * Reset(), становится недействительным
+    */
+    void Release() noexcept;
+
+    /**
+    * @brief Сколько байт занято с последнего Reset() (с учётом выравнивания)
+    */
+    size_t Used() const noexcept;
+
+    /**
+    * @brief Сколько байт во всех блоках арены
+    */
+    size_t Capacity() const noexcept;
+};
+
+/**
+ * @brief Арена текущего потока (создаётся при первом обращении из потока)
+ */
+Arena& ThreadArena();
+
+/**
+ * @brief Область видимости временных буферов: при выходе арена
+ * возвращается к позиции на момент входа.
+ *
+ *     ArenaFrame frame;  // арена текущего потока
+ *     Complex* scratch = frame.Allocate<Complex>(n);
+ */
+class ArenaFrame {
+private:
+    Arena& arena_;          /**< Арена.*/
+    Arena::Marker marker_;  /**< Позиция на момент входа.*/
+
+public:
+    explicit ArenaFrame(Arena& arena = ThreadArena()) noexcept : arena_(arena), marker_(arena.Mark()) {}
+    ~ArenaFrame() { arena_.Rewind(marker_); }
+
+    ArenaFrame(const ArenaFrame&) = delete;
+    ArenaFrame& operator=(const ArenaFrame&) = delete;
+
+    template <class T>
+    T* Allocate(size_t count) {
+        return arena_.Allocate<T>(count);
+    }
+
+    Arena& GetArena() noexcept { return arena_; }
+};
+
+/**
+ * @brief Распределитель для стандартных контейнеров поверх арены:
+ * deallocate ничего не делает, память возвращается при Reset()/Rewind().
+ * Контейнер не должен переживать эти вызовы.
+ */
+template <class T>
+class ArenaAllocator {
+private:
+    template <class U>
+    friend class ArenaAllocator;
+
+    Arena* arena_;  /**< Арена-источник.*/
+
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena = ThreadArena()) noexcept : arena_(&arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) {}
+
+    T* allocate(size_t count) { return arena_->Allocate<T>(count); }
+    void deallocate(T*, size_t) noexcept {}
+
+    Arena& GetArena() const noexcept { return *arena_; }
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return &a.GetArena() == &b.GetArena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return !(a == b);
+}
+
+#endif // COMPLEX_ALLOCATOR_H
@@ -0,0 +1,378 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "../profile.h"
+#include "../simd.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+struct BenchEntry {
+    const char* name;
+    void (*fn)(BenchState&);
+};
+
+vector<BenchEntry>& Registry() {
+    static vector<BenchEntry> entries;
+    return entries;
+}
+
+/**
+ * @brief Итог одного замера (строка таблицы и объект в JSON).
+ */
+struct BenchResult {
+    string name;
+    size_t iterations;
+    double nsPerIter;
+    double nsPerItem;
+    double cyclesPerItem;  /**< 0, если счётчика тактов нет.*/
+    double gflops;         /**< 0, если операции не заданы.*/
+    double gbPerSecond;    /**< 0, если объём памяти не задан.*/
+    string skipped;        /**< Причина пропуска (пусто, если не пропущен).*/
+    vector<BenchState::Counter> counters;  /**< Дополнительные величины последнего прогона.*/
+};
+
+/**
+ * @brief Параметры командной строки.
+ */
+struct Options {
+    const char* filter = nullptr;   /**< Подстрока имени замера.*/
+    const char* json = nullptr;     /**< Куда записать результаты в JSON.*/
+    const char* compare = nullptr;  /**< JSON прошлого запуска для сравнения.*/
+    const char* profile = nullptr;  /**< Куда записать счётчики горячих путей.*/
+    double minSeconds = 0.2;        /**< Минимальная длительность одного замера.*/
+};
+
+// Счётчик тактов ядра через perf_event_open: считает только вызывающий
+// поток и недоступен без прав (perf_event_paranoid) и в части контейнеров.
+#ifdef __linux__
+int OpenPerfCycles() {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+int PerfCycles() {
+    static const int fd = OpenPerfCycles();
+    return fd;
+}
+#endif
+
+void PrintUsage(const char* program) {
+    printf("usage: %s [filter] [--json=FILE] [--compare=FILE] [--min-time=SECONDS] [--simd=LEVEL]\n"
+           "          [--profile=FILE]\n"
+           "  filter          запускать только замеры, в имени которых есть эта подстрока\n"
+           "  --json=FILE     записать результаты в JSON\n"
+           "  --compare=FILE  сравнить нс/элемент с JSON прошлого запуска\n"
+           "  --min-time=S    минимальная длительность одного замера (по умолчанию 0.2 с)\n"
+           "  --simd=LEVEL    ядра уровня sse2, avx2 или avx512 (по умолчанию — лучший\n"
+           "                  поддерживаемый или из переменной окружения COMPLEX_SIMD)\n"
+           "  --profile=FILE  записать счётчики горячих путей за весь запуск (сборка\n"
+           "                  make PROFILE=1): *.prom — в формате Prometheus, иначе JSON\n",
+           program);
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--json=", 7) == 0) {
+            options.json = arg + 7;
+        } else if (strncmp(arg, "--compare=", 10) == 0) {
+            options.compare = arg + 10;
+        } else if (strncmp(arg, "--min-time=", 11) == 0) {
+            options.minSeconds = atof(arg + 11);
+        } else if (strncmp(arg, "--profile=", 10) == 0) {
+            options.profile = arg + 10;
+        } else if (strncmp(arg, "--simd=", 7) == 0) {
+            SimdLevel level;
+            if (!ParseSimdLevel(arg + 7, level) || !SetActiveSimdLevel(level)) {
+                fprintf(stderr, "уровень %s неизвестен или не поддерживается процессором\n", arg + 7);
+                return false;
+            }
+        } else if (arg[0] == '-') {
+            return false;
+        } else {
+            options.filter = arg;
+        }
+    }
+    return options.minSeconds > 0;
+}
+
+/**
+ * @brief Подбирает число итераций под минимальное время и выполняет замер.
+ */
+BenchResult Run(const BenchEntry& entry, double minSeconds) {
+    BenchResult result = {entry.name, 0, 0, 0, 0, 0, 0, "", {}};
+    size_t iterations = 1;
+    for (;;) {
+        BenchState state(iterations);
+        entry.fn(state);
+        double seconds = state.Seconds();
+        if (state.Skipped()) {
+            result.skipped = state.Skipped();
+            return result;
+        }
+        if (seconds >= minSeconds || iterations >= (size_t(1) << 40)) {
+            double items = state.ItemsPerIteration() * iterations;
+            result.iterations = iterations;
+            result.nsPerIter = seconds * 1e9 / iterations;
+            result.nsPerItem = result.nsPerIter / state.ItemsPerIteration();
+            result.cyclesPerItem = state.Cycles() / items;
+            result.gflops = state.FlopsPerIteration() / result.nsPerIter;
+            result.gbPerSecond = state.BytesPerIteration() / result.nsPerIter;
+            for (size_t i = 0; i < state.CounterCount(); ++i) {
+                result.counters.push_back(state.GetCounter(i));
+            }
+            return result;
+        }
+        // Следующая попытка с запасом, чтобы уложиться в минимальное время.
+        double scale = seconds > 0 ? 1.4 * minSeconds / seconds : 100.0;
+        iterations = size_t(iterations * (scale < 100.0 ? (scale > 2.0 ? scale : 2.0) : 100.0));
+    }
+}
+
+void PrintResult(const BenchResult& r) {
+    if (!r.skipped.empty()) {
+        printf("%-40s skipped: %s\n", r.name.c_str(), r.skipped.c_str());
+        return;
+    }
+    printf("%-40s %14zu %12.2f %14.4f", r.name.c_str(), r.iterations, r.nsPerIter, r.nsPerItem);
+    if (r.cyclesPerItem > 0) {
+        printf(" %12.3f", r.cyclesPerItem);
+    } else {
+        printf(" %12s", "-");
+    }
+    if (r.gflops > 0) {
+        printf(" %10.3f", r.gflops);
+    } else if (r.gbPerSecond > 0) {
+        printf(" %10s", "");
+    }
+    if (r.gbPerSecond > 0) {
+        printf(" %10.3f", r.gbPerSecond);
+    }
+    for (const BenchState::Counter& c : r.counters) {
+        printf("  %s=%.4g", c.name, c.value);
+    }
+    printf("\n");
+}
+
+/** Строка в кавычках для JSON */
+string Quote(const string& s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c >= ' ' ? c : ' ';
+    }
+    return out + "\"";
+}
+
+// Каждый замер — одна строка "benchmarks": сравнение (--compare) читает
+// файл построчно и не нуждается в полноценном разборщике JSON.
+bool WriteJson(const char* path, const vector<BenchResult>& results, double minSeconds) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+#ifdef __VERSION__
+    const char* compiler = __VERSION__;
+#else
+    const char* compiler = "unknown";
+#endif
+    fprintf(file, "{\n  \"context\": {\"date\": %s, \"simd\": %s, \"compiler\": %s, \"cycles\": %s, \"min_time\": %g},\n",
+            Quote(date).c_str(), Quote(ActiveKernels().name).c_str(), Quote(compiler).c_str(),
+            Quote(CycleCounterName()).c_str(), minSeconds);
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        const char* comma = i + 1 < results.size() ? "," : "";
+        if (!r.skipped.empty()) {
+            fprintf(file, "    {\"name\": %s, \"skipped\": %s}%s\n", Quote(r.name).c_str(), Quote(r.skipped).c_str(),
+                    comma);
+            continue;
+        }
+        string counters;
+        for (const BenchState::Counter& c : r.counters) {
+            char value[64];
+            snprintf(value, sizeof(value), ": %.6g", c.value);
+            counters += (counters.empty() ? ", \"counters\": {" : ", ") + Quote(c.name) + value;
+        }
+        if (!counters.empty()) {
+            counters += "}";
+        }
+        fprintf(file,
+                "    {\"name\": %s, \"iterations\": %zu, \"ns_per_iter\": %.6g, \"ns_per_item\": %.6g, "
+                "\"cycles_per_item\": %.6g, \"gflops\": %.6g, \"gb_per_s\": %.6g%s}%s\n",
+                Quote(r.name).c_str(), r.iterations, r.nsPerIter, r.nsPerItem, r.cyclesPerItem, r.gflops,
+                r.gbPerSecond, counters.c_str(), comma);
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Пишет счётчики горячих путей (profile.h): в формате Prometheus,
+ * если имя файла кончается на .prom, иначе в JSON.
+ */
+bool WriteProfile(const char* path) {
+    if (!ProfileEnabled()) {
+        fprintf(stderr, "предупреждение: счётчики выключены, соберите замеры через make PROFILE=1\n");
+    }
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    size_t length = strlen(path);
+    bool prometheus = length >= 5 && strcmp(path + length - 5, ".prom") == 0;
+    ProfileSnapshot snapshot = CollectProfile();
+    string text = prometheus ? ProfileToPrometheus(snapshot) : ProfileToJson(snapshot);
+    fputs(text.c_str(), file);
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Читает пары (имя, нс/элемент) из JSON, записанного WriteJson
+ */
+vector<pair<string, double>> ReadBaseline(const char* path) {
+    vector<pair<string, double>> baseline;
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return baseline;
+    }
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        const char* name = strstr(line, "\"name\": \"");
+        const char* ns = strstr(line, "\"ns_per_item\": ");
+        if (!name || !ns) {
+            continue;
+        }
+        name += 9;
+        const char* end = strchr(name, '"');
+        if (end) {
+            baseline.emplace_back(string(name, end), atof(ns + 15));
+        }
+    }
+    fclose(file);
+    return baseline;
+}
+
+/**
+ * @brief Печатает изменение нс/элемент относительно прошлого запуска;
+ * изменения больше 5% помечаются.
+ */
+void PrintComparison(const vector<BenchResult>& results, const vector<pair<string, double>>& baseline) {
+    printf("\n%-40s %14s %14s %10s\n", "benchmark", "base ns/elem", "ns/element", "change");
+    for (const BenchResult& r : results) {
+        for (const auto& base : baseline) {
+            if (base.first != r.name || !r.skipped.empty() || base.second <= 0) {
+                continue;
+            }
+            double change = (r.nsPerItem / base.second - 1) * 100;
+            const char* mark = change > 5 ? "  slower" : change < -5 ? "  faster" : "";
+            printf("%-40s %14.4f %14.4f %+9.1f%%%s\n", r.name.c_str(), base.second, r.nsPerItem, change, mark);
+            break;
+        }
+    }
+}
+
+} // namespace
+
+bool RegisterBenchmark(const char* name, void (*fn)(BenchState&)) {
+    Registry().push_back(BenchEntry{name, fn});
+    return true;
+}
+
+uint64_t ReadCycleCounter() {
+#ifdef __linux__
+    uint64_t count;
+    if (PerfCycles() >= 0 && read(PerfCycles(), &count, sizeof(count)) == ssize_t(sizeof(count))) {
+        return count;
+    }
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+const char* CycleCounterName() {
+#ifdef __linux__
+    if (PerfCycles() >= 0) {
+        return "perf";
+    }
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    return "rdtsc";
+#else
+    return "none";
+#endif
+}
+
+/**
+ * @brief Запускает все зарегистрированные замеры (или только те, в имени
+ * которых встречается подстрока-фильтр), печатает таблицу и по запросу
+ * пишет JSON и сравнивает с прошлым запуском.
+ */
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    vector<pair<string, double>> baseline;
+    if (options.compare) {
+        baseline = ReadBaseline(options.compare);
+        if (baseline.empty()) {
+            fprintf(stderr, "не удалось прочитать замеры из %s\n", options.compare);
+            return 1;
+        }
+    }
+    printf("# simd: %s, cycles: %s\n", ActiveKernels().name, CycleCounterName());
+    printf("%-40s %14s %12s %14s %12s %10s %10s\n", "benchmark", "iterations", "ns/iter", "ns/element", "cycles/elem",
+           "GFLOPS", "GB/s");
+    vector<BenchResult> results;
+    for (const BenchEntry& entry : Registry()) {
+        if (options.filter && !strstr(entry.name, options.filter)) {
+            continue;
+        }
+        results.push_back(Run(entry, options.minSeconds));
+        PrintResult(results.back());
+        fflush(stdout);
+    }
+    if (options.json && !WriteJson(options.json, results, options.minSeconds)) {
+        fprintf(stderr, "не удалось записать %s\n", options.json);
+        return 1;
+    }
+    if (options.compare) {
+        PrintComparison(results, baseline);
+    }
+    if (options.profile && !WriteProfile(options.profile)) {
+        fprintf(stderr, "не удалось записать %s\n", options.profile);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Текущее значение счётчика тактов: аппаратный счётчик тактов ядра
+ * (perf, Linux), если он доступен, иначе rdtsc (такты опорной частоты),
+ * иначе 0. Источник — CycleCounterName().
+ */
+uint64_t ReadCycleCounter();
+
+/**
+ * @brief Источник тактов: "perf", "rdtsc" или "none"
+ */
+const char* CycleCounterName();
+
+/**
+ * @brief Состояние одного замера: число итераций и объём работы на итерацию.
+ *
+ * Тело замера крутится в цикле while (state.KeepRunning()) { ... },
+ * а раннер сам подбирает число итераций под минимальное время.
+ * Время подготовки данных до первого KeepRunning() в замер не входит.
+ */
+class BenchState {
+public:
+    /** Дополнительная величина замера (например, перцентиль задержки). */
+    struct Counter {
+        const char* name;  /**< Имя (строковая константа).*/
+        double value;      /**< Значение.*/
+    };
+
+    /** Сколько дополнительных величин может быть у замера. */
+    static const size_t kMaxCounters = 4;
+
+private:
+    size_t iterations_;  /**< Запрошенное число итераций.*/
+    size_t left_;        /**< Сколько итераций осталось.*/
+    double items_;       /**< Элементов за одну итерацию (для нс/элемент).*/
+    double flops_;       /**< Операций с плавающей точкой за итерацию (0 — не считать).*/
+    double bytes_;       /**< Байт памяти, прочитанных и записанных за итерацию (0 — не считать).*/
+    const char* skipped_;  /**< Причина пропуска замера (nullptr, если не пропущен).*/
+    bool started_;       /**< Был ли уже первый вызов KeepRunning().*/
+    std::chrono::steady_clock::time_point start_;  /**< Начало цикла замера.*/
+    std::chrono::steady_clock::time_point stop_;   /**< Конец цикла замера.*/
+    uint64_t startCycles_;  /**< Счётчик тактов в начале цикла.*/
+    uint64_t stopCycles_;   /**< Счётчик тактов в конце цикла.*/
+    Counter counters_[kMaxCounters];  /**< Дополнительные величины.*/
+    size_t counterCount_;             /**< Сколько их задано.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param iterations Число итераций, которое нужно выполнить
+    */
+    explicit BenchState(size_t iterations) : iterations_(iterations), left_(iterations), items_(1), flops_(0), bytes_(0), skipped_(nullptr), started_(false), startCycles_(0), stopCycles_(0), counterCount_(0) {}
+
+    /**
+    * @brief Условие цикла замера
+    * @return true, пока не выполнены все итерации
+    */
+    bool KeepRunning() {
+        if (!started_) {
+            started_ = true;
+            start_ = std::chrono::steady_clock::now();
+            startCycles_ = ReadCycleCounter();
+        }
+        if (left_ == 0) {
+            stopCycles_ = ReadCycleCounter();
+            stop_ = std::chrono::steady_clock::now();
+            return false;
+        }
+        --left_;
+        return true;
+    }
+
+    /**
+    * @brief Задаёт число обработанных элементов за одну итерацию
+    * @param items Число элементов
+    */
+    void SetItemsPerIteration(double items) { items_ = items; }
+
+    /**
+    * @brief Задаёт число операций с плавающей точкой за итерацию (для GFLOPS)
+    * @param flops Число операций
+    */
+    void SetFlopsPerIteration(double flops) { flops_ = flops; }
+
+    /**
+    * @brief Задаёт объём обращений к памяти за итерацию (для ГБ/с)
+    * @param bytes Число байт (чтение + запись)
+    */
+    void SetBytesPerIteration(double bytes) { bytes_ = bytes; }
+
+    /**
+    * @brief Помечает замер как пропущенный (например, нет нужных инструкций)
+    * @param reason Причина пропуска
+    */
+    void Skip(const char* reason) { skipped_ = reason; }
+
+    /**
+    * @brief Задаёт дополнительную величину, которая выводится после строки
+    * замера и в JSON (повторный вызов с тем же именем заменяет значение;
+    * сверх kMaxCounters величины отбрасываются)
+    * @param name Имя (строковая константа, например "p99_ns")
+    * @param value Значение
+    */
+    void SetCounter(const char* name, double value) {
+        for (size_t i = 0; i < counterCount_; ++i) {
+            if (std::strcmp(counters_[i].name, name) == 0) {
+                counters_[i].value = value;
+                return;
+            }
+        }
+        if (counterCount_ < kMaxCounters) {
+            counters_[counterCount_++] = Counter{name, value};
+        }
+    }
+
+    size_t Iterations() const { return iterations_; }
+    double ItemsPerIteration() const { return items_; }
+    double FlopsPerIteration() const { return flops_; }
+    double BytesPerIteration() const { return bytes_; }
+    const char* Skipped() const { return skipped_; }
+    size_t CounterCount() const { return counterCount_; }
+    const Counter& GetCounter(size_t index) const { return counters_[index]; }
+
+    /** Длительность цикла замера в секундах */
+    double Seconds() const { return std::chrono::duration<double>(stop_ - start_).count(); }
+
+    /** Тактов за цикл замера (0, если счётчика нет) */
+    double Cycles() const { return double(stopCycles_ - startCycles_); }
+};
+
+/**
+ * @brief Регистрирует функцию замера под заданным именем.
+ * @param name Имя замера
+ * @param fn Функция замера
+ * @return Всегда true (для статической регистрации)
+ */
+bool RegisterBenchmark(const char* name, void (*fn)(BenchState&));
+
+/**
+ * @brief Не даёт компилятору выбросить вычисление значения.
+ */
+template <class T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Барьер, заставляющий компилятор считать память изменённой.
+ */
+inline void ClobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+#define BENCHMARK(fn) static const bool fn##_registered = RegisterBenchmark(#fn, fn)
+
+#endif // BENCH_H
@@ -0,0 +1,109 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../complexarray.h"
+#include "../complexbatch.h"
+
+// Модуль комплексного числа: поэлементные циклы против пакетных ядер,
+// точный режим против приближённого (нс/элемент).
+
+namespace {
+
+const size_t kBlock = 4096;
+
+vector<Complex> RandomBlock() {
+    vector<Complex> x(kBlock);
+    srand(1);
+    for (Complex& z : x) {
+        z.Set(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+    }
+    return x;
+}
+
+void Abs_ScalarLoop(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = x[i].Abs();
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Abs_StdHypot(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = hypot(x[i].Re(), x[i].Im());
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void AbsSquared_ScalarLoop(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = x[i].AbsSquared();
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Abs_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        Abs(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Abs_BatchApprox(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        Abs(x.data(), out.data(), kBlock, AbsMode::Approx);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void AbsSquared_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        AbsSquared(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Abs_ArrayApprox(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    ComplexArray a(x.data(), kBlock);
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        Abs(a, out.data(), AbsMode::Approx);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+} // namespace
+
+BENCHMARK(Abs_ScalarLoop);
+BENCHMARK(Abs_StdHypot);
+BENCHMARK(AbsSquared_ScalarLoop);
+BENCHMARK(Abs_Batch);
+BENCHMARK(Abs_BatchApprox);
+BENCHMARK(AbsSquared_Batch);
+BENCHMARK(Abs_ArrayApprox);
@@ -0,0 +1,131 @@
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "../allocator.h"
+#include "../complexarray.h"
+#include "../threadpool.h"
+
+// Рабочие буферы на каждый блок сигнала: три буфера по 16K чисел (256 КБ,
+// выше порога mmap в glibc), которые заполняются и освобождаются на каждом
+// блоке. vector<Complex> и ComplexVector обращаются к куче (и к ОС за
+// страницами) на каждом блоке, арена потока — только при первом блоке.
+// Многопоточные варианты — те же блоки на пуле из 4 потоков.
+
+namespace {
+
+const size_t kBlock = 16384;
+const size_t kBlocks = 64;
+
+/** Работа над буферами блока: запись всех элементов и чтение одного */
+void Touch(Complex* a, Complex* b, Complex* c, size_t i) {
+    for (size_t k = 0; k < kBlock; ++k) {
+        a[k] = Complex(double(k), double(i));
+        b[k] = a[k];
+        c[k] = b[k];
+    }
+    DoNotOptimize(c[i % kBlock]);
+}
+
+void VectorBlock(size_t i) {
+    vector<Complex> a(kBlock), b(kBlock), c(kBlock);
+    Touch(a.data(), b.data(), c.data(), i);
+}
+
+void AlignedBlock(size_t i) {
+    ComplexVector a(kBlock), b(kBlock), c(kBlock);
+    Touch(a.data(), b.data(), c.data(), i);
+}
+
+void ArenaBlock(size_t i) {
+    ArenaFrame frame;
+    Complex* a = frame.Allocate<Complex>(kBlock);
+    Complex* b = frame.Allocate<Complex>(kBlock);
+    Complex* c = frame.Allocate<Complex>(kBlock);
+    Touch(a, b, c, i);
+}
+
+/** Та же работа без выделений: нижняя граница времени на блок */
+void PreallocatedBlock(size_t i) {
+    thread_local vector<Complex> a(kBlock), b(kBlock), c(kBlock);
+    Touch(a.data(), b.data(), c.data(), i);
+}
+
+template <void (*Block)(size_t)>
+void Serial(BenchState& state) {
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlocks; ++i) {
+            Block(i);
+        }
+    }
+    state.SetItemsPerIteration(kBlocks);
+    state.SetBytesPerIteration(3.0 * kBlocks * kBlock * sizeof(Complex));
+}
+
+ThreadPool& Pool() {
+    static ThreadPool pool(3);
+    return pool;
+}
+
+template <void (*Block)(size_t)>
+void Threads4(BenchState& state) {
+    if (thread::hardware_concurrency() < 4) {
+        state.Skip("меньше 4 ядер");
+        return;
+    }
+    ThreadPool& pool = Pool();
+    while (state.KeepRunning()) {
+        pool.ParallelFor(0, 4 * kBlocks, 1, [](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                Block(i);
+            }
+        });
+    }
+    state.SetItemsPerIteration(4 * kBlocks);
+    state.SetBytesPerIteration(12.0 * kBlocks * kBlock * sizeof(Complex));
+}
+
+/** ComplexArray на каждый блок: собственные буферы против буферов арены */
+void ComplexArrayOwned(BenchState& state) {
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlocks; ++i) {
+            ComplexArray a(kBlock);
+            DoNotOptimize(a.Re());
+        }
+    }
+    state.SetItemsPerIteration(kBlocks);
+}
+
+void ComplexArrayArena(BenchState& state) {
+    Arena arena;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlocks; ++i) {
+            arena.Reset();
+            ComplexArray a = ComplexArray::FromArena(arena, kBlock);
+            memset(a.Re(), 0, kBlock * sizeof(double));
+            memset(a.Im(), 0, kBlock * sizeof(double));
+            DoNotOptimize(a.Re());
+        }
+    }
+    state.SetItemsPerIteration(kBlocks);
+}
+
+void Alloc_Block_Vector(BenchState& s) { Serial<VectorBlock>(s); }
+void Alloc_Block_Aligned(BenchState& s) { Serial<AlignedBlock>(s); }
+void Alloc_Block_Arena(BenchState& s) { Serial<ArenaBlock>(s); }
+void Alloc_Block_Preallocated(BenchState& s) { Serial<PreallocatedBlock>(s); }
+void Alloc_Block_Vector_Threads4(BenchState& s) { Threads4<VectorBlock>(s); }
+void Alloc_Block_Arena_Threads4(BenchState& s) { Threads4<ArenaBlock>(s); }
+void Alloc_ComplexArray_Owned(BenchState& s) { ComplexArrayOwned(s); }
+void Alloc_ComplexArray_Arena(BenchState& s) { ComplexArrayArena(s); }
+
+} // namespace
+
+BENCHMARK(Alloc_Block_Vector);
+BENCHMARK(Alloc_Block_Aligned);
+BENCHMARK(Alloc_Block_Arena);
+BENCHMARK(Alloc_Block_Preallocated);
+BENCHMARK(Alloc_Block_Vector_Threads4);
+BENCHMARK(Alloc_Block_Arena_Threads4);
+BENCHMARK(Alloc_ComplexArray_Owned);
+BENCHMARK(Alloc_ComplexArray_Arena);
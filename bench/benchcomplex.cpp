@@ -0,0 +1,80 @@
+#include <vector>
+#include "bench.h"
+#include "legacycomplex.h"
+#include "../mycomplex.h"
+
+// Сравнение заголовочного Complex с прежней вынесенной реализацией
+// на типичных циклах: смеситель, накопление свёртки и копирование блока.
+
+namespace {
+
+const size_t kBlock = 4096;
+
+template <class C>
+void Mixer(BenchState& state) {
+    vector<C> x(kBlock, C(0.5, -0.25)), lo(kBlock, C(0.8, 0.6)), y(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            y[i] = x[i] * lo[i];
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+template <class C>
+void MultiplyAccumulate(BenchState& state) {
+    vector<C> x(kBlock, C(0.5, -0.25)), w(kBlock, C(0.1, 0.2));
+    while (state.KeepRunning()) {
+        C acc;
+        for (size_t i = 0; i < kBlock; ++i) {
+            acc += x[i] * w[i];
+        }
+        DoNotOptimize(acc);
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+template <class C>
+void CopyBlock(BenchState& state) {
+    vector<C> x(kBlock, C(1, 2)), y(kBlock);
+    while (state.KeepRunning()) {
+        DoNotOptimize(x.data());
+        y = x;
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+template <class C>
+void SumAbs(BenchState& state) {
+    vector<C> x(kBlock, C(3, 4));
+    while (state.KeepRunning()) {
+        double sum = 0;
+        for (size_t i = 0; i < kBlock; ++i) {
+            sum += x[i].Abs();
+        }
+        DoNotOptimize(sum);
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Mixer_Inline(BenchState& s) { Mixer<Complex>(s); }
+void Mixer_OutOfLine(BenchState& s) { Mixer<LegacyComplex>(s); }
+void Mac_Inline(BenchState& s) { MultiplyAccumulate<Complex>(s); }
+void Mac_OutOfLine(BenchState& s) { MultiplyAccumulate<LegacyComplex>(s); }
+void Copy_Inline(BenchState& s) { CopyBlock<Complex>(s); }
+void Copy_OutOfLine(BenchState& s) { CopyBlock<LegacyComplex>(s); }
+void SumAbs_Inline(BenchState& s) { SumAbs<Complex>(s); }
+void SumAbs_OutOfLine(BenchState& s) { SumAbs<LegacyComplex>(s); }
+
+} // namespace
+
+BENCHMARK(Mixer_Inline);
+BENCHMARK(Mixer_OutOfLine);
+BENCHMARK(Mac_Inline);
+BENCHMARK(Mac_OutOfLine);
+BENCHMARK(Copy_Inline);
+BENCHMARK(Copy_OutOfLine);
+BENCHMARK(SumAbs_Inline);
+BENCHMARK(SumAbs_OutOfLine);
@@ -0,0 +1,104 @@
+#include <vector>
+#include "bench.h"
+#include "../complexarray.h"
+#include "../simd.h"
+
+// Смеситель и фильтр над vector<Complex> против раздельного ComplexArray
+// и против каждого набора ядер по отдельности.
+
+namespace {
+
+const size_t kSmall = 4096;
+const size_t kLarge = 1 << 20;
+
+void VectorMul(BenchState& state, size_t n) {
+    vector<Complex> x(n, Complex(0.5, -0.25)), lo(n, Complex(0.8, 0.6)), y(n);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < n; ++i) {
+            y[i] = x[i] * lo[i];
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+}
+
+void ArrayMul(BenchState& state, size_t n) {
+    vector<Complex> init(n, Complex(0.5, -0.25));
+    ComplexArray x(init.data(), n), lo(x), y(n);
+    while (state.KeepRunning()) {
+        Mul(x, lo, y);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+}
+
+void KernelMul(BenchState& state, SimdLevel level) {
+    const SimdKernels& k = KernelsFor(level);
+    ComplexArray x(kSmall), lo(kSmall), y(kSmall);
+    while (state.KeepRunning()) {
+        k.mul(x.Re(), x.Im(), lo.Re(), lo.Im(), y.Re(), y.Im(), kSmall);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kSmall);
+}
+
+void KernelAbs(BenchState& state, SimdLevel level) {
+    const SimdKernels& k = KernelsFor(level);
+    ComplexArray x(kSmall);
+    vector<double> out(kSmall);
+    while (state.KeepRunning()) {
+        k.abs(x.Re(), x.Im(), out.data(), kSmall);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kSmall);
+}
+
+void Mul_Vector_4K(BenchState& s) { VectorMul(s, kSmall); }
+void Mul_Array_4K(BenchState& s) { ArrayMul(s, kSmall); }
+void Mul_Vector_1M(BenchState& s) { VectorMul(s, kLarge); }
+void Mul_Array_1M(BenchState& s) { ArrayMul(s, kLarge); }
+void Mul_Sse2_4K(BenchState& s) { KernelMul(s, SimdLevel::Sse2); }
+void Abs_Sse2_4K(BenchState& s) { KernelAbs(s, SimdLevel::Sse2); }
+
+// Наборы выше SSE2 замеряются, только если процессор их поддерживает.
+void Mul_Avx2_4K(BenchState& s) {
+    if (DetectSimdLevel() >= SimdLevel::Avx2) {
+        KernelMul(s, SimdLevel::Avx2);
+    } else {
+        s.Skip("процессор не поддерживает avx2");
+    }
+}
+void Abs_Avx2_4K(BenchState& s) {
+    if (DetectSimdLevel() >= SimdLevel::Avx2) {
+        KernelAbs(s, SimdLevel::Avx2);
+    } else {
+        s.Skip("процессор не поддерживает avx2");
+    }
+}
+void Mul_Avx512_4K(BenchState& s) {
+    if (DetectSimdLevel() >= SimdLevel::Avx512) {
+        KernelMul(s, SimdLevel::Avx512);
+    } else {
+        s.Skip("процессор не поддерживает avx512");
+    }
+}
+void Abs_Avx512_4K(BenchState& s) {
+    if (DetectSimdLevel() >= SimdLevel::Avx512) {
+        KernelAbs(s, SimdLevel::Avx512);
+    } else {
+        s.Skip("процессор не поддерживает avx512");
+    }
+}
+
+} // namespace
+
+BENCHMARK(Mul_Vector_4K);
+BENCHMARK(Mul_Array_4K);
+BENCHMARK(Mul_Vector_1M);
+BENCHMARK(Mul_Array_1M);
+BENCHMARK(Mul_Sse2_4K);
+BENCHMARK(Mul_Avx2_4K);
+BENCHMARK(Mul_Avx512_4K);
+BENCHMARK(Abs_Sse2_4K);
+BENCHMARK(Abs_Avx2_4K);
+BENCHMARK(Abs_Avx512_4K);
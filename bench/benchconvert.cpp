@@ -0,0 +1,81 @@
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../complexbatch.h"
+#include "../simd.h"
+
+// Преобразования между Complex, ComplexF, ComplexQ15 и ComplexHalf: цикл
+// ComplexCast против пакетных Convert (ГБ/с по чтению и записи).
+
+namespace {
+
+const size_t kBlock = 4096;
+
+vector<Complex> RandomBlock() {
+    vector<Complex> x(kBlock);
+    srand(3);
+    for (Complex& z : x) {
+        z.Set(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+    }
+    return x;
+}
+
+template <class To, class From>
+void ScalarCast(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<BasicComplex<From>> src(kBlock);
+    vector<BasicComplex<To>> dst(kBlock);
+    for (size_t i = 0; i < kBlock; ++i) {
+        src[i] = ComplexCast<From>(x[i]);
+    }
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            dst[i] = ComplexCast<To>(src[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetBytesPerIteration(kBlock * (sizeof(src[0]) + sizeof(dst[0])));
+}
+
+template <class To, class From>
+void BatchConvert(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<BasicComplex<From>> src(kBlock);
+    vector<BasicComplex<To>> dst(kBlock);
+    for (size_t i = 0; i < kBlock; ++i) {
+        src[i] = ComplexCast<From>(x[i]);
+    }
+    while (state.KeepRunning()) {
+        Convert(src.data(), dst.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetBytesPerIteration(kBlock * (sizeof(src[0]) + sizeof(dst[0])));
+}
+
+void Convert_F64ToF32_Scalar(BenchState& s) { ScalarCast<float, double>(s); }
+void Convert_F64ToF32_Batch(BenchState& s) { BatchConvert<float, double>(s); }
+void Convert_Q15ToF32_Scalar(BenchState& s) { ScalarCast<float, Q15>(s); }
+void Convert_Q15ToF32_Batch(BenchState& s) { BatchConvert<float, Q15>(s); }
+void Convert_F32ToQ15_Scalar(BenchState& s) { ScalarCast<Q15, float>(s); }
+void Convert_F32ToQ15_Batch(BenchState& s) { BatchConvert<Q15, float>(s); }
+void Convert_HalfToF32_Scalar(BenchState& s) { ScalarCast<float, Half>(s); }
+void Convert_HalfToF32_Batch(BenchState& s) { BatchConvert<float, Half>(s); }
+void Convert_F32ToHalf_Scalar(BenchState& s) { ScalarCast<Half, float>(s); }
+void Convert_F32ToHalf_Batch(BenchState& s) { BatchConvert<Half, float>(s); }
+void Convert_F64ToHalf_Batch(BenchState& s) { BatchConvert<Half, double>(s); }
+
+} // namespace
+
+BENCHMARK(Convert_F64ToF32_Scalar);
+BENCHMARK(Convert_F64ToF32_Batch);
+BENCHMARK(Convert_Q15ToF32_Scalar);
+BENCHMARK(Convert_Q15ToF32_Batch);
+BENCHMARK(Convert_F32ToQ15_Scalar);
+BENCHMARK(Convert_F32ToQ15_Batch);
+BENCHMARK(Convert_HalfToF32_Scalar);
+BENCHMARK(Convert_HalfToF32_Batch);
+BENCHMARK(Convert_F32ToHalf_Scalar);
+BENCHMARK(Convert_F32ToHalf_Batch);
+BENCHMARK(Convert_F64ToHalf_Batch);
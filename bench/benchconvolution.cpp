@@ -0,0 +1,91 @@
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../convolution.h"
+
+// Свёртка 16384 отсчётов с фильтрами из 16, 64, 256 и 2048 отводов:
+// вложенные циклы на operator*= и operator+= против прямой свёртки
+// блоками, перекрытия со сложением и с накоплением и свёртки по
+// разбиениям (блок 256). Элемент — отсчёт выхода; точки перехода для Auto
+// замеряет CalibrateConvolution().
+
+namespace {
+
+const size_t kSignal = 16384;
+
+vector<Complex> RandomBlock(size_t n, unsigned seed) {
+    srand(seed);
+    vector<Complex> x(n);
+    for (Complex& z : x) {
+        z = Complex(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+    }
+    return x;
+}
+
+/** Сегодняшний код: out[k] += x[j] * h[k - j] по одному произведению */
+void Naive(BenchState& state, size_t taps) {
+    vector<Complex> x = RandomBlock(kSignal, 1), h = RandomBlock(taps, 2), out(kSignal + taps - 1);
+    while (state.KeepRunning()) {
+        for (Complex& z : out) {
+            z = Complex();
+        }
+        for (size_t j = 0; j < kSignal; ++j) {
+            for (size_t t = 0; t < taps; ++t) {
+                Complex p = x[j];
+                p *= h[t];
+                out[j + t] += p;
+            }
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(double(out.size()));
+}
+
+void Method(BenchState& state, size_t taps, ConvolutionMethod method) {
+    vector<Complex> x = RandomBlock(kSignal, 1), h = RandomBlock(taps, 2), out(kSignal + taps - 1);
+    while (state.KeepRunning()) {
+        Convolve(x.data(), kSignal, h.data(), taps, out.data(), method);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(double(out.size()));
+}
+
+void Conv_Naive_16(BenchState& s) { Naive(s, 16); }
+void Conv_Direct_16(BenchState& s) { Method(s, 16, ConvolutionMethod::Direct); }
+void Conv_OverlapAdd_16(BenchState& s) { Method(s, 16, ConvolutionMethod::OverlapAdd); }
+void Conv_OverlapSave_16(BenchState& s) { Method(s, 16, ConvolutionMethod::OverlapSave); }
+void Conv_Naive_64(BenchState& s) { Naive(s, 64); }
+void Conv_Direct_64(BenchState& s) { Method(s, 64, ConvolutionMethod::Direct); }
+void Conv_OverlapAdd_64(BenchState& s) { Method(s, 64, ConvolutionMethod::OverlapAdd); }
+void Conv_OverlapSave_64(BenchState& s) { Method(s, 64, ConvolutionMethod::OverlapSave); }
+void Conv_Partitioned_64(BenchState& s) { Method(s, 64, ConvolutionMethod::Partitioned); }
+void Conv_Naive_256(BenchState& s) { Naive(s, 256); }
+void Conv_Direct_256(BenchState& s) { Method(s, 256, ConvolutionMethod::Direct); }
+void Conv_OverlapAdd_256(BenchState& s) { Method(s, 256, ConvolutionMethod::OverlapAdd); }
+void Conv_OverlapSave_256(BenchState& s) { Method(s, 256, ConvolutionMethod::OverlapSave); }
+void Conv_Partitioned_256(BenchState& s) { Method(s, 256, ConvolutionMethod::Partitioned); }
+void Conv_Direct_2048(BenchState& s) { Method(s, 2048, ConvolutionMethod::Direct); }
+void Conv_OverlapAdd_2048(BenchState& s) { Method(s, 2048, ConvolutionMethod::OverlapAdd); }
+void Conv_OverlapSave_2048(BenchState& s) { Method(s, 2048, ConvolutionMethod::OverlapSave); }
+void Conv_Partitioned_2048(BenchState& s) { Method(s, 2048, ConvolutionMethod::Partitioned); }
+
+} // namespace
+
+BENCHMARK(Conv_Naive_16);
+BENCHMARK(Conv_Direct_16);
+BENCHMARK(Conv_OverlapAdd_16);
+BENCHMARK(Conv_OverlapSave_16);
+BENCHMARK(Conv_Naive_64);
+BENCHMARK(Conv_Direct_64);
+BENCHMARK(Conv_OverlapAdd_64);
+BENCHMARK(Conv_OverlapSave_64);
+BENCHMARK(Conv_Partitioned_64);
+BENCHMARK(Conv_Naive_256);
+BENCHMARK(Conv_Direct_256);
+BENCHMARK(Conv_OverlapAdd_256);
+BENCHMARK(Conv_OverlapSave_256);
+BENCHMARK(Conv_Partitioned_256);
+BENCHMARK(Conv_Direct_2048);
+BENCHMARK(Conv_OverlapAdd_2048);
+BENCHMARK(Conv_OverlapSave_2048);
+BENCHMARK(Conv_Partitioned_2048);
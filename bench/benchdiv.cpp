@@ -0,0 +1,114 @@
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../complexarray.h"
+#include "../complexbatch.h"
+#include "../simd.h"
+
+// Комплексное деление: прежняя запись conj(b)*a/|b|^2 в цикле, operator/
+// (Смит), FastDivide и пакетные ядра в обоих режимах (нс/элемент).
+
+namespace {
+
+const size_t kBlock = 4096;
+
+vector<Complex> RandomBlock(unsigned seed) {
+    vector<Complex> x(kBlock);
+    srand(seed);
+    for (Complex& z : x) {
+        z.Set(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+    }
+    return x;
+}
+
+void Div_InlineConj(BenchState& state) {
+    vector<Complex> a = RandomBlock(1), b = RandomBlock(2), out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            Complex conj(b[i].Re(), -b[i].Im());
+            out[i] = a[i] * conj / b[i].AbsSquared();
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Div_ScalarSmith(BenchState& state) {
+    vector<Complex> a = RandomBlock(1), b = RandomBlock(2), out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = a[i] / b[i];
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Div_ScalarFast(BenchState& state) {
+    vector<Complex> a = RandomBlock(1), b = RandomBlock(2), out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = a[i].FastDivide(b[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void BatchDivide(BenchState& state, DivMode mode) {
+    vector<Complex> a = RandomBlock(1), b = RandomBlock(2), out(kBlock);
+    while (state.KeepRunning()) {
+        Divide(a.data(), b.data(), out.data(), kBlock, mode);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void BatchReciprocal(BenchState& state, DivMode mode) {
+    vector<Complex> b = RandomBlock(2), out(kBlock);
+    while (state.KeepRunning()) {
+        Reciprocal(b.data(), out.data(), kBlock, mode);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+// Ядро деления раздельных массивов на заданном уровне инструкций.
+void SplitDivide(BenchState& state, SimdLevel level, bool fast) {
+    if (level > DetectSimdLevel()) {
+        state.Skip("процессор не поддерживает");
+        return;
+    }
+    vector<Complex> a = RandomBlock(1), b = RandomBlock(2);
+    ComplexArray x(a.data(), kBlock), y(b.data(), kBlock), out(kBlock);
+    const SimdKernels& kernels = KernelsFor(level);
+    auto kernel = fast ? kernels.divFast : kernels.div;
+    while (state.KeepRunning()) {
+        kernel(x.Re(), x.Im(), y.Re(), y.Im(), out.Re(), out.Im(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Div_Batch(BenchState& s) { BatchDivide(s, DivMode::Robust); }
+void Div_BatchFast(BenchState& s) { BatchDivide(s, DivMode::Fast); }
+void Reciprocal_Batch(BenchState& s) { BatchReciprocal(s, DivMode::Robust); }
+void Reciprocal_BatchFast(BenchState& s) { BatchReciprocal(s, DivMode::Fast); }
+void Div_Split_Sse2(BenchState& s) { SplitDivide(s, SimdLevel::Sse2, false); }
+void Div_Split_Avx2(BenchState& s) { SplitDivide(s, SimdLevel::Avx2, false); }
+void Div_Split_Avx512(BenchState& s) { SplitDivide(s, SimdLevel::Avx512, false); }
+void Div_SplitFast_Avx512(BenchState& s) { SplitDivide(s, SimdLevel::Avx512, true); }
+
+} // namespace
+
+BENCHMARK(Div_InlineConj);
+BENCHMARK(Div_ScalarSmith);
+BENCHMARK(Div_ScalarFast);
+BENCHMARK(Div_Batch);
+BENCHMARK(Div_BatchFast);
+BENCHMARK(Reciprocal_Batch);
+BENCHMARK(Reciprocal_BatchFast);
+BENCHMARK(Div_Split_Sse2);
+BENCHMARK(Div_Split_Avx2);
+BENCHMARK(Div_Split_Avx512);
+BENCHMARK(Div_SplitFast_Avx512);
@@ -0,0 +1,130 @@
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../complexarray.h"
+#include "../complexbatch.h"
+#include "../simd.h"
+
+// Скалярное произведение и axpy: цепочка operator* + operator+= против
+// FusedMulAdd и пакетных ядер на FMA (быстрый и компенсированный режимы).
+
+namespace {
+
+const size_t kBlock = 4096;
+
+vector<Complex> RandomBlock(unsigned seed) {
+    vector<Complex> x(kBlock);
+    srand(seed);
+    for (Complex& z : x) {
+        z.Set(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+    }
+    return x;
+}
+
+void Dot_OperatorChain(BenchState& state) {
+    vector<Complex> x = RandomBlock(1), y = RandomBlock(2);
+    while (state.KeepRunning()) {
+        Complex acc;
+        for (size_t i = 0; i < kBlock; ++i) {
+            acc += x[i] * y[i];
+        }
+        DoNotOptimize(acc);
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetFlopsPerIteration(8.0 * kBlock);
+}
+
+void Dot_ScalarFma(BenchState& state) {
+    vector<Complex> x = RandomBlock(1), y = RandomBlock(2);
+    while (state.KeepRunning()) {
+        Complex acc;
+        for (size_t i = 0; i < kBlock; ++i) {
+            acc = FusedMulAdd(x[i], y[i], acc);
+        }
+        DoNotOptimize(acc);
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetFlopsPerIteration(8.0 * kBlock);
+}
+
+void BatchDot(BenchState& state, SumMode mode) {
+    vector<Complex> x = RandomBlock(1), y = RandomBlock(2);
+    while (state.KeepRunning()) {
+        DoNotOptimize(Dot(x.data(), y.data(), kBlock, mode));
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetFlopsPerIteration(8.0 * kBlock);
+}
+
+void SplitDot(BenchState& state, SimdLevel level, bool compensated) {
+    if (level > DetectSimdLevel()) {
+        state.Skip("процессор не поддерживает");
+        return;
+    }
+    vector<Complex> a = RandomBlock(1), b = RandomBlock(2);
+    ComplexArray x(a.data(), kBlock), y(b.data(), kBlock);
+    const SimdKernels& kernels = KernelsFor(level);
+    double out[2];
+    while (state.KeepRunning()) {
+        kernels.dot(x.Re(), x.Im(), y.Re(), y.Im(), kBlock, true, compensated, out);
+        DoNotOptimize(out[0]);
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetFlopsPerIteration(8.0 * kBlock);
+}
+
+void Axpy_OperatorChain(BenchState& state) {
+    vector<Complex> x = RandomBlock(1), y = RandomBlock(2);
+    Complex a(0.999, 0.001);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            y[i] += a * x[i];
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetFlopsPerIteration(8.0 * kBlock);
+}
+
+void Axpy_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock(1), y = RandomBlock(2);
+    Complex a(0.999, 0.001);
+    while (state.KeepRunning()) {
+        Axpy(a, x.data(), y.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetFlopsPerIteration(8.0 * kBlock);
+}
+
+void Axpy_Split(BenchState& state) {
+    vector<Complex> a = RandomBlock(1), b = RandomBlock(2);
+    ComplexArray x(a.data(), kBlock), y(b.data(), kBlock);
+    while (state.KeepRunning()) {
+        Axpy(Complex(0.999, 0.001), x, y);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetFlopsPerIteration(8.0 * kBlock);
+}
+
+void Dot_Batch(BenchState& s) { BatchDot(s, SumMode::Fast); }
+void Dot_BatchCompensated(BenchState& s) { BatchDot(s, SumMode::Compensated); }
+void DotConj_Split_Sse2(BenchState& s) { SplitDot(s, SimdLevel::Sse2, false); }
+void DotConj_Split_Avx2(BenchState& s) { SplitDot(s, SimdLevel::Avx2, false); }
+void DotConj_Split_Avx512(BenchState& s) { SplitDot(s, SimdLevel::Avx512, false); }
+void DotConj_SplitCompensated_Avx512(BenchState& s) { SplitDot(s, SimdLevel::Avx512, true); }
+
+} // namespace
+
+BENCHMARK(Dot_OperatorChain);
+BENCHMARK(Dot_ScalarFma);
+BENCHMARK(Dot_Batch);
+BENCHMARK(Dot_BatchCompensated);
+BENCHMARK(DotConj_Split_Sse2);
+BENCHMARK(DotConj_Split_Avx2);
+BENCHMARK(DotConj_Split_Avx512);
+BENCHMARK(DotConj_SplitCompensated_Avx512);
+BENCHMARK(Axpy_OperatorChain);
+BENCHMARK(Axpy_Batch);
+BENCHMARK(Axpy_Split);
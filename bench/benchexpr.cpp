@@ -0,0 +1,83 @@
+#include <vector>
+#include "bench.h"
+#include "../complexexpr.h"
+
+// y = a*b + c*d - e над ComplexArray: поэлементные ядра с промежуточными
+// массивами против ленивого выражения (один проход) и ручного цикла над
+// vector<Complex>. ГБ/с считаются по фактическому трафику: у ядер четыре
+// прохода по 3 массива (192 байта на элемент), у выражения 5 чтений и 1
+// запись (96 байт на элемент).
+
+namespace {
+
+const size_t kSmall = 4096;
+const size_t kLarge = 1 << 20;
+
+struct Operands {
+    ComplexArray a, b, c, d, e;
+
+    explicit Operands(size_t n) : a(n), b(n), c(n), d(n), e(n) {
+        for (size_t i = 0; i < n; ++i) {
+            a.Set(i, Complex(0.5, -0.25));
+            b.Set(i, Complex(0.8, 0.6));
+            c.Set(i, Complex(-1.0, 0.125));
+            d.Set(i, Complex(0.3, 0.7));
+            e.Set(i, Complex(0.01 * (i % 100), 1.0));
+        }
+    }
+};
+
+void Eager(BenchState& state, size_t n) {
+    Operands x(n);
+    ComplexArray t1(n), t2(n), y(n);
+    while (state.KeepRunning()) {
+        Mul(x.a, x.b, t1);
+        Mul(x.c, x.d, t2);
+        Add(t1, t2, y);
+        Sub(y, x.e, y);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(4.0 * 3 * 16 * n);
+}
+
+void Fused(BenchState& state, size_t n) {
+    Operands x(n);
+    ComplexArray y(n);
+    while (state.KeepRunning()) {
+        y = x.a * x.b + x.c * x.d - x.e;
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(6.0 * 16 * n);
+}
+
+// Тот же один проход, написанный вручную над чередующимися Complex.
+void HandLoop(BenchState& state, size_t n) {
+    vector<Complex> a(n, Complex(0.5, -0.25)), b(n, Complex(0.8, 0.6)), c(n, Complex(-1.0, 0.125));
+    vector<Complex> d(n, Complex(0.3, 0.7)), e(n, Complex(0.0, 1.0)), y(n);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < n; ++i) {
+            y[i] = a[i] * b[i] + c[i] * d[i] - e[i];
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(6.0 * 16 * n);
+}
+
+void Expr_Eager_4K(BenchState& s) { Eager(s, kSmall); }
+void Expr_Fused_4K(BenchState& s) { Fused(s, kSmall); }
+void Expr_HandLoop_4K(BenchState& s) { HandLoop(s, kSmall); }
+void Expr_Eager_1M(BenchState& s) { Eager(s, kLarge); }
+void Expr_Fused_1M(BenchState& s) { Fused(s, kLarge); }
+void Expr_HandLoop_1M(BenchState& s) { HandLoop(s, kLarge); }
+
+} // namespace
+
+BENCHMARK(Expr_Eager_4K);
+BENCHMARK(Expr_Fused_4K);
+BENCHMARK(Expr_HandLoop_4K);
+BENCHMARK(Expr_Eager_1M);
+BENCHMARK(Expr_Fused_1M);
+BENCHMARK(Expr_HandLoop_1M);
@@ -0,0 +1,70 @@
+#include <cmath>
+#include <vector>
+#include "bench.h"
+#include "../fft.h"
+
+// БПФ разных длин против прямого ДПФ. GFLOPS считаются по общепринятой
+// оценке 5 N log2 N операций (для ДПФ — фактические 8 N^2).
+
+namespace {
+
+vector<Complex> Signal(size_t n) {
+    vector<Complex> x(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i].Set(cos(0.1 * i), sin(0.37 * i));
+    }
+    return x;
+}
+
+void FftInPlace(BenchState& state, size_t n) {
+    shared_ptr<const FftPlan> plan = FftPlan::Get(n);
+    vector<Complex> x = Signal(n);
+    vector<Complex> scratch(plan->ScratchSize());
+    while (state.KeepRunning()) {
+        plan->Execute(x.data(), x.data(), FftDirection::Forward, scratch.data());
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetFlopsPerIteration(5.0 * n * log2(double(n)));
+}
+
+// Прямое ДПФ на Complex::operator* и operator+= с таблицей корней.
+void NaiveDft(BenchState& state, size_t n) {
+    vector<Complex> x = Signal(n), y(n), roots(n);
+    for (size_t k = 0; k < n; ++k) {
+        double angle = -2.0 * 3.14159265358979323846 * k / n;
+        roots[k].Set(cos(angle), sin(angle));
+    }
+    while (state.KeepRunning()) {
+        for (size_t k = 0; k < n; ++k) {
+            Complex acc;
+            for (size_t j = 0, idx = 0; j < n; ++j, idx = (idx + k) % n) {
+                acc += x[j] * roots[idx];
+            }
+            y[k] = acc;
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetFlopsPerIteration(5.0 * n * log2(double(n)));
+}
+
+void Fft_64(BenchState& s) { FftInPlace(s, 64); }
+void Fft_1024(BenchState& s) { FftInPlace(s, 1024); }
+void Fft_4096(BenchState& s) { FftInPlace(s, 4096); }
+void Fft_65536(BenchState& s) { FftInPlace(s, 65536); }
+void Fft_262144_FourStep(BenchState& s) { FftInPlace(s, 1 << 18); }
+void Fft_1000_Bluestein(BenchState& s) { FftInPlace(s, 1000); }
+void Dft_64_Naive(BenchState& s) { NaiveDft(s, 64); }
+void Dft_1024_Naive(BenchState& s) { NaiveDft(s, 1024); }
+
+} // namespace
+
+BENCHMARK(Fft_64);
+BENCHMARK(Dft_64_Naive);
+BENCHMARK(Fft_1024);
+BENCHMARK(Dft_1024_Naive);
+BENCHMARK(Fft_4096);
+BENCHMARK(Fft_65536);
+BENCHMARK(Fft_262144_FourStep);
+BENCHMARK(Fft_1000_Bluestein);
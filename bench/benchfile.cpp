@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <vector>
+#include "bench.h"
+#include "../complexfile.h"
+#include "../complexio.h"
+
+// Обмен массивом из 1M чисел через файл: двоичный формат (запись, открытие
+// без копирования, чтение с копированием) против текста. Открытие не
+// зависит от размера файла: данные подгружаются при обращении.
+
+namespace {
+
+const size_t kCount = 1 << 20;
+const char* kBinaryPath = "bench_complex.bin";
+const char* kTextPath = "bench_complex.txt";
+
+vector<Complex> Numbers() {
+    vector<Complex> x(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        x[i].Set(i * 0.001, 1.0 / (i + 1));
+    }
+    return x;
+}
+
+void File_WriteBinary(BenchState& state) {
+    vector<Complex> x = Numbers();
+    while (state.KeepRunning()) {
+        WriteComplexFile(kBinaryPath, x.data(), kCount);
+    }
+    remove(kBinaryPath);
+    state.SetItemsPerIteration(kCount);
+    state.SetBytesPerIteration(kCount * sizeof(Complex));
+}
+
+void File_OpenView(BenchState& state) {
+    vector<Complex> x = Numbers();
+    WriteComplexFile(kBinaryPath, x.data(), kCount);
+    while (state.KeepRunning()) {
+        ComplexFile file(kBinaryPath);
+        DoNotOptimize(file.View()[kCount / 2]);
+    }
+    remove(kBinaryPath);
+}
+
+void File_ReadBinary(BenchState& state) {
+    vector<Complex> x = Numbers();
+    WriteComplexFile(kBinaryPath, x.data(), kCount, ComplexLayout::Split);
+    while (state.KeepRunning()) {
+        ComplexArray a = ComplexFile(kBinaryPath).ToArray();
+        DoNotOptimize(a.Re());
+    }
+    remove(kBinaryPath);
+    state.SetItemsPerIteration(kCount);
+    state.SetBytesPerIteration(kCount * sizeof(Complex));
+}
+
+void File_ReadText(BenchState& state) {
+    vector<Complex> x = Numbers();
+    WriteComplexText(kTextPath, x.data(), kCount);
+    while (state.KeepRunning()) {
+        vector<Complex> y = ReadComplexText(kTextPath);
+        DoNotOptimize(y.data());
+    }
+    remove(kTextPath);
+    state.SetItemsPerIteration(kCount);
+    state.SetBytesPerIteration(kCount * sizeof(Complex));
+}
+
+} // namespace
+
+BENCHMARK(File_WriteBinary);
+BENCHMARK(File_OpenView);
+BENCHMARK(File_ReadBinary);
+BENCHMARK(File_ReadText);
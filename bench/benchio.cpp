@@ -0,0 +1,101 @@
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "../complexio.h"
+
+// Текстовый ввод-вывод: operator>> / operator<< через строковые потоки
+// против ParseComplexText / FormatComplex (from_chars / to_chars). Байты —
+// длина текста, так что колонка ГБ/с * 1000 даёт МБ/с. Поток печатает с
+// точностью 17 знаков, чтобы текст, как и у to_chars, читался обратно точно.
+
+namespace {
+
+const size_t kCount = 1 << 14;
+
+vector<Complex> RandomNumbers() {
+    vector<Complex> x(kCount);
+    srand(7);
+    for (Complex& z : x) {
+        z.Set((rand() - RAND_MAX / 2) / 997.0, (rand() - RAND_MAX / 2) / 1009.0);
+    }
+    return x;
+}
+
+string FormatText(ComplexTextFormat format) {
+    vector<Complex> x = RandomNumbers();
+    string text(kCount * kMaxComplexChars, '\0');
+    ComplexFormatResult r = FormatComplex(x.data(), kCount, &text[0], &text[0] + text.size(), format);
+    text.resize(r.ptr - text.data());
+    return text;
+}
+
+void Parse_Istream(BenchState& state) {
+    string text = FormatText(ComplexTextFormat::Pair);
+    vector<Complex> out(kCount);
+    while (state.KeepRunning()) {
+        istringstream input(text);
+        for (Complex& z : out) {
+            input >> z;
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kCount);
+    state.SetBytesPerIteration(text.size());
+}
+
+void ParseFromChars(BenchState& state, ComplexTextFormat format) {
+    string text = FormatText(format);
+    while (state.KeepRunning()) {
+        vector<Complex> out = ParseComplexText(text.data(), text.data() + text.size());
+        DoNotOptimize(out.data());
+    }
+    state.SetItemsPerIteration(kCount);
+    state.SetBytesPerIteration(text.size());
+}
+
+void Format_Ostream(BenchState& state) {
+    vector<Complex> x = RandomNumbers();
+    size_t bytes = 0;
+    while (state.KeepRunning()) {
+        ostringstream output;
+        output.precision(17);
+        for (const Complex& z : x) {
+            output << z << '\n';
+        }
+        bytes = output.str().size();
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kCount);
+    state.SetBytesPerIteration(bytes);
+}
+
+void FormatToChars(BenchState& state, ComplexTextFormat format) {
+    vector<Complex> x = RandomNumbers();
+    vector<char> buffer(kCount * kMaxComplexChars);
+    size_t bytes = 0;
+    while (state.KeepRunning()) {
+        ComplexFormatResult r = FormatComplex(x.data(), kCount, buffer.data(), buffer.data() + buffer.size(), format);
+        bytes = r.ptr - buffer.data();
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kCount);
+    state.SetBytesPerIteration(bytes);
+}
+
+void Parse_FromChars_Pair(BenchState& s) { ParseFromChars(s, ComplexTextFormat::Pair); }
+void Parse_FromChars_Algebraic(BenchState& s) { ParseFromChars(s, ComplexTextFormat::Algebraic); }
+void Parse_FromChars_Tuple(BenchState& s) { ParseFromChars(s, ComplexTextFormat::Tuple); }
+void Format_ToChars_Pair(BenchState& s) { FormatToChars(s, ComplexTextFormat::Pair); }
+void Format_ToChars_Algebraic(BenchState& s) { FormatToChars(s, ComplexTextFormat::Algebraic); }
+
+} // namespace
+
+BENCHMARK(Parse_Istream);
+BENCHMARK(Parse_FromChars_Pair);
+BENCHMARK(Parse_FromChars_Algebraic);
+BENCHMARK(Parse_FromChars_Tuple);
+BENCHMARK(Format_Ostream);
+BENCHMARK(Format_ToChars_Pair);
+BENCHMARK(Format_ToChars_Algebraic);
@@ -0,0 +1,217 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../complexarray.h"
+#include "../complexbatch.h"
+
+// Элементарные функции: поэлементные циклы через complexmath.h против
+// пакетных ядер в режимах Fast и Approx (нс/элемент). Главный случай —
+// поворот фазы (смеситель): z * e^(i * phase).
+
+namespace {
+
+const size_t kBlock = 4096;
+
+vector<Complex> RandomBlock() {
+    vector<Complex> x(kBlock);
+    srand(1);
+    for (Complex& z : x) {
+        z.Set(rand() / double(RAND_MAX) * 4 - 2, rand() / double(RAND_MAX) * 4 - 2);
+    }
+    return x;
+}
+
+vector<double> RandomPhase() {
+    vector<double> phase(kBlock);
+    srand(2);
+    for (double& p : phase) {
+        p = rand() / double(RAND_MAX) * 200 - 100;
+    }
+    return phase;
+}
+
+void Rotate_ScalarLoop(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> phase = RandomPhase();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = x[i] * Polar(1.0, phase[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Rotate_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> phase = RandomPhase();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        Rotate(x.data(), phase.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Rotate_BatchApprox(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> phase = RandomPhase();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        Rotate(x.data(), phase.data(), out.data(), kBlock, MathAccuracy::Approx);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Rotate_ArrayApprox(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> phase = RandomPhase();
+    ComplexArray a(x.data(), kBlock);
+    ComplexArray out(kBlock);
+    while (state.KeepRunning()) {
+        Rotate(a, phase.data(), out, MathAccuracy::Approx);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Polar_ScalarLoop(BenchState& state) {
+    vector<double> phase = RandomPhase();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = Polar(1.0, phase[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Polar_Batch(BenchState& state) {
+    vector<double> phase = RandomPhase();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        Polar(nullptr, phase.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Polar_BatchApprox(BenchState& state) {
+    vector<double> phase = RandomPhase();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        Polar(nullptr, phase.data(), out.data(), kBlock, MathAccuracy::Approx);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Exp_ScalarLoop(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = Exp(x[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Exp_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        Exp(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Log_ScalarLoop(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = Log(x[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Log_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        Log(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Arg_ScalarLoop(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = Arg(x[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Arg_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<double> out(kBlock);
+    while (state.KeepRunning()) {
+        Arg(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Sqrt_ScalarLoop(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = Sqrt(x[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Sqrt_Batch(BenchState& state) {
+    vector<Complex> x = RandomBlock();
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        Sqrt(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+} // namespace
+
+BENCHMARK(Rotate_ScalarLoop);
+BENCHMARK(Rotate_Batch);
+BENCHMARK(Rotate_BatchApprox);
+BENCHMARK(Rotate_ArrayApprox);
+BENCHMARK(Polar_ScalarLoop);
+BENCHMARK(Polar_Batch);
+BENCHMARK(Polar_BatchApprox);
+BENCHMARK(Exp_ScalarLoop);
+BENCHMARK(Exp_Batch);
+BENCHMARK(Log_ScalarLoop);
+BENCHMARK(Log_Batch);
+BENCHMARK(Arg_ScalarLoop);
+BENCHMARK(Arg_Batch);
+BENCHMARK(Sqrt_ScalarLoop);
+BENCHMARK(Sqrt_Batch);
@@ -0,0 +1,168 @@
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../matrix.h"
+
+// Произведения матриц, GFLOPS (8 операций на комплексное умножение со
+// сложением): тройной цикл на operator* и operator+= против блочного Gemm
+// (4M и 3M), Gemv и пакетных произведений 2x2, 4x4 и 8x8 (пакет — 1024
+// матрицы).
+
+namespace {
+
+const size_t kBatch = 1024;
+
+Complex RandomValue() {
+    return Complex(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+}
+
+ComplexMatrix RandomMatrix(size_t rows, size_t cols, unsigned seed) {
+    srand(seed);
+    ComplexMatrix m(rows, cols);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            m.Set(r, c, RandomValue());
+        }
+    }
+    return m;
+}
+
+vector<Complex> RandomBlock(size_t n, unsigned seed) {
+    srand(seed);
+    vector<Complex> x(n);
+    for (Complex& z : x) {
+        z = RandomValue();
+    }
+    return x;
+}
+
+/** Сегодняшний код: C(i, j) += A(i, p) * B(p, j) по строкам */
+void NaiveGemm(const Complex* a, const Complex* b, Complex* c, size_t m, size_t k, size_t n) {
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            Complex acc;
+            for (size_t p = 0; p < k; ++p) {
+                acc += a[i * k + p] * b[p * n + j];
+            }
+            c[i * n + j] = acc;
+        }
+    }
+}
+
+void Naive(BenchState& state, size_t size) {
+    ComplexMatrix a = RandomMatrix(size, size, 1), b = RandomMatrix(size, size, 2), c(size, size);
+    while (state.KeepRunning()) {
+        NaiveGemm(a.Data(), b.Data(), c.Data(), size, size, size);
+        ClobberMemory();
+    }
+    state.SetFlopsPerIteration(8.0 * size * size * size);
+}
+
+void Blocked(BenchState& state, size_t size, GemmMethod method) {
+    ComplexMatrix a = RandomMatrix(size, size, 1), b = RandomMatrix(size, size, 2), c(size, size);
+    while (state.KeepRunning()) {
+        Gemm(a, b, c, Complex(1.0), Complex(), method);
+        ClobberMemory();
+    }
+    state.SetFlopsPerIteration(8.0 * size * size * size);
+}
+
+void Matrix_Naive_64(BenchState& s) { Naive(s, 64); }
+void Matrix_Gemm4M_64(BenchState& s) { Blocked(s, 64, GemmMethod::FourM); }
+void Matrix_Gemm3M_64(BenchState& s) { Blocked(s, 64, GemmMethod::ThreeM); }
+void Matrix_Naive_256(BenchState& s) { Naive(s, 256); }
+void Matrix_Gemm4M_256(BenchState& s) { Blocked(s, 256, GemmMethod::FourM); }
+void Matrix_Gemm3M_256(BenchState& s) { Blocked(s, 256, GemmMethod::ThreeM); }
+void Matrix_Gemm4M_768(BenchState& s) { Blocked(s, 768, GemmMethod::FourM); }
+void Matrix_Gemm3M_768(BenchState& s) { Blocked(s, 768, GemmMethod::ThreeM); }
+
+void Matrix_GemvNaive_512(BenchState& state) {
+    const size_t n = 512;
+    ComplexMatrix a = RandomMatrix(n, n, 1);
+    vector<Complex> x = RandomBlock(n, 2), y(n);
+    while (state.KeepRunning()) {
+        NaiveGemm(a.Data(), x.data(), y.data(), n, n, 1);
+        ClobberMemory();
+    }
+    state.SetFlopsPerIteration(8.0 * n * n);
+}
+
+void Matrix_Gemv_512(BenchState& state) {
+    const size_t n = 512;
+    ComplexMatrix a = RandomMatrix(n, n, 1);
+    vector<Complex> x = RandomBlock(n, 2), y(n);
+    while (state.KeepRunning()) {
+        Gemv(a, x.data(), y.data());
+        ClobberMemory();
+    }
+    state.SetFlopsPerIteration(8.0 * n * n);
+}
+
+void BatchNaive(BenchState& state, size_t n) {
+    vector<Complex> a = RandomBlock(kBatch * n * n, 1), b = RandomBlock(kBatch * n * n, 2), c(kBatch * n * n);
+    while (state.KeepRunning()) {
+        for (size_t t = 0; t < kBatch; ++t) {
+            NaiveGemm(a.data() + t * n * n, b.data() + t * n * n, c.data() + t * n * n, n, n, n);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBatch);
+    state.SetFlopsPerIteration(8.0 * kBatch * n * n * n);
+}
+
+/** Те же матрицы подряд по строкам, через перекладку в пакетное хранение */
+void BatchArrays(BenchState& state, size_t n) {
+    vector<Complex> a = RandomBlock(kBatch * n * n, 1), b = RandomBlock(kBatch * n * n, 2), c(kBatch * n * n);
+    while (state.KeepRunning()) {
+        GemmBatch(a.data(), b.data(), c.data(), n, n, n, kBatch);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBatch);
+    state.SetFlopsPerIteration(8.0 * kBatch * n * n * n);
+}
+
+/** Матрицы сразу в пакетном хранении */
+void BatchPacked(BenchState& state, size_t n) {
+    vector<Complex> a = RandomBlock(kBatch * n * n, 1), b = RandomBlock(kBatch * n * n, 2);
+    ComplexMatrixBatch pa(kBatch, n, n), pb(kBatch, n, n), pc(kBatch, n, n);
+    pa.Assign(a.data());
+    pb.Assign(b.data());
+    while (state.KeepRunning()) {
+        GemmBatch(pa, pb, pc);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBatch);
+    state.SetFlopsPerIteration(8.0 * kBatch * n * n * n);
+}
+
+void Matrix_BatchNaive_2x2(BenchState& s) { BatchNaive(s, 2); }
+void Matrix_BatchArrays_2x2(BenchState& s) { BatchArrays(s, 2); }
+void Matrix_BatchPacked_2x2(BenchState& s) { BatchPacked(s, 2); }
+void Matrix_BatchNaive_4x4(BenchState& s) { BatchNaive(s, 4); }
+void Matrix_BatchArrays_4x4(BenchState& s) { BatchArrays(s, 4); }
+void Matrix_BatchPacked_4x4(BenchState& s) { BatchPacked(s, 4); }
+void Matrix_BatchNaive_8x8(BenchState& s) { BatchNaive(s, 8); }
+void Matrix_BatchArrays_8x8(BenchState& s) { BatchArrays(s, 8); }
+void Matrix_BatchPacked_8x8(BenchState& s) { BatchPacked(s, 8); }
+
+} // namespace
+
+BENCHMARK(Matrix_Naive_64);
+BENCHMARK(Matrix_Gemm4M_64);
+BENCHMARK(Matrix_Gemm3M_64);
+BENCHMARK(Matrix_Naive_256);
+BENCHMARK(Matrix_Gemm4M_256);
+BENCHMARK(Matrix_Gemm3M_256);
+BENCHMARK(Matrix_Gemm4M_768);
+BENCHMARK(Matrix_Gemm3M_768);
+BENCHMARK(Matrix_GemvNaive_512);
+BENCHMARK(Matrix_Gemv_512);
+BENCHMARK(Matrix_BatchNaive_2x2);
+BENCHMARK(Matrix_BatchArrays_2x2);
+BENCHMARK(Matrix_BatchPacked_2x2);
+BENCHMARK(Matrix_BatchNaive_4x4);
+BENCHMARK(Matrix_BatchArrays_4x4);
+BENCHMARK(Matrix_BatchPacked_4x4);
+BENCHMARK(Matrix_BatchNaive_8x8);
+BENCHMARK(Matrix_BatchArrays_8x8);
+BENCHMARK(Matrix_BatchPacked_8x8);
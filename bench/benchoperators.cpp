@@ -0,0 +1,194 @@
+#include <deque>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "../complexarray.h"
+#include "../mycomplex.h"
+
+// Каждый оператор Complex и поэлементные функции ComplexArray на трёх
+// размерах: 1K (данные в L1), 64K (L2/L3) и 1M (память). Имена замеров —
+// Op_<оператор>_<размер> и Array_<функция>_<размер>.
+
+namespace {
+
+const size_t kSizes[] = {1 << 10, 1 << 16, 1 << 20};
+const char* const kSizeNames[] = {"_1K", "_64K", "_1M"};
+
+// Операнды без переполнения и денормалов при многократном применении
+// составных операторов: у b модуль 1.
+vector<Complex> OperandA(size_t n) {
+    vector<Complex> a(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i].Set(1.0 + (i % 7) * 0.125, -0.5 + (i % 5) * 0.25);
+    }
+    return a;
+}
+
+vector<Complex> OperandB(size_t n) {
+    vector<Complex> b(n);
+    for (size_t i = 0; i < n; ++i) {
+        b[i] = i % 2 ? Complex(0.6, 0.8) : Complex(0.8, -0.6);
+    }
+    return b;
+}
+
+const double kReal = 1.25;
+const double kNearOne = 1.0000001;  // для *= и /= вещественного: модуль почти не меняется
+
+// c[i] = op(a[i], b[i])
+template <class Op>
+void Binary(BenchState& state, size_t n) {
+    vector<Complex> a = OperandA(n), b = OperandB(n), c(n);
+    Op op;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < n; ++i) {
+            c[i] = op(a[i], b[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(3.0 * n * sizeof(Complex));
+}
+
+// a[i] op= b[i]
+template <class Op>
+void Compound(BenchState& state, size_t n) {
+    vector<Complex> a = OperandA(n), b = OperandB(n);
+    Op op;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < n; ++i) {
+            op(a[i], b[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(3.0 * n * sizeof(Complex));
+}
+
+// out[i] = op(a[i]), результат вещественный
+template <class Op>
+void Reduce(BenchState& state, size_t n) {
+    vector<Complex> a = OperandA(n);
+    vector<double> out(n);
+    Op op;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = op(a[i]);
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(n * (sizeof(Complex) + sizeof(double)));
+}
+
+struct Add { Complex operator()(const Complex& a, const Complex& b) const { return a + b; } };
+struct Sub { Complex operator()(const Complex& a, const Complex& b) const { return a - b; } };
+struct Mul { Complex operator()(const Complex& a, const Complex& b) const { return a * b; } };
+struct Div { Complex operator()(const Complex& a, const Complex& b) const { return a / b; } };
+struct FastDivide { Complex operator()(const Complex& a, const Complex& b) const { return a.FastDivide(b); } };
+struct AddReal { Complex operator()(const Complex& a, const Complex&) const { return a + kReal; } };
+struct SubReal { Complex operator()(const Complex& a, const Complex&) const { return a - kReal; } };
+struct MulReal { Complex operator()(const Complex& a, const Complex&) const { return a * kReal; } };
+struct DivReal { Complex operator()(const Complex& a, const Complex&) const { return a / kReal; } };
+struct RealSub { Complex operator()(const Complex& a, const Complex&) const { return kReal - a; } };
+struct RealDiv { Complex operator()(const Complex& a, const Complex&) const { return kReal / a; } };
+struct Reciprocal { Complex operator()(const Complex& a, const Complex&) const { return a.Reciprocal(); } };
+struct FastReciprocal { Complex operator()(const Complex& a, const Complex&) const { return a.FastReciprocal(); } };
+struct AddAssign { void operator()(Complex& a, const Complex& b) const { a += b; } };
+struct SubAssign { void operator()(Complex& a, const Complex& b) const { a -= b; } };
+struct MulAssign { void operator()(Complex& a, const Complex& b) const { a *= b; } };
+struct DivAssign { void operator()(Complex& a, const Complex& b) const { a /= b; } };
+struct MulAssignReal { void operator()(Complex& a, const Complex&) const { a *= kNearOne; } };
+struct DivAssignReal { void operator()(Complex& a, const Complex&) const { a /= kNearOne; } };
+struct Abs { double operator()(const Complex& a) const { return a.Abs(); } };
+struct AbsSquared { double operator()(const Complex& a) const { return a.AbsSquared(); } };
+
+// Поэлементные функции ComplexArray.
+struct ArrayAdd { void operator()(const ComplexArray& a, const ComplexArray& b, ComplexArray& c) const { ::Add(a, b, c); } };
+struct ArraySub { void operator()(const ComplexArray& a, const ComplexArray& b, ComplexArray& c) const { ::Sub(a, b, c); } };
+struct ArrayMul { void operator()(const ComplexArray& a, const ComplexArray& b, ComplexArray& c) const { ::Mul(a, b, c); } };
+struct ArrayConjMul { void operator()(const ComplexArray& a, const ComplexArray& b, ComplexArray& c) const { ConjMul(a, b, c); } };
+struct ArrayDiv { void operator()(const ComplexArray& a, const ComplexArray& b, ComplexArray& c) const { ::Div(a, b, c); } };
+struct ArrayScale { void operator()(const ComplexArray& a, const ComplexArray&, ComplexArray& c) const { Scale(a, kReal, c); } };
+struct ArrayAxpy { void operator()(const ComplexArray& a, const ComplexArray&, ComplexArray& c) const { Axpy(Complex(0.5, 0.25), a, c); } };
+
+template <class Op>
+void Array(BenchState& state, size_t n) {
+    vector<Complex> init = OperandA(n), unit = OperandB(n);
+    ComplexArray a(init.data(), n), b(unit.data(), n), c(n);
+    Op op;
+    while (state.KeepRunning()) {
+        op(a, b, c);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(3.0 * n * sizeof(Complex));
+}
+
+void ArrayAbs(BenchState& state, size_t n) {
+    vector<Complex> init = OperandA(n);
+    ComplexArray a(init.data(), n);
+    vector<double> out(n);
+    while (state.KeepRunning()) {
+        ::Abs(a, out.data());
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetBytesPerIteration(n * (sizeof(Complex) + sizeof(double)));
+}
+
+/** Имена замеров живут до конца программы (реестр хранит указатели) */
+const char* Name(const string& name) {
+    static deque<string> names;
+    names.push_back(name);
+    return names.back().c_str();
+}
+
+template <void (*Fn)(BenchState&, size_t), size_t kSize>
+void Sized(BenchState& state) {
+    Fn(state, kSizes[kSize]);
+}
+
+template <void (*Fn)(BenchState&, size_t)>
+void RegisterSizes(const char* name) {
+    RegisterBenchmark(Name(string(name) + kSizeNames[0]), Sized<Fn, 0>);
+    RegisterBenchmark(Name(string(name) + kSizeNames[1]), Sized<Fn, 1>);
+    RegisterBenchmark(Name(string(name) + kSizeNames[2]), Sized<Fn, 2>);
+}
+
+bool RegisterOperators() {
+    RegisterSizes<Binary<Add>>("Op_Add");
+    RegisterSizes<Binary<Sub>>("Op_Sub");
+    RegisterSizes<Binary<Mul>>("Op_Mul");
+    RegisterSizes<Binary<Div>>("Op_Div");
+    RegisterSizes<Binary<FastDivide>>("Op_FastDivide");
+    RegisterSizes<Binary<AddReal>>("Op_AddReal");
+    RegisterSizes<Binary<SubReal>>("Op_SubReal");
+    RegisterSizes<Binary<MulReal>>("Op_MulReal");
+    RegisterSizes<Binary<DivReal>>("Op_DivReal");
+    RegisterSizes<Binary<RealSub>>("Op_RealSub");
+    RegisterSizes<Binary<RealDiv>>("Op_RealDiv");
+    RegisterSizes<Binary<Reciprocal>>("Op_Reciprocal");
+    RegisterSizes<Binary<FastReciprocal>>("Op_FastReciprocal");
+    RegisterSizes<Compound<AddAssign>>("Op_AddAssign");
+    RegisterSizes<Compound<SubAssign>>("Op_SubAssign");
+    RegisterSizes<Compound<MulAssign>>("Op_MulAssign");
+    RegisterSizes<Compound<DivAssign>>("Op_DivAssign");
+    RegisterSizes<Compound<MulAssignReal>>("Op_MulAssignReal");
+    RegisterSizes<Compound<DivAssignReal>>("Op_DivAssignReal");
+    RegisterSizes<Reduce<Abs>>("Op_Abs");
+    RegisterSizes<Reduce<AbsSquared>>("Op_AbsSquared");
+    RegisterSizes<Array<ArrayAdd>>("Array_Add");
+    RegisterSizes<Array<ArraySub>>("Array_Sub");
+    RegisterSizes<Array<ArrayMul>>("Array_Mul");
+    RegisterSizes<Array<ArrayConjMul>>("Array_ConjMul");
+    RegisterSizes<Array<ArrayDiv>>("Array_Div");
+    RegisterSizes<Array<ArrayScale>>("Array_Scale");
+    RegisterSizes<Array<ArrayAxpy>>("Array_Axpy");
+    RegisterSizes<ArrayAbs>("Array_Abs");
+    return true;
+}
+
+const bool registered = RegisterOperators();
+
+} // namespace
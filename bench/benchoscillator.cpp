@@ -0,0 +1,103 @@
+#include <cmath>
+#include <vector>
+#include "bench.h"
+#include "../complexarray.h"
+#include "../oscillator.h"
+
+// Генерация несущей e^(i * w * n): sin/cos на каждый отсчёт против
+// Oscillator (по отсчёту и блоком) и смеситель на его основе (нс/отсчёт).
+
+namespace {
+
+const size_t kBlock = 4096;
+const double kFrequency = 0.0123;
+
+void Carrier_SinCos(BenchState& state) {
+    vector<Complex> out(kBlock);
+    size_t n = 0;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i, ++n) {
+            double x = kFrequency * n;
+            out[i] = Complex(cos(x), sin(x));
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Carrier_Next(BenchState& state) {
+    Oscillator osc(kFrequency);
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            out[i] = osc.Next();
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Carrier_Generate(BenchState& state) {
+    Oscillator osc(kFrequency);
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        osc.Generate(out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetBytesPerIteration(kBlock * sizeof(Complex));
+}
+
+void Carrier_GenerateArray(BenchState& state) {
+    Oscillator osc(kFrequency);
+    ComplexArray out(kBlock);
+    while (state.KeepRunning()) {
+        osc.Generate(out);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+    state.SetBytesPerIteration(kBlock * sizeof(Complex));
+}
+
+void Carrier_Mix(BenchState& state) {
+    Oscillator osc(kFrequency);
+    vector<Complex> x(kBlock, Complex(0.5, -0.25));
+    vector<Complex> out(kBlock);
+    while (state.KeepRunning()) {
+        osc.Mix(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Carrier_MixArray(BenchState& state) {
+    Oscillator osc(kFrequency);
+    vector<Complex> x(kBlock, Complex(0.5, -0.25));
+    ComplexArray a(x.data(), kBlock);
+    ComplexArray out(kBlock);
+    while (state.KeepRunning()) {
+        osc.Mix(a, out);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Carrier_Retune(BenchState& state) {
+    Oscillator osc(kFrequency);
+    double frequency = kFrequency;
+    while (state.KeepRunning()) {
+        frequency = -frequency;
+        osc.SetFrequency(frequency);
+        DoNotOptimize(osc.Next());
+    }
+}
+
+} // namespace
+
+BENCHMARK(Carrier_SinCos);
+BENCHMARK(Carrier_Next);
+BENCHMARK(Carrier_Generate);
+BENCHMARK(Carrier_GenerateArray);
+BENCHMARK(Carrier_Mix);
+BENCHMARK(Carrier_MixArray);
+BENCHMARK(Carrier_Retune);
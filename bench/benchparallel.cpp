@@ -0,0 +1,95 @@
+#include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "../parallel.h"
+
+// Масштабирование по числу потоков: пакетное БПФ и поэлементное умножение
+// на пулах из 1, 2, 4, 8 и 16 потоков. Замеры с числом потоков больше числа
+// ядер пропускаются.
+
+namespace {
+
+// Пулы создаются один раз на всё время работы замеров.
+ThreadPool* PoolOf(size_t threads) {
+    static map<size_t, unique_ptr<ThreadPool>> pools;
+    unique_ptr<ThreadPool>& pool = pools[threads];
+    if (!pool) {
+        pool.reset(new ThreadPool(threads - 1));
+    }
+    return pool.get();
+}
+
+bool SkipIfTooMany(BenchState& state, size_t threads) {
+    if (threads > 1 && threads > thread::hardware_concurrency()) {
+        state.Skip("потоков больше, чем ядер");
+        return true;
+    }
+    return false;
+}
+
+// 256 преобразований длины 4096 (16 МБ).
+void FftBatchThreads(BenchState& state, size_t threads) {
+    if (SkipIfTooMany(state, threads)) {
+        return;
+    }
+    const size_t n = 4096, count = 256;
+    shared_ptr<const FftPlan> plan = FftPlan::Get(n);
+    vector<Complex> x(n * count);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i].Set(cos(0.1 * i), sin(0.37 * i));
+    }
+    ThreadPool& pool = *PoolOf(threads);
+    while (state.KeepRunning()) {
+        FftBatch(*plan, x.data(), count, FftDirection::Forward, pool);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n * count);
+    state.SetFlopsPerIteration(5.0 * n * log2(double(n)) * count);
+}
+
+// Поэлементное умножение 4М элементов (три массива по 64 МБ, упор в память).
+void MulThreads(BenchState& state, size_t threads) {
+    if (SkipIfTooMany(state, threads)) {
+        return;
+    }
+    const size_t n = size_t(1) << 22;
+    ComplexArray a(n), b(n), c(n);
+    for (size_t i = 0; i < n; ++i) {
+        a.Set(i, Complex(1.0 + i, 0.5));
+        b.Set(i, Complex(0.25, 1.0 - i));
+    }
+    ThreadPool& pool = *PoolOf(threads);
+    while (state.KeepRunning()) {
+        Mul(a, b, c, pool);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(n);
+    state.SetFlopsPerIteration(6.0 * n);
+}
+
+void FftBatch_4096x256_Threads1(BenchState& s) { FftBatchThreads(s, 1); }
+void FftBatch_4096x256_Threads2(BenchState& s) { FftBatchThreads(s, 2); }
+void FftBatch_4096x256_Threads4(BenchState& s) { FftBatchThreads(s, 4); }
+void FftBatch_4096x256_Threads8(BenchState& s) { FftBatchThreads(s, 8); }
+void FftBatch_4096x256_Threads16(BenchState& s) { FftBatchThreads(s, 16); }
+void ParallelMul_4M_Threads1(BenchState& s) { MulThreads(s, 1); }
+void ParallelMul_4M_Threads2(BenchState& s) { MulThreads(s, 2); }
+void ParallelMul_4M_Threads4(BenchState& s) { MulThreads(s, 4); }
+void ParallelMul_4M_Threads8(BenchState& s) { MulThreads(s, 8); }
+void ParallelMul_4M_Threads16(BenchState& s) { MulThreads(s, 16); }
+
+} // namespace
+
+BENCHMARK(FftBatch_4096x256_Threads1);
+BENCHMARK(FftBatch_4096x256_Threads2);
+BENCHMARK(FftBatch_4096x256_Threads4);
+BENCHMARK(FftBatch_4096x256_Threads8);
+BENCHMARK(FftBatch_4096x256_Threads16);
+BENCHMARK(ParallelMul_4M_Threads1);
+BENCHMARK(ParallelMul_4M_Threads2);
+BENCHMARK(ParallelMul_4M_Threads4);
+BENCHMARK(ParallelMul_4M_Threads8);
+BENCHMARK(ParallelMul_4M_Threads16);
@@ -0,0 +1,133 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../complexbatch.h"
+#include "../complexmath.h"
+#include "../phase.h"
+
+// Фаза сигнала на блоке 4096 отсчётов: сегодняшние циклы на Abs() и atan2
+// против ToPolar (Fast и Approx), развёртка фазы скалярным циклом против
+// PhaseUnwrapper, частотный дискриминатор через Arg(z * conj(prev)) по
+// отсчёту против FmDiscriminator.
+
+namespace {
+
+const size_t kBlock = 4096;
+const double kPi = 3.14159265358979323846;
+
+vector<Complex> RandomSignal(unsigned seed) {
+    srand(seed);
+    vector<Complex> x(kBlock);
+    double phase = 0;
+    for (Complex& z : x) {
+        phase += (rand() / double(RAND_MAX) - 0.5) * 1.8 * kPi;
+        z = Polar(0.5 + rand() / double(RAND_MAX), phase);
+    }
+    return x;
+}
+
+void Phase_OperatorToPolar(BenchState& state) {
+    vector<Complex> x = RandomSignal(1);
+    vector<double> r(kBlock), theta(kBlock);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            r[i] = x[i].Abs();
+            theta[i] = atan2(x[i].Im(), x[i].Re());
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void BatchToPolar(BenchState& state, MathAccuracy accuracy) {
+    vector<Complex> x = RandomSignal(1);
+    vector<double> r(kBlock), theta(kBlock);
+    while (state.KeepRunning()) {
+        ToPolar(x.data(), r.data(), theta.data(), kBlock, accuracy);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+vector<double> WrappedPhase() {
+    vector<Complex> x = RandomSignal(1);
+    vector<double> theta(kBlock);
+    Arg(x.data(), theta.data(), kBlock);
+    return theta;
+}
+
+/** Сегодняшняя развёртка: сравнение с pi и накопление сдвига по отсчёту */
+void Phase_ScalarUnwrap(BenchState& state) {
+    vector<double> theta = WrappedPhase(), out(kBlock);
+    double last = theta[0], offset = 0;
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            double d = theta[i] - last;
+            while (d > kPi) {
+                d -= 2 * kPi;
+                offset -= 2 * kPi;
+            }
+            while (d < -kPi) {
+                d += 2 * kPi;
+                offset += 2 * kPi;
+            }
+            last = theta[i];
+            out[i] = theta[i] + offset;
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Phase_Unwrap(BenchState& state) {
+    vector<double> theta = WrappedPhase(), out(kBlock);
+    PhaseUnwrapper unwrapper;
+    while (state.KeepRunning()) {
+        unwrapper.Process(theta.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Phase_OperatorDiscriminator(BenchState& state) {
+    vector<Complex> x = RandomSignal(1);
+    vector<double> out(kBlock);
+    Complex previous(1, 0);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kBlock; ++i) {
+            Complex conj(previous.Re(), -previous.Im());
+            out[i] = Arg(x[i] * conj);
+            previous = x[i];
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Discriminator(BenchState& state, MathAccuracy accuracy) {
+    vector<Complex> x = RandomSignal(1);
+    vector<double> out(kBlock);
+    FmDiscriminator discriminator(1, accuracy);
+    while (state.KeepRunning()) {
+        discriminator.Process(x.data(), out.data(), kBlock);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kBlock);
+}
+
+void Phase_ToPolar_Fast(BenchState& s) { BatchToPolar(s, MathAccuracy::Fast); }
+void Phase_ToPolar_Approx(BenchState& s) { BatchToPolar(s, MathAccuracy::Approx); }
+void Phase_Discriminator_Fast(BenchState& s) { Discriminator(s, MathAccuracy::Fast); }
+void Phase_Discriminator_Approx(BenchState& s) { Discriminator(s, MathAccuracy::Approx); }
+
+} // namespace
+
+BENCHMARK(Phase_OperatorToPolar);
+BENCHMARK(Phase_ToPolar_Fast);
+BENCHMARK(Phase_ToPolar_Approx);
+BENCHMARK(Phase_ScalarUnwrap);
+BENCHMARK(Phase_Unwrap);
+BENCHMARK(Phase_OperatorDiscriminator);
+BENCHMARK(Phase_Discriminator_Fast);
+BENCHMARK(Phase_Discriminator_Approx);
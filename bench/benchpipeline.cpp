@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "../oscillator.h"
+#include "../pipeline.h"
+
+// Цепочка смеситель -> КИХ-фильтр (64 отвода) -> дециматор (48 отводов, в 8
+// раз) над сигналом в 2M отсчётов (32 МБ, больше кэша): каждая ступень над
+// всем массивом по очереди против конвейера блоками по 4096 отсчётов, в
+// одном потоке и в поточном режиме (нс на входной отсчёт).
+
+namespace {
+
+const size_t kSamples = size_t(1) << 21;
+const size_t kTaps = 64;
+const size_t kLowpass = 48;
+const size_t kFactor = 8;
+
+struct Signal {
+    vector<Complex> x, taps;
+    vector<double> lowpass;
+
+    Signal() : x(kSamples), taps(kTaps), lowpass(kLowpass) {
+        for (size_t i = 0; i < kSamples; ++i) {
+            x[i] = Complex(double(i % 17) - 8, double(i % 5) - 2);
+        }
+        for (size_t j = 0; j < kTaps; ++j) {
+            taps[j] = Complex(1.0 / (j + 1), 0.5 / (j + 2));
+        }
+        for (size_t j = 0; j < kLowpass; ++j) {
+            lowpass[j] = 1.0 / kLowpass;
+        }
+    }
+};
+
+const Signal& GetSignal() {
+    static Signal signal;
+    return signal;
+}
+
+void Build(Pipeline& pipeline, const Signal& s) {
+    pipeline.Emplace<Mixer>(0.2);
+    pipeline.Emplace<FirFilter>(s.taps.data(), kTaps);
+    pipeline.Emplace<Decimator>(s.lowpass.data(), kLowpass, kFactor);
+}
+
+/** Каждая ступень над всем сигналом: промежуточные массивы уходят из кэша */
+void Pipeline_Materialized(BenchState& state) {
+    const Signal& s = GetSignal();
+    Mixer mixer(0.2);
+    FirFilter fir(s.taps.data(), kTaps);
+    Decimator decimator(s.lowpass.data(), kLowpass, kFactor);
+    vector<Complex> mixed(kSamples), filtered(fir.MaxOutput(kSamples)), out(kSamples / kFactor + 1);
+    while (state.KeepRunning()) {
+        mixer.Process(s.x.data(), kSamples, mixed.data());
+        size_t m = fir.Process(mixed.data(), kSamples, filtered.data());
+        DoNotOptimize(decimator.Process(filtered.data(), m, out.data()));
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kSamples);
+}
+
+void Pipeline_Streaming(BenchState& state) {
+    const Signal& s = GetSignal();
+    Pipeline pipeline;
+    Build(pipeline, s);
+    Complex last;
+    while (state.KeepRunning()) {
+        pipeline.Push(s.x.data(), kSamples, [&](const Complex* y, size_t m) { last = y[m - 1]; });
+        DoNotOptimize(last);
+    }
+    state.SetItemsPerIteration(kSamples);
+}
+
+/** Три потока ступеней (на ядрах 1..3) и источник в текущем потоке */
+void Pipeline_Threaded(BenchState& state) {
+    if (thread::hardware_concurrency() < 4) {
+        state.Skip("меньше 4 ядер");
+        return;
+    }
+    const Signal& s = GetSignal();
+    Pipeline pipeline;
+    Build(pipeline, s);
+    PipelineThreads threads;
+    threads.cpus = {1, 2, 3};
+    Complex last;
+    while (state.KeepRunning()) {
+        size_t pos = 0;
+        pipeline.Run([&](Complex* dst, size_t n) {
+            size_t m = min(n, kSamples - pos);
+            copy(s.x.begin() + pos, s.x.begin() + pos + m, dst);
+            pos += m;
+            return m;
+        }, [&](const Complex* y, size_t m) { last = y[m - 1]; }, threads);
+        DoNotOptimize(last);
+    }
+    state.SetItemsPerIteration(kSamples);
+}
+
+} // namespace
+
+BENCHMARK(Pipeline_Materialized);
+BENCHMARK(Pipeline_Streaming);
+BENCHMARK(Pipeline_Threaded);
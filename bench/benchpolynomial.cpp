@@ -0,0 +1,106 @@
+#include <cstdlib>
+#include <vector>
+#include "bench.h"
+#include "../polynomial.h"
+#include "../threadpool.h"
+
+// Многочлены: значения в 4096 точках — цикл Горнера на operator* и
+// operator+ против пакетного Горнера и схемы Эстрина (степени 16 и 256);
+// произведение прямо и через БПФ (по ним выбран kPolyFftThreshold: на 64
+// они наравне); все корни методом Аберта — Эрлиха (степени 100 и 500).
+
+namespace {
+
+const size_t kPoints = 4096;
+
+vector<Complex> RandomBlock(size_t n, unsigned seed) {
+    srand(seed);
+    vector<Complex> x(n);
+    for (Complex& z : x) {
+        z = Complex(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+    }
+    return x;
+}
+
+/** Сегодняшний код: Горнер на Complex по одной точке */
+void Naive(BenchState& state, size_t count) {
+    vector<Complex> c = RandomBlock(count, 1), z = RandomBlock(kPoints, 2), out(kPoints);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < kPoints; ++i) {
+            Complex r = c[count - 1];
+            for (size_t k = count - 1; k-- > 0;) {
+                r = r * z[i] + c[k];
+            }
+            out[i] = r;
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kPoints);
+    state.SetFlopsPerIteration(8.0 * kPoints * (count - 1));
+}
+
+void Batch(BenchState& state, size_t count, PolyScheme scheme) {
+    vector<Complex> c = RandomBlock(count, 1), z = RandomBlock(kPoints, 2), out(kPoints);
+    while (state.KeepRunning()) {
+        EvaluatePolynomial(c.data(), count, z.data(), out.data(), kPoints, scheme);
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(kPoints);
+    state.SetFlopsPerIteration(8.0 * kPoints * (count - 1));
+}
+
+void Multiply(BenchState& state, size_t n, PolyMultiplyMethod method) {
+    vector<Complex> a = RandomBlock(n, 1), b = RandomBlock(n, 2);
+    while (state.KeepRunning()) {
+        vector<Complex> c = MultiplyPolynomials(a.data(), n, b.data(), n, method);
+        DoNotOptimize(c.data());
+    }
+    state.SetItemsPerIteration(2 * n - 1);
+}
+
+void Roots(BenchState& state, size_t degree) {
+    vector<Complex> c = RandomBlock(degree + 1, 3);
+    while (state.KeepRunning()) {
+        RootResult result = FindRoots(c.data(), c.size());
+        DoNotOptimize(result.roots.data());
+    }
+    state.SetItemsPerIteration(degree);
+}
+
+void Poly_Naive_16(BenchState& s) { Naive(s, 16); }
+void Poly_Horner_16(BenchState& s) { Batch(s, 16, PolyScheme::Horner); }
+void Poly_Estrin_16(BenchState& s) { Batch(s, 16, PolyScheme::Estrin); }
+void Poly_Naive_256(BenchState& s) { Naive(s, 256); }
+void Poly_Horner_256(BenchState& s) { Batch(s, 256, PolyScheme::Horner); }
+void Poly_Estrin_256(BenchState& s) { Batch(s, 256, PolyScheme::Estrin); }
+void Poly_MultiplyDirect_16(BenchState& s) { Multiply(s, 16, PolyMultiplyMethod::Direct); }
+void Poly_MultiplyFft_16(BenchState& s) { Multiply(s, 16, PolyMultiplyMethod::Fft); }
+void Poly_MultiplyDirect_64(BenchState& s) { Multiply(s, 64, PolyMultiplyMethod::Direct); }
+void Poly_MultiplyFft_64(BenchState& s) { Multiply(s, 64, PolyMultiplyMethod::Fft); }
+void Poly_MultiplyDirect_128(BenchState& s) { Multiply(s, 128, PolyMultiplyMethod::Direct); }
+void Poly_MultiplyFft_128(BenchState& s) { Multiply(s, 128, PolyMultiplyMethod::Fft); }
+void Poly_MultiplyDirect_1024(BenchState& s) { Multiply(s, 1024, PolyMultiplyMethod::Direct); }
+void Poly_MultiplyFft_1024(BenchState& s) { Multiply(s, 1024, PolyMultiplyMethod::Fft); }
+void Poly_MultiplyFft_8192(BenchState& s) { Multiply(s, 8192, PolyMultiplyMethod::Fft); }
+void Poly_Roots_100(BenchState& s) { Roots(s, 100); }
+void Poly_Roots_500(BenchState& s) { Roots(s, 500); }
+
+} // namespace
+
+BENCHMARK(Poly_Naive_16);
+BENCHMARK(Poly_Horner_16);
+BENCHMARK(Poly_Estrin_16);
+BENCHMARK(Poly_Naive_256);
+BENCHMARK(Poly_Horner_256);
+BENCHMARK(Poly_Estrin_256);
+BENCHMARK(Poly_MultiplyDirect_16);
+BENCHMARK(Poly_MultiplyFft_16);
+BENCHMARK(Poly_MultiplyDirect_64);
+BENCHMARK(Poly_MultiplyFft_64);
+BENCHMARK(Poly_MultiplyDirect_128);
+BENCHMARK(Poly_MultiplyFft_128);
+BENCHMARK(Poly_MultiplyDirect_1024);
+BENCHMARK(Poly_MultiplyFft_1024);
+BENCHMARK(Poly_MultiplyFft_8192);
+BENCHMARK(Poly_Roots_100);
+BENCHMARK(Poly_Roots_500);
@@ -0,0 +1,145 @@
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "../reductions.h"
+
+// Редукции над 65536 элементами (1 МБ, в L2): сегодняшние циклы на
+// operator+= и Abs() против блочных векторных ядер; сумма 4М элементов на
+// пулах из 1, 4 и 16 потоков (результат одинаков бит в бит).
+
+namespace {
+
+const size_t kLength = 65536;
+const size_t kLarge = size_t(1) << 22;
+
+vector<Complex> RandomBlock(size_t n, unsigned seed) {
+    srand(seed);
+    vector<Complex> x(n);
+    for (Complex& z : x) {
+        z = Complex(rand() / double(RAND_MAX) - 0.5, rand() / double(RAND_MAX) - 0.5);
+    }
+    return x;
+}
+
+// Пулы создаются один раз на всё время работы замеров.
+ThreadPool* PoolOf(size_t threads) {
+    static map<size_t, unique_ptr<ThreadPool>> pools;
+    unique_ptr<ThreadPool>& pool = pools[threads];
+    if (!pool) {
+        pool.reset(new ThreadPool(threads - 1));
+    }
+    return pool.get();
+}
+
+void Reduce_OperatorSum(BenchState& state) {
+    vector<Complex> x = RandomBlock(kLength, 1);
+    while (state.KeepRunning()) {
+        Complex acc;
+        for (const Complex& z : x) {
+            acc += z;
+        }
+        DoNotOptimize(acc);
+    }
+    state.SetItemsPerIteration(kLength);
+}
+
+void BatchSum(BenchState& state, SumMode mode) {
+    vector<Complex> x = RandomBlock(kLength, 1);
+    while (state.KeepRunning()) {
+        DoNotOptimize(Sum(x.data(), kLength, mode));
+    }
+    state.SetItemsPerIteration(kLength);
+}
+
+void Reduce_OperatorEnergy(BenchState& state) {
+    vector<Complex> x = RandomBlock(kLength, 1);
+    while (state.KeepRunning()) {
+        double acc = 0;
+        for (const Complex& z : x) {
+            acc += z.AbsSquared();
+        }
+        DoNotOptimize(acc);
+    }
+    state.SetItemsPerIteration(kLength);
+}
+
+void BatchEnergy(BenchState& state, SumMode mode) {
+    vector<Complex> x = RandomBlock(kLength, 1);
+    while (state.KeepRunning()) {
+        DoNotOptimize(SumAbsSquared(x.data(), kLength, mode));
+    }
+    state.SetItemsPerIteration(kLength);
+}
+
+void Reduce_Variance(BenchState& state) {
+    vector<Complex> x = RandomBlock(kLength, 1);
+    while (state.KeepRunning()) {
+        DoNotOptimize(Variance(x.data(), kLength));
+    }
+    state.SetItemsPerIteration(kLength);
+}
+
+/** Сегодняшний поиск пика: корень на каждый элемент */
+void Reduce_OperatorPeak(BenchState& state) {
+    vector<Complex> x = RandomBlock(kLength, 1);
+    while (state.KeepRunning()) {
+        size_t peak = 0;
+        double best = -1;
+        for (size_t i = 0; i < kLength; ++i) {
+            double r = x[i].Abs();
+            if (r > best) {
+                best = r;
+                peak = i;
+            }
+        }
+        DoNotOptimize(peak);
+    }
+    state.SetItemsPerIteration(kLength);
+}
+
+void Reduce_MaxMagnitude(BenchState& state) {
+    vector<Complex> x = RandomBlock(kLength, 1);
+    while (state.KeepRunning()) {
+        DoNotOptimize(MaxMagnitude(x.data(), kLength).index);
+    }
+    state.SetItemsPerIteration(kLength);
+}
+
+void SumThreads(BenchState& state, size_t threads) {
+    if (threads > 1 && threads > thread::hardware_concurrency()) {
+        state.Skip("потоков больше, чем ядер");
+        return;
+    }
+    vector<Complex> x = RandomBlock(kLarge, 1);
+    ThreadPool& pool = *PoolOf(threads);
+    while (state.KeepRunning()) {
+        DoNotOptimize(Sum(x.data(), kLarge, SumMode::Fast, pool));
+    }
+    state.SetItemsPerIteration(kLarge);
+}
+
+void Reduce_Sum(BenchState& s) { BatchSum(s, SumMode::Fast); }
+void Reduce_SumCompensated(BenchState& s) { BatchSum(s, SumMode::Compensated); }
+void Reduce_Energy(BenchState& s) { BatchEnergy(s, SumMode::Fast); }
+void Reduce_EnergyCompensated(BenchState& s) { BatchEnergy(s, SumMode::Compensated); }
+void Reduce_Sum_4M_Threads1(BenchState& s) { SumThreads(s, 1); }
+void Reduce_Sum_4M_Threads4(BenchState& s) { SumThreads(s, 4); }
+void Reduce_Sum_4M_Threads16(BenchState& s) { SumThreads(s, 16); }
+
+} // namespace
+
+BENCHMARK(Reduce_OperatorSum);
+BENCHMARK(Reduce_Sum);
+BENCHMARK(Reduce_SumCompensated);
+BENCHMARK(Reduce_OperatorEnergy);
+BENCHMARK(Reduce_Energy);
+BENCHMARK(Reduce_EnergyCompensated);
+BENCHMARK(Reduce_Variance);
+BENCHMARK(Reduce_OperatorPeak);
+BENCHMARK(Reduce_MaxMagnitude);
+BENCHMARK(Reduce_Sum_4M_Threads1);
+BENCHMARK(Reduce_Sum_4M_Threads4);
+BENCHMARK(Reduce_Sum_4M_Threads16);
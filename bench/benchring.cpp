@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "../ringbuffer.h"
+
+// Передача блоков по 256 отсчётов из потока захвата в поток обработки:
+// deque под мьютексом с condition_variable против SpscRing и MpmcBlockRing
+// (активное ожидание и futex). Итерация — 4096 блоков; кроме нс/блок
+// выводятся медиана и 99-й перцентиль задержки передачи (от публикации
+// писателем до получения читателем), нс.
+
+namespace {
+
+const size_t kBlock = 256;
+const size_t kBlocks = 4096;
+const size_t kSlots = 16;
+
+using Clock = chrono::steady_clock;
+
+/** Метка времени в первом отсчёте блока */
+void Stamp(Complex* block) {
+    block[0] = Complex(double(chrono::duration_cast<chrono::nanoseconds>(Clock::now().time_since_epoch()).count()));
+}
+
+double Elapsed(const Complex* block) {
+    return double(chrono::duration_cast<chrono::nanoseconds>(Clock::now().time_since_epoch()).count()) - block[0].Re();
+}
+
+void Fill(Complex* block, size_t i) {
+    for (size_t k = 1; k < kBlock; ++k) {
+        block[k] = Complex(double(i), double(k));
+    }
+}
+
+/** Перцентили задержки последнего прогона */
+void Report(BenchState& state, vector<double>& latencies) {
+    if (latencies.empty()) {
+        return;
+    }
+    size_t p50 = latencies.size() / 2, p99 = latencies.size() * 99 / 100;
+    nth_element(latencies.begin(), latencies.begin() + p50, latencies.end());
+    state.SetCounter("p50_ns", latencies[p50]);
+    nth_element(latencies.begin(), latencies.begin() + p99, latencies.end());
+    state.SetCounter("p99_ns", latencies[p99]);
+}
+
+bool NeedCores(BenchState& state, unsigned cores) {
+    if (thread::hardware_concurrency() < cores) {
+        state.Skip(cores == 2 ? "меньше 2 ядер" : "меньше 4 ядер");
+        return false;
+    }
+    return true;
+}
+
+/** Ограниченная очередь блоков под мьютексом (блоки переиспользуются) */
+class MutexQueue {
+private:
+    deque<vector<Complex>> ready_, free_;
+    mutex lock_;
+    condition_variable notEmpty_, notFull_;
+
+public:
+    MutexQueue() {
+        for (size_t i = 0; i < kSlots; ++i) {
+            free_.emplace_back(kBlock);
+        }
+    }
+
+    vector<Complex> TakeFree() {
+        unique_lock<mutex> guard(lock_);
+        notFull_.wait(guard, [this] { return !free_.empty(); });
+        vector<Complex> block = move(free_.front());
+        free_.pop_front();
+        return block;
+    }
+
+    void Push(vector<Complex> block) {
+        {
+            lock_guard<mutex> guard(lock_);
+            ready_.push_back(move(block));
+        }
+        notEmpty_.notify_one();
+    }
+
+    vector<Complex> Pop() {
+        unique_lock<mutex> guard(lock_);
+        notEmpty_.wait(guard, [this] { return !ready_.empty(); });
+        vector<Complex> block = move(ready_.front());
+        ready_.pop_front();
+        return block;
+    }
+
+    void Release(vector<Complex> block) {
+        {
+            lock_guard<mutex> guard(lock_);
+            free_.push_back(move(block));
+        }
+        notFull_.notify_one();
+    }
+};
+
+void Ring_MutexDeque(BenchState& state) {
+    if (!NeedCores(state, 2)) {
+        return;
+    }
+    MutexQueue queue;
+    vector<double> latencies;
+    while (state.KeepRunning()) {
+        latencies.clear();
+        thread producer([&] {
+            for (size_t i = 0; i < kBlocks; ++i) {
+                vector<Complex> block = queue.TakeFree();
+                Fill(block.data(), i);
+                Stamp(block.data());
+                queue.Push(move(block));
+            }
+        });
+        for (size_t i = 0; i < kBlocks; ++i) {
+            vector<Complex> block = queue.Pop();
+            latencies.push_back(Elapsed(block.data()));
+            DoNotOptimize(block[kBlock - 1]);
+            queue.Release(move(block));
+        }
+        producer.join();
+    }
+    Report(state, latencies);
+    state.SetItemsPerIteration(kBlocks);
+    state.SetBytesPerIteration(2.0 * kBlocks * kBlock * sizeof(Complex));
+}
+
+void Spsc(BenchState& state, WaitPolicy policy) {
+    if (!NeedCores(state, 2)) {
+        return;
+    }
+    SpscRing ring(kSlots * kBlock, policy);
+    vector<double> latencies;
+    while (state.KeepRunning()) {
+        latencies.clear();
+        thread producer([&] {
+            for (size_t i = 0; i < kBlocks; ++i) {
+                SpscRing::Region region = ring.ClaimWrite(kBlock);
+                Fill(region.data, i);
+                Stamp(region.data);
+                ring.CommitWrite(region.count);
+            }
+        });
+        for (size_t i = 0; i < kBlocks; ++i) {
+            SpscRing::Region region = ring.ClaimRead(kBlock);
+            latencies.push_back(Elapsed(region.data));
+            DoNotOptimize(region.data[kBlock - 1]);
+            ring.CommitRead(region.count);
+        }
+        producer.join();
+    }
+    Report(state, latencies);
+    state.SetItemsPerIteration(kBlocks);
+    state.SetBytesPerIteration(2.0 * kBlocks * kBlock * sizeof(Complex));
+}
+
+/** producers писателей и столько же читателей; задержки — по всем читателям */
+void Mpmc(BenchState& state, WaitPolicy policy, size_t producers) {
+    if (!NeedCores(state, producers == 1 ? 2 : 4)) {
+        return;
+    }
+    MpmcBlockRing ring(kSlots, kBlock, policy);
+    vector<vector<double>> latencies(producers);
+    const size_t perThread = kBlocks / producers;
+    while (state.KeepRunning()) {
+        vector<thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            latencies[p].clear();
+            threads.emplace_back([&] {
+                for (size_t i = 0; i < perThread; ++i) {
+                    MpmcBlockRing::Block block = ring.ClaimWrite();
+                    Fill(block.data, i);
+                    Stamp(block.data);
+                    ring.CommitWrite(block, kBlock);
+                }
+            });
+            threads.emplace_back([&, p] {
+                for (size_t i = 0; i < perThread; ++i) {
+                    MpmcBlockRing::Block block = ring.ClaimRead();
+                    latencies[p].push_back(Elapsed(block.data));
+                    DoNotOptimize(block.data[kBlock - 1]);
+                    ring.CommitRead(block);
+                }
+            });
+        }
+        for (thread& t : threads) {
+            t.join();
+        }
+    }
+    vector<double> all;
+    for (const vector<double>& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    Report(state, all);
+    state.SetItemsPerIteration(double(perThread * producers));
+    state.SetBytesPerIteration(2.0 * perThread * producers * kBlock * sizeof(Complex));
+}
+
+void Ring_Spsc_Spin(BenchState& s) { Spsc(s, WaitPolicy::Spin); }
+void Ring_Spsc_Futex(BenchState& s) { Spsc(s, WaitPolicy::Futex); }
+void Ring_Mpmc_Spin(BenchState& s) { Mpmc(s, WaitPolicy::Spin, 1); }
+void Ring_Mpmc_Futex(BenchState& s) { Mpmc(s, WaitPolicy::Futex, 1); }
+void Ring_Mpmc_Futex_2x2(BenchState& s) { Mpmc(s, WaitPolicy::Futex, 2); }
+
+} // namespace
+
+BENCHMARK(Ring_MutexDeque);
+BENCHMARK(Ring_Spsc_Spin);
+BENCHMARK(Ring_Spsc_Futex);
+BENCHMARK(Ring_Mpmc_Spin);
+BENCHMARK(Ring_Mpmc_Futex);
+BENCHMARK(Ring_Mpmc_Futex_2x2);
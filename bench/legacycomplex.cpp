@@ -0,0 +1,49 @@
+#include <cmath>
+#include "legacycomplex.h"
+
+using namespace std;
+
+LegacyComplex::LegacyComplex(double real, double imag) : re_(real), im_(imag) {}
+
+LegacyComplex::LegacyComplex(const LegacyComplex& other) : re_(other.re_), im_(other.im_) {}
+
+LegacyComplex::~LegacyComplex() {}
+
+double LegacyComplex::Abs() const {
+    return sqrt(re_ * re_ + im_ * im_);
+}
+
+LegacyComplex LegacyComplex::operator+(const LegacyComplex& other) const {
+    return LegacyComplex(re_ + other.re_, im_ + other.im_);
+}
+
+LegacyComplex LegacyComplex::operator-(const LegacyComplex& other) const {
+    return LegacyComplex(re_ - other.re_, im_ - other.im_);
+}
+
+LegacyComplex LegacyComplex::operator*(const LegacyComplex& other) const {
+    return LegacyComplex(re_ * other.re_ - im_ * other.im_, re_ * other.im_ + im_ * other.re_);
+}
+
+LegacyComplex LegacyComplex::operator*(double value) const {
+    return LegacyComplex(re_ * value, im_ * value);
+}
+
+LegacyComplex& LegacyComplex::operator+=(const LegacyComplex& other) {
+    re_ += other.re_;
+    im_ += other.im_;
+    return *this;
+}
+
+LegacyComplex& LegacyComplex::operator*=(const LegacyComplex& other) {
+    double temp_re = re_;
+    re_ = re_ * other.re_ - im_ * other.im_;
+    im_ = im_ * other.re_ + temp_re * other.im_;
+    return *this;
+}
+
+LegacyComplex& LegacyComplex::operator=(const LegacyComplex& other) {
+    re_ = other.re_;
+    im_ = other.im_;
+    return *this;
+}
@@ -0,0 +1,31 @@
+#ifndef LEGACY_COMPLEX_H
+#define LEGACY_COMPLEX_H
+
+/**
+ * @brief Прежняя реализация Complex с вынесенными в .cpp методами и
+ * пользовательскими конструктором копирования и деструктором.
+ *
+ * Используется только в замерах как точка отсчёта для заголовочной версии.
+ */
+class LegacyComplex {
+private:
+    double re_;  /**< Реальная часть комплексного числа.*/
+    double im_;  /**< Мнимая часть комплексного числа.*/
+
+public:
+    LegacyComplex(double aRe = 0, double aIm = 0);
+    LegacyComplex(const LegacyComplex& other);
+    ~LegacyComplex();
+
+    double Abs() const;
+
+    LegacyComplex operator+(const LegacyComplex& other) const;
+    LegacyComplex operator-(const LegacyComplex& other) const;
+    LegacyComplex operator*(const LegacyComplex& other) const;
+    LegacyComplex operator*(double value) const;
+    LegacyComplex& operator+=(const LegacyComplex& other);
+    LegacyComplex& operator*=(const LegacyComplex& other);
+    LegacyComplex& operator=(const LegacyComplex& other);
+};
+
+#endif // LEGACY_COMPLEX_H
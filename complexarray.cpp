@@ -0,0 +1,352 @@
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "complexarray.h"
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+void CheckSameSize(const ComplexArray& a, const ComplexArray& b) {
+    if (a.Size() != b.Size()) {
+        throw invalid_argument("ComplexArray: размеры операндов не совпадают");
+    }
+}
+
+/** Скалярный режим MathAccuracy::Precise: out[i] = f(a[i]) */
+template <class F>
+void MapPrecise(const ComplexArray& a, ComplexArray& out, F f) {
+    out.Resize(a.Size());
+    for (size_t i = 0; i < a.Size(); ++i) {
+        out.Set(i, f(a[i]));
+    }
+}
+
+} // namespace
+
+void ComplexArray::Allocate(size_t size) {
+    re_ = static_cast<double*>(AllocateAligned(size * sizeof(double), kAlignment));
+    im_ = static_cast<double*>(AllocateAligned(size * sizeof(double), kAlignment));
+    size_ = size;
+    owner_ = true;
+}
+
+void ComplexArray::Release() {
+    if (owner_) {
+        FreeAligned(re_, kAlignment);
+        FreeAligned(im_, kAlignment);
+    }
+    re_ = im_ = nullptr;
+    size_ = 0;
+    owner_ = true;
+}
+
+/**
+ * @brief Конструктор: массив заданной длины, заполненный нулями
+ * @param size Число элементов
+ */
+ComplexArray::ComplexArray(size_t size) {
+    Allocate(size);
+    if (size) {
+        memset(re_, 0, size * sizeof(double));
+        memset(im_, 0, size * sizeof(double));
+    }
+}
+
+/**
+ * @brief Конструктор из обычного массива Complex
+ * @param src Массив комплексных чисел
+ * @param size Число элементов
+ */
+ComplexArray::ComplexArray(const Complex* src, size_t size) {
+    Allocate(size);
+    ActiveKernels().deinterleave(reinterpret_cast<const double*>(src), re_, im_, size);
+}
+
+/**
+ * @brief Конструктор копирования
+ * @param other Другой массив
+ */
+ComplexArray::ComplexArray(const ComplexArray& other) {
+    Allocate(other.size_);
+    if (size_) {
+        memcpy(re_, other.re_, size_ * sizeof(double));
+        memcpy(im_, other.im_, size_ * sizeof(double));
+    }
+}
+
+/**
+ * @brief Конструктор перемещения
+ * @param other Другой массив (остаётся пустым)
+ */
+ComplexArray::ComplexArray(ComplexArray&& other) noexcept
+    : re_(other.re_), im_(other.im_), size_(other.size_), owner_(other.owner_) {
+    other.re_ = other.im_ = nullptr;
+    other.size_ = 0;
+    other.owner_ = true;
+}
+
+/**
+ * @brief Деструктор. Освобождает буферы, если массив ими владеет.
+ */
+ComplexArray::~ComplexArray() {
+    Release();
+}
+
+ComplexArray& ComplexArray::operator=(const ComplexArray& other) {
+    if (this != &other) {
+        ComplexArray copy(other);
+        *this = move(copy);
+    }
+    return *this;
+}
+
+ComplexArray& ComplexArray::operator=(ComplexArray&& other) noexcept {
+    if (this != &other) {
+        Release();
+        re_ = other.re_;
+        im_ = other.im_;
+        size_ = other.size_;
+        owner_ = other.owner_;
+        other.re_ = other.im_ = nullptr;
+        other.size_ = 0;
+        other.owner_ = true;
+    }
+    return *this;
+}
+
+/**
+ * @brief Оборачивает внешние буферы re/im без копирования.
+ */
+ComplexArray ComplexArray::Wrap(double* re, double* im, size_t size) {
+    ComplexArray array;
+    array.re_ = re;
+    array.im_ = im;
+    array.size_ = size;
+    array.owner_ = false;
+    return array;
+}
+
+/**
+ * @brief Массив с буферами из арены (содержимое не инициализируется)
+ */
+ComplexArray ComplexArray::FromArena(Arena& arena, size_t size) {
+    return Wrap(arena.Allocate<double>(size), arena.Allocate<double>(size), size);
+}
+
+/**
+ * @brief Заполняет массив из обычного массива Complex
+ * @param src Массив комплексных чисел
+ * @param size Число элементов
+ */
+void ComplexArray::Assign(const Complex* src, size_t size) {
+    Resize(size);
+    ActiveKernels().deinterleave(reinterpret_cast<const double*>(src), re_, im_, size);
+}
+
+/**
+ * @brief Меняет число элементов (содержимое не сохраняется)
+ * @param size Новое число элементов
+ */
+void ComplexArray::Resize(size_t size) {
+    if (size == size_) {
+        return;
+    }
+    if (!owner_) {
+        throw invalid_argument("ComplexArray: нельзя менять размер чужих буферов");
+    }
+    Release();
+    Allocate(size);
+}
+
+/**
+ * @brief Выгружает массив в обычный массив Complex
+ * @param dst Массив не короче Size()
+ */
+void ComplexArray::CopyTo(Complex* dst) const {
+    ActiveKernels().interleave(re_, im_, reinterpret_cast<double*>(dst), size_);
+}
+
+ComplexArray& ComplexArray::operator+=(const ComplexArray& other) {
+    Add(*this, other, *this);
+    return *this;
+}
+
+ComplexArray& ComplexArray::operator-=(const ComplexArray& other) {
+    Sub(*this, other, *this);
+    return *this;
+}
+
+ComplexArray& ComplexArray::operator*=(const ComplexArray& other) {
+    Mul(*this, other, *this);
+    return *this;
+}
+
+void Add(const ComplexArray& a, const ComplexArray& b, ComplexArray& out) {
+    COMPLEX_PROFILE_KERNEL("array.add", a.Size());
+    CheckSameSize(a, b);
+    out.Resize(a.Size());
+    ActiveKernels().add(a.Re(), a.Im(), b.Re(), b.Im(), out.Re(), out.Im(), a.Size());
+}
+
+void Sub(const ComplexArray& a, const ComplexArray& b, ComplexArray& out) {
+    COMPLEX_PROFILE_KERNEL("array.sub", a.Size());
+    CheckSameSize(a, b);
+    out.Resize(a.Size());
+    ActiveKernels().sub(a.Re(), a.Im(), b.Re(), b.Im(), out.Re(), out.Im(), a.Size());
+}
+
+void Mul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out) {
+    COMPLEX_PROFILE_KERNEL("array.mul", a.Size());
+    CheckSameSize(a, b);
+    out.Resize(a.Size());
+    ActiveKernels().mul(a.Re(), a.Im(), b.Re(), b.Im(), out.Re(), out.Im(), a.Size());
+}
+
+void ConjMul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out) {
+    COMPLEX_PROFILE_KERNEL("array.conj_mul", a.Size());
+    CheckSameSize(a, b);
+    out.Resize(a.Size());
+    ActiveKernels().conjMul(a.Re(), a.Im(), b.Re(), b.Im(), out.Re(), out.Im(), a.Size());
+}
+
+void Scale(const ComplexArray& a, double k, ComplexArray& out) {
+    COMPLEX_PROFILE_KERNEL("array.scale", a.Size());
+    out.Resize(a.Size());
+    ActiveKernels().scale(a.Re(), a.Im(), k, out.Re(), out.Im(), a.Size());
+}
+
+void Div(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, DivMode mode) {
+    COMPLEX_PROFILE_KERNEL("array.div", a.Size());
+    CheckSameSize(a, b);
+    out.Resize(a.Size());
+    if (mode == DivMode::Fast) {
+        ActiveKernels().divFast(a.Re(), a.Im(), b.Re(), b.Im(), out.Re(), out.Im(), a.Size());
+    } else {
+        ActiveKernels().div(a.Re(), a.Im(), b.Re(), b.Im(), out.Re(), out.Im(), a.Size());
+    }
+}
+
+void Reciprocal(const ComplexArray& a, ComplexArray& out, DivMode mode) {
+    COMPLEX_PROFILE_KERNEL("array.reciprocal", a.Size());
+    out.Resize(a.Size());
+    if (mode == DivMode::Fast) {
+        ActiveKernels().reciprocalFast(a.Re(), a.Im(), out.Re(), out.Im(), a.Size());
+    } else {
+        ActiveKernels().reciprocal(a.Re(), a.Im(), out.Re(), out.Im(), a.Size());
+    }
+}
+
+void Axpy(const Complex& a, const ComplexArray& x, ComplexArray& y) {
+    COMPLEX_PROFILE_KERNEL("array.axpy", x.Size());
+    CheckSameSize(x, y);
+    ActiveKernels().axpy(a.Re(), a.Im(), x.Re(), x.Im(), y.Re(), y.Im(), x.Size());
+}
+
+Complex Dot(const ComplexArray& x, const ComplexArray& y, SumMode mode) {
+    COMPLEX_PROFILE_KERNEL("array.dot", x.Size());
+    CheckSameSize(x, y);
+    double out[2];
+    ActiveKernels().dot(x.Re(), x.Im(), y.Re(), y.Im(), x.Size(), false, mode == SumMode::Compensated, out);
+    return Complex(out[0], out[1]);
+}
+
+Complex DotConj(const ComplexArray& x, const ComplexArray& y, SumMode mode) {
+    COMPLEX_PROFILE_KERNEL("array.dot_conj", x.Size());
+    CheckSameSize(x, y);
+    double out[2];
+    ActiveKernels().dot(x.Re(), x.Im(), y.Re(), y.Im(), x.Size(), true, mode == SumMode::Compensated, out);
+    return Complex(out[0], out[1]);
+}
+
+void Abs(const ComplexArray& a, double* out, AbsMode mode) {
+    COMPLEX_PROFILE_KERNEL("array.abs", a.Size());
+    if (mode == AbsMode::Approx) {
+        ActiveKernels().absApprox(a.Re(), a.Im(), out, a.Size());
+    } else {
+        ActiveKernels().abs(a.Re(), a.Im(), out, a.Size());
+    }
+}
+
+void AbsSquared(const ComplexArray& a, double* out) {
+    COMPLEX_PROFILE_KERNEL("array.abs_squared", a.Size());
+    ActiveKernels().absSquared(a.Re(), a.Im(), out, a.Size());
+}
+
+void Arg(const ComplexArray& a, double* out, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("array.arg", a.Size());
+    if (accuracy == MathAccuracy::Precise) {
+        for (size_t i = 0; i < a.Size(); ++i) {
+            out[i] = Arg(a[i]);
+        }
+    } else {
+        ActiveKernels().arg(a.Re(), a.Im(), out, a.Size(), accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Polar(const double* r, const double* theta, ComplexArray& out, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("array.polar", out.Size());
+    if (accuracy == MathAccuracy::Precise) {
+        for (size_t i = 0; i < out.Size(); ++i) {
+            out.Set(i, Polar(r ? r[i] : 1.0, theta[i]));
+        }
+    } else {
+        ActiveKernels().polar(r, theta, out.Re(), out.Im(), out.Size(), accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Rotate(const ComplexArray& a, const double* phase, ComplexArray& out, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("array.rotate", a.Size());
+    out.Resize(a.Size());
+    if (accuracy == MathAccuracy::Precise) {
+        for (size_t i = 0; i < a.Size(); ++i) {
+            out.Set(i, a[i] * Polar(1.0, phase[i]));
+        }
+    } else {
+        ActiveKernels().rotate(a.Re(), a.Im(), phase, out.Re(), out.Im(), a.Size(),
+                               accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Exp(const ComplexArray& a, ComplexArray& out, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("array.exp", a.Size());
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(a, out, [](const Complex& z) { return Exp(z); });
+    } else {
+        out.Resize(a.Size());
+        ActiveKernels().exp(a.Re(), a.Im(), out.Re(), out.Im(), a.Size(), accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Log(const ComplexArray& a, ComplexArray& out, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("array.log", a.Size());
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(a, out, [](const Complex& z) { return Log(z); });
+    } else {
+        out.Resize(a.Size());
+        ActiveKernels().log(a.Re(), a.Im(), out.Re(), out.Im(), a.Size(), accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Sqrt(const ComplexArray& a, ComplexArray& out, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("array.sqrt", a.Size());
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(a, out, [](const Complex& z) { return Sqrt(z); });
+    } else {
+        out.Resize(a.Size());
+        ActiveKernels().sqrt(a.Re(), a.Im(), out.Re(), out.Im(), a.Size());
+    }
+}
+
+void Pow(const ComplexArray& a, double p, ComplexArray& out, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("array.pow", a.Size());
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(a, out, [p](const Complex& z) { return Pow(z, p); });
+    } else {
+        out.Resize(a.Size());
+        ActiveKernels().pow(a.Re(), a.Im(), p, out.Re(), out.Im(), a.Size(), accuracy == MathAccuracy::Approx);
+    }
+}
@@ -0,0 +1,256 @@
+#ifndef COMPLEX_ARRAY_H
+#define COMPLEX_ARRAY_H
+
+#include <cstddef>
+#include "allocator.h"
+#include "complexbatch.h"
+#include "mycomplex.h"
+
+template <class E>
+class ArrayExpr;
+
+/**
+ * @brief Массив комплексных чисел в раздельном хранении (structure of arrays).
+ *
+ * Действительные и мнимые части лежат в двух отдельных буферах, выровненных
+ * на 64 байта, поэтому поэлементные ядра обрабатывают их целыми векторными
+ * регистрами без перестановок.
+ */
+class ComplexArray {
+private:
+    double* re_;    /**< Действительные части.*/
+    double* im_;    /**< Мнимые части.*/
+    size_t size_;   /**< Число элементов.*/
+    bool owner_;    /**< Владеет ли массив своими буферами.*/
+
+    void Allocate(size_t size);
+    void Release();
+
+public:
+    /** Выравнивание буферов в байтах (размер строки кэша). */
+    static const size_t kAlignment = 64;
+
+    /**
+    * @brief Конструктор: массив заданной длины, заполненный нулями
+    * @param size Число элементов (по умолчанию 0)
+    */
+    explicit ComplexArray(size_t size = 0);
+
+    /**
+    * @brief Конструктор из обычного массива Complex (разбор на re/im за один проход)
+    * @param src Массив комплексных чисел
+    * @param size Число элементов
+    */
+    ComplexArray(const Complex* src, size_t size);
+
+    /**
+    * @brief Конструктор копирования (всегда создаёт собственные буферы)
+    * @param other Другой массив
+    */
+    ComplexArray(const ComplexArray& other);
+
+    /**
+    * @brief Конструктор перемещения
+    * @param other Другой массив
+    */
+    ComplexArray(ComplexArray&& other) noexcept;
+
+    /**
+    * @brief Деструктор
+    */
+    ~ComplexArray();
+
+    ComplexArray& operator=(const ComplexArray& other);
+    ComplexArray& operator=(ComplexArray&& other) noexcept;
+
+    // Ленивые выражения (определены в complexexpr.h): всё выражение справа
+    // вычисляется одним проходом, без промежуточных массивов.
+
+    /**
+    * @brief Конструктор из выражения: ComplexArray y = a * b + c;
+    * @param expr Выражение над массивами
+    */
+    template <class E>
+    ComplexArray(const ArrayExpr<E>& expr);
+
+    template <class E>
+    ComplexArray& operator=(const ArrayExpr<E>& expr);
+    template <class E>
+    ComplexArray& operator+=(const ArrayExpr<E>& expr);
+    template <class E>
+    ComplexArray& operator-=(const ArrayExpr<E>& expr);
+    template <class E>
+    ComplexArray& operator*=(const ArrayExpr<E>& expr);
+
+    // Те же операции с одним массивом справа — сразу векторными ядрами.
+    ComplexArray& operator+=(const ComplexArray& other);
+    ComplexArray& operator-=(const ComplexArray& other);
+    ComplexArray& operator*=(const ComplexArray& other);
+
+    /**
+    * @brief Оборачивает внешние буферы re/im без копирования.
+    * Буферы должны жить дольше возвращённого массива.
+    * @param re Действительные части
+    * @param im Мнимые части
+    * @param size Число элементов
+    * @return Массив, не владеющий данными
+    */
+    static ComplexArray Wrap(double* re, double* im, size_t size);
+
+    /**
+    * @brief Рабочий массив с буферами из арены, например на время обработки
+    * блока: ArenaFrame frame; ComplexArray t = ComplexArray::FromArena(frame.GetArena(), n);
+    * Массив не владеет буферами (как Wrap()) и действителен до Reset() или
+    * Rewind() арены; содержимое не инициализируется.
+    * @param arena Арена
+    * @param size Число элементов
+    * @return Массив, не владеющий данными
+    */
+    static ComplexArray FromArena(Arena& arena, size_t size);
+
+    size_t Size() const noexcept { return size_; }
+    double* Re() noexcept { return re_; }
+    const double* Re() const noexcept { return re_; }
+    double* Im() noexcept { return im_; }
+    const double* Im() const noexcept { return im_; }
+
+    /**
+    * @brief Элемент массива
+    * @param i Индекс
+    * @return Комплексное число
+    */
+    Complex operator[](size_t i) const noexcept { return Complex(re_[i], im_[i]); }
+
+    /**
+    * @brief Записывает элемент массива
+    * @param i Индекс
+    * @param value Новое значение
+    */
+    void Set(size_t i, const Complex& value) noexcept {
+        re_[i] = value.Re();
+        im_[i] = value.Im();
+    }
+
+    /**
+    * @brief Меняет число элементов; содержимое при этом не сохраняется.
+    * Для массивов из Wrap() бросает invalid_argument.
+    * @param size Новое число элементов
+    */
+    void Resize(size_t size);
+
+    /**
+    * @brief Заполняет массив из обычного массива Complex (размер меняется на size)
+    * @param src Массив комплексных чисел
+    * @param size Число элементов
+    */
+    void Assign(const Complex* src, size_t size);
+
+    /**
+    * @brief Выгружает массив в обычный массив Complex
+    * @param dst Массив не короче Size()
+    */
+    void CopyTo(Complex* dst) const;
+};
+
+// Поэлементные ядра. Размеры a и b должны совпадать (иначе invalid_argument),
+// out подгоняется под них через Resize() и может совпадать с одним из входов.
+
+/**
+ * @brief Поэлементное сложение: out = a + b
+ */
+void Add(const ComplexArray& a, const ComplexArray& b, ComplexArray& out);
+
+/**
+ * @brief Поэлементное вычитание: out = a - b
+ */
+void Sub(const ComplexArray& a, const ComplexArray& b, ComplexArray& out);
+
+/**
+ * @brief Поэлементное умножение: out = a * b
+ */
+void Mul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out);
+
+/**
+ * @brief Умножение на сопряжённое: out = a * conj(b)
+ */
+void ConjMul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out);
+
+/**
+ * @brief Умножение на вещественное число: out = a * k
+ */
+void Scale(const ComplexArray& a, double k, ComplexArray& out);
+
+/**
+ * @brief Поэлементное деление: out = a / b
+ * @param mode Устойчивый или быстрый режим (по умолчанию устойчивый)
+ */
+void Div(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, DivMode mode = DivMode::Robust);
+
+/**
+ * @brief Обратные числа: out = 1 / a
+ * @param mode Устойчивый или быстрый режим (по умолчанию устойчивый)
+ */
+void Reciprocal(const ComplexArray& a, ComplexArray& out, DivMode mode = DivMode::Robust);
+
+/**
+ * @brief y += a * x через FMA (размеры x и y должны совпадать)
+ */
+void Axpy(const Complex& a, const ComplexArray& x, ComplexArray& y);
+
+/**
+ * @brief Скалярное произведение без сопряжения: sum x[i] * y[i]
+ */
+Complex Dot(const ComplexArray& x, const ComplexArray& y, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Скалярное произведение с сопряжением: sum x[i] * conj(y[i])
+ */
+Complex DotConj(const ComplexArray& x, const ComplexArray& y, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Модули элементов: out[i] = |a[i]|
+ * @param a Входной массив
+ * @param out Массив не короче a.Size()
+ * @param mode Точный или приближённый режим (по умолчанию точный)
+ */
+void Abs(const ComplexArray& a, double* out, AbsMode mode = AbsMode::Exact);
+
+/**
+ * @brief Квадраты модулей элементов: out[i] = |a[i]|^2
+ * @param a Входной массив
+ * @param out Массив не короче a.Size()
+ */
+void AbsSquared(const ComplexArray& a, double* out);
+
+// Элементарные функции (точность — см. MathAccuracy в complexbatch.h).
+
+/**
+ * @brief Аргументы элементов: out[i] = Arg(a[i])
+ * @param out Массив не короче a.Size()
+ */
+void Arg(const ComplexArray& a, double* out, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief out[i] = r[i] * e^(i * theta[i]) для out.Size() элементов
+ * @param r Модули; nullptr — единичные
+ * @param theta Аргументы в радианах
+ */
+void Polar(const double* r, const double* theta, ComplexArray& out, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Поворот фазы: out[i] = a[i] * e^(i * phase[i])
+ * @param phase Углы в радианах, не короче a.Size()
+ */
+void Rotate(const ComplexArray& a, const double* phase, ComplexArray& out,
+            MathAccuracy accuracy = MathAccuracy::Fast);
+
+void Exp(const ComplexArray& a, ComplexArray& out, MathAccuracy accuracy = MathAccuracy::Fast);
+void Log(const ComplexArray& a, ComplexArray& out, MathAccuracy accuracy = MathAccuracy::Fast);
+void Sqrt(const ComplexArray& a, ComplexArray& out, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Вещественные степени: out[i] = a[i]^p
+ */
+void Pow(const ComplexArray& a, double p, ComplexArray& out, MathAccuracy accuracy = MathAccuracy::Fast);
+
+#endif // COMPLEX_ARRAY_H
@@ -0,0 +1,263 @@
+#include "complexbatch.h"
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double* AsDoubles(const Complex* src) {
+    return reinterpret_cast<const double*>(src);
+}
+
+double* AsDoubles(Complex* dst) {
+    return reinterpret_cast<double*>(dst);
+}
+
+const float* AsFloats(const ComplexF* src) {
+    return reinterpret_cast<const float*>(src);
+}
+
+float* AsFloats(ComplexF* dst) {
+    return reinterpret_cast<float*>(dst);
+}
+
+// Части ComplexQ15 и ComplexHalf лежат подряд, как пары 16-битных слов.
+const int16_t* AsRaw(const ComplexQ15* src) {
+    return reinterpret_cast<const int16_t*>(src);
+}
+
+int16_t* AsRaw(ComplexQ15* dst) {
+    return reinterpret_cast<int16_t*>(dst);
+}
+
+const uint16_t* AsRaw(const ComplexHalf* src) {
+    return reinterpret_cast<const uint16_t*>(src);
+}
+
+uint16_t* AsRaw(ComplexHalf* dst) {
+    return reinterpret_cast<uint16_t*>(dst);
+}
+
+/** Блок промежуточного float-буфера для преобразования binary16 -> double */
+const size_t kConvertChunk = 512;
+
+/** Скалярный режим MathAccuracy::Precise: out[i] = f(src[i]) */
+template <class F>
+void MapPrecise(const Complex* src, Complex* out, size_t n, F f) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = f(src[i]);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Модули элементов массива: out[i] = |src[i]|
+ */
+void Abs(const Complex* src, double* out, size_t n, AbsMode mode) {
+    COMPLEX_PROFILE_KERNEL("batch.abs", n);
+    if (mode == AbsMode::Approx) {
+        ActiveKernels().absApproxInterleaved(AsDoubles(src), out, n);
+    } else {
+        ActiveKernels().absInterleaved(AsDoubles(src), out, n);
+    }
+}
+
+/**
+ * @brief Квадраты модулей элементов массива: out[i] = |src[i]|^2
+ */
+void AbsSquared(const Complex* src, double* out, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.abs_squared", n);
+    ActiveKernels().absSquaredInterleaved(AsDoubles(src), out, n);
+}
+
+/**
+ * @brief Поэлементное деление: out[i] = a[i] / b[i]
+ */
+void Divide(const Complex* a, const Complex* b, Complex* out, size_t n, DivMode mode) {
+    COMPLEX_PROFILE_KERNEL("batch.divide", n);
+    if (mode == DivMode::Fast) {
+        ActiveKernels().divFastInterleaved(AsDoubles(a), AsDoubles(b), AsDoubles(out), n);
+    } else {
+        ActiveKernels().divInterleaved(AsDoubles(a), AsDoubles(b), AsDoubles(out), n);
+    }
+}
+
+/**
+ * @brief Обратные числа: out[i] = 1 / src[i]
+ */
+void Reciprocal(const Complex* src, Complex* out, size_t n, DivMode mode) {
+    COMPLEX_PROFILE_KERNEL("batch.reciprocal", n);
+    if (mode == DivMode::Fast) {
+        ActiveKernels().reciprocalFastInterleaved(AsDoubles(src), AsDoubles(out), n);
+    } else {
+        ActiveKernels().reciprocalInterleaved(AsDoubles(src), AsDoubles(out), n);
+    }
+}
+
+/**
+ * @brief y[i] += a * x[i]
+ */
+void Axpy(const Complex& a, const Complex* x, Complex* y, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.axpy", n);
+    ActiveKernels().axpyInterleaved(a.Re(), a.Im(), AsDoubles(x), AsDoubles(y), n);
+}
+
+Complex Dot(const Complex* x, const Complex* y, size_t n, SumMode mode) {
+    COMPLEX_PROFILE_KERNEL("batch.dot", n);
+    double out[2];
+    ActiveKernels().dotInterleaved(AsDoubles(x), AsDoubles(y), n, false, mode == SumMode::Compensated, out);
+    return Complex(out[0], out[1]);
+}
+
+Complex DotConj(const Complex* x, const Complex* y, size_t n, SumMode mode) {
+    COMPLEX_PROFILE_KERNEL("batch.dot_conj", n);
+    double out[2];
+    ActiveKernels().dotInterleaved(AsDoubles(x), AsDoubles(y), n, true, mode == SumMode::Compensated, out);
+    return Complex(out[0], out[1]);
+}
+
+void Arg(const Complex* src, double* out, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.arg", n);
+    if (accuracy == MathAccuracy::Precise) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = Arg(src[i]);
+        }
+    } else {
+        ActiveKernels().argInterleaved(AsDoubles(src), out, n, accuracy == MathAccuracy::Approx);
+    }
+}
+
+void ToPolar(const Complex* src, double* r, double* theta, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.to_polar", n);
+    if (accuracy == MathAccuracy::Precise) {
+        for (size_t i = 0; i < n; ++i) {
+            r[i] = src[i].Abs();
+            theta[i] = Arg(src[i]);
+        }
+    } else {
+        ActiveKernels().toPolarInterleaved(AsDoubles(src), r, theta, n, accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Polar(const double* r, const double* theta, Complex* out, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.polar", n);
+    if (accuracy == MathAccuracy::Precise) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = Polar(r ? r[i] : 1.0, theta[i]);
+        }
+    } else {
+        ActiveKernels().polarInterleaved(r, theta, AsDoubles(out), n, accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Rotate(const Complex* src, const double* phase, Complex* out, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.rotate", n);
+    if (accuracy == MathAccuracy::Precise) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = src[i] * Polar(1.0, phase[i]);
+        }
+    } else {
+        ActiveKernels().rotateInterleaved(AsDoubles(src), phase, AsDoubles(out), n,
+                                          accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Exp(const Complex* src, Complex* out, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.exp", n);
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(src, out, n, [](const Complex& z) { return Exp(z); });
+    } else {
+        ActiveKernels().expInterleaved(AsDoubles(src), AsDoubles(out), n, accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Log(const Complex* src, Complex* out, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.log", n);
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(src, out, n, [](const Complex& z) { return Log(z); });
+    } else {
+        ActiveKernels().logInterleaved(AsDoubles(src), AsDoubles(out), n, accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Sqrt(const Complex* src, Complex* out, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.sqrt", n);
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(src, out, n, [](const Complex& z) { return Sqrt(z); });
+    } else {
+        ActiveKernels().sqrtInterleaved(AsDoubles(src), AsDoubles(out), n);
+    }
+}
+
+void Pow(const Complex* src, double p, Complex* out, size_t n, MathAccuracy accuracy) {
+    COMPLEX_PROFILE_KERNEL("batch.pow", n);
+    if (accuracy == MathAccuracy::Precise) {
+        MapPrecise(src, out, n, [p](const Complex& z) { return Pow(z, p); });
+    } else {
+        ActiveKernels().powInterleaved(AsDoubles(src), p, AsDoubles(out), n, accuracy == MathAccuracy::Approx);
+    }
+}
+
+void Convert(const Complex* src, ComplexF* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().f64ToF32(AsDoubles(src), AsFloats(dst), 2 * n);
+}
+
+void Convert(const ComplexF* src, Complex* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().f32ToF64(AsFloats(src), AsDoubles(dst), 2 * n);
+}
+
+void Convert(const ComplexQ15* src, ComplexF* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().q15ToF32(AsRaw(src), AsFloats(dst), 2 * n);
+}
+
+void Convert(const ComplexF* src, ComplexQ15* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().f32ToQ15(AsFloats(src), AsRaw(dst), 2 * n);
+}
+
+void Convert(const ComplexQ15* src, Complex* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().q15ToF64(AsRaw(src), AsDoubles(dst), 2 * n);
+}
+
+void Convert(const Complex* src, ComplexQ15* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().f64ToQ15(AsDoubles(src), AsRaw(dst), 2 * n);
+}
+
+void Convert(const ComplexHalf* src, ComplexF* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().f16ToF32(AsRaw(src), AsFloats(dst), 2 * n);
+}
+
+void Convert(const ComplexF* src, ComplexHalf* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().f32ToF16(AsFloats(src), AsRaw(dst), 2 * n);
+}
+
+/**
+ * @brief binary16 -> double через float (точно) кусками по kConvertChunk
+ */
+void Convert(const ComplexHalf* src, Complex* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    const SimdKernels& kernels = ActiveKernels();
+    float buffer[2 * kConvertChunk];
+    for (size_t i = 0; i < n; i += kConvertChunk) {
+        size_t m = n - i < kConvertChunk ? n - i : kConvertChunk;
+        kernels.f16ToF32(AsRaw(src + i), buffer, 2 * m);
+        kernels.f32ToF64(buffer, AsDoubles(dst + i), 2 * m);
+    }
+}
+
+/**
+ * @brief double -> binary16 с одним округлением, как Half::FromDouble
+ */
+void Convert(const Complex* src, ComplexHalf* dst, size_t n) {
+    COMPLEX_PROFILE_KERNEL("batch.convert", n);
+    ActiveKernels().f64ToF16(AsDoubles(src), AsRaw(dst), 2 * n);
+}
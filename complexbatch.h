@@ -0,0 +1,198 @@
+#ifndef COMPLEX_BATCH_H
+#define COMPLEX_BATCH_H
+
+#include <cstddef>
+#include "complexmath.h"
+#include "complexstorage.h"
+#include "mycomplex.h"
+
+// Пакетные операции над обычными массивами Complex (чередующиеся re, im).
+// Все функции выбирают векторные ядра под текущий процессор (см. simd.h).
+
+/**
+ * @brief Режим вычисления модуля в пакетных функциях.
+ */
+enum class AbsMode {
+    Exact,   /**< Как Complex::Abs: корень, без ложного переполнения.*/
+    Approx   /**< alpha*max + beta*min, без корня; отн. погрешность <= 3.96%.*/
+};
+
+/**
+ * @brief Режим комплексного деления в пакетных функциях.
+ */
+enum class DivMode {
+    Robust,  /**< Как Complex::operator/: Смит с масштабированием, особые случаи по C99 Annex G.*/
+    Fast     /**< Как Complex::FastDivide: умножение на 1/|b|^2, без защиты диапазона.*/
+};
+
+/**
+ * @brief Режим накопления сумм в скалярных произведениях и редукциях.
+ */
+enum class SumMode {
+    Fast,         /**< Несколько аккумуляторов на FMA; ошибка растёт с длиной.*/
+    Compensated   /**< Точные ошибки произведений и сумм копятся отдельно (Dot2/Neumaier).*/
+};
+
+/**
+ * @brief Точность пакетных элементарных функций (Arg, ToPolar, Polar,
+ * Rotate, Exp, Log, Sqrt, Pow).
+ *
+ * Погрешности — максимум на случайных аргументах, в ULP модуля результата
+ * (для Arg и Log — ULP самой части). У Pow к ним добавляется около
+ * 2 * |p * log|z|| ULP от округления показателя. Векторные режимы работают
+ * при |фаза| <= 2^20, |Re| <= 708 для Exp и |z| в [2^-480, 2^500] для Log и
+ * Sqrt; остальные элементы и особые значения (inf, NaN, нули для Log)
+ * считаются скалярно, как Precise.
+ */
+enum class MathAccuracy {
+    Precise,  /**< Скалярные функции из complexmath.h поэлементно: <= 2 ULP, не зависит от набора инструкций.*/
+    Fast,     /**< Векторные полиномы: <= 2 ULP.*/
+    Approx    /**< Укороченные полиномы для генерации и демодуляции фазы: отн. погрешность <= 4e-9 (Sqrt — как Fast).*/
+};
+
+/**
+ * @brief Модули элементов массива: out[i] = |src[i]|
+ * @param src Массив комплексных чисел
+ * @param out Массив результатов (не короче n)
+ * @param n Число элементов
+ * @param mode Точный или приближённый режим (по умолчанию точный)
+ */
+void Abs(const Complex* src, double* out, size_t n, AbsMode mode = AbsMode::Exact);
+
+/**
+ * @brief Квадраты модулей элементов массива: out[i] = |src[i]|^2
+ * @param src Массив комплексных чисел
+ * @param out Массив результатов (не короче n)
+ * @param n Число элементов
+ */
+void AbsSquared(const Complex* src, double* out, size_t n);
+
+/**
+ * @brief Поэлементное деление: out[i] = a[i] / b[i]. out может совпадать с a или b.
+ * @param a Делимые
+ * @param b Делители
+ * @param out Массив результатов (не короче n)
+ * @param n Число элементов
+ * @param mode Устойчивый или быстрый режим (по умолчанию устойчивый)
+ */
+void Divide(const Complex* a, const Complex* b, Complex* out, size_t n, DivMode mode = DivMode::Robust);
+
+/**
+ * @brief Обратные числа: out[i] = 1 / src[i]. out может совпадать с src.
+ * @param src Массив комплексных чисел
+ * @param out Массив результатов (не короче n)
+ * @param n Число элементов
+ * @param mode Устойчивый или быстрый режим (по умолчанию устойчивый)
+ */
+void Reciprocal(const Complex* src, Complex* out, size_t n, DivMode mode = DivMode::Robust);
+
+/**
+ * @brief y[i] += a * x[i] через FMA (как FusedMulAdd). y может совпадать с x.
+ * @param a Множитель
+ * @param x Входной массив
+ * @param y Массив-аккумулятор
+ * @param n Число элементов
+ */
+void Axpy(const Complex& a, const Complex* x, Complex* y, size_t n);
+
+/**
+ * @brief Скалярное произведение без сопряжения: sum x[i] * y[i]
+ * @param x Первый массив
+ * @param y Второй массив
+ * @param n Число элементов
+ * @param mode Быстрый или компенсированный режим
+ * @return Сумма
+ */
+Complex Dot(const Complex* x, const Complex* y, size_t n, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Скалярное произведение с сопряжением второго множителя: sum x[i] * conj(y[i])
+ * @param x Первый массив
+ * @param y Второй массив
+ * @param n Число элементов
+ * @param mode Быстрый или компенсированный режим
+ * @return Сумма
+ */
+Complex DotConj(const Complex* x, const Complex* y, size_t n, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Аргументы элементов: out[i] = Arg(src[i]) в [-pi, pi]
+ * @param src Массив комплексных чисел
+ * @param out Массив результатов (не короче n)
+ * @param n Число элементов
+ * @param accuracy Точность
+ */
+void Arg(const Complex* src, double* out, size_t n, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Полярная форма за один проход: r[i] = |src[i]|, theta[i] = Arg(src[i]).
+ * Модуль точный при любой точности (как Abs), аргумент — как у Arg;
+ * обратное преобразование — Polar.
+ * @param src Массив комплексных чисел
+ * @param r Модули (не короче n)
+ * @param theta Аргументы в [-pi, pi] (не короче n)
+ * @param n Число элементов
+ * @param accuracy Точность аргумента
+ */
+void ToPolar(const Complex* src, double* r, double* theta, size_t n, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Числа по модулям и аргументам: out[i] = r[i] * e^(i * theta[i])
+ * @param r Модули; nullptr — единичные (out[i] = e^(i * theta[i]))
+ * @param theta Аргументы в радианах
+ * @param out Массив результатов (не короче n)
+ * @param n Число элементов
+ * @param accuracy Точность
+ */
+void Polar(const double* r, const double* theta, Complex* out, size_t n,
+           MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Поворот фазы: out[i] = src[i] * e^(i * phase[i]). out может совпадать с src.
+ * @param src Массив комплексных чисел
+ * @param phase Углы поворота в радианах
+ * @param out Массив результатов (не короче n)
+ * @param n Число элементов
+ * @param accuracy Точность
+ */
+void Rotate(const Complex* src, const double* phase, Complex* out, size_t n,
+            MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Экспоненты: out[i] = e^src[i]. out может совпадать с src.
+ */
+void Exp(const Complex* src, Complex* out, size_t n, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Логарифмы (главная ветвь): out[i] = Log(src[i]). out может совпадать с src.
+ */
+void Log(const Complex* src, Complex* out, size_t n, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Квадратные корни (главная ветвь): out[i] = Sqrt(src[i]). out может совпадать с src.
+ * @param accuracy Точность (Approx — как Fast)
+ */
+void Sqrt(const Complex* src, Complex* out, size_t n, MathAccuracy accuracy = MathAccuracy::Fast);
+
+/**
+ * @brief Вещественные степени: out[i] = src[i]^p. out может совпадать с src.
+ * Векторные режимы считают e^(p * Log z), поэтому к погрешности добавляется
+ * |p * log|z|| ULP; Precise считает модуль через pow.
+ */
+void Pow(const Complex* src, double p, Complex* out, size_t n, MathAccuracy accuracy = MathAccuracy::Fast);
+
+// Преобразование массивов между типами частей — поэлементно то же, что
+// ComplexCast (округление к ближайшему чётному, в Q15 с насыщением).
+// Массивы не должны пересекаться; n — число комплексных элементов.
+void Convert(const Complex* src, ComplexF* dst, size_t n);
+void Convert(const ComplexF* src, Complex* dst, size_t n);
+void Convert(const ComplexQ15* src, ComplexF* dst, size_t n);
+void Convert(const ComplexF* src, ComplexQ15* dst, size_t n);
+void Convert(const ComplexQ15* src, Complex* dst, size_t n);
+void Convert(const Complex* src, ComplexQ15* dst, size_t n);
+void Convert(const ComplexHalf* src, ComplexF* dst, size_t n);
+void Convert(const ComplexF* src, ComplexHalf* dst, size_t n);
+void Convert(const ComplexHalf* src, Complex* dst, size_t n);
+void Convert(const Complex* src, ComplexHalf* dst, size_t n);
+
+#endif // COMPLEX_BATCH_H
@@ -0,0 +1,247 @@
+#ifndef COMPLEX_EXPR_H
+#define COMPLEX_EXPR_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "complexarray.h"
+#include "mycomplex.h"
+
+// Ленивые выражения над ComplexArray. Операторы + - * / над массивами,
+// выражениями, Complex и double ничего не вычисляют, а строят дерево узлов;
+// дерево вычисляется при присваивании в ComplexArray одним циклом по
+// элементам, без промежуточных массивов:
+//
+//     y = a * b + c * d - e;    // один проход: 5 чтений и 1 запись на элемент
+//     y += Conj(x) * 0.5;
+//
+// Узлы хранят только указатели на данные и скаляры, поэтому копируются
+// дёшево. Выражение поэлементное, так что результат можно записывать в
+// один из операндов (y = y * w).
+
+/**
+ * @brief База всех узлов выражения (CRTP). Узел E обязан иметь
+ * static constexpr bool kScalar (true — одно число, подходит к массиву
+ * любой длины, его Size() не используется), Size() и operator[](i).
+ */
+template <class E>
+class ArrayExpr {
+public:
+    const E& Self() const noexcept { return static_cast<const E&>(*this); }
+};
+
+/**
+ * @brief Лист выражения: ссылка на данные ComplexArray.
+ */
+class ArrayRef : public ArrayExpr<ArrayRef> {
+private:
+    const double* re_;  /**< Действительные части.*/
+    const double* im_;  /**< Мнимые части.*/
+    size_t size_;       /**< Число элементов.*/
+
+public:
+    static constexpr bool kScalar = false;
+
+    explicit ArrayRef(const ComplexArray& a) noexcept : re_(a.Re()), im_(a.Im()), size_(a.Size()) {}
+
+    size_t Size() const noexcept { return size_; }
+    Complex operator[](size_t i) const noexcept { return Complex(re_[i], im_[i]); }
+};
+
+/**
+ * @brief Лист выражения: одно число, одинаковое для всех элементов.
+ */
+class ScalarExpr : public ArrayExpr<ScalarExpr> {
+private:
+    Complex value_;  /**< Значение.*/
+
+public:
+    static constexpr bool kScalar = true;
+
+    explicit ScalarExpr(const Complex& value) noexcept : value_(value) {}
+
+    size_t Size() const noexcept { return 0; }
+    Complex operator[](size_t) const noexcept { return value_; }
+};
+
+/**
+ * @brief Узел с двумя операндами: Op::Apply(left[i], right[i]). Длины
+ * операндов-массивов должны совпадать (пустой массив — тоже массив).
+ */
+template <class Op, class L, class R>
+class BinaryExpr : public ArrayExpr<BinaryExpr<Op, L, R>> {
+private:
+    L left_;       /**< Левый операнд.*/
+    R right_;      /**< Правый операнд.*/
+    size_t size_;  /**< Длина результата.*/
+
+public:
+    static constexpr bool kScalar = L::kScalar && R::kScalar;
+
+    BinaryExpr(const L& left, const R& right) : left_(left), right_(right), size_(0) {
+        if (!L::kScalar && !R::kScalar && left.Size() != right.Size()) {
+            throw invalid_argument("ComplexArray: размеры операндов не совпадают");
+        }
+        if (!kScalar) {
+            size_ = L::kScalar ? right.Size() : left.Size();
+        }
+    }
+
+    size_t Size() const noexcept { return size_; }
+    Complex operator[](size_t i) const noexcept { return Op::Apply(left_[i], right_[i]); }
+};
+
+/**
+ * @brief Узел с одним операндом: Op::Apply(arg[i]).
+ */
+template <class Op, class A>
+class UnaryExpr : public ArrayExpr<UnaryExpr<Op, A>> {
+private:
+    A arg_;  /**< Операнд.*/
+
+public:
+    static constexpr bool kScalar = A::kScalar;
+
+    explicit UnaryExpr(const A& arg) noexcept : arg_(arg) {}
+
+    size_t Size() const noexcept { return arg_.Size(); }
+    Complex operator[](size_t i) const noexcept { return Op::Apply(arg_[i]); }
+};
+
+// Поэлементные операции узлов — те же операторы Complex, что и в скалярном коде.
+struct ExprAdd {
+    static Complex Apply(const Complex& a, const Complex& b) noexcept { return a + b; }
+};
+struct ExprSub {
+    static Complex Apply(const Complex& a, const Complex& b) noexcept { return a - b; }
+};
+struct ExprMul {
+    static Complex Apply(const Complex& a, const Complex& b) noexcept { return a * b; }
+};
+struct ExprDiv {
+    static Complex Apply(const Complex& a, const Complex& b) noexcept { return a / b; }
+};
+struct ExprNeg {
+    static Complex Apply(const Complex& a) noexcept { return Complex(-a.Re(), -a.Im()); }
+};
+struct ExprConj {
+    static Complex Apply(const Complex& a) noexcept { return Complex(a.Re(), -a.Im()); }
+};
+
+// Приведение операндов к узлам: массив — ArrayRef, выражение — само себя,
+// Complex и числа — ScalarExpr.
+inline ArrayRef AsExprNode(const ComplexArray& a) noexcept { return ArrayRef(a); }
+template <class E>
+const E& AsExprNode(const ArrayExpr<E>& e) noexcept { return e.Self(); }
+inline ScalarExpr AsExprNode(const Complex& c) noexcept { return ScalarExpr(c); }
+inline ScalarExpr AsExprNode(double x) noexcept { return ScalarExpr(Complex(x)); }
+
+/** Массив или выражение над массивами */
+template <class T>
+struct IsArrayOperand
+    : integral_constant<bool, is_same<T, ComplexArray>::value || is_base_of<ArrayExpr<T>, T>::value> {};
+
+/** Допустимый операнд: массив, выражение, Complex или число */
+template <class T>
+struct IsExprOperand
+    : integral_constant<bool, IsArrayOperand<T>::value || is_same<T, Complex>::value || is_arithmetic<T>::value> {};
+
+/** Тип узла для операнда T */
+template <class T>
+using ExprNodeOf = typename decay<decltype(AsExprNode(declval<const T&>()))>::type;
+
+/** Операторы участвуют в перегрузке, только если хотя бы один операнд — массив */
+template <class L, class R>
+using EnableArrayOp = typename enable_if<(IsArrayOperand<L>::value || IsArrayOperand<R>::value) &&
+                                         IsExprOperand<L>::value && IsExprOperand<R>::value>::type;
+
+template <class L, class R, class = EnableArrayOp<L, R>>
+BinaryExpr<ExprAdd, ExprNodeOf<L>, ExprNodeOf<R>> operator+(const L& l, const R& r) {
+    return BinaryExpr<ExprAdd, ExprNodeOf<L>, ExprNodeOf<R>>(AsExprNode(l), AsExprNode(r));
+}
+
+template <class L, class R, class = EnableArrayOp<L, R>>
+BinaryExpr<ExprSub, ExprNodeOf<L>, ExprNodeOf<R>> operator-(const L& l, const R& r) {
+    return BinaryExpr<ExprSub, ExprNodeOf<L>, ExprNodeOf<R>>(AsExprNode(l), AsExprNode(r));
+}
+
+template <class L, class R, class = EnableArrayOp<L, R>>
+BinaryExpr<ExprMul, ExprNodeOf<L>, ExprNodeOf<R>> operator*(const L& l, const R& r) {
+    return BinaryExpr<ExprMul, ExprNodeOf<L>, ExprNodeOf<R>>(AsExprNode(l), AsExprNode(r));
+}
+
+template <class L, class R, class = EnableArrayOp<L, R>>
+BinaryExpr<ExprDiv, ExprNodeOf<L>, ExprNodeOf<R>> operator/(const L& l, const R& r) {
+    return BinaryExpr<ExprDiv, ExprNodeOf<L>, ExprNodeOf<R>>(AsExprNode(l), AsExprNode(r));
+}
+
+template <class A, class = typename enable_if<IsArrayOperand<A>::value>::type>
+UnaryExpr<ExprNeg, ExprNodeOf<A>> operator-(const A& a) {
+    return UnaryExpr<ExprNeg, ExprNodeOf<A>>(AsExprNode(a));
+}
+
+/**
+ * @brief Ленивое сопряжение массива или выражения
+ */
+template <class A, class = typename enable_if<IsArrayOperand<A>::value>::type>
+UnaryExpr<ExprConj, ExprNodeOf<A>> Conj(const A& a) {
+    return UnaryExpr<ExprConj, ExprNodeOf<A>>(AsExprNode(a));
+}
+
+/**
+ * @brief Вычисляет выражение одним циклом: assign(re[i], im[i], expr[i]).
+ *
+ * Цикл разбит на блоки фиксированной длины: такой внутренний цикл GCC
+ * векторизует и при -O2 (дешёвой модели стоимости не нужен хвост), а ivdep
+ * снимает проверки пересечения выхода с операндами — выражение
+ * поэлементное, поэтому запись в операнд безопасна.
+ */
+template <class E, class Assign>
+void EvaluateExpr(const E& expr, double* re, double* im, size_t n, Assign assign) {
+    const size_t kBlock = 8;
+    size_t i = 0;
+    for (; i + kBlock <= n; i += kBlock) {
+#pragma GCC ivdep
+        for (size_t j = i; j < i + kBlock; ++j) {
+            assign(re[j], im[j], expr[j]);
+        }
+    }
+    for (; i < n; ++i) {
+        assign(re[i], im[i], expr[i]);
+    }
+}
+
+template <class E>
+ComplexArray::ComplexArray(const ArrayExpr<E>& expr) {
+    Allocate(expr.Self().Size());
+    *this = expr;
+}
+
+template <class E>
+ComplexArray& ComplexArray::operator=(const ArrayExpr<E>& expr) {
+    static_assert(!E::kScalar, "ComplexArray: в выражении нет ни одного массива");
+    const E& e = expr.Self();
+    Resize(e.Size());
+    EvaluateExpr(e, re_, im_, size_, [](double& re, double& im, const Complex& v) {
+        re = v.Re();
+        im = v.Im();
+    });
+    return *this;
+}
+
+template <class E>
+ComplexArray& ComplexArray::operator+=(const ArrayExpr<E>& expr) {
+    return *this = *this + expr.Self();
+}
+
+template <class E>
+ComplexArray& ComplexArray::operator-=(const ArrayExpr<E>& expr) {
+    return *this = *this - expr.Self();
+}
+
+template <class E>
+ComplexArray& ComplexArray::operator*=(const ArrayExpr<E>& expr) {
+    return *this = *this * expr.Self();
+}
+
+#endif // COMPLEX_EXPR_H
@@ -0,0 +1,455 @@
+#include "complexfile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "profile.h"
+
+using namespace std;
+
+namespace {
+
+const char kMagic[8] = {'C', 'P', 'L', 'X', 'D', 'A', 'T', 'A'};
+
+/** Смещение данных и выравнивание мнимых частей Split */
+const uint64_t kDataAlignment = 64;
+
+/** Размер буферов записи */
+const size_t kWriteBuffer = 1 << 20;
+
+uint8_t NativeEndian() {
+    const uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    return first == 1 ? 0 : 1;
+}
+
+uint32_t SwapBytes(uint32_t x) {
+    return __builtin_bswap32(x);
+}
+
+uint64_t SwapBytes(uint64_t x) {
+    return __builtin_bswap64(x);
+}
+
+void SwapHeader(ComplexFileHeader& h) {
+    h.version = SwapBytes(h.version);
+    h.count = SwapBytes(h.count);
+    h.dataOffset = SwapBytes(h.dataOffset);
+    h.imOffset = SwapBytes(h.imOffset);
+}
+
+uint64_t AlignUp(uint64_t x) {
+    return (x + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+
+/**
+ * @brief Читает число типа T из файла, при необходимости переставляя байты
+ */
+template <class T>
+double LoadPart(const char* p, bool swap) {
+    char bytes[sizeof(T)];
+    if (swap) {
+        reverse_copy(p, p + sizeof(T), bytes);
+        p = bytes;
+    }
+    T x;
+    memcpy(&x, p, sizeof(T));
+    return x;
+}
+
+/**
+ * @brief Преобразует n элементов файла в outRe/outIm с шагом stride.
+ * step — шаг между соседними элементами в файле в байтах.
+ */
+template <class T>
+void LoadParts(const char* re, const char* im, size_t step, bool swap, size_t n,
+               double* outRe, double* outIm, size_t stride) {
+    for (size_t i = 0; i < n; ++i) {
+        outRe[i * stride] = LoadPart<T>(re + i * step, swap);
+        outIm[i * stride] = LoadPart<T>(im + i * step, swap);
+    }
+}
+
+ComplexFileHeader MakeHeader(ComplexLayout layout, ComplexDType dtype) {
+    ComplexFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kComplexFileVersion;
+    h.layout = uint8_t(layout);
+    h.dtype = uint8_t(dtype);
+    h.endian = NativeEndian();
+    h.dataOffset = kDataAlignment;
+    return h;
+}
+
+/**
+ * @brief Проверяет заголовок; возвращает, нужна ли перестановка байтов
+ */
+bool CheckHeader(ComplexFileHeader& h, const string& path) {
+    if (memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw runtime_error("ComplexFile: " + path + " — не файл комплексных чисел");
+    }
+    if (h.endian > 1) {
+        throw runtime_error("ComplexFile: " + path + " — неизвестный порядок байтов");
+    }
+    bool swap = h.endian != NativeEndian();
+    if (swap) {
+        SwapHeader(h);
+    }
+    if (h.version == 0 || h.version > kComplexFileVersion) {
+        throw runtime_error("ComplexFile: " + path + " — неподдерживаемая версия " + to_string(h.version));
+    }
+    if (h.layout > uint8_t(ComplexLayout::Split) || h.dtype > uint8_t(ComplexDType::F32)) {
+        throw runtime_error("ComplexFile: " + path + " — неизвестная раскладка или тип данных");
+    }
+    return swap;
+}
+
+} // namespace
+
+/**
+ * @brief Открывает и проверяет файл
+ */
+ComplexFile::ComplexFile(const string& path) : file_(path) {
+    if (file_.Size() < sizeof(ComplexFileHeader)) {
+        throw runtime_error("ComplexFile: " + path + " — файл короче заголовка");
+    }
+    memcpy(&header_, file_.Data(), sizeof(header_));
+    nativeEndian_ = !CheckHeader(header_, path);
+
+    // Данные должны помещаться в файл; count проверяется первым, чтобы
+    // произведения ниже не переполнялись.
+    uint64_t size = file_.Size(), es = ElementSize();
+    bool ok = header_.dataOffset >= sizeof(ComplexFileHeader) && header_.dataOffset <= size &&
+              header_.count <= (size - header_.dataOffset) / (2 * es);
+    if (ok && Layout() == ComplexLayout::Split) {
+        ok = header_.imOffset >= header_.dataOffset + header_.count * es && header_.imOffset <= size &&
+             header_.count <= (size - header_.imOffset) / es;
+    }
+    if (!ok) {
+        throw runtime_error("ComplexFile: " + path + " — данные не помещаются в файл");
+    }
+    // Начало отображения выровнено на страницу, так что кратное размеру
+    // части смещение даёт выровненные double и Complex для View и SplitView.
+    static_assert(alignof(Complex) <= sizeof(double), "Complex выровнен сильнее double");
+    if (header_.dataOffset % es != 0 || header_.imOffset % es != 0) {
+        throw runtime_error("ComplexFile: " + path + " — данные не выровнены");
+    }
+}
+
+/**
+ * @brief Размер одной части (re или im) в байтах
+ */
+size_t ComplexFile::ElementSize() const noexcept {
+    return DType() == ComplexDType::F32 ? sizeof(float) : sizeof(double);
+}
+
+void ComplexFile::RequireZeroCopy(ComplexLayout layout) const {
+    if (Layout() != layout) {
+        throw runtime_error("ComplexFile: раскладка файла не подходит для этого представления");
+    }
+    if (!IsZeroCopy()) {
+        throw runtime_error("ComplexFile: данные f32 или в чужом порядке байтов читаются только с копированием");
+    }
+}
+
+/**
+ * @brief Данные файла Interleaved как массив Complex, без копирования
+ */
+ComplexView ComplexFile::View() const {
+    RequireZeroCopy(ComplexLayout::Interleaved);
+    return ComplexView(reinterpret_cast<const Complex*>(file_.Data() + header_.dataOffset), Count());
+}
+
+/**
+ * @brief Данные файла Split как ComplexArray, не владеющий данными
+ */
+ComplexArray ComplexFile::SplitView() {
+    RequireZeroCopy(ComplexLayout::Split);
+    file_.EnableCopyOnWrite();
+    char* base = file_.MutableData();
+    return ComplexArray::Wrap(reinterpret_cast<double*>(base + header_.dataOffset),
+                              reinterpret_cast<double*>(base + header_.imOffset), Count());
+}
+
+/**
+ * @brief Читает элементы [first, first + n) с преобразованием в Complex
+ */
+void ComplexFile::Read(size_t first, size_t n, Complex* out) const {
+    COMPLEX_PROFILE_KERNEL("file.read", n);
+    if (first > Count() || n > Count() - first) {
+        throw out_of_range("ComplexFile::Read: диапазон за пределами файла");
+    }
+    double* re = reinterpret_cast<double*>(out);
+    size_t es = ElementSize();
+    const char* base = file_.Data() + header_.dataOffset;
+    if (Layout() == ComplexLayout::Interleaved && IsZeroCopy()) {
+        memcpy(out, base + first * 2 * es, n * sizeof(Complex));
+        return;
+    }
+    const char* fileRe;
+    const char* fileIm;
+    size_t step;
+    if (Layout() == ComplexLayout::Interleaved) {
+        fileRe = base + first * 2 * es;
+        fileIm = fileRe + es;
+        step = 2 * es;
+    } else {
+        fileRe = base + first * es;
+        fileIm = file_.Data() + header_.imOffset + first * es;
+        step = es;
+    }
+    if (DType() == ComplexDType::F32) {
+        LoadParts<float>(fileRe, fileIm, step, !nativeEndian_, n, re, re + 1, 2);
+    } else {
+        LoadParts<double>(fileRe, fileIm, step, !nativeEndian_, n, re, re + 1, 2);
+    }
+}
+
+/**
+ * @brief Копия всех данных в вектор
+ */
+vector<Complex> ComplexFile::ToVector() const {
+    vector<Complex> out(Count());
+    Read(0, Count(), out.data());
+    return out;
+}
+
+/**
+ * @brief Копия всех данных в ComplexArray
+ */
+ComplexArray ComplexFile::ToArray() const {
+    ComplexArray out(Count());
+    size_t es = ElementSize();
+    const char* base = file_.Data() + header_.dataOffset;
+    if (Layout() == ComplexLayout::Split && IsZeroCopy()) {
+        memcpy(out.Re(), base, Count() * sizeof(double));
+        memcpy(out.Im(), file_.Data() + header_.imOffset, Count() * sizeof(double));
+        return out;
+    }
+    const char* fileIm = Layout() == ComplexLayout::Split ? file_.Data() + header_.imOffset : base + es;
+    size_t step = Layout() == ComplexLayout::Split ? es : 2 * es;
+    if (DType() == ComplexDType::F32) {
+        LoadParts<float>(base, fileIm, step, !nativeEndian_, Count(), out.Re(), out.Im(), 1);
+    } else {
+        LoadParts<double>(base, fileIm, step, !nativeEndian_, Count(), out.Re(), out.Im(), 1);
+    }
+    return out;
+}
+
+/**
+ * @brief Открывает файл для записи
+ */
+ComplexFileWriter::ComplexFileWriter(const string& path, ComplexLayout layout, ComplexDType dtype,
+                                     ComplexFileMode mode)
+    : path_(path), header_(MakeHeader(layout, dtype)), open_(false) {
+    ios::openmode io = ios::in | ios::out | ios::binary;
+    if (mode == ComplexFileMode::Append) {
+        file_.open(path, io);
+    }
+    if (file_.is_open()) {
+        OpenExisting();
+    } else {
+        file_.open(path, io | ios::trunc);
+        if (!file_) {
+            throw runtime_error("ComplexFileWriter: не удалось создать " + path);
+        }
+        WriteHeader();
+        if (layout == ComplexLayout::Split) {
+            imFile_.open(path + ".im", io | ios::trunc);
+        }
+    }
+    if (layout == ComplexLayout::Split && !imFile_) {
+        throw runtime_error("ComplexFileWriter: не удалось создать " + path + ".im");
+    }
+    open_ = true;
+}
+
+/**
+ * @brief Дописывание: читает заголовок, встаёт в конец данных
+ */
+void ComplexFileWriter::OpenExisting() {
+    ComplexFileHeader existing;
+    if (!file_.read(reinterpret_cast<char*>(&existing), sizeof(existing))) {
+        throw runtime_error("ComplexFileWriter: " + path_ + " — файл короче заголовка");
+    }
+    if (CheckHeader(existing, path_)) {
+        throw runtime_error("ComplexFileWriter: " + path_ + " — дописывание в чужом порядке байтов не поддерживается");
+    }
+    if (existing.layout != header_.layout || existing.dtype != header_.dtype) {
+        throw runtime_error("ComplexFileWriter: " + path_ + " — раскладка или тип данных не совпадают с файлом");
+    }
+    header_ = existing;
+    size_t es = ElementSize();
+    if (ComplexLayout(header_.layout) == ComplexLayout::Split) {
+        // Мнимые части уходят во временный файл: новые действительные
+        // части лягут поверх них.
+        imFile_.open(path_ + ".im", ios::in | ios::out | ios::binary | ios::trunc);
+        file_.seekg(header_.imOffset);
+        vector<char> chunk(kWriteBuffer);
+        for (uint64_t left = header_.count * es; left && imFile_;) {
+            size_t m = size_t(min<uint64_t>(left, chunk.size()));
+            if (!file_.read(chunk.data(), m)) {
+                throw runtime_error("ComplexFileWriter: " + path_ + " — файл обрезан");
+            }
+            imFile_.write(chunk.data(), m);
+            left -= m;
+        }
+        file_.seekp(header_.dataOffset + header_.count * es);
+    } else {
+        file_.seekp(header_.dataOffset + header_.count * 2 * es);
+    }
+}
+
+/**
+ * @brief Деструктор: закрывает файл
+ */
+ComplexFileWriter::~ComplexFileWriter() {
+    try {
+        Close();
+    } catch (...) {
+    }
+}
+
+size_t ComplexFileWriter::ElementSize() const noexcept {
+    return ComplexDType(header_.dtype) == ComplexDType::F32 ? sizeof(float) : sizeof(double);
+}
+
+/**
+ * @brief Переписывает заголовок и возвращается к концу данных
+ */
+void ComplexFileWriter::WriteHeader() {
+    streamoff end = max<streamoff>(file_.tellp(), sizeof(header_));
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    file_.seekp(end);
+}
+
+void ComplexFileWriter::FlushBuffers() {
+    file_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+    if (imFile_.is_open()) {
+        imFile_.write(imBuffer_.data(), imBuffer_.size());
+        imBuffer_.clear();
+    }
+    if (!file_ || (imFile_.is_open() && !imFile_)) {
+        throw runtime_error("ComplexFileWriter: ошибка записи в " + path_);
+    }
+}
+
+/**
+ * @brief Дописывает n элементов из re/im с шагом stride, преобразуя в T
+ */
+template <class T>
+void ComplexFileWriter::Append(const double* re, const double* im, size_t stride, size_t n) {
+    bool split = ComplexLayout(header_.layout) == ComplexLayout::Split;
+    const size_t kChunk = kWriteBuffer / (2 * sizeof(T));
+    while (n) {
+        size_t m = min(n, kChunk);
+        size_t old = buffer_.size();
+        if (split) {
+            buffer_.resize(old + m * sizeof(T));
+            imBuffer_.resize(old + m * sizeof(T));  // буферы Split растут и сбрасываются вместе
+            for (size_t i = 0; i < m; ++i) {
+                T r = T(re[i * stride]), j = T(im[i * stride]);
+                memcpy(&buffer_[old + i * sizeof(T)], &r, sizeof(T));
+                memcpy(&imBuffer_[old + i * sizeof(T)], &j, sizeof(T));
+            }
+        } else {
+            buffer_.resize(old + 2 * m * sizeof(T));
+            for (size_t i = 0; i < m; ++i) {
+                T part[2] = {T(re[i * stride]), T(im[i * stride])};
+                memcpy(&buffer_[old + 2 * i * sizeof(T)], part, sizeof(part));
+            }
+        }
+        header_.count += m;
+        re += m * stride;
+        im += m * stride;
+        n -= m;
+        if (buffer_.size() >= kWriteBuffer) {
+            FlushBuffers();
+        }
+    }
+}
+
+/**
+ * @brief Дописывает элементы
+ */
+void ComplexFileWriter::Write(const Complex* src, size_t n) {
+    COMPLEX_PROFILE_KERNEL("file.write", n);
+    if (!open_) {
+        throw runtime_error("ComplexFileWriter: файл уже закрыт");
+    }
+    const double* re = reinterpret_cast<const double*>(src);
+    if (ComplexDType(header_.dtype) == ComplexDType::F32) {
+        Append<float>(re, re + 1, 2, n);
+    } else {
+        Append<double>(re, re + 1, 2, n);
+    }
+}
+
+/**
+ * @brief Дописывает элементы массива
+ */
+void ComplexFileWriter::Write(const ComplexArray& src) {
+    if (!open_) {
+        throw runtime_error("ComplexFileWriter: файл уже закрыт");
+    }
+    if (ComplexDType(header_.dtype) == ComplexDType::F32) {
+        Append<float>(src.Re(), src.Im(), 1, src.Size());
+    } else {
+        Append<double>(src.Re(), src.Im(), 1, src.Size());
+    }
+}
+
+/**
+ * @brief Сбрасывает буферы на диск и (для Interleaved) обновляет заголовок
+ */
+void ComplexFileWriter::Flush() {
+    if (!open_) {
+        return;
+    }
+    FlushBuffers();
+    if (ComplexLayout(header_.layout) == ComplexLayout::Interleaved) {
+        WriteHeader();
+    }
+    file_.flush();
+}
+
+/**
+ * @brief Завершает файл: переносит мнимые части Split, пишет заголовок
+ */
+void ComplexFileWriter::Close() {
+    if (!open_) {
+        return;
+    }
+    open_ = false;
+    FlushBuffers();
+    if (ComplexLayout(header_.layout) == ComplexLayout::Split) {
+        uint64_t reEnd = header_.dataOffset + header_.count * ElementSize();
+        header_.imOffset = AlignUp(reEnd);
+        vector<char> chunk(kWriteBuffer, 0);
+        file_.write(chunk.data(), header_.imOffset - reEnd);
+        imFile_.seekg(0);
+        while (imFile_.read(chunk.data(), chunk.size()) || imFile_.gcount()) {
+            file_.write(chunk.data(), imFile_.gcount());
+        }
+        imFile_.close();
+        remove((path_ + ".im").c_str());
+    }
+    WriteHeader();
+    file_.close();
+    if (!file_) {
+        throw runtime_error("ComplexFileWriter: ошибка записи в " + path_);
+    }
+}
+
+/**
+ * @brief Записывает массив в новый файл целиком
+ */
+void WriteComplexFile(const string& path, const Complex* src, size_t n, ComplexLayout layout, ComplexDType dtype) {
+    ComplexFileWriter writer(path, layout, dtype);
+    writer.Write(src, n);
+    writer.Close();
+}
@@ -0,0 +1,245 @@
+#ifndef COMPLEX_FILE_H
+#define COMPLEX_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "complexarray.h"
+#include "mappedfile.h"
+#include "mycomplex.h"
+
+// Двоичный формат для обмена массивами Complex между этапами обработки.
+//
+// Файл начинается с заголовка в 64 байта (ComplexFileHeader), данные
+// лежат сразу за ним и выровнены на 64 байта. Поля заголовка записаны в
+// порядке байтов, указанном в самом заголовке (байт endian читается
+// одинаково при любом порядке). Раскладка данных:
+//
+//     Interleaved:  re0 im0 re1 im1 ...              начиная с dataOffset
+//     Split:        re0 re1 ... | выравнивание | im0 im1 ...   (im с imOffset)
+//
+// Файл с f64 в родном порядке байтов читается без копирования: ComplexFile
+// отображает его в память и отдаёт данные как массив Complex или как пару
+// массивов re/im. Остальные файлы (f32, чужой порядок байтов) читаются с
+// преобразованием — целиком или кусками.
+
+/**
+ * @brief Раскладка комплексных чисел в файле.
+ */
+enum class ComplexLayout : uint8_t {
+    Interleaved = 0,  /**< Пары re, im подряд, как в массиве Complex.*/
+    Split = 1         /**< Все re, затем все im, как в ComplexArray.*/
+};
+
+/**
+ * @brief Тип частей комплексного числа в файле.
+ */
+enum class ComplexDType : uint8_t {
+    F64 = 0,  /**< double*/
+    F32 = 1   /**< float (при записи округляется)*/
+};
+
+/**
+ * @brief Заголовок файла, 64 байта.
+ */
+struct ComplexFileHeader {
+    char magic[8];        /**< "CPLXDATA"*/
+    uint32_t version;     /**< Версия формата (kComplexFileVersion).*/
+    uint8_t layout;       /**< ComplexLayout*/
+    uint8_t dtype;        /**< ComplexDType*/
+    uint8_t endian;       /**< 0 — little endian, 1 — big endian.*/
+    uint8_t reserved0;    /**< Нули.*/
+    uint64_t count;       /**< Число комплексных элементов.*/
+    uint64_t dataOffset;  /**< Смещение данных (для Split — действительных частей).*/
+    uint64_t imOffset;    /**< Смещение мнимых частей (только Split, иначе 0).*/
+    uint8_t reserved[24]; /**< Нули; место для полей следующих версий.*/
+};
+
+static_assert(sizeof(ComplexFileHeader) == 64, "заголовок файла должен занимать 64 байта");
+
+/** Текущая версия формата */
+const uint32_t kComplexFileVersion = 1;
+
+/**
+ * @brief Массив Complex без владения данными (отображение файла).
+ */
+class ComplexView {
+private:
+    const Complex* data_;  /**< Начало.*/
+    size_t size_;          /**< Число элементов.*/
+
+public:
+    ComplexView(const Complex* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    const Complex* Data() const noexcept { return data_; }
+    size_t Size() const noexcept { return size_; }
+    const Complex& operator[](size_t i) const noexcept { return data_[i]; }
+    const Complex* begin() const noexcept { return data_; }
+    const Complex* end() const noexcept { return data_ + size_; }
+};
+
+/**
+ * @brief Файл с комплексными числами, отображённый в память.
+ *
+ * Открытие не читает данные: стоимость не зависит от размера файла,
+ * страницы подгружаются при первом обращении. Файл отображается только
+ * для чтения, поэтому не занимает выделенной памяти и файл больше
+ * свободной памяти тоже открывается. Первый SplitView переводит
+ * отображение в копирование при записи: массив можно менять на месте, файл
+ * на диске от этого не меняется, но ОС учитывает в выделенной памяти весь
+ * файл.
+ */
+class ComplexFile {
+private:
+    MappedFile file_;           /**< Отображение файла.*/
+    ComplexFileHeader header_;  /**< Заголовок в родном порядке байтов.*/
+    bool nativeEndian_;         /**< Совпадает ли порядок байтов данных с родным.*/
+
+    size_t ElementSize() const noexcept;
+    void RequireZeroCopy(ComplexLayout layout) const;
+
+public:
+    /**
+    * @brief Открывает и проверяет файл
+    * @param path Путь к файлу
+    * @throws runtime_error, если файл не открывается, заголовок некорректен
+    * или смещения частей не кратны их размеру
+    */
+    explicit ComplexFile(const string& path);
+
+    size_t Count() const noexcept { return header_.count; }
+    ComplexLayout Layout() const noexcept { return ComplexLayout(header_.layout); }
+    ComplexDType DType() const noexcept { return ComplexDType(header_.dtype); }
+    bool IsNativeEndian() const noexcept { return nativeEndian_; }
+
+    /**
+    * @brief Можно ли читать без копирования (f64 в родном порядке байтов)
+    */
+    bool IsZeroCopy() const noexcept { return nativeEndian_ && DType() == ComplexDType::F64; }
+
+    /**
+    * @brief Данные файла Interleaved как массив Complex, без копирования
+    * @throws runtime_error, если раскладка другая или !IsZeroCopy()
+    */
+    ComplexView View() const;
+
+    /**
+    * @brief Данные файла Split как ComplexArray, не владеющий данными (ComplexArray::Wrap).
+    * Массив действителен, пока жив ComplexFile. Первый вызов переводит
+    * отображение в копирование при записи (MappedFile::EnableCopyOnWrite).
+    * @throws runtime_error, если раскладка другая, !IsZeroCopy() или ОС не
+    * выделяет память под копирование при записи
+    */
+    ComplexArray SplitView();
+
+    /**
+    * @brief Читает элементы [first, first + n) с преобразованием в Complex.
+    * Работает для любого файла; удобно для обработки больших f32 файлов кусками.
+    * @throws out_of_range, если диапазон выходит за Count()
+    */
+    void Read(size_t first, size_t n, Complex* out) const;
+
+    /**
+    * @brief Копия всех данных в вектор
+    */
+    vector<Complex> ToVector() const;
+
+    /**
+    * @brief Копия всех данных в ComplexArray
+    */
+    ComplexArray ToArray() const;
+};
+
+/**
+ * @brief Режим открытия файла для записи.
+ */
+enum class ComplexFileMode {
+    Create,  /**< Создать новый файл (существующий перезаписывается).*/
+    Append   /**< Дописать в существующий файл (или создать, если его нет).*/
+};
+
+/**
+ * @brief Запись файла кусками.
+ *
+ * Данные копятся в буфере и сбрасываются на диск крупными блоками.
+ * Interleaved файл после Flush уже корректен и читается ComplexFile. У
+ * Split файла мнимые части до Close пишутся во временный файл рядом
+ * (path + ".im") и переносятся на место при закрытии; дописывание в Split
+ * файл поэтому сначала выносит во временный файл его мнимые части.
+ */
+class ComplexFileWriter {
+private:
+    string path_;               /**< Путь к файлу.*/
+    fstream file_;              /**< Основной файл.*/
+    fstream imFile_;            /**< Временный файл мнимых частей (Split).*/
+    ComplexFileHeader header_;  /**< Заголовок (count — уже записанные элементы).*/
+    vector<char> buffer_;       /**< Буфер основного файла.*/
+    vector<char> imBuffer_;     /**< Буфер мнимых частей (Split).*/
+    bool open_;                 /**< Открыт ли файл.*/
+
+    size_t ElementSize() const noexcept;
+    void OpenExisting();
+    void WriteHeader();
+    void FlushBuffers();
+    template <class T>
+    void Append(const double* re, const double* im, size_t stride, size_t n);
+
+public:
+    /**
+    * @brief Открывает файл для записи
+    * @param path Путь к файлу
+    * @param layout Раскладка нового файла
+    * @param dtype Тип частей нового файла
+    * @param mode Создать или дописать; при дописывании раскладка и тип
+    * должны совпадать с файлом
+    * @throws runtime_error при ошибке ввода-вывода, несовпадении формата
+    * или чужом порядке байтов дописываемого файла
+    */
+    ComplexFileWriter(const string& path, ComplexLayout layout = ComplexLayout::Interleaved,
+                      ComplexDType dtype = ComplexDType::F64, ComplexFileMode mode = ComplexFileMode::Create);
+
+    /**
+    * @brief Деструктор: закрывает файл; ошибки закрытия при этом теряются,
+    * поэтому для их обработки надо вызывать Close явно
+    */
+    ~ComplexFileWriter();
+
+    ComplexFileWriter(const ComplexFileWriter&) = delete;
+    ComplexFileWriter& operator=(const ComplexFileWriter&) = delete;
+
+    /**
+    * @brief Дописывает элементы
+    */
+    void Write(const Complex* src, size_t n);
+
+    /**
+    * @brief Дописывает элементы массива
+    */
+    void Write(const ComplexArray& src);
+
+    /**
+    * @brief Сбрасывает буферы на диск и (для Interleaved) обновляет заголовок
+    */
+    void Flush();
+
+    /**
+    * @brief Завершает файл: переносит мнимые части Split, пишет заголовок
+    * @throws runtime_error при ошибке ввода-вывода
+    */
+    void Close();
+
+    /**
+    * @brief Число элементов в файле вместе с записанными
+    */
+    size_t Count() const noexcept { return header_.count; }
+};
+
+/**
+ * @brief Записывает массив в новый файл целиком
+ */
+void WriteComplexFile(const string& path, const Complex* src, size_t n,
+                      ComplexLayout layout = ComplexLayout::Interleaved, ComplexDType dtype = ComplexDType::F64);
+
+#endif // COMPLEX_FILE_H
@@ -0,0 +1,255 @@
+#include "complexio.h"
+#include <cmath>
+#include <fstream>
+#include "mappedfile.h"
+#include "profile.h"
+
+using namespace std;
+
+namespace {
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+const char* SkipSpace(const char* p, const char* last) {
+    while (p != last && IsSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief from_chars с необязательным '+' впереди (from_chars его не принимает).
+ * При ошибке ptr указывает на начало числа.
+ */
+from_chars_result ParseReal(const char* p, const char* last, double& x) {
+    const char* start = p;
+    if (p != last && *p == '+') {
+        ++p;
+        if (p != last && (*p == '+' || *p == '-')) {
+            return {start, errc::invalid_argument};
+        }
+    }
+    from_chars_result r = from_chars(p, last, x);
+    if (r.ec != errc()) {
+        r.ptr = start;
+    }
+    return r;
+}
+
+from_chars_result Fail(const char* p) {
+    return {p, errc::invalid_argument};
+}
+
+/**
+ * @brief Дописывает символ, если есть место
+ */
+bool PutChar(char*& p, char* last, char c) {
+    if (p == last) {
+        return false;
+    }
+    *p++ = c;
+    return true;
+}
+
+bool PutDouble(char*& p, char* last, double x) {
+    to_chars_result r = to_chars(p, last, x);
+    p = r.ptr;
+    return r.ec == errc();
+}
+
+string ParseErrorMessage(errc ec, size_t offset) {
+    const char* what = ec == errc::result_out_of_range ? "число вне диапазона double" : "некорректное число";
+    return string("ParseComplexText: ") + what + " на смещении " + to_string(offset);
+}
+
+} // namespace
+
+/**
+ * @brief Разбирает одно число в любой из трёх записей
+ */
+from_chars_result FromChars(const char* first, const char* last, Complex& value) {
+    COMPLEX_PROFILE_OP(Read);
+    double re, im;
+    if (first == last) {
+        return Fail(first);
+    }
+    if (*first == '(') {
+        from_chars_result r = ParseReal(SkipSpace(first + 1, last), last, re);
+        if (r.ec != errc()) {
+            return r;
+        }
+        const char* p = SkipSpace(r.ptr, last);
+        if (p == last || *p != ',') {
+            return Fail(p);
+        }
+        r = ParseReal(SkipSpace(p + 1, last), last, im);
+        if (r.ec != errc()) {
+            return r;
+        }
+        p = SkipSpace(r.ptr, last);
+        if (p == last || *p != ')') {
+            return Fail(p);
+        }
+        value = Complex(re, im);
+        return {p + 1, errc()};
+    }
+
+    from_chars_result r = ParseReal(first, last, re);
+    if (r.ec != errc()) {
+        return r;
+    }
+    const char* p = r.ptr;
+    if (p != last && *p == 'i') {
+        value = Complex(0.0, re);
+        return {p + 1, errc()};
+    }
+    if (p != last && (*p == '+' || *p == '-')) {
+        // Алгебраическая запись: знак мнимой части стоит вплотную к действительной.
+        r = ParseReal(p, last, im);
+        if (r.ec != errc()) {
+            return r;
+        }
+        if (r.ptr == last || *r.ptr != 'i') {
+            return Fail(r.ptr);
+        }
+        value = Complex(re, im);
+        return {r.ptr + 1, errc()};
+    }
+
+    // Пара "a b": между частями обязателен хотя бы один пробельный символ.
+    const char* q = SkipSpace(p, last);
+    if (q == p) {
+        return Fail(p);
+    }
+    r = ParseReal(q, last, im);
+    if (r.ec != errc()) {
+        return r;
+    }
+    value = Complex(re, im);
+    return r;
+}
+
+/**
+ * @brief Разбирает подряд идущие числа, пока не кончится текст или место в out
+ */
+ComplexParseResult ParseComplex(const char* first, const char* last, Complex* out, size_t capacity) {
+    const char* p = SkipSpace(first, last);
+    size_t count = 0;
+    while (p != last && count < capacity) {
+        from_chars_result r = FromChars(p, last, out[count]);
+        if (r.ec != errc()) {
+            return {r.ptr, count, r.ec};
+        }
+        if (r.ptr != last && !IsSpace(*r.ptr)) {
+            return {r.ptr, count, errc::invalid_argument};
+        }
+        ++count;
+        p = SkipSpace(r.ptr, last);
+    }
+    return {p, count, errc()};
+}
+
+/**
+ * @brief Разбирает весь текст в вектор
+ */
+vector<Complex> ParseComplexText(const char* first, const char* last) {
+    COMPLEX_PROFILE_KERNEL("io.parse", last - first);
+    // Кратчайшая запись double — обычно 17-20 символов, так что на число
+    // уходит не меньше ~32 байт; дальше вектор при нехватке удваивается.
+    vector<Complex> out(static_cast<size_t>(last - first) / 32 + 16);
+    size_t count = 0;
+    const char* p = first;
+    for (;;) {
+        ComplexParseResult r = ParseComplex(p, last, out.data() + count, out.size() - count);
+        count += r.count;
+        if (r.ec != errc()) {
+            size_t offset = static_cast<size_t>(r.ptr - first);
+            throw ComplexParseError(ParseErrorMessage(r.ec, offset), offset);
+        }
+        if (r.ptr == last) {
+            break;
+        }
+        p = r.ptr;
+        out.resize(out.size() * 2);
+    }
+    out.resize(count);
+    return out;
+}
+
+/**
+ * @brief Читает текстовый файл с числами через отображение в память
+ */
+vector<Complex> ReadComplexText(const string& path) {
+    MappedFile file(path);
+    return ParseComplexText(file.begin(), file.end());
+}
+
+/**
+ * @brief Печатает одно число кратчайшей точной записью
+ */
+to_chars_result ToChars(char* first, char* last, const Complex& value, ComplexTextFormat format) {
+    COMPLEX_PROFILE_OP(Write);
+    char* p = first;
+    bool ok;
+    switch (format) {
+    case ComplexTextFormat::Pair:
+        ok = PutDouble(p, last, value.Re()) && PutChar(p, last, ' ') && PutDouble(p, last, value.Im());
+        break;
+    case ComplexTextFormat::Tuple:
+        ok = PutChar(p, last, '(') && PutDouble(p, last, value.Re()) && PutChar(p, last, ',') &&
+             PutDouble(p, last, value.Im()) && PutChar(p, last, ')');
+        break;
+    default:
+        // Знак берётся из знакового бита, а не из im >= 0: так -0 и -nan
+        // печатаются как "-0i" и "-nani" и читаются обратно без потерь.
+        ok = PutDouble(p, last, value.Re()) && (signbit(value.Im()) || PutChar(p, last, '+')) &&
+             PutDouble(p, last, value.Im()) && PutChar(p, last, 'i');
+        break;
+    }
+    if (!ok) {
+        return {last, errc::value_too_large};
+    }
+    return {p, errc()};
+}
+
+/**
+ * @brief Печатает числа подряд, каждое с разделителем после него
+ */
+ComplexFormatResult FormatComplex(const Complex* src, size_t n, char* first, char* last,
+                                  ComplexTextFormat format, char separator) {
+    COMPLEX_PROFILE_KERNEL("io.format", n);
+    char* p = first;
+    size_t count = 0;
+    for (; count < n; ++count) {
+        to_chars_result r = ToChars(p, last, src[count], format);
+        if (r.ec != errc() || r.ptr == last) {
+            break;
+        }
+        *r.ptr = separator;
+        p = r.ptr + 1;
+    }
+    return {p, count};
+}
+
+/**
+ * @brief Записывает числа в текстовый файл, по одному на строку
+ */
+void WriteComplexText(const string& path, const Complex* src, size_t n, ComplexTextFormat format) {
+    ofstream file(path, ios::binary);
+    if (!file) {
+        throw runtime_error("WriteComplexText: не удалось открыть " + path);
+    }
+    const size_t kChunk = 1 << 16;
+    vector<char> buffer(kChunk);
+    while (n) {
+        ComplexFormatResult r = FormatComplex(src, n, buffer.data(), buffer.data() + kChunk, format);
+        file.write(buffer.data(), r.ptr - buffer.data());
+        src += r.count;
+        n -= r.count;
+    }
+    if (!file) {
+        throw runtime_error("WriteComplexText: ошибка записи в " + path);
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef COMPLEX_IO_H
+#define COMPLEX_IO_H
+
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "mycomplex.h"
+
+// Быстрый текстовый ввод-вывод массивов Complex прямо из буфера и в буфер,
+// без istream/ostream: числа разбираются std::from_chars и печатаются
+// std::to_chars (кратчайшая запись, которая читается обратно в то же
+// значение). Файлы читаются через отображение в память (mappedfile.h).
+//
+// Понимаются три записи, в одном тексте их можно смешивать:
+//
+//     1.5 -2        пара "a b", как читает operator>>
+//     1.5-2i        алгебраическая "a+bi", как печатает operator<<; "2i" — чисто мнимое
+//     (1.5,-2)      кортеж "(a,b)", пробелы внутри скобок допустимы
+//
+// Числа разделяются любыми пробельными символами.
+
+/**
+ * @brief Запись комплексного числа при форматировании.
+ */
+enum class ComplexTextFormat {
+    Pair,       /**< "a b"*/
+    Algebraic,  /**< "a+bi" / "a-bi"*/
+    Tuple       /**< "(a,b)"*/
+};
+
+/**
+ * @brief Верхняя граница длины одного числа в любой записи вместе с разделителем.
+ * Буфера из n * kMaxComplexChars байт всегда хватает на n чисел.
+ */
+const size_t kMaxComplexChars = 64;
+
+/**
+ * @brief Итог пакетного разбора.
+ */
+struct ComplexParseResult {
+    const char* ptr;  /**< Где остановился разбор; при ошибке — место ошибки.*/
+    size_t count;     /**< Сколько чисел записано в выходной массив.*/
+    errc ec;          /**< errc() — успех; invalid_argument — синтаксис; result_out_of_range — вне double.*/
+};
+
+/**
+ * @brief Итог пакетного форматирования.
+ */
+struct ComplexFormatResult {
+    char* ptr;     /**< Конец записанного текста.*/
+    size_t count;  /**< Сколько чисел записано целиком.*/
+};
+
+/**
+ * @brief Ошибка разбора текста с комплексными числами.
+ */
+class ComplexParseError : public invalid_argument {
+private:
+    size_t offset_;  /**< Смещение ошибки от начала текста в байтах.*/
+
+public:
+    ComplexParseError(const string& message, size_t offset) : invalid_argument(message), offset_(offset) {}
+
+    /**
+    * @brief Смещение места ошибки от начала текста в байтах
+    */
+    size_t Offset() const noexcept { return offset_; }
+};
+
+/**
+ * @brief Разбирает одно число в любой из трёх записей, как std::from_chars:
+ * пробелы перед числом не пропускаются.
+ * @param first Начало текста
+ * @param last Конец текста
+ * @param value Результат (при ошибке не определён)
+ * @return Конец числа или место ошибки и код ошибки
+ */
+from_chars_result FromChars(const char* first, const char* last, Complex& value);
+
+/**
+ * @brief Разбирает подряд идущие числа, пока не кончится текст или место в out.
+ *
+ * Если out заполнен раньше, чем кончился текст, ptr указывает на начало
+ * следующего числа — разбор можно продолжить с него.
+ * @param first Начало текста
+ * @param last Конец текста
+ * @param out Массив результатов
+ * @param capacity Длина out
+ */
+ComplexParseResult ParseComplex(const char* first, const char* last, Complex* out, size_t capacity);
+
+/**
+ * @brief Разбирает весь текст в вектор
+ * @throws ComplexParseError со смещением первой ошибки
+ */
+vector<Complex> ParseComplexText(const char* first, const char* last);
+
+/**
+ * @brief Читает текстовый файл с числами через отображение в память
+ * @throws runtime_error, если файл не открывается; ComplexParseError при ошибке в тексте
+ */
+vector<Complex> ReadComplexText(const string& path);
+
+/**
+ * @brief Печатает одно число кратчайшей точной записью, как std::to_chars
+ * @return Конец записи; errc::value_too_large, если не хватило места
+ */
+to_chars_result ToChars(char* first, char* last, const Complex& value,
+                        ComplexTextFormat format = ComplexTextFormat::Algebraic);
+
+/**
+ * @brief Печатает числа подряд, каждое с разделителем после него.
+ * Останавливается перед числом, которое уже не помещается в буфер.
+ * @param src Числа
+ * @param n Их количество
+ * @param first Начало буфера
+ * @param last Конец буфера
+ * @param format Запись чисел
+ * @param separator Разделитель (по умолчанию перевод строки)
+ */
+ComplexFormatResult FormatComplex(const Complex* src, size_t n, char* first, char* last,
+                                  ComplexTextFormat format = ComplexTextFormat::Algebraic,
+                                  char separator = '\n');
+
+/**
+ * @brief Записывает числа в текстовый файл, по одному на строку
+ * @throws runtime_error, если файл не открывается или запись не удалась
+ */
+void WriteComplexText(const string& path, const Complex* src, size_t n,
+                      ComplexTextFormat format = ComplexTextFormat::Algebraic);
+
+#endif // COMPLEX_IO_H
@@ -0,0 +1,221 @@
+#ifndef COMPLEX_MATH_H
+#define COMPLEX_MATH_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include "mycomplex.h"
+
+// Элементарные функции комплексного переменного для Complex и ComplexF.
+//
+// Разрезы — как в C99 Annex G и std::complex: Log, Sqrt и Pow разрезаны по
+// отрицательной вещественной полуоси, и знак нулевой мнимой части выбирает
+// берег разреза: Log(-1 + 0i) = i*pi, Log(-1 - 0i) = -i*pi, Sqrt(-4 +- 0i) =
+// +-2i. Arg лежит в [-pi, pi]. Бесконечности и NaN обрабатываются по Annex G.
+//
+// Скалярные функции опираются на libm; пакетные версии с выбором точности —
+// в complexbatch.h (MathAccuracy).
+
+/**
+ * @brief Аргумент (фаза) комплексного числа: atan2(im, re) в [-pi, pi]
+ */
+template <class T>
+inline T Arg(const BasicComplex<T>& z) noexcept {
+    return atan2(z.Im(), z.Re());
+}
+
+/**
+ * @brief Сопряжённое число
+ */
+template <class T>
+constexpr BasicComplex<T> Conj(const BasicComplex<T>& z) noexcept {
+    return BasicComplex<T>(z.Re(), -z.Im());
+}
+
+/**
+ * @brief Число по модулю и аргументу: r * (cos theta + i sin theta)
+ * @param r Модуль
+ * @param theta Аргумент в радианах
+ */
+template <class T>
+inline BasicComplex<T> Polar(T r, T theta) noexcept {
+    return BasicComplex<T>(r * cos(theta), r * sin(theta));
+}
+
+/**
+ * @brief Экспонента e^z = e^re * (cos im + i sin im).
+ *
+ * Вещественный аргумент (im == +-0) даёт точный ноль мнимой части с тем же
+ * знаком. Если e^re переполняется, а произведение ещё представимо, e^re
+ * умножается по половинам.
+ */
+template <class T>
+BasicComplex<T> Exp(const BasicComplex<T>& z) noexcept {
+    T x = z.Re(), y = z.Im();
+    if (y == 0) {
+        return BasicComplex<T>(exp(x), y);
+    }
+    if (isinf(x) && !isfinite(y)) {
+        // e^(-inf + i*y) = 0; e^(+inf + i*y) = inf + i*NaN (Annex G).
+        return x < 0 ? BasicComplex<T>(0, copysign(T(0), y)) : BasicComplex<T>(x, y - y);
+    }
+    T e = exp(x);
+    if (isinf(e) && isfinite(x)) {
+        T half = exp(x / 2);
+        return BasicComplex<T>(half * cos(y) * half, half * sin(y) * half);
+    }
+    return BasicComplex<T>(e * cos(y), e * sin(y));
+}
+
+/**
+ * @brief Сумма слагаемых с точностью тройной точности (SumK Огиты–Румпа–Оиси,
+ * K = 3): два прохода TwoSum без ошибок округления сносят ошибки в младшие
+ * слагаемые, после чего все складываются обычным образом. Массив изменяется.
+ */
+template <class T, size_t N>
+inline T AccurateSum(T (&p)[N]) noexcept {
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 1; i < N; ++i) {
+            T sum = p[i] + p[i - 1];
+            T bv = sum - p[i];
+            p[i - 1] = (p[i] - (sum - bv)) + (p[i - 1] - bv);
+            p[i] = sum;
+        }
+    }
+    T sum = p[0];
+    for (size_t i = 1; i < N; ++i) {
+        sum += p[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Натуральный логарифм (главная ветвь): log|z| + i*Arg(z).
+ *
+ * При 1/2 < |z| < 2 log|z| = log1p(re^2 + im^2 - 1) / 2, где
+ * re^2 + im^2 - 1 — сумма пяти double (точные ошибки произведений через
+ * fma) с точностью AccurateSum, поэтому относительная точность сохраняется и
+ * при |z| -> 1. Вне диапазона квадрата модуля z масштабируется степенью
+ * двойки. Log(0) = -inf + i*Arg(0).
+ */
+template <class T>
+BasicComplex<T> Log(const BasicComplex<T>& z) noexcept {
+    T x = z.Re(), y = z.Im();
+    T s = z.AbsSquared();
+    T logAbs;
+    if (s > T(0.25) && s < T(4)) {
+        // При |z| -> 1 старшие слагаемые сокращаются, и результат задают
+        // ошибки произведений: их сумма нужна точнее, чем даёт double-double.
+        T xx = x * x, yy = y * y;
+        T terms[5] = {fma(x, x, -xx), fma(y, y, -yy), yy, T(-1), xx};
+        logAbs = log1p(AccurateSum(terms)) / 2;
+    } else if (s >= numeric_limits<T>::min() && s <= numeric_limits<T>::max()) {
+        logAbs = log(s) / 2;
+    } else if (isfinite(x) && isfinite(y) && (x != 0 || y != 0)) {
+        // Квадрат модуля вне диапазона: |z| субнормален (теряет разряды) или
+        // переполняется, поэтому z сначала точно масштабируется степенью двойки.
+        T scale = s > 1 ? 1 / ComplexLimits<T>::kAbsScale : ComplexLimits<T>::kAbsScale;
+        logAbs = log((z * scale).Abs()) - log(scale);
+    } else {
+        logAbs = log(z.Abs());
+    }
+    return BasicComplex<T>(logAbs, atan2(y, x));
+}
+
+/**
+ * @brief Главный квадратный корень (Re >= 0) по Кэхэну:
+ * t = sqrt((|re| + |z|) / 2), вторая часть — |im| / (2t).
+ *
+ * Без вычитаний, поэтому точность не теряется ни около разреза, ни около
+ * мнимой оси. Крупные и мелкие числа масштабируются чётной степенью двойки.
+ * Sqrt(+-0 + 0i) = +0 + 0i, Sqrt(x + i*inf) = inf + i*inf.
+ */
+template <class T>
+BasicComplex<T> Sqrt(const BasicComplex<T>& z) noexcept {
+    using Limits = ComplexLimits<T>;
+    const T kInf = numeric_limits<T>::infinity();
+    T x = z.Re(), y = z.Im();
+    if (isinf(y)) {
+        return BasicComplex<T>(kInf, y);
+    }
+    if (isinf(x)) {
+        if (x > 0) {
+            return BasicComplex<T>(x, isnan(y) ? y : copysign(T(0), y));
+        }
+        return BasicComplex<T>(isnan(y) ? y : T(0), copysign(kInf, y));
+    }
+    if (isnan(x) || isnan(y)) {
+        return BasicComplex<T>(x + y, x + y);
+    }
+    if (x == 0 && y == 0) {
+        return BasicComplex<T>(0, y);
+    }
+    T ax = fabs(x), ay = fabs(y);
+    T scale = 1;
+    if (ax > numeric_limits<T>::max() / 4 || ay > numeric_limits<T>::max() / 4) {
+        // |re| + |z| не должно переполниться: sqrt(z) = 2 * sqrt(z / 4).
+        ax /= 4;
+        ay /= 4;
+        scale = 2;
+    } else if (ax < Limits::kDivLow && ay < Limits::kDivLow) {
+        // Субнормальные части теряют биты: sqrt(z) = sqrt(z * s^2) / s.
+        ax *= Limits::kAbsScale;
+        ay *= Limits::kAbsScale;
+        scale = 1 / sqrt(Limits::kAbsScale);
+    }
+    T t = sqrt((ax + BasicComplex<T>(ax, ay).Abs()) / 2);
+    T u = t * scale, v = ay / (2 * t) * scale;
+    if (x >= 0) {
+        return BasicComplex<T>(u, copysign(v, y));
+    }
+    return BasicComplex<T>(v, copysign(u, y));
+}
+
+/**
+ * @brief Степень z^w = e^(w * Log z) (главная ветвь). z^0 = 1 для любого z,
+ * 0^w = 0 при Re w > 0.
+ */
+template <class T>
+BasicComplex<T> Pow(const BasicComplex<T>& z, const BasicComplex<T>& w) noexcept {
+    if (w.Re() == 0 && w.Im() == 0) {
+        return BasicComplex<T>(1);
+    }
+    if (z.Re() == 0 && z.Im() == 0 && w.Re() > 0) {
+        return BasicComplex<T>();
+    }
+    return Exp(w * Log(z));
+}
+
+/**
+ * @brief Вещественная степень z^p = |z|^p * e^(i * p * Arg z): модуль через
+ * pow, поэтому точнее, чем e^(p * Log z) при больших |p * log|z||.
+ */
+template <class T>
+BasicComplex<T> Pow(const BasicComplex<T>& z, typename BasicComplex<T>::value_type p) noexcept {
+    if (p == 0) {
+        return BasicComplex<T>(1);
+    }
+    return Polar(pow(z.Abs(), p), p * Arg(z));
+}
+
+/**
+ * @brief Целая степень повторным возведением в квадрат (O(log n) умножений);
+ * отрицательная степень — обратное число от положительной.
+ */
+template <class T, class I, class = typename enable_if<is_integral<I>::value>::type>
+BasicComplex<T> Pow(const BasicComplex<T>& z, I n) noexcept {
+    unsigned long long m = n < 0 ? 0ULL - static_cast<unsigned long long>(n) : static_cast<unsigned long long>(n);
+    BasicComplex<T> result(1), base = z;
+    while (m != 0) {
+        if (m & 1) {
+            result *= base;
+        }
+        base *= base;
+        m >>= 1;
+    }
+    return n < 0 ? result.Reciprocal() : result;
+}
+
+static_assert(Conj(Complex(1, 2)).Im() == -2, "Conj должен вычисляться на этапе компиляции");
+
+#endif // COMPLEX_MATH_H
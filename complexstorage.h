@@ -0,0 +1,300 @@
+#ifndef COMPLEX_STORAGE_H
+#define COMPLEX_STORAGE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include "mycomplex.h"
+
+// Компактные типы хранения комплексных отсчётов — 4 байта на число вместо 16:
+//
+//     ComplexQ15   16-битная фиксированная точка Q15 (I/Q с АЦП), с насыщением
+//     ComplexHalf  16-битный IEEE binary16, только хранение (считать — через ComplexF)
+//
+// Преобразования между всеми типами — ComplexCast<To>(z) для одного числа и
+// Convert(...) из complexbatch.h для массивов; округление к ближайшему чётному.
+
+/**
+ * @brief Число в формате Q15: raw / 32768, диапазон [-1, 1 - 2^-15].
+ */
+struct Q15 {
+    int16_t raw = 0;  /**< Хранимое значение.*/
+
+    /**
+    * @brief Число с заданным хранимым значением
+    */
+    static constexpr Q15 FromRaw(int16_t raw) noexcept {
+        Q15 q;
+        q.raw = raw;
+        return q;
+    }
+
+    /**
+    * @brief Округление к ближайшему с насыщением: значения вне диапазона
+    * дают -1 или 1 - 2^-15, NaN даёт 0.
+    */
+    static Q15 FromDouble(double x) noexcept {
+        double y = x * 32768.0;
+        if (!(y == y)) {
+            y = 0;
+        }
+        y = y < -32768.0 ? -32768.0 : y;
+        y = y > 32767.0 ? 32767.0 : y;
+        return FromRaw(int16_t(nearbyint(y)));
+    }
+
+    constexpr double ToDouble() const noexcept { return raw / 32768.0; }
+};
+
+/**
+ * @brief 16-битное число с плавающей точкой IEEE 754 binary16 (только хранение).
+ * 11 бит мантиссы, диапазон до 65504, субнормальные числа, inf и NaN.
+ */
+struct Half {
+    uint16_t bits = 0;  /**< Двоичное представление.*/
+
+    static constexpr Half FromBits(uint16_t bits) noexcept {
+        Half h;
+        h.bits = bits;
+        return h;
+    }
+
+    /**
+    * @brief Округление float к ближайшему чётному binary16 (переполнение даёт inf)
+    */
+    static Half FromFloat(float x) noexcept {
+        uint32_t f;
+        memcpy(&f, &x, sizeof(f));
+        uint32_t sign = f & 0x80000000u;
+        f ^= sign;
+        uint32_t out;
+        if (f >= 0x47800000u) {
+            // >= 2^16: переполнение в inf; NaN остаётся тихим NaN.
+            out = f > 0x7f800000u ? 0x7e00u : 0x7c00u;
+        } else if (f < 0x38800000u) {
+            // < 2^-14: субнормальное binary16. Сложение с 0.5 сдвигает
+            // мантиссу на место и округляет её аппаратно.
+            float t;
+            memcpy(&t, &f, sizeof(t));
+            t += 0.5f;
+            memcpy(&out, &t, sizeof(out));
+            out -= 0x3f000000u;
+        } else {
+            // Нормальное: смена смещения порядка и округление к чётному.
+            uint32_t odd = (f >> 13) & 1;
+            out = (f + 0xc8000fffu + odd) >> 13;
+        }
+        return FromBits(uint16_t(out | (sign >> 16)));
+    }
+
+    /**
+    * @brief Округление double к ближайшему чётному binary16 (один раз).
+    * Младшие 29 бит мантиссы, которых нет во float, заменяются «липким»
+    * младшим битом float (округление к нечётному): float(x) после этого
+    * точен, а бит лишь отличает «чуть больше середины» от середины, так что
+    * FromFloat округляет как из double. Вне нормального диапазона float
+    * binary16 — ноль или inf, и второе округление ничего не меняет.
+    */
+    static Half FromDouble(double x) noexcept {
+        uint64_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        uint64_t low = bits & 0x1fffffffu;
+        bits = (bits - low) | (low ? 0x20000000u : 0);
+        memcpy(&x, &bits, sizeof(x));
+        return FromFloat(float(x));
+    }
+
+    /**
+    * @brief Точное преобразование в float
+    */
+    float ToFloat() const noexcept {
+        uint32_t out = uint32_t(bits & 0x7fff) << 13;
+        uint32_t exponent = out & 0x0f800000u;
+        out += 0x38000000u;
+        if (exponent == 0x0f800000u) {
+            out += 0x38000000u;  // inf и NaN
+        } else if (exponent == 0) {
+            // Субнормальное: нормализуется вычитанием 2^-14.
+            out += 0x00800000u;
+            float t;
+            memcpy(&t, &out, sizeof(t));
+            t -= 0x1p-14f;
+            memcpy(&out, &t, sizeof(out));
+        }
+        out |= uint32_t(bits & 0x8000) << 16;
+        float x;
+        memcpy(&x, &out, sizeof(x));
+        return x;
+    }
+};
+
+/**
+ * @brief Комплексное число в формате Q15 с насыщающей арифметикой.
+ *
+ * Сложение и вычитание насыщаются на границах диапазона, умножение
+ * округляет произведение Q30 к ближайшему и насыщается (только -1 * -1
+ * выходит за диапазон). Деления нет: частное в Q15 почти всегда вне
+ * [-1, 1); для него и для точных вычислений есть ComplexCast<float>.
+ */
+template <>
+class BasicComplex<Q15> {
+private:
+    int16_t re_;  /**< Действительная часть (raw).*/
+    int16_t im_;  /**< Мнимая часть (raw).*/
+
+    static constexpr int16_t Saturate(int32_t x) noexcept {
+        return x > 32767 ? 32767 : x < -32768 ? -32768 : int16_t(x);
+    }
+
+    /** Произведение в Q30 -> Q15 с округлением и насыщением */
+    static constexpr int16_t RoundQ30(int32_t p) noexcept { return Saturate((p + 0x4000) >> 15); }
+
+public:
+    using value_type = Q15;
+
+    constexpr BasicComplex() noexcept : re_(0), im_(0) {}
+
+    /**
+    * @brief Конструктор из частей
+    * @param aRe Действительная часть
+    * @param aIm Мнимая часть (по умолчанию 0)
+    */
+    constexpr BasicComplex(Q15 aRe, Q15 aIm = Q15()) noexcept : re_(aRe.raw), im_(aIm.raw) {}
+
+    /**
+    * @brief Число с заданными хранимыми значениями частей
+    */
+    static constexpr BasicComplex FromRaw(int16_t re, int16_t im) noexcept {
+        return BasicComplex(Q15::FromRaw(re), Q15::FromRaw(im));
+    }
+
+    constexpr Q15 Re() const noexcept { return Q15::FromRaw(re_); }
+    constexpr Q15 Im() const noexcept { return Q15::FromRaw(im_); }
+    constexpr int16_t RawRe() const noexcept { return re_; }
+    constexpr int16_t RawIm() const noexcept { return im_; }
+
+    constexpr BasicComplex operator+(const BasicComplex& other) const noexcept {
+        return FromRaw(Saturate(int32_t(re_) + other.re_), Saturate(int32_t(im_) + other.im_));
+    }
+
+    constexpr BasicComplex operator-(const BasicComplex& other) const noexcept {
+        return FromRaw(Saturate(int32_t(re_) - other.re_), Saturate(int32_t(im_) - other.im_));
+    }
+
+    /**
+    * @brief Комплексное умножение: обе суммы произведений считаются точно в
+    * Q30 (|сумма| < 2^31) и округляются один раз
+    */
+    constexpr BasicComplex operator*(const BasicComplex& other) const noexcept {
+        return FromRaw(RoundQ30(int32_t(re_) * other.re_ - int32_t(im_) * other.im_),
+                       RoundQ30(int32_t(re_) * other.im_ + int32_t(im_) * other.re_));
+    }
+
+    /**
+    * @brief Умножение на вещественное число Q15
+    */
+    constexpr BasicComplex operator*(Q15 value) const noexcept {
+        return FromRaw(RoundQ30(int32_t(re_) * value.raw), RoundQ30(int32_t(im_) * value.raw));
+    }
+
+    constexpr BasicComplex& operator+=(const BasicComplex& other) noexcept { return *this = *this + other; }
+    constexpr BasicComplex& operator-=(const BasicComplex& other) noexcept { return *this = *this - other; }
+    constexpr BasicComplex& operator*=(const BasicComplex& other) noexcept { return *this = *this * other; }
+    constexpr BasicComplex& operator*=(Q15 value) noexcept { return *this = *this * value; }
+
+    /**
+    * @brief Ввод в формате "a b" (вещественные числа, с насыщением)
+    */
+    friend istream& operator>>(istream& input, BasicComplex& c) {
+        double re, im;
+        if (input >> re >> im) {
+            c = BasicComplex(Q15::FromDouble(re), Q15::FromDouble(im));
+        }
+        return input;
+    }
+
+    /**
+    * @brief Вывод как у Complex ("a+bi", значения в [-1, 1))
+    */
+    friend ostream& operator<<(ostream& output, const BasicComplex& c) {
+        return output << Complex(c.Re().ToDouble(), c.Im().ToDouble());
+    }
+};
+
+/**
+ * @brief Комплексное число binary16 — только хранение: чтение и запись
+ * частей, вывод. Для вычислений — ComplexCast<float>.
+ */
+template <>
+class BasicComplex<Half> {
+private:
+    uint16_t re_;  /**< Действительная часть (биты).*/
+    uint16_t im_;  /**< Мнимая часть (биты).*/
+
+public:
+    using value_type = Half;
+
+    constexpr BasicComplex() noexcept : re_(0), im_(0) {}
+
+    /**
+    * @brief Конструктор из частей
+    * @param aRe Действительная часть
+    * @param aIm Мнимая часть (по умолчанию 0)
+    */
+    constexpr BasicComplex(Half aRe, Half aIm = Half()) noexcept : re_(aRe.bits), im_(aIm.bits) {}
+
+    constexpr Half Re() const noexcept { return Half::FromBits(re_); }
+    constexpr Half Im() const noexcept { return Half::FromBits(im_); }
+
+    friend ostream& operator<<(ostream& output, const BasicComplex& c) {
+        return output << ComplexF(c.Re().ToFloat(), c.Im().ToFloat());
+    }
+};
+
+/** Комплексный отсчёт Q15 (4 байта) */
+using ComplexQ15 = BasicComplex<Q15>;
+
+/** Комплексное число binary16 для хранения (4 байта) */
+using ComplexHalf = BasicComplex<Half>;
+
+static_assert(sizeof(ComplexQ15) == 4 && is_trivially_copyable<ComplexQ15>::value,
+              "ComplexQ15 должен занимать 4 байта и тривиально копироваться");
+static_assert(sizeof(ComplexHalf) == 4 && is_trivially_copyable<ComplexHalf>::value,
+              "ComplexHalf должен занимать 4 байта и тривиально копироваться");
+static_assert((ComplexQ15::FromRaw(-32768, 0) * ComplexQ15::FromRaw(-32768, 0)).RawRe() == 32767,
+              "умножение Q15 должно насыщаться");
+
+// Части любого типа проходят через double: double вмещает все значения
+// float, Q15 и binary16 точно, поэтому округление происходит один раз — при
+// переводе в целевой тип (в binary16 — см. Half::FromDouble).
+inline double ScalarToDouble(double x) noexcept { return x; }
+inline double ScalarToDouble(float x) noexcept { return x; }
+inline double ScalarToDouble(Q15 x) noexcept { return x.ToDouble(); }
+inline double ScalarToDouble(Half x) noexcept { return x.ToFloat(); }
+
+template <class T>
+T ScalarFromDouble(double x) noexcept;
+template <>
+inline double ScalarFromDouble<double>(double x) noexcept { return x; }
+template <>
+inline float ScalarFromDouble<float>(double x) noexcept { return float(x); }
+template <>
+inline Q15 ScalarFromDouble<Q15>(double x) noexcept { return Q15::FromDouble(x); }
+template <>
+inline Half ScalarFromDouble<Half>(double x) noexcept { return Half::FromDouble(x); }
+
+/**
+ * @brief Преобразование комплексного числа между типами частей:
+ * ComplexCast<float>(z), ComplexCast<Q15>(zf), ComplexCast<double>(h)
+ * @param z Исходное число
+ * @return Число с частями типа To
+ */
+template <class To, class From>
+BasicComplex<To> ComplexCast(const BasicComplex<From>& z) noexcept {
+    return BasicComplex<To>(ScalarFromDouble<To>(ScalarToDouble(z.Re())),
+                            ScalarFromDouble<To>(ScalarToDouble(z.Im())));
+}
+
+#endif // COMPLEX_STORAGE_H
@@ -0,0 +1,419 @@
+#include "convolution.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double* AsDoubles(const Complex* src) {
+    return reinterpret_cast<const double*>(src);
+}
+
+double* AsDoubles(Complex* dst) {
+    return reinterpret_cast<double*>(dst);
+}
+
+/** Отсчётов выхода в блоке прямой свёртки (16 КБ — в L1 вместе с окном входа). */
+const size_t kDirectBlock = 1024;
+
+/** Блок PartitionedConvolver при ConvolutionMethod::Partitioned. */
+const size_t kPartitionedBlock = 256;
+
+/** Текущая настройка; читается из файла при первом обращении. */
+struct TuningState {
+    mutex lock;
+    bool loaded = false;
+    ConvolutionTuning tuning;
+};
+
+TuningState& Tuning() {
+    static TuningState state;
+    return state;
+}
+
+bool ValidTuning(const ConvolutionTuning& tuning) {
+    size_t factor = tuning.fftBlockFactor;
+    return factor >= 2 && factor <= 64 && (factor & (factor - 1)) == 0 &&
+           (tuning.blockMethod == ConvolutionMethod::OverlapSave || tuning.blockMethod == ConvolutionMethod::OverlapAdd);
+}
+
+/** Длина БПФ блока для m отводов */
+size_t BlockFftSize(size_t m, size_t factor) {
+    size_t size = 64;
+    while (size < factor * m) {
+        size *= 2;
+    }
+    return size;
+}
+
+/**
+ * @brief Прямая свёртка: блок выхода [k0, k1) обходится по отводам, и на
+ * каждый отвод ядро axpy прибавляет h[j] * x к отрезку блока. Блок и
+ * соответствующий отрезок x остаются в кэше на все m отводов.
+ */
+void DirectConvolve(const Complex* x, size_t n, const Complex* h, size_t m, Complex* out) {
+    COMPLEX_PROFILE_KERNEL("conv.direct", n * m);
+    const SimdKernels& kernels = ActiveKernels();
+    size_t total = n + m - 1;
+    fill(out, out + total, Complex());
+    for (size_t k0 = 0; k0 < total; k0 += kDirectBlock) {
+        size_t k1 = min(total, k0 + kDirectBlock);
+        for (size_t j = 0; j < m; ++j) {
+            size_t lo = max(k0, j), hi = min(k1, j + n);
+            if (lo < hi) {
+                kernels.axpyInterleaved(h[j].Re(), h[j].Im(), AsDoubles(x + lo - j), AsDoubles(out + lo), hi - lo);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Перекрытие с накоплением: окно x[s - (m - 1) .. s + L) (вне x —
+ * нули) даёт L отсчётов выхода начиная с s
+ */
+void OverlapSaveConvolve(const Complex* x, size_t n, const Complex* h, size_t m, Complex* out, size_t size) {
+    COMPLEX_PROFILE_KERNEL("conv.overlap_save", n + m - 1);
+    shared_ptr<const FftPlan> plan = FftPlan::Get(size);
+    const SimdKernels& kernels = ActiveKernels();
+    ArenaFrame frame;
+    Complex* spectrum = frame.Allocate<Complex>(size);
+    Complex* work = frame.Allocate<Complex>(size);
+    fill(copy(h, h + m, spectrum), spectrum + size, Complex());
+    plan->Forward(spectrum);
+    const size_t keep = m - 1, block = size - keep, total = n + m - 1;
+    for (size_t s = 0; s < total; s += block) {
+        // Окно начинается с отсчёта s - keep; индексы x со сдвигом на keep.
+        size_t from = max(s, keep), to = min(s + size, n + keep);
+        fill(work, work + size, Complex());
+        if (from < to) {
+            copy(x + from - keep, x + to - keep, work + (from - s));
+        }
+        plan->Forward(work);
+        kernels.mulInterleaved(AsDoubles(work), AsDoubles(spectrum), AsDoubles(work), size);
+        plan->Inverse(work);
+        copy(work + keep, work + keep + min(block, total - s), out + s);
+    }
+}
+
+/**
+ * @brief Перекрытие со сложением: блок x[s .. s + L) после БПФ-свёртки
+ * даёт L + m - 1 отсчётов, которые прибавляются к out начиная с s
+ */
+void OverlapAddConvolve(const Complex* x, size_t n, const Complex* h, size_t m, Complex* out, size_t size) {
+    COMPLEX_PROFILE_KERNEL("conv.overlap_add", n + m - 1);
+    shared_ptr<const FftPlan> plan = FftPlan::Get(size);
+    const SimdKernels& kernels = ActiveKernels();
+    ArenaFrame frame;
+    Complex* spectrum = frame.Allocate<Complex>(size);
+    Complex* work = frame.Allocate<Complex>(size);
+    fill(copy(h, h + m, spectrum), spectrum + size, Complex());
+    plan->Forward(spectrum);
+    const size_t block = size - m + 1;
+    fill(out, out + n + m - 1, Complex());
+    for (size_t s = 0; s < n; s += block) {
+        size_t length = min(block, n - s);
+        fill(copy(x + s, x + s + length, work), work + size, Complex());
+        plan->Forward(work);
+        kernels.mulInterleaved(AsDoubles(work), AsDoubles(spectrum), AsDoubles(work), size);
+        plan->Inverse(work);
+        kernels.axpyInterleaved(1, 0, AsDoubles(work), AsDoubles(out + s), length + m - 1);
+    }
+}
+
+/** Вся последовательность через PartitionedConvolver, хвост — нулями на входе */
+void PartitionedConvolve(const Complex* x, size_t n, const Complex* h, size_t m, Complex* out) {
+    COMPLEX_PROFILE_KERNEL("conv.partitioned", n + m - 1);
+    PartitionedConvolver convolver(h, m, kPartitionedBlock);
+    const size_t block = convolver.BlockLength(), total = n + m - 1;
+    ArenaFrame frame;
+    Complex* in = frame.Allocate<Complex>(block);
+    Complex* result = frame.Allocate<Complex>(block);
+    for (size_t s = 0; s < total; s += block) {
+        size_t length = s < n ? min(block, n - s) : 0;
+        fill(copy(x + s, x + s + length, in), in + block, Complex());
+        convolver.Process(in, block, result);
+        copy(result, result + min(block, total - s), out + s);
+    }
+}
+
+/** Секунд на один вызов f: повторяется, пока не пройдёт seconds (не меньше одного раза) */
+template <class F>
+double TimeCall(double seconds, F f) {
+    auto start = chrono::steady_clock::now();
+    size_t calls = 0;
+    double elapsed;
+    do {
+        f();
+        ++calls;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    return elapsed / calls;
+}
+
+const char* MethodName(ConvolutionMethod method) {
+    return method == ConvolutionMethod::OverlapAdd ? "overlap_add" : "overlap_save";
+}
+
+} // namespace
+
+ConvolutionTuning GetConvolutionTuning() {
+    TuningState& state = Tuning();
+    lock_guard<mutex> guard(state.lock);
+    if (!state.loaded) {
+        state.loaded = true;
+        const char* path = getenv(kConvolutionTuningVariable);
+        if (path) {
+            try {
+                state.tuning = LoadConvolutionTuning(path);
+            } catch (const runtime_error&) {
+                // Нечитаемый файл — как его отсутствие: настройка по умолчанию.
+            }
+        }
+    }
+    return state.tuning;
+}
+
+void SetConvolutionTuning(const ConvolutionTuning& tuning) {
+    if (!ValidTuning(tuning)) {
+        throw invalid_argument("SetConvolutionTuning: неверная длина блока БПФ или способ");
+    }
+    TuningState& state = Tuning();
+    lock_guard<mutex> guard(state.lock);
+    state.loaded = true;
+    state.tuning = tuning;
+}
+
+ConvolutionTuning CalibrateConvolution(double secondsPerTrial) {
+    const size_t n = 16384, maxTaps = 1024;
+    ComplexVector x(n), h(maxTaps), out(n + maxTaps - 1);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = Complex(cos(0.37 * double(i)), sin(0.11 * double(i)));
+    }
+    for (size_t j = 0; j < maxTaps; ++j) {
+        h[j] = Complex(1.0 / double(j + 1), 0.5 / double(j + 2));
+    }
+    ConvolutionTuning tuning;
+
+    // Длина блока и способ — на 128 отводах.
+    const size_t taps = 128;
+    double best = INFINITY;
+    for (size_t factor = 2; factor <= 32; factor *= 2) {
+        double t = TimeCall(secondsPerTrial, [&] {
+            OverlapSaveConvolve(x.data(), n, h.data(), taps, out.data(), BlockFftSize(taps, factor));
+        });
+        if (t < best) {
+            best = t;
+            tuning.fftBlockFactor = factor;
+        }
+    }
+    size_t size = BlockFftSize(taps, tuning.fftBlockFactor);
+    double add = TimeCall(secondsPerTrial, [&] { OverlapAddConvolve(x.data(), n, h.data(), taps, out.data(), size); });
+    tuning.blockMethod = add < best ? ConvolutionMethod::OverlapAdd : ConvolutionMethod::OverlapSave;
+
+    // Прямая свёртка — пока она быстрее выбранного способа на БПФ.
+    tuning.directMaxTaps = 0;
+    for (size_t m = 2; m <= maxTaps; m *= 2) {
+        double direct = TimeCall(secondsPerTrial, [&] { DirectConvolve(x.data(), n, h.data(), m, out.data()); });
+        size = BlockFftSize(m, tuning.fftBlockFactor);
+        double fft = TimeCall(secondsPerTrial, [&] {
+            if (tuning.blockMethod == ConvolutionMethod::OverlapAdd) {
+                OverlapAddConvolve(x.data(), n, h.data(), m, out.data(), size);
+            } else {
+                OverlapSaveConvolve(x.data(), n, h.data(), m, out.data(), size);
+            }
+        });
+        if (direct > fft) {
+            break;
+        }
+        tuning.directMaxTaps = m;
+    }
+    return tuning;
+}
+
+void SaveConvolutionTuning(const ConvolutionTuning& tuning, const string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        throw runtime_error("SaveConvolutionTuning: не удалось создать " + path);
+    }
+    fprintf(file, "# Точки перехода свёртки (CalibrateConvolution)\n");
+    fprintf(file, "direct_max_taps %zu\n", tuning.directMaxTaps);
+    fprintf(file, "fft_block_factor %zu\n", tuning.fftBlockFactor);
+    fprintf(file, "block_method %s\n", MethodName(tuning.blockMethod));
+    bool failed = ferror(file) != 0;
+    if (fclose(file) != 0 || failed) {
+        throw runtime_error("SaveConvolutionTuning: ошибка записи " + path);
+    }
+}
+
+ConvolutionTuning LoadConvolutionTuning(const string& path) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file) {
+        throw runtime_error("LoadConvolutionTuning: не удалось открыть " + path);
+    }
+    ConvolutionTuning tuning;
+    char line[256];
+    int lineNumber = 0;
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file)) {
+        ++lineNumber;
+        char key[64], value[64];
+        int fields = sscanf(line, "%63s %63s", key, value);
+        if (fields <= 0 || key[0] == '#') {
+            continue;
+        }
+        char* end = value;
+        unsigned long long number = fields == 2 ? strtoull(value, &end, 10) : 0;
+        bool isNumber = fields == 2 && end != value && *end == '\0';
+        if (strcmp(key, "direct_max_taps") == 0 && isNumber) {
+            tuning.directMaxTaps = size_t(number);
+        } else if (strcmp(key, "fft_block_factor") == 0 && isNumber) {
+            tuning.fftBlockFactor = size_t(number);
+        } else if (strcmp(key, "block_method") == 0 && fields == 2 && strcmp(value, "overlap_add") == 0) {
+            tuning.blockMethod = ConvolutionMethod::OverlapAdd;
+        } else if (strcmp(key, "block_method") == 0 && fields == 2 && strcmp(value, "overlap_save") == 0) {
+            tuning.blockMethod = ConvolutionMethod::OverlapSave;
+        } else {
+            valid = false;
+        }
+    }
+    fclose(file);
+    if (!valid || !ValidTuning(tuning)) {
+        throw runtime_error("LoadConvolutionTuning: " + path + ", строка " + to_string(lineNumber) +
+                            " — неверная настройка");
+    }
+    return tuning;
+}
+
+ConvolutionMethod SelectConvolutionMethod(size_t n, size_t m) {
+    ConvolutionTuning tuning = GetConvolutionTuning();
+    return min(n, m) <= tuning.directMaxTaps ? ConvolutionMethod::Direct : tuning.blockMethod;
+}
+
+void Convolve(const Complex* x, size_t n, const Complex* h, size_t m, Complex* out, ConvolutionMethod method) {
+    if (n == 0 || m == 0) {
+        return;
+    }
+    // Отводы — короткая из двух: от неё зависят длина блока и число проходов.
+    if (m > n) {
+        swap(x, h);
+        swap(n, m);
+    }
+    ConvolutionTuning tuning = GetConvolutionTuning();
+    if (method == ConvolutionMethod::Auto) {
+        method = m <= tuning.directMaxTaps ? ConvolutionMethod::Direct : tuning.blockMethod;
+    }
+    switch (method) {
+    case ConvolutionMethod::Direct:
+        DirectConvolve(x, n, h, m, out);
+        break;
+    case ConvolutionMethod::OverlapAdd:
+        OverlapAddConvolve(x, n, h, m, out, BlockFftSize(m, tuning.fftBlockFactor));
+        break;
+    case ConvolutionMethod::Partitioned:
+        PartitionedConvolve(x, n, h, m, out);
+        break;
+    default:
+        OverlapSaveConvolve(x, n, h, m, out, BlockFftSize(m, tuning.fftBlockFactor));
+        break;
+    }
+}
+
+void Correlate(const Complex* x, size_t n, const Complex* y, size_t m, Complex* out, ConvolutionMethod method) {
+    if (n == 0 || m == 0) {
+        return;
+    }
+    // r[k] = sum x[j + k] conj(y[j]) — свёртка x с перевёрнутым сопряжённым y.
+    ArenaFrame frame;
+    Complex* reversed = frame.Allocate<Complex>(m);
+    for (size_t j = 0; j < m; ++j) {
+        reversed[j] = Complex(y[m - 1 - j].Re(), -y[m - 1 - j].Im());
+    }
+    Convolve(x, n, reversed, m, out, method);
+}
+
+PartitionedConvolver::PartitionedConvolver(const Complex* taps, size_t count, size_t block)
+    : block_(block), newest_(0), filled_(0) {
+    if (count == 0 || block == 0 || (block & (block - 1)) != 0) {
+        throw invalid_argument("PartitionedConvolver: нужен хотя бы один отвод и блок — степень двойки");
+    }
+    const size_t size = 2 * block;
+    plan_ = FftPlan::Get(size);
+    partitions_ = (count + block - 1) / block;
+    spectra_.assign(partitions_ * size, Complex());
+    for (size_t p = 0; p < partitions_; ++p) {
+        Complex* spectrum = spectra_.data() + p * size;
+        copy(taps + p * block, taps + min(count, (p + 1) * block), spectrum);
+        plan_->Forward(spectrum);
+    }
+    delayLine_.assign(partitions_ * size, Complex());
+    window_.assign(size, Complex());
+    work_.resize(size);
+}
+
+/**
+ * @brief Дополняет текущий блок; каждый полный блок даёт B отсчётов выхода.
+ */
+size_t PartitionedConvolver::Process(const Complex* in, size_t n, Complex* out) {
+    COMPLEX_PROFILE_KERNEL("partitioned.process", n);
+    const SimdKernels& kernels = ActiveKernels();
+    const size_t size = 2 * block_;
+    size_t produced = 0;
+    while (n > 0) {
+        size_t m = min(n, block_ - filled_);
+        copy(in, in + m, window_.begin() + block_ + filled_);
+        in += m;
+        n -= m;
+        filled_ += m;
+        if (filled_ < block_) {
+            break;
+        }
+        // Новейший спектр — в слоте newest_, блок p назад — в newest_ + p.
+        newest_ = (newest_ + partitions_ - 1) % partitions_;
+        plan_->Execute(window_.data(), delayLine_.data() + newest_ * size, FftDirection::Forward);
+        fill(work_.begin(), work_.end(), Complex());
+        for (size_t p = 0; p < partitions_; ++p) {
+            size_t slot = (newest_ + p) % partitions_;
+            kernels.mulAccumulateInterleaved(AsDoubles(spectra_.data() + p * size),
+                                             AsDoubles(delayLine_.data() + slot * size), AsDoubles(work_.data()),
+                                             size);
+        }
+        plan_->Execute(work_.data(), work_.data(), FftDirection::Inverse);
+        // Первая половина обратного БПФ испорчена циклическим переносом.
+        copy(work_.begin() + block_, work_.end(), out + produced);
+        produced += block_;
+        copy(window_.begin() + block_, window_.end(), window_.begin());
+        filled_ = 0;
+    }
+    return produced;
+}
+
+void PartitionedConvolver::Reset() {
+    fill(delayLine_.begin(), delayLine_.end(), Complex());
+    fill(window_.begin(), window_.end(), Complex());
+    newest_ = 0;
+    filled_ = 0;
+}
+
+unique_ptr<StreamStage> MakeConvolver(const Complex* taps, size_t count, size_t maxBlock) {
+    if (count == 0) {
+        throw invalid_argument("MakeConvolver: нужен хотя бы один отвод");
+    }
+    size_t size = BlockFftSize(count, GetConvolutionTuning().fftBlockFactor);
+    if (maxBlock == 0 || size - count + 1 <= maxBlock) {
+        return unique_ptr<StreamStage>(new FirFilter(taps, count, size));
+    }
+    size_t block = 1;
+    while (2 * block <= maxBlock) {
+        block *= 2;
+    }
+    return unique_ptr<StreamStage>(new PartitionedConvolver(taps, count, block));
+}
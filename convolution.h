@@ -0,0 +1,171 @@
+#ifndef COMPLEX_CONVOLUTION_H
+#define COMPLEX_CONVOLUTION_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "allocator.h"
+#include "fft.h"
+#include "mycomplex.h"
+#include "pipeline.h"
+
+using namespace std;
+
+// Свёртка и взаимная корреляция комплексных последовательностей.
+//
+// Прямая свёртка идёт блоками выхода, помещающимися в L1, ядром axpy по
+// отводу; быстрые — через БПФ блоками (перекрытие со сложением или с
+// накоплением), для потоков с малой задержкой — по разбиениям отводов.
+// ConvolutionMethod::Auto выбирает способ по длинам и по настройке
+// ConvolutionTuning: её значения по умолчанию замерены на x86-64 с AVX-512,
+// CalibrateConvolution() замеряет точки перехода на этой машине, а
+// SaveConvolutionTuning() сохраняет их в файл, который при следующем
+// запуске подхватывается через переменную окружения
+// kConvolutionTuningVariable.
+
+/**
+ * @brief Способ свёртки.
+ */
+enum class ConvolutionMethod {
+    Auto,         /**< По длинам и текущей ConvolutionTuning.*/
+    Direct,       /**< Прямо: n * m умножений, ошибка — как у суммы произведений.*/
+    OverlapAdd,   /**< БПФ блоками входа, хвосты блоков складываются.*/
+    OverlapSave,  /**< БПФ перекрывающихся окон входа, испорченное начало окна отбрасывается.*/
+    Partitioned   /**< Отводы делятся на куски по блоку (PartitionedConvolver): задержка — блок, а не длина фильтра.*/
+};
+
+/**
+ * @brief Точки перехода для ConvolutionMethod::Auto.
+ */
+struct ConvolutionTuning {
+    size_t directMaxTaps = 32;                                   /**< До скольких отводов (короткой из двух последовательностей) прямая свёртка быстрее БПФ.*/
+    size_t fftBlockFactor = 16;                                  /**< Длина БПФ блока — степень двойки не меньше fftBlockFactor * m (и 64).*/
+    ConvolutionMethod blockMethod = ConvolutionMethod::OverlapSave;  /**< OverlapSave или OverlapAdd.*/
+};
+
+/** Переменная окружения с путём к файлу SaveConvolutionTuning(), читается при первом Auto. */
+const char* const kConvolutionTuningVariable = "COMPLEX_CONVOLUTION_TUNING";
+
+/**
+ * @brief Текущая настройка (при первом обращении — из файла
+ * kConvolutionTuningVariable, если он задан и читается, иначе по умолчанию)
+ */
+ConvolutionTuning GetConvolutionTuning();
+
+/**
+ * @brief Заменяет текущую настройку (для всех потоков)
+ * @throws invalid_argument если fftBlockFactor — не степень двойки от 2 до 64
+ * или blockMethod — не OverlapSave и не OverlapAdd
+ */
+void SetConvolutionTuning(const ConvolutionTuning& tuning);
+
+/**
+ * @brief Замеряет точки перехода на этой машине (однопоточно): длину блока
+ * БПФ, перекрытие со сложением против перекрытия с накоплением и наибольшее
+ * число отводов, при котором прямая свёртка ещё быстрее.
+ * Текущую настройку не меняет.
+ * @param secondsPerTrial Сколько повторять каждый замер (около 40 замеров)
+ * @return Замеренная настройка
+ */
+ConvolutionTuning CalibrateConvolution(double secondsPerTrial = 0.02);
+
+/**
+ * @brief Сохраняет настройку в текстовый файл (строки "ключ значение")
+ * @throws runtime_error если файл не создаётся
+ */
+void SaveConvolutionTuning(const ConvolutionTuning& tuning, const string& path);
+
+/**
+ * @brief Читает настройку из файла SaveConvolutionTuning(); отсутствующие
+ * ключи остаются по умолчанию
+ * @throws runtime_error если файл не читается или в нём неверная строка
+ */
+ConvolutionTuning LoadConvolutionTuning(const string& path);
+
+/**
+ * @brief Способ, который Auto выбирает для длин n и m при текущей настройке
+ */
+ConvolutionMethod SelectConvolutionMethod(size_t n, size_t m);
+
+/**
+ * @brief Линейная свёртка out[k] = sum x[j] * h[k - j], k = 0 .. n + m - 2
+ * @param x Первая последовательность
+ * @param n Её длина
+ * @param h Вторая последовательность (роли x и h симметричны)
+ * @param m Её длина
+ * @param out n + m - 1 отсчётов (пусто, если n или m — 0); не пересекается с x и h
+ * @param method Способ
+ */
+void Convolve(const Complex* x, size_t n, const Complex* h, size_t m, Complex* out,
+              ConvolutionMethod method = ConvolutionMethod::Auto);
+
+/**
+ * @brief Взаимная корреляция r[k] = sum x[j + k] * conj(y[j]) для сдвигов
+ * k = -(m - 1) .. n - 1; r[k] записывается в out[k + m - 1]
+ * @param x Сигнал
+ * @param n Его длина
+ * @param y Образец (для согласованного фильтра — искомый импульс)
+ * @param m Его длина
+ * @param out n + m - 1 отсчётов; не пересекается с x и y
+ * @param method Способ
+ */
+void Correlate(const Complex* x, size_t n, const Complex* y, size_t m, Complex* out,
+               ConvolutionMethod method = ConvolutionMethod::Auto);
+
+/**
+ * @brief КИХ-фильтр свёрткой по разбиениям (uniformly partitioned
+ * overlap-save): выход идёт порциями по B отсчётов и отстаёт от входа не
+ * больше чем на B - 1 при любой длине фильтра.
+ *
+ * Отводы делятся на P = ceil(M / B) кусков по B, спектр каждого (БПФ длины
+ * 2B) считается один раз. На каждый блок входа — одно прямое БПФ окна
+ * [предыдущий блок][текущий], P умножений с накоплением со спектрами
+ * прошлых блоков (линия задержки в частотной области) и одно обратное БПФ.
+ * Начальная история — нули.
+ */
+class PartitionedConvolver : public StreamStage {
+private:
+    shared_ptr<const FftPlan> plan_;  /**< План БПФ длины 2B.*/
+    ComplexVector spectra_;           /**< P спектров кусков отводов по 2B.*/
+    ComplexVector delayLine_;         /**< P спектров последних блоков входа (кольцо).*/
+    ComplexVector window_;            /**< [предыдущий блок][текущий блок].*/
+    ComplexVector work_;              /**< Накопленный спектр выхода.*/
+    size_t block_;                    /**< B.*/
+    size_t partitions_;               /**< P.*/
+    size_t newest_;                   /**< Слот delayLine_ с последним блоком.*/
+    size_t filled_;                   /**< Новых отсчётов в текущем блоке.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param taps Отводы h[0..count)
+    * @param count Число отводов M (не 0)
+    * @param block Длина блока B — степень двойки
+    * @throws invalid_argument при count == 0 или если block — не степень двойки
+    */
+    PartitionedConvolver(const Complex* taps, size_t count, size_t block = 64);
+
+    const char* Name() const noexcept override { return "partitioned"; }
+    size_t MaxOutput(size_t n) const noexcept override { return (n + block_ - 1) / block_ * block_; }
+    size_t Process(const Complex* in, size_t n, Complex* out) override;
+    void Reset() override;
+
+    /** Длина блока B */
+    size_t BlockLength() const noexcept { return block_; }
+    /** Число кусков отводов P */
+    size_t Partitions() const noexcept { return partitions_; }
+};
+
+/**
+ * @brief Потоковый КИХ-фильтр быстрейшего способа, выход которого идёт
+ * порциями не длиннее maxBlock: FirFilter (перекрытие с накоплением, блок
+ * БПФ по текущей настройке), если его порция укладывается, иначе
+ * PartitionedConvolver с наибольшим блоком-степенью двойки не длиннее maxBlock.
+ * @param taps Отводы
+ * @param count Число отводов (не 0)
+ * @param maxBlock Наибольшая порция выхода; 0 — без ограничения
+ * @throws invalid_argument при count == 0
+ */
+unique_ptr<StreamStage> MakeConvolver(const Complex* taps, size_t count, size_t maxBlock = 0);
+
+#endif // COMPLEX_CONVOLUTION_H
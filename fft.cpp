@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include "allocator.h"
+#include "fft.h"
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+/**
+ * @brief exp(-2*pi*i*k/n), вычисленное напрямую (без накопления ошибки рекурсии).
+ */
+Complex UnitRoot(size_t k, size_t n) {
+    double angle = -2.0 * kPi * double(k) / double(n);
+    return Complex(cos(angle), sin(angle));
+}
+
+bool IsPowerOfTwo(size_t n) {
+    return n && !(n & (n - 1));
+}
+
+unsigned Log2(size_t n) {
+    unsigned log = 0;
+    while ((size_t(1) << log) < n) {
+        ++log;
+    }
+    return log;
+}
+
+inline Complex Conj(const Complex& z) {
+    return Complex(z.Re(), -z.Im());
+}
+
+/**
+ * @brief Блочная транспозиция: dst[c * rows + r] = src[r * cols + c].
+ * Плитки 32x32 элемента (16 КБ) помещаются в L1 вместе с обеими сторонами.
+ */
+void Transpose(const Complex* src, Complex* dst, size_t rows, size_t cols) {
+    const size_t kTile = 32;
+    for (size_t r0 = 0; r0 < rows; r0 += kTile) {
+        size_t r1 = min(rows, r0 + kTile);
+        for (size_t c0 = 0; c0 < cols; c0 += kTile) {
+            size_t c1 = min(cols, c0 + kTile);
+            for (size_t r = r0; r < r1; ++r) {
+                for (size_t c = c0; c < c1; ++c) {
+                    dst[c * rows + r] = src[r * cols + c];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Этапы radix-4 (с прореживанием по времени) над данными в
+ * бит-реверсном порядке. Для нечётного log2 n сначала идёт этап radix-2.
+ * @param data Данные длины n
+ * @param n Длина (степень двойки)
+ * @param w Множители этапов: для каждого этапа 6h чисел (см. SimdKernels::fftRadix4Stage)
+ * @param inverse Обратное преобразование
+ */
+void Radix4Stages(Complex* data, size_t n, const double* w, bool inverse) {
+    size_t h = 1;
+    if (Log2(n) % 2) {
+        for (size_t i = 0; i < n; i += 2) {
+            Complex a = data[i], b = data[i + 1];
+            data[i] = a + b;
+            data[i + 1] = a - b;
+        }
+        h = 2;
+    }
+    const SimdKernels& kernels = ActiveKernels();
+    for (; 4 * h <= n; h *= 4) {
+        kernels.fftRadix4Stage(reinterpret_cast<double*>(data), n, h, w, inverse);
+        w += 6 * h;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор: строит план и все таблицы для длины size
+ * @param size Длина преобразования
+ */
+FftPlan::FftPlan(size_t size) : size_(size), kind_(Kind::Trivial), scratchSize_(0), rows_(0), cols_(0) {
+    if (size <= 1) {
+        return;
+    }
+    if (!IsPowerOfTwo(size)) {
+        InitBluestein();
+    } else if (size >= kFourStepThreshold) {
+        InitFourStep();
+    } else {
+        InitRadix4();
+    }
+}
+
+void FftPlan::InitRadix4() {
+    kind_ = Kind::Radix4;
+    unsigned log = Log2(size_);
+    bitReverse_.resize(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        size_t r = 0;
+        for (unsigned b = 0; b < log; ++b) {
+            r |= ((i >> b) & 1) << (log - 1 - b);
+        }
+        bitReverse_[i] = uint32_t(r);
+    }
+    // Для каждого этапа: re W^k, im W^k, re W^2k, ... — по h чисел подряд.
+    for (size_t h = (log % 2) ? 2 : 1; 4 * h <= size_; h *= 4) {
+        size_t base = stageTwiddles_.size();
+        stageTwiddles_.resize(base + 6 * h);
+        for (size_t k = 0; k < h; ++k) {
+            for (size_t m = 1; m <= 3; ++m) {
+                Complex w = UnitRoot(m * k, 4 * h);
+                stageTwiddles_[base + (2 * m - 2) * h + k] = w.Re();
+                stageTwiddles_[base + (2 * m - 1) * h + k] = w.Im();
+            }
+        }
+    }
+}
+
+void FftPlan::InitFourStep() {
+    kind_ = Kind::FourStep;
+    unsigned log = Log2(size_);
+    rows_ = size_t(1) << (log / 2);
+    cols_ = size_ / rows_;
+    rowPlan_ = Get(rows_);
+    colPlan_ = Get(cols_);
+    twiddles_.resize(size_);
+    for (size_t k1 = 0; k1 < rows_; ++k1) {
+        for (size_t n2 = 0; n2 < cols_; ++n2) {
+            twiddles_[k1 * cols_ + n2] = UnitRoot(k1 * n2, size_);
+        }
+    }
+    scratchSize_ = size_ + kColumnBlock * rows_ + max(rowPlan_->ScratchSize(), colPlan_->ScratchSize());
+}
+
+void FftPlan::InitBluestein() {
+    kind_ = Kind::Bluestein;
+    size_t m = size_t(1) << Log2(2 * size_ - 1);
+    rowPlan_ = Get(m);
+    // Чирп w[k] = exp(-i*pi*k^2/N); k^2 берётся по модулю 2N, чтобы аргумент
+    // оставался малым и точным для больших k.
+    twiddles_.resize(size_);
+    size_t square = 0;
+    for (size_t k = 0; k < size_; ++k) {
+        if (k) {
+            square = (square + 2 * k - 1) % (2 * size_);
+        }
+        twiddles_[k] = UnitRoot(square, 2 * size_);
+    }
+    filter_.assign(m, Complex());
+    filter_[0] = Conj(twiddles_[0]);
+    for (size_t k = 1; k < size_; ++k) {
+        filter_[k] = filter_[m - k] = Conj(twiddles_[k]);
+    }
+    vector<Complex> sub(rowPlan_->ScratchSize());
+    rowPlan_->Run(filter_.data(), filter_.data(), false, sub.data());
+    // Нормировка обратного БПФ свёртки заранее внесена в фильтр.
+    for (Complex& f : filter_) {
+        f /= double(m);
+    }
+    scratchSize_ = m + rowPlan_->ScratchSize();
+}
+
+/**
+ * @brief Возвращает план из общего кэша, создавая его при первом запросе.
+ */
+shared_ptr<const FftPlan> FftPlan::Get(size_t size) {
+    static mutex cacheMutex;
+    static map<size_t, shared_ptr<const FftPlan>> cache;
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto it = cache.find(size);
+        if (it != cache.end()) {
+            return it->second;
+        }
+    }
+    // План строится вне блокировки: конструктор сам запрашивает подпланы.
+    shared_ptr<const FftPlan> plan = make_shared<FftPlan>(size);
+    lock_guard<mutex> lock(cacheMutex);
+    return cache.emplace(size, plan).first->second;
+}
+
+/**
+ * @brief Выполняет преобразование. in и out могут совпадать.
+ */
+void FftPlan::Execute(const Complex* in, Complex* out, FftDirection direction, Complex* scratch) const {
+    COMPLEX_PROFILE_KERNEL("fft.execute", size_);
+    bool inverse = direction == FftDirection::Inverse;
+    ArenaFrame frame;
+    if (!scratch && scratchSize_) {
+        scratch = frame.Allocate<Complex>(scratchSize_);
+    }
+    Run(in, out, inverse, scratch);
+    if (inverse && size_ > 1) {
+        double scale = 1.0 / double(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            out[i] *= scale;
+        }
+    }
+}
+
+// Ненормированное преобразование; подпланы вызываются только через Run.
+void FftPlan::Run(const Complex* in, Complex* out, bool inverse, Complex* scratch) const {
+    switch (kind_) {
+    case Kind::Trivial:
+        if (size_ == 1 && in != out) {
+            out[0] = in[0];
+        }
+        break;
+    case Kind::Radix4:
+        RunRadix4(in, out, inverse);
+        break;
+    case Kind::FourStep:
+        RunFourStep(in, out, inverse, scratch);
+        break;
+    case Kind::Bluestein:
+        RunBluestein(in, out, inverse, scratch);
+        break;
+    }
+}
+
+void FftPlan::RunRadix4(const Complex* in, Complex* out, bool inverse) const {
+    if (in != out) {
+        for (size_t i = 0; i < size_; ++i) {
+            out[bitReverse_[i]] = in[i];
+        }
+    } else {
+        for (size_t i = 0; i < size_; ++i) {
+            size_t j = bitReverse_[i];
+            if (i < j) {
+                swap(out[i], out[j]);
+            }
+        }
+    }
+    Radix4Stages(out, size_, stageTwiddles_.data(), inverse);
+}
+
+// Четырёхшаговая схема: вход рассматривается как матрица N1 x N2
+// (n = N2 * n1 + n2), выход — как X[k1 + N1 * k2]. Столбцы обрабатываются
+// блоками по kColumnBlock: блок собирается в компактный буфер, получает БПФ
+// длины N1 и возвращается на место уже умноженным на W_N^(k1 * n2).
+void FftPlan::RunFourStep(const Complex* in, Complex* out, bool inverse, Complex* scratch) const {
+    Complex* t = scratch;
+    Complex* block = scratch + size_;
+    Complex* sub = block + kColumnBlock * rows_;
+    for (size_t c0 = 0; c0 < cols_; c0 += kColumnBlock) {
+        for (size_t r = 0; r < rows_; ++r) {
+            for (size_t b = 0; b < kColumnBlock; ++b) {
+                block[b * rows_ + r] = in[r * cols_ + c0 + b];
+            }
+        }
+        for (size_t b = 0; b < kColumnBlock; ++b) {
+            rowPlan_->Run(block + b * rows_, block + b * rows_, inverse, sub);
+        }
+        for (size_t k1 = 0; k1 < rows_; ++k1) {
+            const Complex* w = twiddles_.data() + k1 * cols_ + c0;
+            for (size_t b = 0; b < kColumnBlock; ++b) {
+                out[k1 * cols_ + c0 + b] = block[b * rows_ + k1] * (inverse ? Conj(w[b]) : w[b]);
+            }
+        }
+    }
+    // БПФ длины N2 по строкам (строки уже непрерывны), затем транспозиция
+    // в порядок X[k1 + N1 * k2].
+    for (size_t k1 = 0; k1 < rows_; ++k1) {
+        colPlan_->Run(out + k1 * cols_, t + k1 * cols_, inverse, sub);
+    }
+    Transpose(t, out, rows_, cols_);
+}
+
+// Блюстейн: X[k] = w[k] * sum x[n] w[n] conj(w[k - n]) — свёртка через БПФ
+// длины M. Обратное преобразование сводится к прямому через сопряжение.
+void FftPlan::RunBluestein(const Complex* in, Complex* out, bool inverse, Complex* scratch) const {
+    size_t m = filter_.size();
+    Complex* a = scratch;
+    Complex* sub = scratch + m;
+    for (size_t k = 0; k < size_; ++k) {
+        a[k] = (inverse ? Conj(in[k]) : in[k]) * twiddles_[k];
+    }
+    fill(a + size_, a + m, Complex());
+    rowPlan_->Run(a, a, false, sub);
+    for (size_t k = 0; k < m; ++k) {
+        a[k] *= filter_[k];
+    }
+    rowPlan_->Run(a, a, true, sub);
+    for (size_t k = 0; k < size_; ++k) {
+        Complex x = a[k] * twiddles_[k];
+        out[k] = inverse ? Conj(x) : x;
+    }
+}
+
+void Fft(Complex* data, size_t n) {
+    FftPlan::Get(n)->Forward(data);
+}
+
+void InverseFft(Complex* data, size_t n) {
+    FftPlan::Get(n)->Inverse(data);
+}
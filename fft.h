@@ -0,0 +1,127 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "mycomplex.h"
+
+/**
+ * @brief Направление преобразования Фурье.
+ */
+enum class FftDirection {
+    Forward,  /**< X[k] = sum x[n] * exp(-2*pi*i*n*k/N) */
+    Inverse   /**< x[n] = (1/N) * sum X[k] * exp(+2*pi*i*n*k/N) */
+};
+
+/**
+ * @brief План быстрого преобразования Фурье заданной длины.
+ *
+ * План хранит заранее вычисленные таблицы поворачивающих множителей и
+ * выбирает алгоритм по длине:
+ *  - степень двойки до kFourStepThreshold: radix-4 (и один radix-2 этап
+ *    для нечётного log2 N) на месте после бит-реверсной перестановки;
+ *    этапы radix-4 считает ядро SimdKernels::fftRadix4Stage выбранного
+ *    уровня инструкций (результат на всех уровнях одинаков до бита);
+ *  - большие степени двойки: четырёхшаговая схема N = N1 * N2, в которой
+ *    столбцы обрабатываются блоками, чтобы подпреобразования помещались в кэш;
+ *  - остальные длины: алгоритм Блюстейна через БПФ длины 2^m >= 2N - 1.
+ *
+ * Готовый план неизменяем, поэтому один план можно выполнять из нескольких
+ * потоков одновременно, если у каждого свой буфер scratch.
+ */
+class FftPlan {
+private:
+    enum class Kind { Trivial, Radix4, FourStep, Bluestein };
+
+    size_t size_;                    /**< Длина преобразования.*/
+    Kind kind_;                      /**< Выбранный алгоритм.*/
+    size_t scratchSize_;             /**< Размер рабочего буфера (в элементах).*/
+    vector<uint32_t> bitReverse_;    /**< Бит-реверсная перестановка (Radix4).*/
+    vector<double> stageTwiddles_;   /**< Множители этапов radix-4: на этап h раздельно re/im W^k, W^2k, W^3k (6h чисел).*/
+    vector<Complex> twiddles_;       /**< Множители шага 2 четырёхшаговой схемы / чирп Блюстейна.*/
+    vector<Complex> filter_;         /**< БПФ фильтра Блюстейна, деленное на M.*/
+    size_t rows_;                    /**< N1 для четырёхшаговой схемы.*/
+    size_t cols_;                    /**< N2 для четырёхшаговой схемы.*/
+    shared_ptr<const FftPlan> rowPlan_;  /**< Подплан длины N1 (или M для Блюстейна).*/
+    shared_ptr<const FftPlan> colPlan_;  /**< Подплан длины N2.*/
+
+    void InitRadix4();
+    void InitFourStep();
+    void InitBluestein();
+
+    void Run(const Complex* in, Complex* out, bool inverse, Complex* scratch) const;
+    void RunRadix4(const Complex* in, Complex* out, bool inverse) const;
+    void RunFourStep(const Complex* in, Complex* out, bool inverse, Complex* scratch) const;
+    void RunBluestein(const Complex* in, Complex* out, bool inverse, Complex* scratch) const;
+
+public:
+    /** Степени двойки от этой длины (2 МБ данных) считаются четырёхшаговой схемой. */
+    static const size_t kFourStepThreshold = size_t(1) << 17;
+
+    /** Сколько столбцов за раз собирается в буфер в четырёхшаговой схеме. */
+    static const size_t kColumnBlock = 16;
+
+    /**
+    * @brief Конструктор: строит план и все таблицы для длины size
+    * @param size Длина преобразования (любая, включая 0 и 1)
+    */
+    explicit FftPlan(size_t size);
+
+    FftPlan(const FftPlan&) = delete;
+    FftPlan& operator=(const FftPlan&) = delete;
+
+    /**
+    * @brief Возвращает план из общего кэша, создавая его при первом запросе.
+    * Безопасно вызывать из нескольких потоков.
+    * @param size Длина преобразования
+    * @return Разделяемый план
+    */
+    static shared_ptr<const FftPlan> Get(size_t size);
+
+    size_t Size() const noexcept { return size_; }
+
+    /**
+    * @brief Размер рабочего буфера для Execute (0, если не нужен)
+    */
+    size_t ScratchSize() const noexcept { return scratchSize_; }
+
+    /**
+    * @brief Выполняет преобразование. in и out могут совпадать (на месте).
+    * @param in Входной массив длины Size()
+    * @param out Выходной массив длины Size()
+    * @param direction Направление (обратное нормируется на 1/N)
+    * @param scratch Рабочий буфер из ScratchSize() элементов; если nullptr,
+    *                а буфер нужен, он берётся из арены потока (ThreadArena())
+    */
+    void Execute(const Complex* in, Complex* out, FftDirection direction, Complex* scratch = nullptr) const;
+
+    /** Прямое преобразование на месте */
+    void Forward(Complex* data) const { Execute(data, data, FftDirection::Forward); }
+
+    /** Обратное преобразование на месте */
+    void Inverse(Complex* data) const { Execute(data, data, FftDirection::Inverse); }
+
+    /** Прямое преобразование из in в out */
+    void Forward(const Complex* in, Complex* out) const { Execute(in, out, FftDirection::Forward); }
+
+    /** Обратное преобразование из in в out */
+    void Inverse(const Complex* in, Complex* out) const { Execute(in, out, FftDirection::Inverse); }
+};
+
+/**
+ * @brief Прямое БПФ на месте с планом из общего кэша
+ * @param data Массив длины n
+ * @param n Длина
+ */
+void Fft(Complex* data, size_t n);
+
+/**
+ * @brief Обратное БПФ на месте (с нормировкой 1/n) с планом из общего кэша
+ * @param data Массив длины n
+ * @param n Длина
+ */
+void InverseFft(Complex* data, size_t n);
+
+#endif // FFT_H
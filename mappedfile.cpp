@@ -0,0 +1,142 @@
+#include "mappedfile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string& path, Mode mode)
+    : data_(nullptr), size_(0), mode_(mode), file_(INVALID_HANDLE_VALUE), mapping_(nullptr) {
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        throw runtime_error("MappedFile: не удалось открыть " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size)) {
+        Close();
+        throw runtime_error("MappedFile: не удалось узнать размер " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+    mapping_ = CreateFileMappingA(file_, nullptr, mode == Mode::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY,
+                                  0, 0, nullptr);
+    if (mapping_) {
+        DWORD access = mode == Mode::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ;
+        data_ = static_cast<char*>(MapViewOfFile(mapping_, access, 0, 0, 0));
+    }
+    if (!data_) {
+        Close();
+        throw runtime_error("MappedFile: не удалось отобразить " + path);
+    }
+}
+
+/**
+ * @brief Переводит отображение в режим CopyOnWrite
+ */
+void MappedFile::EnableCopyOnWrite() {
+    if (mode_ == Mode::CopyOnWrite) {
+        return;
+    }
+    if (size_ != 0) {
+        // Права вида ограничены правами секции: нужна новая секция и новый вид.
+        void* mapping = CreateFileMappingA(file_, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        char* data = mapping ? static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0)) : nullptr;
+        if (!data) {
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+            throw runtime_error("MappedFile: не удалось отобразить файл с копированием при записи");
+        }
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        data_ = data;
+        mapping_ = mapping;
+    }
+    mode_ = Mode::CopyOnWrite;
+}
+
+void MappedFile::Close() noexcept {
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+        CloseHandle(mapping_);
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_);
+    }
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile(const string& path, Mode mode) : data_(nullptr), size_(0), mode_(mode) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("MappedFile: не удалось открыть " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("MappedFile: не удалось узнать размер " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ != 0) {
+        int protection = mode == Mode::CopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* p = mmap(nullptr, size_, protection, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("MappedFile: не удалось отобразить " + path);
+        }
+        // Файл читается подряд: просим ОС подгружать страницы с опережением.
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<char*>(p);
+    }
+    // Отображение держит файл само, дескриптор больше не нужен.
+    close(fd);
+}
+
+/**
+ * @brief Переводит отображение в режим CopyOnWrite
+ */
+void MappedFile::EnableCopyOnWrite() {
+    if (mode_ == Mode::CopyOnWrite) {
+        return;
+    }
+    // Закрытое (MAP_PRIVATE) отображение можно открыть для записи и при файле,
+    // открытом только на чтение; память под копии страниц учитывается здесь.
+    if (size_ != 0 && mprotect(data_, size_, PROT_READ | PROT_WRITE) != 0) {
+        throw runtime_error("MappedFile: не удалось разрешить запись в отображение");
+    }
+    mode_ = Mode::CopyOnWrite;
+}
+
+void MappedFile::Close() noexcept {
+    if (data_) {
+        munmap(data_, size_);
+    }
+    data_ = nullptr;
+}
+
+#endif
+
+/**
+ * @brief Деструктор: снимает отображение и закрывает файл
+ */
+MappedFile::~MappedFile() {
+    Close();
+}
@@ -0,0 +1,78 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief Файл, отображённый в память.
+ *
+ * Данные доступны как обычный буфер, страницы подгружает ОС по мере
+ * чтения — без копирования через буферы потока. Пустой файл отображается
+ * в пустой буфер (Data() == nullptr, Size() == 0).
+ *
+ * В режиме копирования при записи страницы можно менять: изменённая
+ * страница копируется в память процесса, файл на диске не меняется. Такое
+ * отображение ОС целиком учитывает в выделенной памяти (commit charge), и
+ * файл больше свободной памяти может не отобразиться; поэтому по умолчанию
+ * файл отображается только для чтения, а запись включается явно
+ * (EnableCopyOnWrite).
+ */
+class MappedFile {
+public:
+    /**
+    * @brief Режим отображения.
+    */
+    enum class Mode {
+        ReadOnly,     /**< Только чтение.*/
+        CopyOnWrite   /**< Запись разрешена, но не попадает в файл.*/
+    };
+
+private:
+    char* data_;        /**< Начало отображения.*/
+    size_t size_;       /**< Длина файла в байтах.*/
+    Mode mode_;         /**< Текущий режим.*/
+#ifdef _WIN32
+    void* file_;        /**< Дескриптор файла.*/
+    void* mapping_;     /**< Дескриптор отображения.*/
+#endif
+
+    void Close() noexcept;
+
+public:
+    /**
+    * @brief Открывает и отображает файл
+    * @param path Путь к файлу
+    * @param mode Только чтение (по умолчанию) или копирование при записи
+    * @throws runtime_error, если файл не открывается или не отображается
+    */
+    explicit MappedFile(const string& path, Mode mode = Mode::ReadOnly);
+
+    /**
+    * @brief Деструктор: снимает отображение и закрывает файл
+    */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+    * @brief Переводит отображение в режим CopyOnWrite (в нём — ничего не делает).
+    * На POSIX адрес данных сохраняется; на Windows отображение создаётся
+    * заново, и прежние указатели на данные становятся недействительными.
+    * @throws runtime_error, если ОС не выделяет память под копии страниц
+    */
+    void EnableCopyOnWrite();
+
+    Mode GetMode() const noexcept { return mode_; }
+    const char* Data() const noexcept { return data_; }
+    /** Изменяемые данные; писать можно только в режиме CopyOnWrite */
+    char* MutableData() noexcept { return data_; }
+    size_t Size() const noexcept { return size_; }
+    const char* begin() const noexcept { return data_; }
+    const char* end() const noexcept { return data_ + size_; }
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,465 @@
+#include "matrix.h"
+#include <algorithm>
+#include <stdexcept>
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+// Размеры блоков Gemm: панель B kc x nc — в L3, блок A mc x kc — в L2,
+// панель B kc x ширина плитки — в L1.
+const size_t kGemmDepth = 256;      /**< kc.*/
+const size_t kGemmBlockRows = 64;   /**< mc (кратно kGemmRows и gemmRealRows).*/
+const size_t kGemmBlockCols = 1024; /**< nc (кратно 2 * gemmCols).*/
+
+// GemmBatch для массивов Complex перекладывает матрицы по группе: все части
+// группы остаются в L1.
+const size_t kBatchChunk = ComplexMatrixBatch::kGroup;
+
+/** Доступ к частям элемента (r, c): re[r * rowStride + c * colStride] */
+struct MatrixView {
+    double* re;
+    double* im;
+    size_t rowStride;
+    size_t colStride;
+
+    size_t Offset(size_t r, size_t c) const { return r * rowStride + c * colStride; }
+};
+
+MatrixView View(const ComplexMatrix& m) {
+    bool rowMajor = m.Order() == MatrixOrder::RowMajor;
+    size_t rs = rowMajor ? m.Cols() : 1, cs = rowMajor ? 1 : m.Rows();
+    if (m.Storage() == MatrixStorage::Interleaved) {
+        double* base = const_cast<double*>(reinterpret_cast<const double*>(m.Data()));
+        return MatrixView{base, base + 1, 2 * rs, 2 * cs};
+    }
+    return MatrixView{const_cast<double*>(m.Re()), const_cast<double*>(m.Im()), rs, cs};
+}
+
+size_t RoundUp(size_t n, size_t step) {
+    return (n + step - 1) / step * step;
+}
+
+/** Что класть в панель: обе части или одну величину на элемент (3M) */
+enum class Part { Both, Re, Im, Sum };
+
+/**
+ * @brief Упаковывает блок count x depth в панели по width: элемент (q, p)
+ * лежит по смещению q * qStride + p * pStride. В панели на каждый шаг p —
+ * width значений (при Part::Both — width re, затем width im); недостающие
+ * до width дополняются нулями.
+ */
+void Pack(const MatrixView& v, size_t qStride, size_t pStride, size_t q0, size_t count, size_t p0, size_t depth,
+          size_t width, Part part, double* dst) {
+    for (size_t panel = 0; panel < count; panel += width) {
+        size_t used = min(width, count - panel);
+        for (size_t p = 0; p < depth; ++p) {
+            double* im = dst + width;
+            for (size_t q = 0; q < width; ++q) {
+                double x = 0, y = 0;
+                if (q < used) {
+                    size_t offset = (q0 + panel + q) * qStride + (p0 + p) * pStride;
+                    x = v.re[offset];
+                    y = v.im[offset];
+                }
+                switch (part) {
+                case Part::Both: dst[q] = x; im[q] = y; break;
+                case Part::Re: dst[q] = x; break;
+                case Part::Im: dst[q] = y; break;
+                case Part::Sum: dst[q] = x + y; break;
+                }
+            }
+            dst += part == Part::Both ? 2 * width : width;
+        }
+    }
+}
+
+/** Блок A (строки i0.., столбцы p0..) в панели по width строк */
+void PackA(const MatrixView& a, size_t i0, size_t rows, size_t p0, size_t depth, size_t width, Part part,
+           double* dst) {
+    Pack(a, a.rowStride, a.colStride, i0, rows, p0, depth, width, part, dst);
+}
+
+/** Блок B (строки p0.., столбцы j0..) в панели по width столбцов */
+void PackB(const MatrixView& b, size_t p0, size_t depth, size_t j0, size_t cols, size_t width, Part part,
+           double* dst) {
+    Pack(b, b.colStride, b.rowStride, j0, cols, p0, depth, width, part, dst);
+}
+
+/** C[i.., j..] += alpha * плитка (строки плитки — с шагом stride) */
+void Accumulate(const MatrixView& c, size_t i, size_t j, size_t rows, size_t cols, const double* tr,
+                const double* ti, size_t stride, const Complex& alpha) {
+    bool unit = alpha.Re() == 1 && alpha.Im() == 0;
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t q = 0; q < cols; ++q) {
+            size_t offset = c.Offset(i + r, j + q);
+            double x = tr[r * stride + q], y = ti[r * stride + q];
+            if (unit) {
+                c.re[offset] += x;
+                c.im[offset] += y;
+            } else {
+                c.re[offset] += alpha.Re() * x - alpha.Im() * y;
+                c.im[offset] += alpha.Re() * y + alpha.Im() * x;
+            }
+        }
+    }
+}
+
+/** C = beta * C; при beta == 0 — нули, даже если в C были NaN */
+void ScaleMatrix(ComplexMatrix& c, const Complex& beta) {
+    if (beta.Re() == 1 && beta.Im() == 0) {
+        return;
+    }
+    if (beta.Re() == 0 && beta.Im() == 0) {
+        c.Fill(Complex());
+        return;
+    }
+    MatrixView v = View(c);
+    for (size_t r = 0; r < c.Rows(); ++r) {
+        for (size_t q = 0; q < c.Cols(); ++q) {
+            size_t offset = v.Offset(r, q);
+            Complex z = beta * Complex(v.re[offset], v.im[offset]);
+            v.re[offset] = z.Re();
+            v.im[offset] = z.Im();
+        }
+    }
+}
+
+/**
+ * @brief 4M: плитка kGemmRows x gemmCols считается комплексным микроядром.
+ */
+void Gemm4M(const MatrixView& a, const MatrixView& b, const MatrixView& c, size_t m, size_t n, size_t k,
+            const Complex& alpha) {
+    const SimdKernels& kernels = ActiveKernels();
+    const size_t mr = kGemmRows, nr = kernels.gemmCols;
+    ArenaFrame frame;
+    double* packA = frame.Allocate<double>(2 * RoundUp(kGemmBlockRows, mr) * kGemmDepth);
+    double* packB = frame.Allocate<double>(2 * RoundUp(kGemmBlockCols, nr) * kGemmDepth);
+    double* tileRe = frame.Allocate<double>(mr * nr);
+    double* tileIm = frame.Allocate<double>(mr * nr);
+    for (size_t jc = 0; jc < n; jc += kGemmBlockCols) {
+        size_t nb = min(kGemmBlockCols, n - jc);
+        for (size_t pc = 0; pc < k; pc += kGemmDepth) {
+            size_t kb = min(kGemmDepth, k - pc);
+            PackB(b, pc, kb, jc, nb, nr, Part::Both, packB);
+            for (size_t ic = 0; ic < m; ic += kGemmBlockRows) {
+                size_t mb = min(kGemmBlockRows, m - ic);
+                PackA(a, ic, mb, pc, kb, mr, Part::Both, packA);
+                for (size_t jr = 0; jr < nb; jr += nr) {
+                    const double* panelB = packB + (jr / nr) * 2 * nr * kb;
+                    for (size_t ir = 0; ir < mb; ir += mr) {
+                        kernels.gemmTile(kb, packA + (ir / mr) * 2 * mr * kb, panelB, tileRe, tileIm);
+                        Accumulate(c, ic + ir, jc + jr, min(mr, mb - ir), min(nr, nb - jr), tileRe, tileIm, nr, alpha);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 3M: T1 = Ar Br, T2 = Ai Bi, T3 = (Ar + Ai)(Br + Bi) вещественным
+ * микроядром; Re = T1 - T2, Im = T3 - T1 - T2.
+ */
+void Gemm3M(const MatrixView& a, const MatrixView& b, const MatrixView& c, size_t m, size_t n, size_t k,
+            const Complex& alpha) {
+    const SimdKernels& kernels = ActiveKernels();
+    const size_t mr = kernels.gemmRealRows, nr = 2 * kernels.gemmCols;
+    const size_t sizeA = RoundUp(kGemmBlockRows, mr) * kGemmDepth, sizeB = RoundUp(kGemmBlockCols, nr) * kGemmDepth;
+    const Part parts[3] = {Part::Re, Part::Im, Part::Sum};
+    ArenaFrame frame;
+    double* packA = frame.Allocate<double>(3 * sizeA);
+    double* packB = frame.Allocate<double>(3 * sizeB);
+    double* tiles = frame.Allocate<double>(3 * mr * nr);
+    double* tileRe = frame.Allocate<double>(mr * nr);
+    double* tileIm = frame.Allocate<double>(mr * nr);
+    for (size_t jc = 0; jc < n; jc += kGemmBlockCols) {
+        size_t nb = min(kGemmBlockCols, n - jc);
+        for (size_t pc = 0; pc < k; pc += kGemmDepth) {
+            size_t kb = min(kGemmDepth, k - pc);
+            for (size_t s = 0; s < 3; ++s) {
+                PackB(b, pc, kb, jc, nb, nr, parts[s], packB + s * sizeB);
+            }
+            for (size_t ic = 0; ic < m; ic += kGemmBlockRows) {
+                size_t mb = min(kGemmBlockRows, m - ic);
+                for (size_t s = 0; s < 3; ++s) {
+                    PackA(a, ic, mb, pc, kb, mr, parts[s], packA + s * sizeA);
+                }
+                for (size_t jr = 0; jr < nb; jr += nr) {
+                    size_t offsetB = (jr / nr) * nr * kb;
+                    for (size_t ir = 0; ir < mb; ir += mr) {
+                        size_t offsetA = (ir / mr) * mr * kb;
+                        for (size_t s = 0; s < 3; ++s) {
+                            kernels.gemmTileReal(kb, packA + s * sizeA + offsetA, packB + s * sizeB + offsetB,
+                                                 tiles + s * mr * nr);
+                        }
+                        const double *t1 = tiles, *t2 = tiles + mr * nr, *t3 = tiles + 2 * mr * nr;
+                        for (size_t e = 0; e < mr * nr; ++e) {
+                            tileRe[e] = t1[e] - t2[e];
+                            tileIm[e] = t3[e] - t1[e] - t2[e];
+                        }
+                        Accumulate(c, ic + ir, jc + jr, min(mr, mb - ir), min(nr, nb - jr), tileRe, tileIm, nr, alpha);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+ComplexMatrix::ComplexMatrix(size_t rows, size_t cols, MatrixOrder order, MatrixStorage storage)
+    : rows_(rows), cols_(cols), order_(order), storage_(storage), data_(2 * rows * cols, 0.0) {}
+
+ComplexMatrix ComplexMatrix::Identity(size_t n, MatrixOrder order, MatrixStorage storage) {
+    ComplexMatrix m(n, n, order, storage);
+    for (size_t i = 0; i < n; ++i) {
+        m.Set(i, i, Complex(1.0));
+    }
+    return m;
+}
+
+Complex ComplexMatrix::Get(size_t r, size_t c) const noexcept {
+    size_t i = Index(r, c);
+    if (storage_ == MatrixStorage::Interleaved) {
+        return Complex(data_[2 * i], data_[2 * i + 1]);
+    }
+    return Complex(data_[i], data_[rows_ * cols_ + i]);
+}
+
+void ComplexMatrix::Set(size_t r, size_t c, const Complex& z) noexcept {
+    size_t i = Index(r, c);
+    if (storage_ == MatrixStorage::Interleaved) {
+        data_[2 * i] = z.Re();
+        data_[2 * i + 1] = z.Im();
+    } else {
+        data_[i] = z.Re();
+        data_[rows_ * cols_ + i] = z.Im();
+    }
+}
+
+void ComplexMatrix::Fill(const Complex& z) noexcept {
+    size_t count = rows_ * cols_;
+    for (size_t i = 0; i < count; ++i) {
+        if (storage_ == MatrixStorage::Interleaved) {
+            data_[2 * i] = z.Re();
+            data_[2 * i + 1] = z.Im();
+        } else {
+            data_[i] = z.Re();
+            data_[count + i] = z.Im();
+        }
+    }
+}
+
+Complex* ComplexMatrix::Data() noexcept {
+    return storage_ == MatrixStorage::Interleaved ? reinterpret_cast<Complex*>(data_.data()) : nullptr;
+}
+
+const Complex* ComplexMatrix::Data() const noexcept {
+    return storage_ == MatrixStorage::Interleaved ? reinterpret_cast<const Complex*>(data_.data()) : nullptr;
+}
+
+double* ComplexMatrix::Re() noexcept {
+    return storage_ == MatrixStorage::Split ? data_.data() : nullptr;
+}
+
+const double* ComplexMatrix::Re() const noexcept {
+    return storage_ == MatrixStorage::Split ? data_.data() : nullptr;
+}
+
+double* ComplexMatrix::Im() noexcept {
+    return storage_ == MatrixStorage::Split ? data_.data() + rows_ * cols_ : nullptr;
+}
+
+const double* ComplexMatrix::Im() const noexcept {
+    return storage_ == MatrixStorage::Split ? data_.data() + rows_ * cols_ : nullptr;
+}
+
+ComplexMatrix ComplexMatrix::Convert(MatrixOrder order, MatrixStorage storage) const {
+    ComplexMatrix m(rows_, cols_, order, storage);
+    for (size_t r = 0; r < rows_; ++r) {
+        for (size_t c = 0; c < cols_; ++c) {
+            m.Set(r, c, Get(r, c));
+        }
+    }
+    return m;
+}
+
+void Gemm(const ComplexMatrix& a, const ComplexMatrix& b, ComplexMatrix& c, const Complex& alpha,
+          const Complex& beta, GemmMethod method) {
+    COMPLEX_PROFILE_KERNEL("matrix.gemm", a.Rows() * a.Cols() * b.Cols());
+    const size_t m = a.Rows(), k = a.Cols(), n = b.Cols();
+    if (b.Rows() != k) {
+        throw invalid_argument("Gemm: число столбцов A не равно числу строк B");
+    }
+    if (&c == &a || &c == &b) {
+        throw invalid_argument("Gemm: результат не может совпадать с сомножителем");
+    }
+    if (c.Rows() == 0 && c.Cols() == 0) {
+        c = ComplexMatrix(m, n);
+    } else if (c.Rows() != m || c.Cols() != n) {
+        throw invalid_argument("Gemm: размер C не равен m x n");
+    }
+    ScaleMatrix(c, beta);
+    if (m == 0 || n == 0 || k == 0 || (alpha.Re() == 0 && alpha.Im() == 0)) {
+        return;
+    }
+    if (method == GemmMethod::Auto) {
+        method = min(min(m, n), k) >= kGemm3MThreshold ? GemmMethod::ThreeM : GemmMethod::FourM;
+    }
+    if (method == GemmMethod::ThreeM) {
+        Gemm3M(View(a), View(b), View(c), m, n, k, alpha);
+    } else {
+        Gemm4M(View(a), View(b), View(c), m, n, k, alpha);
+    }
+}
+
+/**
+ * @brief По строкам — скалярные произведения строк A на x (dot), по
+ * столбцам — сумма столбцов A с весами x (axpy): память читается подряд.
+ */
+void Gemv(const ComplexMatrix& a, const Complex* x, Complex* y, const Complex& alpha, const Complex& beta) {
+    COMPLEX_PROFILE_KERNEL("matrix.gemv", a.Rows() * a.Cols());
+    const size_t m = a.Rows(), n = a.Cols();
+    const SimdKernels& kernels = ActiveKernels();
+    ArenaFrame frame;
+    Complex* acc = frame.Allocate<Complex>(m);
+    double* accPairs = reinterpret_cast<double*>(acc);
+    const double* xPairs = reinterpret_cast<const double*>(x);
+    bool interleaved = a.Storage() == MatrixStorage::Interleaved;
+    if (a.Order() == MatrixOrder::RowMajor) {
+        if (interleaved) {
+            const double* data = reinterpret_cast<const double*>(a.Data());
+            for (size_t i = 0; i < m; ++i) {
+                kernels.dotInterleaved(data + 2 * i * n, xPairs, n, false, false, accPairs + 2 * i);
+            }
+        } else {
+            double* xr = frame.Allocate<double>(n);
+            double* xi = frame.Allocate<double>(n);
+            kernels.deinterleave(xPairs, xr, xi, n);
+            for (size_t i = 0; i < m; ++i) {
+                kernels.dot(a.Re() + i * n, a.Im() + i * n, xr, xi, n, false, false, accPairs + 2 * i);
+            }
+        }
+    } else {
+        if (interleaved) {
+            fill(acc, acc + m, Complex());
+            const double* data = reinterpret_cast<const double*>(a.Data());
+            for (size_t j = 0; j < n; ++j) {
+                kernels.axpyInterleaved(x[j].Re(), x[j].Im(), data + 2 * j * m, accPairs, m);
+            }
+        } else {
+            double* accRe = frame.Allocate<double>(m);
+            double* accIm = frame.Allocate<double>(m);
+            fill(accRe, accRe + m, 0.0);
+            fill(accIm, accIm + m, 0.0);
+            for (size_t j = 0; j < n; ++j) {
+                kernels.axpy(x[j].Re(), x[j].Im(), a.Re() + j * m, a.Im() + j * m, accRe, accIm, m);
+            }
+            kernels.interleave(accRe, accIm, accPairs, m);
+        }
+    }
+    bool keep = beta.Re() != 0 || beta.Im() != 0;
+    for (size_t i = 0; i < m; ++i) {
+        y[i] = keep ? alpha * acc[i] + beta * y[i] : alpha * acc[i];
+    }
+}
+
+ComplexMatrixBatch::ComplexMatrixBatch(size_t count, size_t rows, size_t cols)
+    : count_(count), rows_(rows), cols_(cols), re_(RoundUp(count, kGroup) * rows * cols, 0.0),
+      im_(RoundUp(count, kGroup) * rows * cols, 0.0) {}
+
+Complex ComplexMatrixBatch::Get(size_t index, size_t r, size_t c) const noexcept {
+    size_t i = Offset(index, r, c);
+    return Complex(re_[i], im_[i]);
+}
+
+void ComplexMatrixBatch::Set(size_t index, size_t r, size_t c, const Complex& z) noexcept {
+    size_t i = Offset(index, r, c);
+    re_[i] = z.Re();
+    im_[i] = z.Im();
+}
+
+void ComplexMatrixBatch::Assign(const Complex* src) noexcept {
+    for (size_t t = 0; t < count_; ++t) {
+        for (size_t r = 0; r < rows_; ++r) {
+            for (size_t c = 0; c < cols_; ++c) {
+                Set(t, r, c, *src++);
+            }
+        }
+    }
+}
+
+void ComplexMatrixBatch::CopyTo(Complex* dst) const noexcept {
+    for (size_t t = 0; t < count_; ++t) {
+        for (size_t r = 0; r < rows_; ++r) {
+            for (size_t c = 0; c < cols_; ++c) {
+                *dst++ = Get(t, r, c);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Каждая группа — отдельный вызов ядра с шагом kGroup между
+ * элементами: все её части лежат подряд.
+ */
+void GemmBatch(const ComplexMatrixBatch& a, const ComplexMatrixBatch& b, ComplexMatrixBatch& c) {
+    COMPLEX_PROFILE_KERNEL("matrix.gemm_batch", a.Count());
+    const size_t m = a.Rows(), k = a.Cols(), n = b.Cols(), count = a.Count();
+    if (b.Rows() != k || b.Count() != count) {
+        throw invalid_argument("GemmBatch: пакеты A и B несогласованы");
+    }
+    if (&c == &a || &c == &b) {
+        throw invalid_argument("GemmBatch: результат не может совпадать с сомножителем");
+    }
+    if (c.Count() == 0) {
+        c = ComplexMatrixBatch(count, m, n);
+    } else if (c.Count() != count || c.Rows() != m || c.Cols() != n) {
+        throw invalid_argument("GemmBatch: размер пакета C не равен count x m x n");
+    }
+    const SimdKernels& kernels = ActiveKernels();
+    const size_t group = ComplexMatrixBatch::kGroup;
+    for (size_t first = 0; first < count; first += group) {
+        size_t x = first * m * k, y = first * k * n, z = first * m * n;
+        kernels.gemmBatch(m, k, n, a.Re() + x, a.Im() + x, b.Re() + y, b.Im() + y, c.Re() + z, c.Im() + z, group,
+                          min(group, count - first));
+    }
+}
+
+void GemmBatch(const Complex* a, const Complex* b, Complex* c, size_t m, size_t k, size_t n, size_t count) {
+    COMPLEX_PROFILE_KERNEL("matrix.gemm_batch", count);
+    const SimdKernels& kernels = ActiveKernels();
+    const size_t sizeA = m * k, sizeB = k * n, sizeC = m * n;
+    ArenaFrame frame;
+    double* ar = frame.Allocate<double>(sizeA * kBatchChunk);
+    double* ai = frame.Allocate<double>(sizeA * kBatchChunk);
+    double* br = frame.Allocate<double>(sizeB * kBatchChunk);
+    double* bi = frame.Allocate<double>(sizeB * kBatchChunk);
+    double* cr = frame.Allocate<double>(sizeC * kBatchChunk);
+    double* ci = frame.Allocate<double>(sizeC * kBatchChunk);
+    for (size_t first = 0; first < count; first += kBatchChunk) {
+        size_t chunk = min(kBatchChunk, count - first);
+        for (size_t t = 0; t < chunk; ++t) {
+            const Complex* x = a + (first + t) * sizeA;
+            for (size_t e = 0; e < sizeA; ++e) {
+                ar[e * kBatchChunk + t] = x[e].Re();
+                ai[e * kBatchChunk + t] = x[e].Im();
+            }
+            const Complex* y = b + (first + t) * sizeB;
+            for (size_t e = 0; e < sizeB; ++e) {
+                br[e * kBatchChunk + t] = y[e].Re();
+                bi[e * kBatchChunk + t] = y[e].Im();
+            }
+        }
+        kernels.gemmBatch(m, k, n, ar, ai, br, bi, cr, ci, kBatchChunk, chunk);
+        for (size_t t = 0; t < chunk; ++t) {
+            Complex* z = c + (first + t) * sizeC;
+            for (size_t e = 0; e < sizeC; ++e) {
+                z[e] = Complex(cr[e * kBatchChunk + t], ci[e * kBatchChunk + t]);
+            }
+        }
+    }
+}
@@ -0,0 +1,223 @@
+#ifndef COMPLEX_MATRIX_H
+#define COMPLEX_MATRIX_H
+
+#include <cstddef>
+#include <vector>
+#include "allocator.h"
+#include "mycomplex.h"
+
+using namespace std;
+
+// Плотные комплексные матрицы и их произведения.
+//
+// Gemm режет задачу на блоки, которые помещаются в кэш (по общему измерению
+// — kc, по строкам A — mc, по столбцам B — nc), упаковывает блоки A и B в
+// непрерывные панели и считает плитки результата микроядрами из таблицы
+// SimdKernels: плитка целиком живёт в векторных регистрах, а панели читаются
+// подряд. Gemv идёт по строкам или по столбцам A — в зависимости от порядка
+// хранения — ядрами dot и axpy. Для множества крошечных матриц (2x2 .. 8x8)
+// есть пакетное хранение ComplexMatrixBatch, в котором одна векторная
+// операция обрабатывает сразу несколько матриц.
+
+/**
+ * @brief Порядок элементов матрицы в памяти.
+ */
+enum class MatrixOrder {
+    RowMajor,  /**< По строкам (как в C).*/
+    ColMajor   /**< По столбцам (как в Fortran и BLAS).*/
+};
+
+/**
+ * @brief Хранение частей элементов.
+ */
+enum class MatrixStorage {
+    Interleaved,  /**< Пары (re, im) подряд, как массив Complex.*/
+    Split         /**< Все re, затем все im (как ComplexArray).*/
+};
+
+/**
+ * @brief Способ умножения комплексных блоков в Gemm.
+ */
+enum class GemmMethod {
+    Auto,    /**< 3M для больших матриц (все размеры от kGemm3MThreshold), иначе 4M.*/
+    FourM,   /**< 4 вещественных умножения на комплексное: точнее.*/
+    ThreeM   /**< 3 вещественных произведения (Гаусс): на четверть меньше умножений, ошибка Im — от |Re| + |Im| сомножителей.*/
+};
+
+/** С какого наименьшего размера m, n, k GemmMethod::Auto выбирает 3M. */
+const size_t kGemm3MThreshold = 512;
+
+/**
+ * @brief Плотная комплексная матрица rows x cols.
+ *
+ * Данные выровнены на строку кэша. Порядок и хранение задаются при
+ * создании; Convert() даёт копию в другом представлении. Произведения
+ * (Gemm, Gemv) принимают матрицы в любом представлении.
+ */
+class ComplexMatrix {
+private:
+    size_t rows_;                                   /**< Число строк.*/
+    size_t cols_;                                   /**< Число столбцов.*/
+    MatrixOrder order_;                             /**< Порядок элементов.*/
+    MatrixStorage storage_;                         /**< Хранение частей.*/
+    vector<double, AlignedAllocator<double>> data_; /**< Пары (re, im) или [все re][все im].*/
+
+public:
+    /**
+    * @brief Конструктор: матрица rows x cols, заполненная нулями
+    * @param rows Число строк
+    * @param cols Число столбцов
+    * @param order Порядок элементов
+    * @param storage Хранение частей
+    */
+    explicit ComplexMatrix(size_t rows = 0, size_t cols = 0, MatrixOrder order = MatrixOrder::RowMajor,
+                           MatrixStorage storage = MatrixStorage::Interleaved);
+
+    /**
+    * @brief Единичная матрица n x n
+    */
+    static ComplexMatrix Identity(size_t n, MatrixOrder order = MatrixOrder::RowMajor,
+                                  MatrixStorage storage = MatrixStorage::Interleaved);
+
+    size_t Rows() const noexcept { return rows_; }
+    size_t Cols() const noexcept { return cols_; }
+    bool Empty() const noexcept { return rows_ == 0 || cols_ == 0; }
+    MatrixOrder Order() const noexcept { return order_; }
+    MatrixStorage Storage() const noexcept { return storage_; }
+
+    /** Номер элемента (r, c) в порядке хранения */
+    size_t Index(size_t r, size_t c) const noexcept { return order_ == MatrixOrder::RowMajor ? r * cols_ + c : c * rows_ + r; }
+
+    /** Элемент (r, c) (без проверки границ) */
+    Complex Get(size_t r, size_t c) const noexcept;
+
+    /** Записывает элемент (r, c) (без проверки границ) */
+    void Set(size_t r, size_t c, const Complex& z) noexcept;
+
+    /** Заполняет матрицу значением z */
+    void Fill(const Complex& z) noexcept;
+
+    /** Элементы как массив Complex в порядке хранения; nullptr при MatrixStorage::Split */
+    Complex* Data() noexcept;
+    const Complex* Data() const noexcept;
+
+    /** Действительные и мнимые части; nullptr при MatrixStorage::Interleaved */
+    double* Re() noexcept;
+    const double* Re() const noexcept;
+    double* Im() noexcept;
+    const double* Im() const noexcept;
+
+    /**
+    * @brief Копия в другом порядке и (или) хранении
+    */
+    ComplexMatrix Convert(MatrixOrder order, MatrixStorage storage) const;
+};
+
+/**
+ * @brief C = alpha * A * B + beta * C
+ * @param a Матрица m x k
+ * @param b Матрица k x n
+ * @param c Результат m x n; пустая матрица создаётся (по строкам, пары)
+ * @param alpha Множитель произведения
+ * @param beta Множитель прежнего C (при beta == 0 прежнее C не читается)
+ * @param method 4M или 3M
+ * @throws invalid_argument при несогласованных размерах или если c — это a или b
+ */
+void Gemm(const ComplexMatrix& a, const ComplexMatrix& b, ComplexMatrix& c, const Complex& alpha = Complex(1.0),
+          const Complex& beta = Complex(), GemmMethod method = GemmMethod::Auto);
+
+/**
+ * @brief y = alpha * A * x + beta * y
+ * @param a Матрица m x n
+ * @param x Вектор длины n
+ * @param y Вектор длины m (при beta == 0 прежнее y не читается); не пересекается с x
+ * @param alpha Множитель произведения
+ * @param beta Множитель прежнего y
+ */
+void Gemv(const ComplexMatrix& a, const Complex* x, Complex* y, const Complex& alpha = Complex(1.0),
+          const Complex& beta = Complex());
+
+/**
+ * @brief Пакет из count одинаковых матриц rows x cols (для множества
+ * крошечных произведений, 2x2 .. 8x8).
+ *
+ * Матрицы хранятся группами по kGroup: внутри группы элемент (i, j)
+ * матрицы t лежит в Re()[Offset(t, i, j)] = [(i * cols + j) * kGroup +
+ * t % kGroup] от начала группы (и так же в Im()). Одноимённые элементы
+ * соседних матриц занимают соседние дорожки векторного регистра, поэтому
+ * GemmBatch не переставляет данные, а группа лежит в памяти одним куском.
+ */
+class ComplexMatrixBatch {
+private:
+    size_t count_;                                 /**< Число матриц.*/
+    size_t rows_;                                  /**< Строк в матрице.*/
+    size_t cols_;                                  /**< Столбцов в матрице.*/
+    vector<double, AlignedAllocator<double>> re_;  /**< Действительные части.*/
+    vector<double, AlignedAllocator<double>> im_;  /**< Мнимые части.*/
+
+public:
+    /**
+    * @brief Конструктор: count нулевых матриц rows x cols (последняя группа
+    * дополняется нулевыми матрицами)
+    */
+    explicit ComplexMatrixBatch(size_t count = 0, size_t rows = 0, size_t cols = 0);
+
+    size_t Count() const noexcept { return count_; }
+    size_t Rows() const noexcept { return rows_; }
+    size_t Cols() const noexcept { return cols_; }
+
+    /** Матриц в группе (не меньше числа double в векторном регистре). */
+    static const size_t kGroup = 8;
+
+    /** Номер части элемента (r, c) матрицы index в Re() и Im() */
+    size_t Offset(size_t index, size_t r, size_t c) const noexcept {
+        return index / kGroup * kGroup * rows_ * cols_ + (r * cols_ + c) * kGroup + index % kGroup;
+    }
+
+    /** Элемент (r, c) матрицы index (без проверки границ) */
+    Complex Get(size_t index, size_t r, size_t c) const noexcept;
+
+    /** Записывает элемент (r, c) матрицы index (без проверки границ) */
+    void Set(size_t index, size_t r, size_t c, const Complex& z) noexcept;
+
+    /**
+    * @brief Заполняет пакет из count матриц, лежащих подряд по строкам
+    * @param src count * rows * cols элементов
+    */
+    void Assign(const Complex* src) noexcept;
+
+    /**
+    * @brief Выгружает пакет в count матриц подряд по строкам
+    * @param dst count * rows * cols элементов
+    */
+    void CopyTo(Complex* dst) const noexcept;
+
+    double* Re() noexcept { return re_.data(); }
+    const double* Re() const noexcept { return re_.data(); }
+    double* Im() noexcept { return im_.data(); }
+    const double* Im() const noexcept { return im_.data(); }
+};
+
+/**
+ * @brief C_t = A_t * B_t для всех матриц пакета
+ * @param a Пакет матриц m x k
+ * @param b Пакет матриц k x n (столько же)
+ * @param c Результат; пустой пакет создаётся, непустой должен быть того же числа матриц m x n
+ * @throws invalid_argument при несогласованных размерах или если c — это a или b
+ */
+void GemmBatch(const ComplexMatrixBatch& a, const ComplexMatrixBatch& b, ComplexMatrixBatch& c);
+
+/**
+ * @brief C_t = A_t * B_t для count матриц, лежащих подряд по строкам
+ *
+ * Матрицы перекладываются в пакетное хранение группами по
+ * ComplexMatrixBatch::kGroup (в арене потока) и обратно; перекладка
+ * стоит столько же, сколько само произведение 2x2, поэтому для
+ * многократных произведений выгоднее сразу хранить ComplexMatrixBatch.
+ * @param a count матриц m x k
+ * @param b count матриц k x n
+ * @param c count матриц m x n (не пересекается с a и b)
+ */
+void GemmBatch(const Complex* a, const Complex* b, Complex* c, size_t m, size_t k, size_t n, size_t count);
+
+#endif // COMPLEX_MATRIX_H
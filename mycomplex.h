@@ -1,208 +1,593 @@
 ﻿#ifndef MY_COMPLEX_H
 #define MY_COMPLEX_H
 
+#include <cfloat>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <type_traits>
+#include "profile.h"
 using namespace std;
 
-/*
- * @brief Класс для представления комплексных чисел.
+/**
+ * @brief Константы диапазона для BasicComplex<T>: границы деления по Смиту
+ * без масштабирования и множители масштабирования (Baudin, Smith 2012).
+ *
+ * kDivLow = 2 * min / eps, kDivScale = 2 / eps^2; kAbsScale переводит
+ * части, у которых сумма квадратов переполнилась или стала субнормальной,
+ * в безопасный диапазон.
  */
+template <class T>
+struct ComplexLimits;
+
+template <>
+struct ComplexLimits<double> {
+    static constexpr double kDivLow = 0x1p-968;
+    static constexpr double kDivHigh = DBL_MAX / 2;
+    static constexpr double kDivScale = 0x1p107;
+    static constexpr double kAbsScale = 0x1p600;
+};
+
+template <>
+struct ComplexLimits<float> {
+    static constexpr float kDivLow = 0x1p-101f;
+    static constexpr float kDivHigh = FLT_MAX / 2;
+    static constexpr float kDivScale = 0x1p49f;
+    static constexpr float kAbsScale = 0x1p90f;
+};
+
+/**
+ * @brief Класс для представления комплексных чисел с частями типа T.
+ *
+ * Все методы определены прямо в заголовке (constexpr/noexcept), а специальные
+ * члены оставлены компилятору, поэтому объект тривиально копируется и
+ * полностью встраивается в циклы обработки сигналов. Общий шаблон — для
+ * float и double (Complex — это BasicComplex<double>); компактные типы
+ * хранения Q15 и Half — специализации в complexstorage.h. В сборке с
+ * COMPLEX_PROFILE операции считаются по видам (profile.h), без неё
+ * COMPLEX_PROFILE_OP пуст.
+ */
+template <class T>
+class BasicComplex {
+    static_assert(is_floating_point<T>::value, "для целых и 16-битных типов см. complexstorage.h");
 
-class Complex {
 private:
-    double Re;  /*< Реальная часть комплексного числа.*/
-    double Im; /*< Мнимая часть комплексного числа.*/
+    T re_;  /**< Реальная часть комплексного числа.*/
+    T im_;  /**< Мнимая часть комплексного числа.*/
 
+    using Limits = ComplexLimits<T>;
 
 public:
+    using value_type = T;
+
     /**
     * @brief Конструктор с возможностью задать значения частей комплексного числа
     * @param aRe Действительная часть (по умолчанию 0)
-    * @param Мнимая часть(по умолчанию 0)
+    * @param aIm Мнимая часть (по умолчанию 0)
+    */
+    constexpr BasicComplex(T aRe = 0, T aIm = 0) noexcept : re_(aRe), im_(aIm) {}
+
+    /**
+    * @brief Явное преобразование между float и double версиями
+    * @param other Число с частями другого вещественного типа
     */
-    Complex(double aRe = 0, double aIm = 0);
+    template <class U, class = typename enable_if<is_floating_point<U>::value>::type>
+    constexpr explicit BasicComplex(const BasicComplex<U>& other) noexcept
+        : re_(T(other.Re())), im_(T(other.Im())) {}
 
     /**
-    * @brief Конструктор копирования
-    * @param other Другой объект Complex для копирования
+    * @brief Конструктор копирования (тривиальный)
     */
-    Complex(const Complex& other);
+    BasicComplex(const BasicComplex& other) = default;
 
-    /** 
-    * @brief Деструктор
+    /**
+    * @brief Деструктор (тривиальный)
+    */
+    ~BasicComplex() = default;
+
+    /**
+    * @brief Оператор присваивания для двух комплексных чисел (тривиальный)
+    */
+    BasicComplex& operator=(const BasicComplex& other) = default;
+
+    /**
+    * @brief Действительная часть
+    */
+    constexpr T Re() const noexcept { return re_; }
+
+    /**
+    * @brief Мнимая часть
     */
-    ~Complex();
+    constexpr T Im() const noexcept { return im_; }
 
     /**
     * @brief Метод для установки значений частей
     * @param aRe Новое значение действительной части
-    * @param aIm Новое значение мнимой части(по умолчанию 0)
+    * @param aIm Новое значение мнимой части (по умолчанию 0)
     */
-    void Set(double aRe, double aIm = 0);
+    constexpr void Set(T aRe, T aIm = 0) noexcept {
+        re_ = aRe;
+        im_ = aIm;
+    }
 
     /**
-    * @brief Оператор преобразования в double(например, для получения длины вектора)
+    * @brief Оператор преобразования в T (модуль комплексного числа).
+    * Явный, чтобы корень не вычислялся незаметно при неявных преобразованиях.
     */
-    operator double();
+    explicit operator T() const noexcept { return Abs(); }
+
+    /**
+    * @brief Вычисляет квадрат модуля (без извлечения корня).
+    * @return Квадрат модуля комплексного числа.
+    */
+    constexpr T AbsSquared() const noexcept {
+        COMPLEX_PROFILE_OP(Abs);
+        return re_ * re_ + im_ * im_;
+    }
 
     /**
     * @brief Вычисляет модуль (абсолютное значение) комплексного числа.
+    *
+    * В обычном диапазоне это просто sqrt(re^2 + im^2); если сумма квадратов
+    * переполнилась или ушла в субнормальные числа, модуль пересчитывается
+    * с масштабированием, как hypot.
     * @return Модуль комплексного числа.
     */
-    double abs();
+    T Abs() const noexcept {
+        COMPLEX_PROFILE_OP(Abs);
+        T sum = re_ * re_ + im_ * im_;
+        if ((sum >= numeric_limits<T>::min() || (re_ == 0 && im_ == 0)) && sum <= numeric_limits<T>::max()) {
+            return sqrt(sum);
+        }
+        return ScaledAbs(re_, im_);
+    }
+
+    /**
+    * @brief Модуль с масштабированием степенью двойки (медленная ветвь Abs).
+    * Бесконечность в любой части даёт +inf, даже если другая часть NaN.
+    * @param re Действительная часть
+    * @param im Мнимая часть
+    * @return Модуль без ложного переполнения и потери точности
+    */
+    static T ScaledAbs(T re, T im) noexcept {
+        re = fabs(re);
+        im = fabs(im);
+        if (isinf(re) || isinf(im)) {
+            return numeric_limits<T>::infinity();
+        }
+        if (isnan(re) || isnan(im)) {
+            return re + im;
+        }
+        T scale = (re > 1 || im > 1) ? 1 / Limits::kAbsScale : Limits::kAbsScale;
+        re *= scale;
+        im *= scale;
+        return sqrt(re * re + im * im) / scale;
+    }
+
+    /** Границы, внутри которых деление по Смиту идёт без масштабирования (см. ComplexLimits). */
+    static constexpr T kDivLow = Limits::kDivLow;
+    static constexpr T kDivHigh = Limits::kDivHigh;
+
+    /**
+    * @brief Деление (a + bi) / (c + di) по Смиту с масштабированием (Baudin, Smith 2012).
+    *
+    * Если модули частей лежат в [kDivLow, kDivHigh] (делимое может быть нулём),
+    * выполняется один шаг Смита; иначе — ScaledDivide.
+    * @return Частное
+    */
+    static BasicComplex Divide(T a, T b, T c, T d) noexcept {
+        COMPLEX_PROFILE_OP(Div);
+        // Максимумы модулей частей (при NaN — как maxpd, без вызова fmax).
+        T ab = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+        T cd = fabs(c) > fabs(d) ? fabs(c) : fabs(d);
+        if ((ab >= kDivLow || ab == 0) && ab <= kDivHigh && cd >= kDivLow && cd <= kDivHigh) {
+            return SmithDivide(a, b, c, d);
+        }
+        return ScaledDivide(a, b, c, d);
+    }
+
+    /**
+    * @brief Медленная ветвь Divide: операнды вне [kDivLow, kDivHigh] сначала
+    * масштабируются степенью двойки, поэтому промежуточные суммы не
+    * переполняются и не теряют точность. Особые случаи — как в C99 Annex G:
+    * z/0 = inf, inf/z = inf, z/inf = 0.
+    * @return Частное
+    */
+    static BasicComplex ScaledDivide(T a, T b, T c, T d) noexcept {
+        const T kScale = Limits::kDivScale;
+        T a0 = a, b0 = b, c0 = c, d0 = d;
+        // Максимумы модулей частей (при NaN — как maxpd, без вызова fmax).
+        T ab = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+        T cd = fabs(c) > fabs(d) ? fabs(c) : fabs(d);
+        T s = 1;
+        if (ab > kDivHigh) {
+            a *= 0.5;
+            b *= 0.5;
+            s *= 2;
+        }
+        if (cd > kDivHigh) {
+            c *= 0.5;
+            d *= 0.5;
+            s *= 0.5;
+        }
+        if (ab < kDivLow) {
+            a *= kScale;
+            b *= kScale;
+            s /= kScale;
+        }
+        if (cd < kDivLow) {
+            c *= kScale;
+            d *= kScale;
+            s *= kScale;
+        }
+        BasicComplex q = SmithDivide(a, b, c, d);
+        T x = q.re_ * s, y = q.im_ * s;
+        const T kInf = numeric_limits<T>::infinity();
+        if (isnan(x) && isnan(y)) {
+            if (c0 == 0 && d0 == 0 && (!isnan(a0) || !isnan(b0))) {
+                x = copysign(kInf, c0) * a0;
+                y = copysign(kInf, c0) * b0;
+            } else if ((isinf(a0) || isinf(b0)) && isfinite(c0) && isfinite(d0)) {
+                a = copysign(isinf(a0) ? T(1) : T(0), a0);
+                b = copysign(isinf(b0) ? T(1) : T(0), b0);
+                x = kInf * (a * c0 + b * d0);
+                y = kInf * (b * c0 - a * d0);
+            } else if ((isinf(c0) || isinf(d0)) && isfinite(a0) && isfinite(b0)) {
+                c = copysign(isinf(c0) ? T(1) : T(0), c0);
+                d = copysign(isinf(d0) ? T(1) : T(0), d0);
+                // Масштабированные a, b: суммы не переполняются (0 * inf = NaN).
+                x = T(0) * (a * c + b * d);
+                y = T(0) * (b * c - a * d);
+            }
+        }
+        return BasicComplex(x, y);
+    }
+
+    /**
+    * @brief Шаг Смита без масштабирования. При |d| > |c| тот же шаг делается
+    * с переставленными частями и сменой знака y; выбор без ветвления, потому
+    * что на случайных данных он непредсказуем.
+    * @return Частное
+    */
+    static BasicComplex SmithDivide(T a, T b, T c, T d) noexcept {
+        T x, y;
+        bool swap = fabs(d) > fabs(c);
+        SmithStep(swap ? b : a, swap ? a : b, swap ? d : c, swap ? c : d, x, y);
+        return BasicComplex(x, swap ? -y : y);
+    }
+
+    /**
+    * @brief Один шаг Смита для |d| <= |c|: r = d/c, знаменатель c + d*r.
+    * Если r ушло в ноль при d != 0, d*(b/c) сохраняет вклад малой части делителя.
+    */
+    static void SmithStep(T a, T b, T c, T d, T& x, T& y) noexcept {
+        T r = d / c;
+        T den = c + d * r;
+        if (r != 0 || d == 0) {
+            x = (a + b * r) / den;
+            y = (b - a * r) / den;
+        } else {
+            x = (a + d * (b / c)) / den;
+            y = (b - d * (a / c)) / den;
+        }
+    }
+
+    /**
+    * @brief Обратное число 1/z (устойчивый режим, как operator/).
+    * @return 1 / z
+    */
+    BasicComplex Reciprocal() const noexcept { return Divide(1, 0, re_, im_); }
+
+    /**
+    * @brief Быстрое обратное число conj(z) * (1/|z|^2) без защиты от
+    * переполнения: годится, пока |z|^2 представимо (для double примерно
+    * 1e-154..1e154, для float 1e-19..1e19).
+    * @return 1 / z
+    */
+    constexpr BasicComplex FastReciprocal() const noexcept {
+        COMPLEX_PROFILE_OP(Div);
+        T s = 1 / (re_ * re_ + im_ * im_);
+        return BasicComplex(re_ * s, -im_ * s);
+    }
 
     /**
-    * @brief Перегрузка оператора ввода для класса Complex.
+    * @brief Быстрое деление через умножение на 1/|other|^2 (одно деление
+    * вместо двух). Ограничения по диапазону — как у FastReciprocal.
+    * @param other Делитель
+    * @return Частное
+    */
+    constexpr BasicComplex FastDivide(const BasicComplex& other) const noexcept {
+        COMPLEX_PROFILE_OP(Div);
+        T s = 1 / (other.re_ * other.re_ + other.im_ * other.im_);
+        return BasicComplex((re_ * other.re_ + im_ * other.im_) * s, (im_ * other.re_ - re_ * other.im_) * s);
+    }
+
+    /**
+    * @brief Перегрузка оператора ввода для класса Complex (формат "a b").
     * @param input Поток ввода.
-    * @param c Объект класса Complex, в который будет записано число.
+    * @param c Комплексное число, в которое будет записан результат.
     * @return Поток ввода.
     */
-    friend istream& operator>>(istream& input, Complex& c);
+    friend istream& operator>>(istream& input, BasicComplex& c) {
+        COMPLEX_PROFILE_OP(Read);
+        input >> c.re_ >> c.im_;
+        return input;
+    }
 
-    /** 
+    /**
     * @brief Перегрузка оператора вывода для класса Complex.
     * @param output Поток вывода.
-    * @param c Объект класса Complex, который нужно вывести.
+    * @param c Комплексное число, которое нужно вывести.
     * @return Поток вывода.
     */
-    friend ostream& operator<<(ostream& output, Complex& c);
+    friend ostream& operator<<(ostream& output, const BasicComplex& c) {
+        COMPLEX_PROFILE_OP(Write);
+        output << c.re_;
+        if (c.im_ >= 0) {
+            output << "+";
+        }
+        output << c.im_ << "i";
+        return output;
+    }
 
     /**
-    *@brief Перегрузка оператора сложения(с другим комплексным числом)
-    * @param other Другой объект Complex 
-    * @return Результат сложения 
+    * @brief Перегрузка оператора сложения (с другим комплексным числом)
+    * @param other Другое комплексное число
+    * @return Результат сложения
     */
-    Complex operator+(const Complex& other);
+    constexpr BasicComplex operator+(const BasicComplex& other) const noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        return BasicComplex(re_ + other.re_, im_ + other.im_);
+    }
 
     /**
-    * @brief Перегрузка оператора вычитания(с другим комплексным числом)
-    * @param other  Другой объект Complex 
+    * @brief Перегрузка оператора вычитания (с другим комплексным числом)
+    * @param other Другое комплексное число
     * @return Результат вычитания
-    */ 
-    Complex operator-(const Complex& other);
+    */
+    constexpr BasicComplex operator-(const BasicComplex& other) const noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        return BasicComplex(re_ - other.re_, im_ - other.im_);
+    }
 
     /**
-    * @brief Перегрузка оператора сложения для Complex и double.
-    * @param a Число типа double.
+    * @brief Перегрузка оператора сложения для комплексного и вещественного числа.
+    * @param value Вещественное число.
     * @return Результат сложения.
     */
-    Complex operator+(const double& value);
+    constexpr BasicComplex operator+(T value) const noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        return BasicComplex(re_ + value, im_);
+    }
 
     /**
-    * @brief Перегрузка оператора сложения(с числом типа double) в другом порядке
-    * @param value Число типа double
-    * @param c Объект complex
+    * @brief Перегрузка оператора сложения (с вещественным числом) в другом порядке
+    * @param value Вещественное число
+    * @param c Комплексное число
     * @return Результат сложения
     */
-     
-    friend Complex operator+(const double& value, const Complex& c);
+    friend constexpr BasicComplex operator+(T value, const BasicComplex& c) noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        return BasicComplex(value + c.re_, c.im_);
+    }
 
     /**
     * @brief Перегрузка оператора вычитания
-    * @param value Число типа double
-    * @return Результат вычитания 
-    */ 
-    Complex operator-(const double& value);
-
-    /** 
-    * @brief Перегрузка оператора вычитания(с числом типа double) в другом порядке
-    * @param value Число типа double
-    * @param c Объект complex
+    * @param value Вещественное число
+    * @return Результат вычитания
+    */
+    constexpr BasicComplex operator-(T value) const noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        return BasicComplex(re_ - value, im_);
+    }
+
+    /**
+    * @brief Перегрузка оператора вычитания (с вещественным числом) в другом порядке
+    * @param value Вещественное число
+    * @param c Комплексное число
     * @return Результат вычитания
     */
-    friend Complex operator-(const double& value, const Complex& c);
+    friend constexpr BasicComplex operator-(T value, const BasicComplex& c) noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        return BasicComplex(value - c.re_, -c.im_);
+    }
 
     /**
-    * @brief Перегрузка оператора умножения(с другим комплексным числом)
-    * @param other  Другой объект Complex
-    * @return Результат умножения 
+    * @brief Перегрузка оператора умножения (с другим комплексным числом)
+    * @param other Другое комплексное число
+    * @return Результат умножения
     */
-    Complex operator*(const Complex& other);
+    constexpr BasicComplex operator*(const BasicComplex& other) const noexcept {
+        COMPLEX_PROFILE_OP(Mul);
+        return BasicComplex(re_ * other.re_ - im_ * other.im_, re_ * other.im_ + im_ * other.re_);
+    }
 
     /**
-    * @brief Перегрузка оператора умножения(с числом типа double) в другом порядке
-    * @param value Число типа double
+    * @brief Перегрузка оператора умножения (с вещественным числом)
+    * @param value Вещественное число
     * @return Результат умножения
     */
-    Complex operator*(const double& value);
-    
-    /** 
-    * @brief Перегрузка оператора умножения(с числом типа double) в другом порядке
-    * @param value Число типа double
-    * @param c Объект complex
+    constexpr BasicComplex operator*(T value) const noexcept {
+        COMPLEX_PROFILE_OP(Scale);
+        return BasicComplex(re_ * value, im_ * value);
+    }
+
+    /**
+    * @brief Перегрузка оператора умножения (с вещественным числом) в другом порядке
+    * @param value Вещественное число
+    * @param c Комплексное число
     * @return Результат умножения
     */
-    friend Complex operator*(const double& value, const Complex& c);
-   
-    /** 
-    * @brief Перегрузка оператора деления(с числом типа double) в другом порядке
-    * @param value Число типа double
+    friend constexpr BasicComplex operator*(T value, const BasicComplex& c) noexcept {
+        COMPLEX_PROFILE_OP(Scale);
+        return BasicComplex(value * c.re_, value * c.im_);
+    }
+
+    /**
+    * @brief Перегрузка оператора деления (на вещественное число)
+    * @param value Вещественное число
+    * @return Результат деления
+    */
+    constexpr BasicComplex operator/(T value) const noexcept {
+        COMPLEX_PROFILE_OP(Scale);
+        return BasicComplex(re_ / value, im_ / value);
+    }
+
+    /**
+    * @brief Перегрузка оператора деления (на другое комплексное число), устойчивый режим
+    * @param other Другое комплексное число
+    * @return Результат деления
+    */
+    BasicComplex operator/(const BasicComplex& other) const noexcept {
+        return Divide(re_, im_, other.re_, other.im_);
+    }
+
+    /**
+    * @brief Перегрузка оператора деления (вещественного числа на комплексное)
+    * @param value Вещественное число
+    * @param c Комплексное число
     * @return Результат деления
     */
-    Complex operator/(const double& value);
+    friend BasicComplex operator/(T value, const BasicComplex& c) noexcept {
+        return Divide(value, 0, c.re_, c.im_);
+    }
 
-   /**
-   * @brief Перегрузка оператора += для двух объектов Complex.
-   * @param a Другой объект Complex.
-   * @return Ссылка на текущий объект.
-   */
-    Complex& operator+=(const Complex& other);
+    /**
+    * @brief Перегрузка оператора += для двух комплексных чисел.
+    * @param other Другое комплексное число.
+    * @return Ссылка на текущий объект.
+    */
+    constexpr BasicComplex& operator+=(const BasicComplex& other) noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        re_ += other.re_;
+        im_ += other.im_;
+        return *this;
+    }
 
     /**
-    *@brief Перегрузка оператора -= для двух объектов Complex.
-    * @param a Другой объект Complex.
+    * @brief Перегрузка оператора -= для двух комплексных чисел.
+    * @param other Другое комплексное число.
     * @return Ссылка на текущий объект.
     */
-    Complex& operator-=(const Complex& other);
-  
+    constexpr BasicComplex& operator-=(const BasicComplex& other) noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        re_ -= other.re_;
+        im_ -= other.im_;
+        return *this;
+    }
+
     /**
-   *@brief Перегрузка оператора *= для двух объектов Complex.
-   * @param a Другой объект Complex.
-   * @return Ссылка на текущий объект.
-   */
-    Complex& operator*=(const Complex& other);
-   
+    * @brief Перегрузка оператора *= для двух комплексных чисел.
+    * Обе части считаются до записи, поэтому z *= z тоже верно.
+    * @param other Другое комплексное число.
+    * @return Ссылка на текущий объект.
+    */
+    constexpr BasicComplex& operator*=(const BasicComplex& other) noexcept {
+        COMPLEX_PROFILE_OP(Mul);
+        T re = re_ * other.re_ - im_ * other.im_;
+        im_ = im_ * other.re_ + re_ * other.im_;
+        re_ = re;
+        return *this;
+    }
+
     /**
-    *@brief Перегрузка оператора += для Complex и double.
-    * @param a Число типа double.
+    * @brief Перегрузка оператора += для комплексного и вещественного числа.
+    * @param value Вещественное число.
     * @return Ссылка на текущий объект.
     */
-    Complex& operator+=(const double& value);
+    constexpr BasicComplex& operator+=(T value) noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        re_ += value;
+        return *this;
+    }
 
     /**
-    *@brief Перегрузка оператора -= для Complex и double.
-    * @param a Число типа double.
+    * @brief Перегрузка оператора -= для комплексного и вещественного числа.
+    * @param value Вещественное число.
     * @return Ссылка на текущий объект.
     */
-    Complex& operator-=(const double& value);
+    constexpr BasicComplex& operator-=(T value) noexcept {
+        COMPLEX_PROFILE_OP(Add);
+        re_ -= value;
+        return *this;
+    }
 
     /**
-    *@brief Перегрузка оператора *= для Complex и double.
-    * @param a Число типа double.
+    * @brief Перегрузка оператора *= для комплексного и вещественного числа.
+    * @param value Вещественное число.
     * @return Ссылка на текущий объект.
     */
-    Complex& operator*=(const double& value);
+    constexpr BasicComplex& operator*=(T value) noexcept {
+        COMPLEX_PROFILE_OP(Scale);
+        re_ *= value;
+        im_ *= value;
+        return *this;
+    }
 
     /**
-    *@brief Перегрузка оператора /= для Complex и double.
-    * @param a Число типа double.
+    * @brief Перегрузка оператора /= для комплексного и вещественного числа.
+    * @param value Вещественное число.
     * @return Ссылка на текущий объект.
     */
-    Complex& operator/=(const double& value);
+    constexpr BasicComplex& operator/=(T value) noexcept {
+        COMPLEX_PROFILE_OP(Scale);
+        re_ /= value;
+        im_ /= value;
+        return *this;
+    }
 
     /**
-    *@brief Перегрузка оператора присваивания для двух объектов Complex.
-    * @param a Другой объект Complex.
+    * @brief Перегрузка оператора /= для двух комплексных чисел (устойчивый режим).
+    * @param other Другое комплексное число.
     * @return Ссылка на текущий объект.
     */
-    Complex& operator=(const Complex& other);
+    BasicComplex& operator/=(const BasicComplex& other) noexcept {
+        return *this = Divide(re_, im_, other.re_, other.im_);
+    }
 
     /**
-    *@brief Перегрузка оператора присваивания для Complex и double.
-    * @param a Число типа double.
+    * @brief Перегрузка оператора присваивания для комплексного и вещественного числа (мнимая часть обнуляется).
+    * @param value Вещественное число.
     * @return Ссылка на текущий объект.
     */
-    Complex& operator=(const double& value);
+    constexpr BasicComplex& operator=(T value) noexcept {
+        re_ = value;
+        im_ = 0;
+        return *this;
+    }
 };
 
+/** Комплексное число двойной точности — основной тип библиотеки */
+using Complex = BasicComplex<double>;
+
+/** Комплексное число одинарной точности: вдвое меньше памяти и вдвое больше элементов в регистре */
+using ComplexF = BasicComplex<float>;
+
+/**
+ * @brief Комплексное умножение со сложением a * b + c на инструкциях FMA:
+ * каждая часть считается двумя fma, то есть с двумя округлениями вместо
+ * четырёх у operator* и operator+=.
+ * @param a Первый множитель
+ * @param b Второй множитель
+ * @param c Слагаемое
+ * @return a * b + c
+ */
+template <class T>
+inline BasicComplex<T> FusedMulAdd(const BasicComplex<T>& a, const BasicComplex<T>& b,
+                                   const BasicComplex<T>& c) noexcept {
+    return BasicComplex<T>(fma(a.Re(), b.Re(), fma(-a.Im(), b.Im(), c.Re())),
+                   fma(a.Re(), b.Im(), fma(a.Im(), b.Re(), c.Im())));
+}
+
+// Проверки на этапе компиляции: Complex и ComplexF должны оставаться
+// POD-подобными значениями из двух чисел, иначе пропадут memcpy и векторизация.
+static_assert(is_trivially_copyable<Complex>::value, "Complex должен тривиально копироваться");
+static_assert(is_standard_layout<Complex>::value, "Complex должен иметь стандартную раскладку");
+static_assert(sizeof(Complex) == 2 * sizeof(double), "Complex должен занимать 16 байт");
+static_assert(is_trivially_copyable<ComplexF>::value && sizeof(ComplexF) == 2 * sizeof(float),
+              "ComplexF должен тривиально копироваться и занимать 8 байт");
+static_assert((Complex(1, 2) * Complex(3, 4)).Re() == -5 && (Complex(1, 2) * Complex(3, 4)).Im() == 10,
+              "арифметика Complex должна вычисляться на этапе компиляции");
+static_assert((ComplexF(1, 2) * ComplexF(3, 4)).Im() == 10, "арифметика ComplexF должна вычисляться на этапе компиляции");
+
 #endif // MY_COMPLEX_H
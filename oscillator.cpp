@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "complexmath.h"
+#include "oscillator.h"
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double kTwoPi = 6.283185307179586476925286766559;
+
+/** Один шаг аккумулятора в радианах: 2pi / 2^64 */
+const double kRadiansPerStep = kTwoPi / 0x1p64;
+
+/**
+ * @brief Радианы -> доли оборота * 2^64 (по модулю 2^64)
+ * @throws invalid_argument, если угол не конечен
+ */
+uint64_t ToSteps(double radians) {
+    if (!isfinite(radians)) {
+        throw invalid_argument("Oscillator: частота и фаза должны быть конечными");
+    }
+    double turns = radians / kTwoPi;
+    turns -= nearbyint(turns);
+    double steps = nearbyint(turns * 0x1p64);
+    if (steps >= 0x1p63) {
+        steps -= 0x1p64;
+    }
+    return uint64_t(int64_t(steps));
+}
+
+/** Доли оборота * 2^64 -> радианы в [-pi, pi) */
+double ToRadians(uint64_t steps) {
+    return double(int64_t(steps)) * kRadiansPerStep;
+}
+
+Complex Phasor(uint64_t steps) {
+    return Polar(1.0, ToRadians(steps));
+}
+
+const double* AsDoubles(const Complex* src) {
+    return reinterpret_cast<const double*>(src);
+}
+
+double* AsDoubles(Complex* dst) {
+    return reinterpret_cast<double*>(dst);
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор: аккумулятор, опорный фазор и таблица
+ */
+Oscillator::Oscillator(double frequency, double phase) : phase_(ToSteps(phase)), step_(0), pos_(0) {
+    SetFrequency(frequency);
+}
+
+/**
+ * @brief Переносит начало сегмента на следующий отсчёт
+ */
+void Oscillator::Rebase() {
+    phase_ += pos_ * step_;
+    pos_ = 0;
+    anchor_ = Phasor(phase_);
+}
+
+/**
+ * @brief Начинает следующий сегмент: опорный фазор заново по аккумулятору
+ */
+void Oscillator::NextSegment() {
+    phase_ += kSegment * step_;
+    pos_ = 0;
+    anchor_ = Phasor(phase_);
+}
+
+void Oscillator::SetFrequency(double frequency) {
+    uint64_t step = ToSteps(frequency);
+    Rebase();
+    step_ = step;
+    for (size_t k = 0; k < kSegment; ++k) {
+        table_[k] = Phasor(k * step_);
+        tableRe_[k] = table_[k].Re();
+        tableIm_[k] = table_[k].Im();
+    }
+}
+
+void Oscillator::SetPhase(double phase) {
+    phase_ = ToSteps(phase);
+    pos_ = 0;
+    anchor_ = Phasor(phase_);
+}
+
+void Oscillator::ShiftPhase(double delta) {
+    uint64_t shift = ToSteps(delta);
+    phase_ += shift;
+    Rebase();
+}
+
+double Oscillator::Frequency() const noexcept {
+    return ToRadians(step_);
+}
+
+double Oscillator::Phase() const noexcept {
+    return ToRadians(phase_ + pos_ * step_);
+}
+
+Complex Oscillator::Next() noexcept {
+    if (pos_ == kSegment) {
+        NextSegment();
+    }
+    return anchor_ * table_[pos_++];
+}
+
+/**
+ * @brief Обход следующих n отсчётов кусками внутри сегментов:
+ * fill(done, m) обрабатывает отсчёты [done, done + m) с позиции pos_
+ */
+template <class Fill>
+void Oscillator::Run(size_t n, Fill fill) {
+    size_t done = 0;
+    while (done < n) {
+        if (pos_ == kSegment) {
+            NextSegment();
+        }
+        size_t m = min(n - done, kSegment - pos_);
+        fill(done, m);
+        pos_ += m;
+        done += m;
+    }
+}
+
+void Oscillator::Generate(Complex* out, size_t n) {
+    COMPLEX_PROFILE_KERNEL("oscillator.generate", n);
+    const SimdKernels& kernels = ActiveKernels();
+    Run(n, [&](size_t done, size_t m) {
+        kernels.scaleComplexInterleaved(anchor_.Re(), anchor_.Im(), AsDoubles(table_ + pos_),
+                                        AsDoubles(out + done), m);
+    });
+}
+
+void Oscillator::Generate(ComplexArray& out) {
+    COMPLEX_PROFILE_KERNEL("oscillator.generate", out.Size());
+    const SimdKernels& kernels = ActiveKernels();
+    Run(out.Size(), [&](size_t done, size_t m) {
+        kernels.scaleComplex(anchor_.Re(), anchor_.Im(), tableRe_ + pos_, tableIm_ + pos_,
+                             out.Re() + done, out.Im() + done, m);
+    });
+}
+
+void Oscillator::Mix(const Complex* src, Complex* out, size_t n) {
+    COMPLEX_PROFILE_KERNEL("oscillator.mix", n);
+    const SimdKernels& kernels = ActiveKernels();
+    Complex carrier[kSegment];
+    Run(n, [&](size_t done, size_t m) {
+        kernels.scaleComplexInterleaved(anchor_.Re(), anchor_.Im(), AsDoubles(table_ + pos_), AsDoubles(carrier), m);
+        kernels.mulInterleaved(AsDoubles(src + done), AsDoubles(carrier), AsDoubles(out + done), m);
+    });
+}
+
+void Oscillator::Mix(const ComplexArray& src, ComplexArray& out) {
+    COMPLEX_PROFILE_KERNEL("oscillator.mix", src.Size());
+    const SimdKernels& kernels = ActiveKernels();
+    out.Resize(src.Size());
+    double carrierRe[kSegment], carrierIm[kSegment];
+    Run(src.Size(), [&](size_t done, size_t m) {
+        kernels.scaleComplex(anchor_.Re(), anchor_.Im(), tableRe_ + pos_, tableIm_ + pos_, carrierRe, carrierIm, m);
+        kernels.mul(src.Re() + done, src.Im() + done, carrierRe, carrierIm, out.Re() + done, out.Im() + done, m);
+    });
+}
@@ -0,0 +1,115 @@
+#ifndef OSCILLATOR_H
+#define OSCILLATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "complexarray.h"
+#include "mycomplex.h"
+
+using namespace std;
+
+/**
+ * @brief Генератор комплексной несущей e^(i * (phase + frequency * n))
+ * (NCO) без sin/cos на каждый отсчёт.
+ *
+ * Фаза хранится в 64-битном аккумуляторе (2^64 — полный оборот) и
+ * прибавляется точно, поэтому фаза n-го отсчёта не накапливает ошибок и
+ * через миллиарды отсчётов. Отсчёты идут сегментами по kSegment: в начале
+ * сегмента опорный фазор считается заново по аккумулятору (sin/cos один
+ * раз), внутри сегмента отсчёт — опорный фазор, умноженный на табличный
+ * e^(i * frequency * k). Погрешность каждого отсчёта поэтому ограничена
+ * несколькими ULP и не растёт со временем; на отсчёт приходится одно
+ * комплексное умножение (векторное ядро при заполнении блока).
+ *
+ * Перестройка частоты и фазы не сбивает фазу: следующий отсчёт
+ * продолжает текущую фазу (или начинается с новой при SetPhase).
+ * Результат не зависит от того, какими блоками запрашиваются отсчёты.
+ */
+class Oscillator {
+public:
+    static const size_t kSegment = 128;  /**< Длина сегмента (и таблицы фазоров).*/
+
+private:
+    uint64_t phase_;              /**< Фаза начала текущего сегмента (доли оборота * 2^64).*/
+    uint64_t step_;               /**< Приращение фазы за отсчёт.*/
+    size_t pos_;                  /**< Позиция в сегменте.*/
+    Complex anchor_;              /**< Фазор начала сегмента.*/
+    Complex table_[kSegment];     /**< e^(i * frequency * k).*/
+    double tableRe_[kSegment];    /**< Та же таблица раздельно: действительные части.*/
+    double tableIm_[kSegment];    /**< Мнимые части.*/
+
+    void Rebase();
+    void NextSegment();
+    template <class Fill>
+    void Run(size_t n, Fill fill);
+
+public:
+    /**
+    * @brief Конструктор
+    * @param frequency Частота в радианах на отсчёт (приводится к [-pi, pi))
+    * @param phase Начальная фаза в радианах
+    */
+    explicit Oscillator(double frequency = 0, double phase = 0);
+
+    /**
+    * @brief Новая частота со следующего отсчёта, без скачка фазы.
+    * Пересчитывает таблицу — kSegment вызовов sin/cos.
+    * @param frequency Частота в радианах на отсчёт
+    */
+    void SetFrequency(double frequency);
+
+    /**
+    * @brief Фаза следующего отсчёта
+    * @param phase Фаза в радианах
+    */
+    void SetPhase(double phase);
+
+    /**
+    * @brief Сдвиг фазы следующего отсчёта (для подстройки по ошибке фазы)
+    * @param delta Сдвиг в радианах
+    */
+    void ShiftPhase(double delta);
+
+    /**
+    * @brief Частота в радианах на отсчёт (после округления до 2pi / 2^64)
+    */
+    double Frequency() const noexcept;
+
+    /**
+    * @brief Фаза следующего отсчёта в радианах, в [-pi, pi)
+    */
+    double Phase() const noexcept;
+
+    /**
+    * @brief Следующий отсчёт
+    */
+    Complex Next() noexcept;
+
+    /**
+    * @brief Следующие n отсчётов
+    * @param out Массив результатов (не короче n)
+    * @param n Число отсчётов
+    */
+    void Generate(Complex* out, size_t n);
+
+    /**
+    * @brief Следующие out.Size() отсчётов
+    */
+    void Generate(ComplexArray& out);
+
+    /**
+    * @brief Перенос частоты (смеситель): out[i] = src[i] * несущая[i].
+    * out может совпадать с src.
+    * @param src Входной сигнал
+    * @param out Массив результатов (не короче n)
+    * @param n Число отсчётов
+    */
+    void Mix(const Complex* src, Complex* out, size_t n);
+
+    /**
+    * @brief Перенос частоты для ComplexArray; out получает размер src
+    */
+    void Mix(const ComplexArray& src, ComplexArray& out);
+};
+
+#endif // OSCILLATOR_H
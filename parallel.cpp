@@ -0,0 +1,76 @@
+#include <stdexcept>
+#include <vector>
+#include "allocator.h"
+#include "parallel.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+typedef void (*BinaryKernel)(const double*, const double*, const double*, const double*,
+                             double*, double*, size_t);
+
+void CheckSameSize(const ComplexArray& a, const ComplexArray& b) {
+    if (a.Size() != b.Size()) {
+        throw invalid_argument("ComplexArray: размеры операндов не совпадают");
+    }
+}
+
+// Одно и то же ядро на каждом куске; out готовится заранее в вызывающем потоке.
+void RunBinary(BinaryKernel kernel, const ComplexArray& a, const ComplexArray& b, ComplexArray& out,
+               ThreadPool& pool) {
+    CheckSameSize(a, b);
+    out.Resize(a.Size());
+    const double *ar = a.Re(), *ai = a.Im(), *br = b.Re(), *bi = b.Im();
+    double *cr = out.Re(), *ci = out.Im();
+    pool.ParallelFor(0, a.Size(), kParallelGrain, [=](size_t lo, size_t hi) {
+        kernel(ar + lo, ai + lo, br + lo, bi + lo, cr + lo, ci + lo, hi - lo);
+    });
+}
+
+} // namespace
+
+void ParallelForEach(Complex* data, size_t n, const function<void(Complex*, size_t)>& body,
+                     ThreadPool& pool, size_t grain) {
+    pool.ParallelFor(0, n, grain, [&](size_t lo, size_t hi) { body(data + lo, hi - lo); });
+}
+
+void FftBatch(const FftPlan& plan, Complex* data, size_t count, FftDirection direction, ThreadPool& pool) {
+    size_t n = plan.Size();
+    pool.ParallelFor(0, count, 1, [&](size_t lo, size_t hi) {
+        // Буфер — из арены потока: память выделяется один раз на поток, а не
+        // на каждое преобразование.
+        ArenaFrame frame;
+        Complex* scratch = frame.Allocate<Complex>(plan.ScratchSize());
+        for (size_t i = lo; i < hi; ++i) {
+            plan.Execute(data + i * n, data + i * n, direction, scratch);
+        }
+    });
+}
+
+void Add(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool) {
+    RunBinary(ActiveKernels().add, a, b, out, pool);
+}
+
+void Sub(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool) {
+    RunBinary(ActiveKernels().sub, a, b, out, pool);
+}
+
+void Mul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool) {
+    RunBinary(ActiveKernels().mul, a, b, out, pool);
+}
+
+void ConjMul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool) {
+    RunBinary(ActiveKernels().conjMul, a, b, out, pool);
+}
+
+void Scale(const ComplexArray& a, double k, ComplexArray& out, ThreadPool& pool) {
+    out.Resize(a.Size());
+    const double *ar = a.Re(), *ai = a.Im();
+    double *cr = out.Re(), *ci = out.Im();
+    auto kernel = ActiveKernels().scale;
+    pool.ParallelFor(0, a.Size(), kParallelGrain, [=](size_t lo, size_t hi) {
+        kernel(ar + lo, ai + lo, k, cr + lo, ci + lo, hi - lo);
+    });
+}
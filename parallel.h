@@ -0,0 +1,69 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+#include "complexarray.h"
+#include "fft.h"
+#include "mycomplex.h"
+#include "threadpool.h"
+
+// Многопоточные варианты поэлементных операций и пакетного БПФ. Данные
+// режутся на куски фиксированной длины, не зависящей от числа потоков,
+// а каждый элемент вычисляется тем же ядром, что и в однопоточной версии,
+// поэтому результат совпадает бит в бит при любом размере пула.
+
+/** Длина куска по умолчанию: 16К элементов (256 КБ на массив re+im) */
+const size_t kParallelGrain = 16384;
+
+/**
+ * @brief Параллельный цикл по массиву Complex кусками по grain элементов
+ * @param data Массив
+ * @param n Число элементов
+ * @param body Обработчик куска body(begin, count)
+ * @param pool Пул потоков
+ * @param grain Длина куска
+ */
+void ParallelForEach(Complex* data, size_t n, const function<void(Complex*, size_t)>& body,
+                     ThreadPool& pool = ThreadPool::Default(), size_t grain = kParallelGrain);
+
+/**
+ * @brief Пакет из count преобразований, лежащих подряд (i-е с data + i * plan.Size()).
+ * Каждый поток использует свой рабочий буфер, выделенный один раз.
+ * @param plan План преобразования
+ * @param data Данные пакета
+ * @param count Число преобразований
+ * @param direction Направление
+ * @param pool Пул потоков
+ */
+void FftBatch(const FftPlan& plan, Complex* data, size_t count, FftDirection direction,
+              ThreadPool& pool = ThreadPool::Default());
+
+// Поэлементные ядра ComplexArray на пуле потоков; контракт как у однопоточных.
+
+/**
+ * @brief Параллельное сложение: out = a + b
+ */
+void Add(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool);
+
+/**
+ * @brief Параллельное вычитание: out = a - b
+ */
+void Sub(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool);
+
+/**
+ * @brief Параллельное умножение: out = a * b
+ */
+void Mul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool);
+
+/**
+ * @brief Параллельное умножение на сопряжённое: out = a * conj(b)
+ */
+void ConjMul(const ComplexArray& a, const ComplexArray& b, ComplexArray& out, ThreadPool& pool);
+
+/**
+ * @brief Параллельное умножение на вещественное число: out = a * k
+ */
+void Scale(const ComplexArray& a, double k, ComplexArray& out, ThreadPool& pool);
+
+#endif // PARALLEL_H
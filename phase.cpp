@@ -0,0 +1,47 @@
+#include "phase.h"
+#include "complexmath.h"
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+void PhaseUnwrapper::Process(const double* in, double* out, size_t n) {
+    COMPLEX_PROFILE_KERNEL("phase.unwrap", n);
+    if (n == 0) {
+        return;
+    }
+    if (!started_) {
+        state_[0] = in[0];
+        started_ = true;
+    }
+    ActiveKernels().unwrapPhase(in, out, n, state_);
+}
+
+void PhaseUnwrapper::Reset() noexcept {
+    state_[0] = 0;
+    state_[1] = 0;
+    started_ = false;
+}
+
+void FmDiscriminator::Process(const Complex* in, double* out, size_t n) {
+    COMPLEX_PROFILE_KERNEL("phase.fm_discriminate", n);
+    if (n == 0) {
+        return;
+    }
+    if (!started_) {
+        previous_ = in[0];
+        started_ = true;
+    }
+    if (accuracy_ == MathAccuracy::Precise) {
+        for (size_t i = 0; i < n; ++i) {
+            const Complex& p = i ? in[i - 1] : previous_;
+            Complex product(in[i].Re() * p.Re() + in[i].Im() * p.Im(), in[i].Im() * p.Re() - in[i].Re() * p.Im());
+            out[i] = gain_ * Arg(product);
+        }
+    } else {
+        const double previous[2] = {previous_.Re(), previous_.Im()};
+        ActiveKernels().fmDiscriminateInterleaved(reinterpret_cast<const double*>(in), previous, gain_, out, n,
+                                                  accuracy_ == MathAccuracy::Approx);
+    }
+    previous_ = in[n - 1];
+}
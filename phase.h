@@ -0,0 +1,91 @@
+#ifndef COMPLEX_PHASE_H
+#define COMPLEX_PHASE_H
+
+#include <cstddef>
+#include "complexbatch.h"
+#include "mycomplex.h"
+
+using namespace std;
+
+// Фаза сигнала в демодуляторах: развёртка фазы и частотный дискриминатор.
+// Оба идут блоками произвольной длины и переносят состояние между ними, так
+// что результат не зависит от разбиения входа. Перевод блока в полярную
+// форму и обратно — ToPolar и Polar из complexbatch.h.
+
+/**
+ * @brief Потоковая развёртка фазы: убирает скачки на 2pi, которые
+ * появляются, когда фаза, приведённая к [-pi, pi], переходит через +-pi.
+ *
+ * Скачок между соседними отсчётами больше pi по модулю считается таким
+ * переходом: к этому и всем следующим отсчётам прибавляется кратное 2pi
+ * (число оборотов хранится целым, поэтому ошибка не накапливается). Число
+ * оборотов на отсчёт считается векторно (SimdKernels::unwrapPhase).
+ * Первый отсчёт после создания или Reset() не сдвигается. Скачок через NaN
+ * не считается.
+ */
+class PhaseUnwrapper {
+private:
+    double state_[2];  /**< Последняя входная фаза и накопленные обороты.*/
+    bool started_;     /**< Был ли уже хоть один отсчёт.*/
+
+public:
+    PhaseUnwrapper() noexcept { Reset(); }
+
+    /**
+    * @brief Развёртывает следующий блок
+    * @param in Фазы в радианах
+    * @param out Развёрнутые фазы (может совпадать с in)
+    * @param n Число отсчётов
+    */
+    void Process(const double* in, double* out, size_t n);
+
+    /** Забывает прошлые блоки */
+    void Reset() noexcept;
+
+    /** Накопленный сдвиг в оборотах (прибавляется как 2pi * Turns()) */
+    double Turns() const noexcept { return state_[1]; }
+};
+
+/**
+ * @brief Частотный дискриминатор: out[i] = gain * arg(z[i] * conj(z[i - 1])),
+ * мгновенная частота без развёртки фазы.
+ *
+ * Произведение на сопряжённый предыдущий отсчёт и atan2 идут за один
+ * проход (SimdKernels::fmDiscriminateInterleaved); предыдущий отсчёт
+ * переносится между блоками. Для первого отсчёта после создания или
+ * Reset() предыдущим считается он сам (частота 0 до округления). Точность — как у Arg
+ * с той же MathAccuracy.
+ */
+class FmDiscriminator {
+private:
+    Complex previous_;       /**< Последний отсчёт прошлого блока.*/
+    double gain_;            /**< Множитель выхода.*/
+    MathAccuracy accuracy_;  /**< Точность atan2.*/
+    bool started_;           /**< Был ли уже хоть один отсчёт.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param gain Множитель: 1 — радианы на отсчёт, fs / 2pi — герцы,
+    * 1 / девиация — нормированный звук
+    * @param accuracy Точность atan2
+    */
+    explicit FmDiscriminator(double gain = 1, MathAccuracy accuracy = MathAccuracy::Fast) noexcept
+        : previous_(), gain_(gain), accuracy_(accuracy), started_(false) {}
+
+    /**
+    * @brief Демодулирует следующий блок
+    * @param in Отсчёты
+    * @param out Частоты (не короче n)
+    * @param n Число отсчётов
+    */
+    void Process(const Complex* in, double* out, size_t n);
+
+    /** Забывает прошлые блоки */
+    void Reset() noexcept { started_ = false; }
+
+    /** Множитель выхода */
+    double Gain() const noexcept { return gain_; }
+};
+
+#endif // COMPLEX_PHASE_H
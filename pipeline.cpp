@@ -0,0 +1,360 @@
+#include "pipeline.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "profile.h"
+#include "simd.h"
+#include "threadpool.h"
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+double Seconds(Clock::duration d) {
+    return chrono::duration<double>(d).count();
+}
+
+double* AsDoubles(Complex* dst) {
+    return reinterpret_cast<double*>(dst);
+}
+
+/** Учёт одного блока ступени: время работы и задержка от входа в конвейер */
+void Account(StageStats& stats, size_t in, size_t out, Clock::time_point origin,
+             Clock::time_point start, Clock::time_point finish) {
+    double latency = Seconds(finish - origin);
+    stats.samplesIn += in;
+    stats.samplesOut += out;
+    ++stats.blocks;
+    stats.busySeconds += Seconds(finish - start);
+    stats.latencySeconds += latency;
+    stats.maxLatencySeconds = max(stats.maxLatencySeconds, latency);
+}
+
+} // namespace
+
+FirFilter::FirFilter(const Complex* taps, size_t count, size_t fftSize) : taps_(count), filled_(0) {
+    if (count == 0) {
+        throw invalid_argument("FirFilter: нужен хотя бы один отвод");
+    }
+    if (fftSize == 0) {
+        fftSize = 64;
+        while (fftSize < 4 * count) {
+            fftSize *= 2;
+        }
+    }
+    if (fftSize < count) {
+        throw invalid_argument("FirFilter: длина БПФ меньше числа отводов");
+    }
+    plan_ = FftPlan::Get(fftSize);
+    block_ = fftSize - count + 1;
+    spectrum_.assign(fftSize, Complex());
+    copy(taps, taps + count, spectrum_.begin());
+    plan_->Forward(spectrum_.data());
+    buffer_.assign(fftSize, Complex());
+    work_.resize(fftSize);
+}
+
+/**
+ * @brief Дополняет текущий блок; каждый полный блок даёт L отсчётов выхода.
+ */
+size_t FirFilter::Process(const Complex* in, size_t n, Complex* out) {
+    COMPLEX_PROFILE_KERNEL("fir.process", n);
+    const size_t keep = taps_ - 1;
+    const size_t size = plan_->Size();
+    size_t produced = 0;
+    while (n > 0) {
+        size_t m = min(n, block_ - filled_);
+        copy(in, in + m, buffer_.begin() + keep + filled_);
+        in += m;
+        n -= m;
+        filled_ += m;
+        if (filled_ < block_) {
+            break;
+        }
+        plan_->Execute(buffer_.data(), work_.data(), FftDirection::Forward);
+        ActiveKernels().mulInterleaved(AsDoubles(work_.data()), AsDoubles(spectrum_.data()), AsDoubles(work_.data()), size);
+        plan_->Execute(work_.data(), work_.data(), FftDirection::Inverse);
+        // Первые M - 1 отсчётов обратного БПФ испорчены циклическим переносом.
+        copy(work_.begin() + keep, work_.end(), out + produced);
+        produced += block_;
+        copy(buffer_.begin() + block_, buffer_.end(), buffer_.begin());
+        filled_ = 0;
+    }
+    return produced;
+}
+
+void FirFilter::Reset() {
+    fill(buffer_.begin(), buffer_.end(), Complex());
+    filled_ = 0;
+}
+
+Decimator::Decimator(const double* taps, size_t count, size_t factor) : factor_(factor), next_(0) {
+    if (count == 0 || factor == 0) {
+        throw invalid_argument("Decimator: нужны хотя бы один отвод и коэффициент прореживания не меньше 1");
+    }
+    taps_.assign(taps, taps + count);
+    reverse(taps_.begin(), taps_.end());
+    line_.assign(count - 1, Complex());
+}
+
+/**
+ * @brief Дописывает блок за историей и считает выходы в позициях,
+ * кратных factor (нумерация отсчётов — с начала потока).
+ */
+size_t Decimator::Process(const Complex* in, size_t n, Complex* out) {
+    const size_t keep = taps_.size() - 1;
+    if (line_.size() < keep + n) {
+        line_.resize(keep + n);
+    }
+    copy(in, in + n, line_.begin() + keep);
+    const double* h = taps_.data();
+    size_t produced = 0;
+    size_t i = next_;
+    for (; i < n; i += factor_) {
+        // Окно line_[i .. i + M) — отсчёты от i - (M - 1) до i.
+        const Complex* x = line_.data() + i;
+        double re = 0, im = 0;
+        for (size_t j = 0; j <= keep; ++j) {
+            re += h[j] * x[j].Re();
+            im += h[j] * x[j].Im();
+        }
+        out[produced++] = Complex(re, im);
+    }
+    next_ = i - n;
+    copy(line_.begin() + n, line_.begin() + n + keep, line_.begin());
+    return produced;
+}
+
+void Decimator::Reset() {
+    fill(line_.begin(), line_.end(), Complex());
+    next_ = 0;
+}
+
+Mixer::Mixer(double frequency, double phase) : oscillator_(frequency, phase), frequency_(frequency), phase_(phase) {}
+
+size_t Mixer::Process(const Complex* in, size_t n, Complex* out) {
+    oscillator_.Mix(in, out, n);
+    return n;
+}
+
+void Mixer::Reset() {
+    oscillator_ = Oscillator(frequency_, phase_);
+}
+
+BlockRing::BlockRing(size_t slots, size_t capacity, WaitPolicy policy)
+    : capacity_(capacity), policy_(policy), tail_(0), head_(0), closed_(false) {
+    if (slots == 0) {
+        throw invalid_argument("BlockRing: нужен хотя бы один слот");
+    }
+    slots_.resize(slots);
+    for (Slot& slot : slots_) {
+        slot.data.resize(capacity);
+        slot.count = 0;
+    }
+}
+
+BlockRing::Slot* BlockRing::BeginWrite() {
+    // Счётчик tail_ меняет только писатель, head_ — только читатель.
+    uint64_t tail = tail_.load(memory_order_relaxed);
+    auto ready = [&] {
+        return closed_.load(memory_order_acquire) || tail - head_.load(memory_order_acquire) < slots_.size();
+    };
+    if (!ready()) {
+        writable_.Wait(ready, policy_);
+    }
+    return closed_.load(memory_order_acquire) ? nullptr : &slots_[tail % slots_.size()];
+}
+
+void BlockRing::EndWrite() noexcept {
+    tail_.store(tail_.load(memory_order_relaxed) + 1, memory_order_release);
+    if (policy_ == WaitPolicy::Futex) {
+        readable_.Notify();
+    }
+}
+
+BlockRing::Slot* BlockRing::BeginRead() {
+    uint64_t head = head_.load(memory_order_relaxed);
+    auto ready = [&] { return head < tail_.load(memory_order_acquire) || closed_.load(memory_order_acquire); };
+    if (!ready()) {
+        readable_.Wait(ready, policy_);
+    }
+    return head < tail_.load(memory_order_acquire) ? &slots_[head % slots_.size()] : nullptr;
+}
+
+void BlockRing::EndRead() noexcept {
+    head_.store(head_.load(memory_order_relaxed) + 1, memory_order_release);
+    if (policy_ == WaitPolicy::Futex) {
+        writable_.Notify();
+    }
+}
+
+void BlockRing::Close() noexcept {
+    closed_.store(true, memory_order_release);
+    readable_.Notify();
+    writable_.Notify();
+}
+
+Pipeline::Pipeline(size_t blockSize) : blockSize_(blockSize ? blockSize : 1) {}
+
+StreamStage& Pipeline::Add(unique_ptr<StreamStage> stage) {
+    if (!stage) {
+        throw invalid_argument("Pipeline::Add: пустая ступень");
+    }
+    stages_.push_back(move(stage));
+    stats_.emplace_back();
+    return *stages_.back();
+}
+
+/**
+ * @brief Наибольшая длина блока на входе каждой ступени и на выходе последней
+ */
+vector<size_t> Pipeline::Capacities() const {
+    vector<size_t> capacities(1, blockSize_);
+    for (const unique_ptr<StreamStage>& stage : stages_) {
+        capacities.push_back(stage->MaxOutput(capacities.back()));
+    }
+    return capacities;
+}
+
+/**
+ * @brief Блок идёт через все ступени по двум буферам арены попеременно.
+ */
+void Pipeline::Push(const Complex* in, size_t n, const Sink& sink) {
+    vector<size_t> capacities = Capacities();
+    size_t capacity = *max_element(capacities.begin(), capacities.end());
+    ArenaFrame frame;
+    Complex* buffers[2] = {frame.Allocate<Complex>(capacity), frame.Allocate<Complex>(capacity)};
+    for (size_t pos = 0; pos < n; pos += blockSize_) {
+        const Complex* src = in + pos;
+        size_t count = min(blockSize_, n - pos);
+        Clock::time_point origin = Clock::now(), start = origin;
+        for (size_t i = 0; i < stages_.size() && count > 0; ++i) {
+            Complex* dst = buffers[i % 2];
+            size_t produced = stages_[i]->Process(src, count, dst);
+            Clock::time_point finish = Clock::now();
+            Account(stats_[i], count, produced, origin, start, finish);
+            start = finish;
+            src = dst;
+            count = produced;
+        }
+        if (count > 0) {
+            sink(src, count);
+        }
+    }
+}
+
+/**
+ * @brief Источник — в вызывающем потоке, ступень i — в своём потоке между
+ * кольцами i и i + 1; последняя ступень пишет сразу в приёмник.
+ */
+void Pipeline::Run(const Source& source, const Sink& sink, const PipelineThreads& threads) {
+    vector<size_t> capacities = Capacities();
+    if (stages_.empty()) {
+        ComplexVector block(blockSize_);
+        while (size_t count = source(block.data(), blockSize_)) {
+            sink(block.data(), min(count, blockSize_));
+        }
+        return;
+    }
+    vector<unique_ptr<BlockRing>> rings;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        rings.emplace_back(new BlockRing(threads.ringSlots ? threads.ringSlots : 1, capacities[i], threads.wait));
+    }
+    mutex errorLock;
+    exception_ptr error;
+    auto fail = [&] {
+        {
+            lock_guard<mutex> guard(errorLock);
+            if (!error) {
+                error = current_exception();
+            }
+        }
+        for (unique_ptr<BlockRing>& ring : rings) {
+            ring->Close();
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        workers.emplace_back([&, i] {
+            if (i < threads.cpus.size()) {
+                PinCurrentThread(threads.cpus[i]);
+            }
+            StreamStage& stage = *stages_[i];
+            StageStats& stats = stats_[i];
+            BlockRing& input = *rings[i];
+            BlockRing* output = i + 1 < rings.size() ? rings[i + 1].get() : nullptr;
+            try {
+                ComplexVector last(output ? 0 : capacities[i + 1]);
+                for (;;) {
+                    Clock::time_point waitStart = Clock::now();
+                    BlockRing::Slot* in = input.BeginRead();
+                    BlockRing::Slot* out = in && output ? output->BeginWrite() : nullptr;
+                    if (!in || (output && !out)) {
+                        break;
+                    }
+                    Complex* dst = out ? out->data.data() : last.data();
+                    Clock::time_point start = Clock::now();
+                    stats.waitSeconds += Seconds(start - waitStart);
+                    size_t produced = stage.Process(in->data.data(), in->count, dst);
+                    Account(stats, in->count, produced, in->origin, start, Clock::now());
+                    Clock::time_point origin = in->origin;
+                    input.EndRead();
+                    if (produced > 0) {
+                        if (out) {
+                            out->count = produced;
+                            out->origin = origin;
+                            output->EndWrite();
+                        } else {
+                            sink(dst, produced);
+                        }
+                    }
+                }
+            } catch (...) {
+                fail();
+            }
+            if (output) {
+                output->Close();
+            }
+        });
+    }
+
+    try {
+        for (;;) {
+            BlockRing::Slot* slot = rings[0]->BeginWrite();
+            if (!slot) {
+                break;
+            }
+            size_t count = min(source(slot->data.data(), blockSize_), blockSize_);
+            if (count == 0) {
+                break;
+            }
+            slot->count = count;
+            slot->origin = Clock::now();
+            rings[0]->EndWrite();
+        }
+    } catch (...) {
+        fail();
+    }
+    rings[0]->Close();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+void Pipeline::Reset() {
+    for (unique_ptr<StreamStage>& stage : stages_) {
+        stage->Reset();
+    }
+}
+
+void Pipeline::ResetStats() {
+    fill(stats_.begin(), stats_.end(), StageStats());
+}
@@ -0,0 +1,340 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "allocator.h"
+#include "fft.h"
+#include "mycomplex.h"
+#include "oscillator.h"
+#include "ringbuffer.h"
+
+using namespace std;
+
+// Потоковая обработка бесконечных сигналов блоками.
+//
+// Ступень (StreamStage) хранит своё состояние между блоками — историю
+// фильтра, фазу генератора, — поэтому результат не зависит от того, какими
+// блоками подаётся сигнал. Pipeline проводит каждый блок через все ступени
+// подряд, пока он в кэше: промежуточные буферы размером в блок (а не в
+// весь сигнал) берутся из арены потока. В поточном режиме у каждой ступени
+// свой поток (по желанию — привязанный к ядру), а между ступенями стоят
+// ограниченные кольца блоков BlockRing.
+
+/**
+ * @brief Ступень потоковой обработки.
+ */
+class StreamStage {
+public:
+    virtual ~StreamStage() = default;
+
+    /** Имя ступени (для статистики) */
+    virtual const char* Name() const noexcept = 0;
+
+    /**
+    * @brief Сколько отсчётов ступень может выдать на n входных при любом
+    * состоянии (размер выходного буфера)
+    */
+    virtual size_t MaxOutput(size_t n) const noexcept = 0;
+
+    /**
+    * @brief Обрабатывает очередные n отсчётов
+    * @param in Вход
+    * @param n Число входных отсчётов
+    * @param out Выход (не короче MaxOutput(n)); не пересекается с in
+    * @return Сколько отсчётов записано в out
+    */
+    virtual size_t Process(const Complex* in, size_t n, Complex* out) = 0;
+
+    /** Возвращает ступень в начальное состояние */
+    virtual void Reset() = 0;
+};
+
+/**
+ * @brief КИХ-фильтр y[k] = sum h[j] * x[k - j] методом перекрытия с
+ * накоплением (overlap-save).
+ *
+ * Вход копится блоками по L = N - M + 1 отсчётов (N — длина БПФ, M — число
+ * отводов); каждый блок вместе с M - 1 предыдущими отсчётами проходит БПФ,
+ * умножение на спектр фильтра и обратное БПФ, из которого берутся последние
+ * L отсчётов. Поэтому выход идёт порциями по L и отстаёт от входа не больше
+ * чем на L - 1 отсчётов; начальная история — нули.
+ */
+class FirFilter : public StreamStage {
+private:
+    shared_ptr<const FftPlan> plan_;  /**< План БПФ длины N.*/
+    ComplexVector spectrum_;          /**< БПФ отводов, дополненных нулями до N.*/
+    ComplexVector buffer_;            /**< [M - 1 отсчётов истории][до L новых].*/
+    ComplexVector work_;              /**< Рабочий буфер спектра.*/
+    size_t taps_;                     /**< M.*/
+    size_t block_;                    /**< L.*/
+    size_t filled_;                   /**< Новых отсчётов в buffer_.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param taps Отводы h[0..count)
+    * @param count Число отводов M (не 0)
+    * @param fftSize Длина БПФ N >= M; 0 — степень двойки не меньше 4M (и 64)
+    * @throws invalid_argument при count == 0 или fftSize < count
+    */
+    FirFilter(const Complex* taps, size_t count, size_t fftSize = 0);
+
+    const char* Name() const noexcept override { return "fir"; }
+    size_t MaxOutput(size_t n) const noexcept override { return (n + block_ - 1) / block_ * block_; }
+    size_t Process(const Complex* in, size_t n, Complex* out) override;
+    void Reset() override;
+
+    /** Длина блока выхода L */
+    size_t BlockLength() const noexcept { return block_; }
+    /** Длина БПФ N */
+    size_t FftSize() const noexcept { return plan_->Size(); }
+};
+
+/**
+ * @brief Многофазный дециматор: КИХ-фильтр с действительными отводами и
+ * прореживанием в factor раз, y[m] = sum h[j] * x[m * factor - j].
+ *
+ * Считаются только сохраняемые отсчёты: каждый выход — сумма factor
+ * многофазных ветвей по M / factor отводов, то есть M / factor умножений
+ * на входной отсчёт вместо M. Начальная история — нули; первый выход
+ * соответствует первому входному отсчёту.
+ */
+class Decimator : public StreamStage {
+private:
+    vector<double> taps_;  /**< Отводы в обратном порядке: taps_[j] = h[M - 1 - j].*/
+    ComplexVector line_;   /**< [M - 1 отсчётов истории][текущий блок].*/
+    size_t factor_;        /**< Коэффициент прореживания.*/
+    size_t next_;          /**< Номер отсчёта следующего блока, дающего выход.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param taps Отводы h[0..count)
+    * @param count Число отводов (не 0)
+    * @param factor Коэффициент прореживания (не 0)
+    * @throws invalid_argument при count == 0 или factor == 0
+    */
+    Decimator(const double* taps, size_t count, size_t factor);
+
+    const char* Name() const noexcept override { return "decimator"; }
+    size_t MaxOutput(size_t n) const noexcept override { return (n + factor_ - 1) / factor_; }
+    size_t Process(const Complex* in, size_t n, Complex* out) override;
+    void Reset() override;
+
+    size_t Factor() const noexcept { return factor_; }
+};
+
+/**
+ * @brief Смеситель: перенос частоты умножением на несущую Oscillator.
+ */
+class Mixer : public StreamStage {
+private:
+    Oscillator oscillator_;  /**< Генератор несущей.*/
+    double frequency_;       /**< Начальная частота (для Reset).*/
+    double phase_;           /**< Начальная фаза (для Reset).*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param frequency Частота несущей, радиан на отсчёт
+    * @param phase Начальная фаза, радиан
+    */
+    explicit Mixer(double frequency, double phase = 0);
+
+    const char* Name() const noexcept override { return "mixer"; }
+    size_t MaxOutput(size_t n) const noexcept override { return n; }
+    size_t Process(const Complex* in, size_t n, Complex* out) override;
+    void Reset() override;
+
+    /** Генератор несущей (для перестройки на ходу) */
+    Oscillator& GetOscillator() noexcept { return oscillator_; }
+};
+
+/**
+ * @brief Счётчики ступени конвейера.
+ *
+ * Задержка блока — время от поступления блока в конвейер (чтения из
+ * источника) до конца его обработки этой ступенью; в неё входят
+ * предыдущие ступени и ожидание в кольцах.
+ */
+struct StageStats {
+    uint64_t samplesIn = 0;       /**< Принято отсчётов.*/
+    uint64_t samplesOut = 0;      /**< Выдано отсчётов.*/
+    uint64_t blocks = 0;          /**< Обработано блоков.*/
+    double busySeconds = 0;       /**< Время внутри Process.*/
+    double waitSeconds = 0;       /**< Ожидание входа и места на выходе (поточный режим).*/
+    double latencySeconds = 0;    /**< Сумма задержек блоков.*/
+    double maxLatencySeconds = 0; /**< Наибольшая задержка блока.*/
+
+    /** Входных отсчётов в секунду работы ступени */
+    double Throughput() const noexcept { return busySeconds > 0 ? samplesIn / busySeconds : 0; }
+    /** Средняя задержка блока, секунды */
+    double MeanLatency() const noexcept { return blocks ? latencySeconds / blocks : 0; }
+};
+
+/**
+ * @brief Ограниченное кольцо блоков между двумя потоками (один пишет,
+ * один читает), без блокировок.
+ *
+ * Слоты выделяются один раз; писатель заполняет слот на месте и
+ * публикует его, читатель обрабатывает слот на месте и освобождает, так
+ * что данные не копируются. Полное кольцо останавливает писателя, пустое —
+ * читателя (ожидание — по WaitPolicy, как в SpscRing). Close() можно
+ * вызвать из любого потока; он будит обоих: читатель дочитывает
+ * опубликованное и получает nullptr, писатель сразу получает nullptr.
+ */
+class BlockRing {
+public:
+    /** Слот кольца. */
+    struct Slot {
+        ComplexVector data;                      /**< Отсчёты (ёмкость — Capacity()).*/
+        size_t count;                            /**< Сколько отсчётов записано.*/
+        chrono::steady_clock::time_point origin; /**< Когда блок вошёл в конвейер.*/
+    };
+
+private:
+    vector<Slot> slots_;   /**< Слоты.*/
+    size_t capacity_;      /**< Ёмкость слота в отсчётах.*/
+    WaitPolicy policy_;    /**< Способ ожидания.*/
+
+    alignas(kCacheLineAlignment) atomic<uint64_t> tail_;  /**< Опубликовано слотов (пишет писатель).*/
+    alignas(kCacheLineAlignment) atomic<uint64_t> head_;  /**< Освобождено слотов (пишет читатель).*/
+    alignas(kCacheLineAlignment) atomic<bool> closed_;    /**< Кольцо закрыто.*/
+    RingSignal readable_;                                 /**< Опубликован слот или кольцо закрыто.*/
+    RingSignal writable_;                                 /**< Освобождён слот или кольцо закрыто.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param slots Число слотов (не 0)
+    * @param capacity Ёмкость слота в отсчётах
+    * @param policy Способ ожидания
+    * @throws invalid_argument при slots == 0
+    */
+    BlockRing(size_t slots, size_t capacity, WaitPolicy policy = WaitPolicy::Futex);
+
+    BlockRing(const BlockRing&) = delete;
+    BlockRing& operator=(const BlockRing&) = delete;
+
+    /**
+    * @brief Свободный слот для записи (ждёт, пока он появится)
+    * @return Слот или nullptr, если кольцо закрыто
+    */
+    Slot* BeginWrite();
+
+    /** Публикует слот из BeginWrite; без вызова следующий BeginWrite вернёт тот же слот */
+    void EndWrite() noexcept;
+
+    /**
+    * @brief Следующий опубликованный слот (ждёт, пока он появится)
+    * @return Слот или nullptr, если кольцо закрыто и пусто
+    */
+    Slot* BeginRead();
+
+    /** Освобождает слот из BeginRead */
+    void EndRead() noexcept;
+
+    /** Закрывает кольцо */
+    void Close() noexcept;
+
+    size_t Capacity() const noexcept { return capacity_; }
+};
+
+/**
+ * @brief Параметры поточного режима Pipeline::Run.
+ */
+struct PipelineThreads {
+    size_t ringSlots = 4;                  /**< Слотов в кольце перед каждой ступенью.*/
+    WaitPolicy wait = WaitPolicy::Futex;   /**< Ожидание на пустых и полных кольцах.*/
+    vector<int> cpus;                      /**< cpus[i] — ядро потока ступени i; отрицательное или отсутствующее — без привязки.*/
+};
+
+/**
+ * @brief Цепочка ступеней, через которую сигнал идёт блоками.
+ *
+ *     Pipeline pipeline;
+ *     pipeline.Emplace<Mixer>(-0.3);
+ *     pipeline.Emplace<FirFilter>(taps.data(), taps.size());
+ *     pipeline.Emplace<Decimator>(lowpass.data(), lowpass.size(), 8);
+ *     pipeline.Push(samples, n, [&](const Complex* y, size_t m) { ... });
+ */
+class Pipeline {
+public:
+    /** Приёмник выхода: (отсчёты, их число) */
+    using Sink = function<void(const Complex*, size_t)>;
+    /** Источник входа: заполняет до n отсчётов и возвращает их число; 0 — конец */
+    using Source = function<size_t(Complex*, size_t)>;
+
+    /** Длина блока по умолчанию: 4096 чисел (64 КБ) — вход и выход ступени в L2. */
+    static const size_t kDefaultBlock = 4096;
+
+private:
+    vector<unique_ptr<StreamStage>> stages_;  /**< Ступени по порядку.*/
+    vector<StageStats> stats_;                /**< Счётчики ступеней.*/
+    size_t blockSize_;                        /**< Длина входного блока.*/
+
+    vector<size_t> Capacities() const;
+
+public:
+    /**
+    * @brief Конструктор
+    * @param blockSize Длина блока, которым вход подаётся в первую ступень (0 считается за 1)
+    */
+    explicit Pipeline(size_t blockSize = kDefaultBlock);
+
+    /**
+    * @brief Добавляет ступень в конец цепочки
+    * @return Добавленная ступень
+    * @throws invalid_argument, если stage пуст
+    */
+    StreamStage& Add(unique_ptr<StreamStage> stage);
+
+    /** Создаёт и добавляет ступень S(args...) */
+    template <class S, class... Args>
+    S& Emplace(Args&&... args) {
+        return static_cast<S&>(Add(unique_ptr<StreamStage>(new S(forward<Args>(args)...))));
+    }
+
+    size_t StageCount() const noexcept { return stages_.size(); }
+    StreamStage& Stage(size_t index) { return *stages_.at(index); }
+    size_t BlockSize() const noexcept { return blockSize_; }
+
+    /**
+    * @brief Проводит n отсчётов через все ступени в текущем потоке: блок за
+    * блоком, каждый — через всю цепочку. Выход отдаётся в sink сразу по
+    * готовности (указатель действителен только внутри вызова).
+    * @param in Вход
+    * @param n Число отсчётов
+    * @param sink Приёмник выхода последней ступени
+    */
+    void Push(const Complex* in, size_t n, const Sink& sink);
+
+    /**
+    * @brief Поточный режим: источник читается в текущем потоке, каждая
+    * ступень работает в своём, блоки передаются через кольца; sink
+    * вызывается из потока последней ступени. Возвращается, когда источник исчерпан и весь вход
+    * обработан. Первое исключение из источника, ступени или приёмника
+    * останавливает конвейер и пробрасывается наружу.
+    * @param source Источник (вызывается из текущего потока)
+    * @param sink Приёмник
+    * @param threads Параметры потоков
+    */
+    void Run(const Source& source, const Sink& sink, const PipelineThreads& threads = PipelineThreads());
+
+    /** Сбрасывает состояние всех ступеней (счётчики не трогаются) */
+    void Reset();
+
+    /** Счётчики ступеней (по порядку) */
+    const vector<StageStats>& Stats() const noexcept { return stats_; }
+
+    /** Обнуляет счётчики */
+    void ResetStats();
+};
+
+#endif // PIPELINE_H
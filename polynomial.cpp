@@ -0,0 +1,296 @@
+#include "polynomial.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "allocator.h"
+#include "complexmath.h"
+#include "fft.h"
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double kEps = numeric_limits<double>::epsilon();
+
+const double* AsDoubles(const Complex* src) {
+    return reinterpret_cast<const double*>(src);
+}
+
+double* AsDoubles(Complex* dst) {
+    return reinterpret_cast<double*>(dst);
+}
+
+bool IsZero(const Complex& z) {
+    return z.Re() == 0 && z.Im() == 0;
+}
+
+/**
+ * @brief Многочлен степени n для поиска корней: внутри единичного круга он
+ * считается как есть, вне — перевёрнутым в точке 1/z. Модули коэффициентов
+ * (как вещественные Complex) дают знаменатель обратной ошибки.
+ */
+struct RootPolynomial {
+    size_t degree;                /**< n.*/
+    vector<Complex> direct;       /**< q_0 .. q_n.*/
+    vector<Complex> reversed;     /**< q_n .. q_0.*/
+    vector<Complex> directAbs;    /**< |q_0| .. |q_n|.*/
+    vector<Complex> reversedAbs;  /**< |q_n| .. |q_0|.*/
+
+    RootPolynomial(const Complex* q, size_t n) : degree(n), direct(q, q + n + 1) {
+        for (const Complex& x : direct) {
+            directAbs.push_back(Complex(x.Abs()));
+        }
+        reversed.assign(direct.rbegin(), direct.rend());
+        reversedAbs.assign(directAbs.rbegin(), directAbs.rend());
+    }
+};
+
+/**
+ * @brief Поправки Ньютона p(z)/p'(z) и обратные ошибки для корней [lo, hi),
+ * кроме отмеченных в skip (может быть nullptr). Точки внутри и вне
+ * единичного круга собираются в два пакета для polyEvalInterleaved:
+ * вне круга p/p' = z / (n - y q'(y) / q(y)), q — перевёрнутый, y = 1/z.
+ */
+void NewtonCorrections(const RootPolynomial& poly, const Complex* z, const unsigned char* skip, size_t lo,
+                       size_t hi, Complex* correction, double* backwardError) {
+    const SimdKernels& kernels = ActiveKernels();
+    ArenaFrame frame;
+    size_t m = hi - lo, count = poly.degree + 1;
+    size_t* index = frame.Allocate<size_t>(m);
+    Complex* points = frame.Allocate<Complex>(m);
+    Complex* p = frame.Allocate<Complex>(m);
+    Complex* dp = frame.Allocate<Complex>(m);
+    Complex* bound = frame.Allocate<Complex>(m);
+    for (int outer = 0; outer < 2; ++outer) {
+        size_t used = 0;
+        for (size_t i = lo; i < hi; ++i) {
+            if ((!skip || !skip[i]) && (z[i].AbsSquared() > 1) == bool(outer)) {
+                index[used] = i;
+                points[used++] = outer ? z[i].Reciprocal() : z[i];
+            }
+        }
+        if (used == 0) {
+            continue;
+        }
+        const vector<Complex>& c = outer ? poly.reversed : poly.direct;
+        const vector<Complex>& cAbs = outer ? poly.reversedAbs : poly.directAbs;
+        kernels.polyEvalInterleaved(AsDoubles(c.data()), count, AsDoubles(points), AsDoubles(p), AsDoubles(dp), used,
+                                    false);
+        for (size_t k = 0; k < used; ++k) {
+            size_t i = index[k];
+            Complex n;
+            if (IsZero(p[k])) {
+                n = Complex();
+            } else if (outer) {
+                n = z[i] / (double(poly.degree) - points[k] * dp[k] / p[k]);
+            } else {
+                n = p[k] / dp[k];
+            }
+            if (!isfinite(n.Re()) || !isfinite(n.Im())) {
+                // p' = 0 вне корня: сдвиг, чтобы уйти из критической точки.
+                n = Complex(1e-3 * (1 + z[i].Abs()));
+            }
+            correction[i] = n;
+            points[k] = Complex(points[k].Abs());
+        }
+        kernels.polyEvalInterleaved(AsDoubles(cAbs.data()), count, AsDoubles(points), AsDoubles(bound), nullptr, used,
+                                    false);
+        for (size_t k = 0; k < used; ++k) {
+            backwardError[index[k]] = bound[k].Re() > 0 ? p[k].Abs() / bound[k].Re() : 0;
+        }
+    }
+}
+
+/**
+ * @brief Начальные приближения: для каждого отрезка [a, b] верхней выпуклой
+ * оболочки точек (k, log|q_k|) — b - a точек на окружности радиуса
+ * (|q_a| / |q_b|)^(1 / (b - a)), повёрнутых, чтобы не совпадать по углу.
+ */
+void InitialGuesses(const RootPolynomial& poly, Complex* z) {
+    const double kPi = 3.14159265358979323846;
+    size_t n = poly.degree;
+    vector<double> logs(n + 1);
+    vector<size_t> hull;
+    for (size_t k = 0; k <= n; ++k) {
+        if (poly.directAbs[k].Re() == 0) {
+            continue;
+        }
+        logs[k] = log(poly.directAbs[k].Re());
+        while (hull.size() >= 2) {
+            size_t a = hull[hull.size() - 2], b = hull.back();
+            if ((logs[b] - logs[a]) * double(k - a) > (logs[k] - logs[a]) * double(b - a)) {
+                break;
+            }
+            hull.pop_back();
+        }
+        hull.push_back(k);
+    }
+    for (size_t s = 0; s + 1 < hull.size(); ++s) {
+        size_t a = hull[s], m = hull[s + 1] - a;
+        double radius = exp((logs[a] - logs[hull[s + 1]]) / double(m));
+        for (size_t j = 0; j < m; ++j) {
+            z[a + j] = Polar(radius, 2 * kPi * double(j) / double(m) + 2 * kPi * double(a) / double(n) + 0.4);
+        }
+    }
+}
+
+} // namespace
+
+Complex EvaluatePolynomial(const Complex* c, size_t count, const Complex& z) noexcept {
+    if (count == 0) {
+        return Complex();
+    }
+    Complex r = c[count - 1];
+    for (size_t k = count - 1; k-- > 0;) {
+        r = r * z + c[k];
+    }
+    return r;
+}
+
+void EvaluatePolynomial(const Complex* c, size_t count, const Complex* z, Complex* out, size_t n,
+                        PolyScheme scheme) {
+    COMPLEX_PROFILE_KERNEL("poly.eval", n);
+    ActiveKernels().polyEvalInterleaved(AsDoubles(c), count, AsDoubles(z), AsDoubles(out), nullptr, n,
+                                        scheme == PolyScheme::Estrin);
+}
+
+void EvaluatePolynomial(const Complex* c, size_t count, const Complex* z, Complex* out, Complex* derivative,
+                        size_t n) {
+    COMPLEX_PROFILE_KERNEL("poly.eval_derivative", n);
+    ActiveKernels().polyEvalInterleaved(AsDoubles(c), count, AsDoubles(z), AsDoubles(out), AsDoubles(derivative), n,
+                                        false);
+}
+
+vector<Complex> MultiplyPolynomials(const Complex* a, size_t na, const Complex* b, size_t nb,
+                                    PolyMultiplyMethod method) {
+    if (na == 0 || nb == 0) {
+        return vector<Complex>();
+    }
+    size_t size = na + nb - 1;
+    COMPLEX_PROFILE_KERNEL("poly.multiply", size);
+    if (method == PolyMultiplyMethod::Auto) {
+        method = min(na, nb) >= kPolyFftThreshold ? PolyMultiplyMethod::Fft : PolyMultiplyMethod::Direct;
+    }
+    if (method == PolyMultiplyMethod::Direct) {
+        // По строке на коэффициент короткого множителя, ядро axpy — по длинному.
+        if (na > nb) {
+            swap(a, b);
+            swap(na, nb);
+        }
+        vector<Complex> out(size);
+        const SimdKernels& kernels = ActiveKernels();
+        for (size_t i = 0; i < na; ++i) {
+            kernels.axpyInterleaved(a[i].Re(), a[i].Im(), AsDoubles(b), AsDoubles(out.data() + i), nb);
+        }
+        return out;
+    }
+    size_t length = 1;
+    while (length < size) {
+        length <<= 1;
+    }
+    shared_ptr<const FftPlan> plan = FftPlan::Get(length);
+    ArenaFrame frame;
+    Complex* x = frame.Allocate<Complex>(length);
+    Complex* y = frame.Allocate<Complex>(length);
+    fill(copy(a, a + na, x), x + length, Complex());
+    fill(copy(b, b + nb, y), y + length, Complex());
+    plan->Forward(x);
+    plan->Forward(y);
+    ActiveKernels().mulInterleaved(AsDoubles(x), AsDoubles(y), AsDoubles(x), length);
+    plan->Inverse(x);
+    return vector<Complex>(x, x + size);
+}
+
+RootResult FindRoots(const Complex* c, size_t count, const RootOptions& options, ThreadPool& pool) {
+    size_t top = count;
+    while (top > 0 && IsZero(c[top - 1])) {
+        --top;
+    }
+    if (top == 0) {
+        throw invalid_argument("FindRoots: все коэффициенты нулевые");
+    }
+    COMPLEX_PROFILE_KERNEL("poly.roots", top - 1);
+    size_t zeros = 0;
+    while (IsZero(c[zeros])) {
+        ++zeros;
+    }
+    size_t total = top - 1, n = total - zeros;
+    RootResult result;
+    result.roots.assign(total, Complex());
+    result.backwardError.assign(total, 0);
+    result.errorBound.assign(total, 0);
+    result.iterations.assign(total, 0);
+    result.sweeps = 0;
+    result.converged = true;
+    result.maxBackwardError = 0;
+    result.maxErrorBound = 0;
+    if (n == 0) {
+        return result;
+    }
+
+    // Корни отличного от нуля множителя — в roots[0, n), точные нули — в конце.
+    RootPolynomial poly(c + zeros, n);
+    double tolerance = options.tolerance > 0 ? options.tolerance : 4 * double(n) * kEps;
+    vector<Complex> current(n), next(n), correction(n);
+    vector<double> backwardError(n);
+    vector<unsigned char> done(n, 0), polished(n, 0);
+    InitialGuesses(poly, current.data());
+    const SimdKernels& kernels = ActiveKernels();
+    size_t grain = max<size_t>(options.grain, 1), active = n;
+    while (active > 0 && result.sweeps < options.maxIterations) {
+        const Complex* z = current.data();
+        pool.ParallelFor(0, n, grain, [&](size_t lo, size_t hi) {
+            NewtonCorrections(poly, z, done.data(), lo, hi, correction.data(), backwardError.data());
+            for (size_t i = lo; i < hi; ++i) {
+                next[i] = z[i];
+                if (done[i]) {
+                    continue;
+                }
+                // Порог достигнут — ещё один шаг: поправка ниже уровня
+                // округления дешева. Корень готов, если и после шага он
+                // под порогом (шаг по соседям, что ещё сдвигаются, может
+                // и ухудшить его — тогда уточнение продолжается).
+                if (backwardError[i] <= tolerance) {
+                    if (polished[i]) {
+                        done[i] = 1;
+                        continue;
+                    }
+                    polished[i] = 1;
+                } else {
+                    polished[i] = 0;
+                }
+                // w = N / (1 - N * sum_{j != i} 1 / (z_i - z_j)), N = p / p'.
+                double left[2], right[2];
+                kernels.reciprocalSumInterleaved(z[i].Re(), z[i].Im(), AsDoubles(z), i, left);
+                kernels.reciprocalSumInterleaved(z[i].Re(), z[i].Im(), AsDoubles(z + i + 1), n - i - 1, right);
+                Complex sum(left[0] + right[0], left[1] + right[1]);
+                Complex denominator = 1.0 - correction[i] * sum;
+                Complex w = IsZero(denominator) ? correction[i] : correction[i] / denominator;
+                next[i] = z[i] - w;
+                ++result.iterations[i];
+                if (w.Abs() <= kEps * z[i].Abs()) {
+                    done[i] = 1;  // Поправка меньше ulp: дальше не сдвинуть.
+                }
+            }
+        });
+        current.swap(next);
+        ++result.sweeps;
+        active = size_t(count_if(done.begin(), done.end(), [](unsigned char d) { return !d; }));
+    }
+
+    pool.ParallelFor(0, n, grain, [&](size_t lo, size_t hi) {
+        NewtonCorrections(poly, current.data(), nullptr, lo, hi, correction.data(), backwardError.data());
+    });
+    for (size_t i = 0; i < n; ++i) {
+        result.roots[i] = current[i];
+        result.backwardError[i] = backwardError[i];
+        result.errorBound[i] = double(n) * correction[i].Abs();
+        result.converged = result.converged && backwardError[i] <= tolerance;
+        result.maxBackwardError = max(result.maxBackwardError, backwardError[i]);
+        result.maxErrorBound = max(result.maxErrorBound, result.errorBound[i]);
+    }
+    return result;
+}
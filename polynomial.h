@@ -0,0 +1,136 @@
+#ifndef COMPLEX_POLYNOMIAL_H
+#define COMPLEX_POLYNOMIAL_H
+
+#include <cstddef>
+#include <vector>
+#include "mycomplex.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// Многочлены с комплексными коэффициентами: значения во множестве точек,
+// произведение и все корни.
+//
+// Коэффициенты везде идут по возрастанию степени: c[0] — свободный член,
+// c[count - 1] — старший. Пакетное вычисление раскладывает точки по
+// дорожкам векторных регистров (ядро SimdKernels::polyEvalInterleaved), так
+// что шаг схемы Горнера — четыре FMA сразу на kWidth точек. Произведение
+// высоких степеней идёт через БПФ, корни ищутся методом Аберта — Эрлиха
+// одновременно для всех корней, параллельно по корням.
+
+/**
+ * @brief Схема вычисления значений многочлена.
+ */
+enum class PolyScheme {
+    Horner,  /**< Схема Горнера: count шагов подряд, наименьшая ошибка округления.*/
+    Estrin   /**< Схема Эстрина: дерево глубины log2(count), короче цепочка зависимостей; выгодна при
+                  немногих точках — при многих Горнер и так идёт независимыми цепочками по точкам.*/
+};
+
+/**
+ * @brief Способ умножения многочленов.
+ */
+enum class PolyMultiplyMethod {
+    Auto,    /**< Через БПФ, если оба множителя не короче kPolyFftThreshold, иначе прямо.*/
+    Direct,  /**< Прямая свёртка: na * nb умножений, ошибка — как у суммы произведений.*/
+    Fft      /**< Через БПФ длины 2^m >= na + nb - 1: O(N log N), ошибка — от наибольшего коэффициента.*/
+};
+
+/** С какой длины обоих множителей PolyMultiplyMethod::Auto выбирает БПФ (по замерам bench). */
+const size_t kPolyFftThreshold = 64;
+
+/**
+ * @brief Значение многочлена в одной точке (схема Горнера)
+ * @param c Коэффициенты, c[0] — свободный член
+ * @param count Число коэффициентов (0 — нулевой многочлен)
+ * @param z Точка
+ */
+Complex EvaluatePolynomial(const Complex* c, size_t count, const Complex& z) noexcept;
+
+/**
+ * @brief Значения многочлена в n точках
+ * @param c Коэффициенты, c[0] — свободный член
+ * @param count Число коэффициентов
+ * @param z Точки
+ * @param out Значения (может совпадать с z)
+ * @param n Число точек
+ * @param scheme Горнер или Эстрин
+ */
+void EvaluatePolynomial(const Complex* c, size_t count, const Complex* z, Complex* out, size_t n,
+                        PolyScheme scheme = PolyScheme::Horner);
+
+/**
+ * @brief Значения многочлена и его производной в n точках (схема Горнера)
+ * @param c Коэффициенты, c[0] — свободный член
+ * @param count Число коэффициентов
+ * @param z Точки
+ * @param out Значения p(z)
+ * @param derivative Значения p'(z)
+ * @param n Число точек
+ */
+void EvaluatePolynomial(const Complex* c, size_t count, const Complex* z, Complex* out, Complex* derivative,
+                        size_t n);
+
+/**
+ * @brief Произведение многочленов
+ * @param a Коэффициенты первого множителя
+ * @param na Их число
+ * @param b Коэффициенты второго множителя
+ * @param nb Их число
+ * @param method Прямо или через БПФ
+ * @return na + nb - 1 коэффициентов (пусто, если один из множителей пуст)
+ */
+vector<Complex> MultiplyPolynomials(const Complex* a, size_t na, const Complex* b, size_t nb,
+                                    PolyMultiplyMethod method = PolyMultiplyMethod::Auto);
+
+/**
+ * @brief Параметры поиска корней.
+ */
+struct RootOptions {
+    size_t maxIterations = 200;  /**< Наибольшее число проходов по всем корням.*/
+    double tolerance = 0;        /**< Порог обратной ошибки корня; 0 — 4 * n * eps (n — степень), уровень округления схемы Горнера.*/
+    size_t grain = 16;           /**< Корней в одной задаче пула.*/
+};
+
+/**
+ * @brief Корни многочлена и оценки их точности.
+ *
+ * Обратная ошибка корня z — |p(z)| / sum |c_k| |z|^k: на сколько (в
+ * относительной мере) надо изменить коэффициенты, чтобы z стал точным
+ * корнем. Круг радиуса errorBound с центром в z содержит корень p (оценка
+ * n |p(z) / p'(z)|, n — степень).
+ */
+struct RootResult {
+    vector<Complex> roots;          /**< Корни с учётом кратности (n штук).*/
+    vector<double> backwardError;   /**< Обратная ошибка каждого корня.*/
+    vector<double> errorBound;      /**< Радиус круга, содержащего корень.*/
+    vector<size_t> iterations;      /**< Сколько раз уточнялся каждый корень.*/
+    size_t sweeps;                  /**< Проходов по всем корням.*/
+    bool converged;                 /**< Все корни достигли порога обратной ошибки.*/
+    double maxBackwardError;        /**< Наибольшая обратная ошибка.*/
+    double maxErrorBound;           /**< Наибольший радиус.*/
+};
+
+/**
+ * @brief Все корни многочлена методом Аберта — Эрлиха
+ *
+ * Начальные приближения — на окружностях с радиусами из многоугольника
+ * Ньютона (выпуклой оболочки точек (k, log|c_k|)), поэтому и корни сильно
+ * различающихся модулей начинают с близких к ним окружностей. На каждом
+ * проходе все ещё не сошедшиеся корни уточняются по значениям предыдущего
+ * прохода (как в методе Якоби), куски по grain корней идут в пул: результат
+ * до бита не зависит от числа потоков. Корень перестаёт уточняться, когда
+ * его обратная ошибка не больше порога и после ещё одного шага, или когда
+ * поправка меньше ulp. Корни вне единичного круга считаются через
+ * перевёрнутый многочлен в точке 1/z, что избегает переполнения z^n. Нулевые младшие коэффициенты дают точные нули,
+ * нулевые старшие отбрасываются.
+ * @param c Коэффициенты, c[0] — свободный член
+ * @param count Число коэффициентов
+ * @param options Параметры
+ * @param pool Пул потоков
+ * @throws invalid_argument если все коэффициенты нулевые
+ */
+RootResult FindRoots(const Complex* c, size_t count, const RootOptions& options = RootOptions(),
+                     ThreadPool& pool = ThreadPool::Default());
+
+#endif // COMPLEX_POLYNOMIAL_H
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include "profile.h"
+
+using namespace std;
+
+namespace {
+
+const char* const kOpNames[kProfileOpCount] = {"add", "mul", "scale", "div", "abs", "read", "write"};
+
+/** Строка JSON или метка Prometheus в кавычках (экранируются \ " и перевод строки) */
+string Quote(const string& s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+void AppendCounter(string& out, const char* metric, const char* label, const string& value, uint64_t count) {
+    char number[32];
+    snprintf(number, sizeof(number), " %llu\n", (unsigned long long)count);
+    out += string(metric) + "{" + label + "=" + Quote(value) + "}" + number;
+}
+
+#ifdef COMPLEX_PROFILE
+
+/**
+ * @brief Все блоки потоков, имена замеров и точка отсчёта ResetProfile().
+ * Не разрушается: потоки могут завершаться и после выхода из main.
+ */
+struct ProfileRegistry {
+    mutex lock;
+    vector<unique_ptr<ProfileThreadCounters>> blocks;  /**< Все выданные блоки.*/
+    vector<ProfileThreadCounters*> released;           /**< Блоки завершившихся потоков.*/
+    vector<string> kernelNames;                        /**< Имена замеров по номерам.*/
+    uint64_t baseOps[kProfileOpCount] = {};            /**< Сумма операций на момент ResetProfile().*/
+    uint64_t baseKernels[kProfileMaxKernels][3] = {};  /**< То же для замеров: вызовы, элементы, такты.*/
+};
+
+ProfileRegistry& Registry() {
+    static ProfileRegistry* registry = new ProfileRegistry;
+    return *registry;
+}
+
+/** Возвращает блок в реестр при завершении потока */
+struct ProfileThreadHolder {
+    ProfileThreadCounters* counters = nullptr;
+
+    ~ProfileThreadHolder() {
+        if (counters) {
+            ProfileRegistry& registry = Registry();
+            lock_guard<mutex> guard(registry.lock);
+            registry.released.push_back(counters);
+        }
+    }
+};
+
+thread_local ProfileThreadHolder profileThreadHolder;
+
+/** Сумма всех блоков: операции и (вызовы, элементы, такты) замеров */
+void SumBlocks(ProfileRegistry& registry, uint64_t* ops, uint64_t (*kernels)[3]) {
+    for (const auto& block : registry.blocks) {
+        for (size_t i = 0; i < kProfileOpCount; ++i) {
+            ops[i] += block->ops[i].load(memory_order_relaxed);
+        }
+        for (size_t k = 0; k < registry.kernelNames.size(); ++k) {
+            kernels[k][0] += block->kernels[k].calls.load(memory_order_relaxed);
+            kernels[k][1] += block->kernels[k].items.load(memory_order_relaxed);
+            kernels[k][2] += block->kernels[k].cycles.load(memory_order_relaxed);
+        }
+    }
+}
+
+#endif // COMPLEX_PROFILE
+
+} // namespace
+
+#ifdef COMPLEX_PROFILE
+
+ProfileThreadCounters* AttachProfileThread() {
+    ProfileRegistry& registry = Registry();
+    lock_guard<mutex> guard(registry.lock);
+    ProfileThreadCounters* counters;
+    if (!registry.released.empty()) {
+        counters = registry.released.back();
+        registry.released.pop_back();
+    } else {
+        registry.blocks.emplace_back(new ProfileThreadCounters());
+        counters = registry.blocks.back().get();
+    }
+    profileThreadHolder.counters = counters;
+    profileThreadCounters = counters;
+    return counters;
+}
+
+size_t RegisterProfileKernel(const char* name) {
+    ProfileRegistry& registry = Registry();
+    lock_guard<mutex> guard(registry.lock);
+    vector<string>& names = registry.kernelNames;
+    auto it = find(names.begin(), names.end(), name);
+    if (it != names.end()) {
+        return size_t(it - names.begin());
+    }
+    if (names.size() + 1 == kProfileMaxKernels) {
+        names.push_back("other");
+    }
+    if (names.size() == kProfileMaxKernels) {
+        return kProfileMaxKernels - 1;
+    }
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+#endif // COMPLEX_PROFILE
+
+const char* ProfileOpName(ProfileOp op) {
+    return size_t(op) < kProfileOpCount ? kOpNames[size_t(op)] : "unknown";
+}
+
+bool ProfileEnabled() noexcept {
+#ifdef COMPLEX_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+ProfileSnapshot CollectProfile() {
+    ProfileSnapshot snapshot = {ProfileEnabled(), 0, {}, {}};
+#ifdef COMPLEX_PROFILE
+    ProfileRegistry& registry = Registry();
+    lock_guard<mutex> guard(registry.lock);
+    uint64_t kernels[kProfileMaxKernels][3] = {};
+    SumBlocks(registry, snapshot.ops, kernels);
+    snapshot.threads = registry.blocks.size();
+    for (size_t i = 0; i < kProfileOpCount; ++i) {
+        snapshot.ops[i] -= registry.baseOps[i];
+    }
+    for (size_t k = 0; k < registry.kernelNames.size(); ++k) {
+        ProfileKernelStats stats = {registry.kernelNames[k], kernels[k][0] - registry.baseKernels[k][0],
+                                    kernels[k][1] - registry.baseKernels[k][1],
+                                    kernels[k][2] - registry.baseKernels[k][2]};
+        if (stats.calls) {
+            snapshot.kernels.push_back(stats);
+        }
+    }
+    sort(snapshot.kernels.begin(), snapshot.kernels.end(),
+         [](const ProfileKernelStats& a, const ProfileKernelStats& b) { return a.cycles > b.cycles; });
+#endif
+    return snapshot;
+}
+
+void ResetProfile() {
+#ifdef COMPLEX_PROFILE
+    ProfileRegistry& registry = Registry();
+    lock_guard<mutex> guard(registry.lock);
+    fill(registry.baseOps, registry.baseOps + kProfileOpCount, 0);
+    for (auto& kernel : registry.baseKernels) {
+        fill(kernel, kernel + 3, 0);
+    }
+    SumBlocks(registry, registry.baseOps, registry.baseKernels);
+#endif
+}
+
+string ProfileToJson(const ProfileSnapshot& snapshot) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "{\"enabled\": %s, \"threads\": %zu, \"operations\": {",
+             snapshot.enabled ? "true" : "false", snapshot.threads);
+    string out = buffer;
+    for (size_t i = 0; i < kProfileOpCount; ++i) {
+        snprintf(buffer, sizeof(buffer), "%s\"%s\": %llu", i ? ", " : "", kOpNames[i],
+                 (unsigned long long)snapshot.ops[i]);
+        out += buffer;
+    }
+    out += "}, \"kernels\": [";
+    for (size_t k = 0; k < snapshot.kernels.size(); ++k) {
+        const ProfileKernelStats& s = snapshot.kernels[k];
+        snprintf(buffer, sizeof(buffer),
+                 ", \"calls\": %llu, \"items\": %llu, \"cycles\": %llu, \"cycles_per_item\": %.6g}",
+                 (unsigned long long)s.calls, (unsigned long long)s.items, (unsigned long long)s.cycles,
+                 s.items ? double(s.cycles) / double(s.items) : 0.0);
+        out += string(k ? ",\n  " : "\n  ") + "{\"name\": " + Quote(s.name) + buffer;
+    }
+    out += snapshot.kernels.empty() ? "]}\n" : "\n]}\n";
+    return out;
+}
+
+string ProfileToPrometheus(const ProfileSnapshot& snapshot) {
+    string out = "# HELP complex_operations_total Вызовы операций Complex по видам.\n"
+                 "# TYPE complex_operations_total counter\n";
+    for (size_t i = 0; i < kProfileOpCount; ++i) {
+        AppendCounter(out, "complex_operations_total", "op", kOpNames[i], snapshot.ops[i]);
+    }
+    struct Metric {
+        const char* name;
+        const char* help;
+        uint64_t ProfileKernelStats::*field;
+    };
+    const Metric metrics[] = {
+        {"complex_kernel_calls_total", "Вызовы пакетных функций.", &ProfileKernelStats::calls},
+        {"complex_kernel_items_total", "Элементы, обработанные пакетными функциями.", &ProfileKernelStats::items},
+        {"complex_kernel_tsc_cycles_total", "Такты TSC в пакетных функциях (с вложенными).",
+         &ProfileKernelStats::cycles},
+    };
+    for (const Metric& metric : metrics) {
+        out += string("# HELP ") + metric.name + " " + metric.help + "\n# TYPE " + metric.name + " counter\n";
+        for (const ProfileKernelStats& s : snapshot.kernels) {
+            AppendCounter(out, metric.name, "kernel", s.name, s.*metric.field);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,169 @@
+#ifndef COMPLEX_PROFILE_H
+#define COMPLEX_PROFILE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Необязательные счётчики горячих путей: сколько раз вызваны операции
+// Complex каждого вида и сколько тактов TSC заняли пакетные функции
+// (ComplexArray, complexbatch.h, БПФ, матрицы, фильтры, текстовый ввод-вывод).
+//
+// Включаются при сборке с -DCOMPLEX_PROFILE (make PROFILE=1); без него
+// макросы COMPLEX_PROFILE_OP и COMPLEX_PROFILE_KERNEL пусты и код
+// библиотеки такой же, как без этого файла. Счётчики у каждого потока свои
+// (пишет только владелец, без атомарных read-modify-write), а
+// CollectProfile() складывает их по запросу из любого потока.
+
+/**
+ * @brief Вид операции Complex для счётчиков.
+ */
+enum class ProfileOp {
+    Add,    /**< +, - и их составные формы (в том числе с вещественным числом).*/
+    Mul,    /**< Комплексное умножение (*, *=).*/
+    Scale,  /**< Умножение и деление на вещественное число.*/
+    Div,    /**< Комплексное деление и обратное число (все режимы).*/
+    Abs,    /**< Модуль и квадрат модуля.*/
+    Read,   /**< Число прочитано из потока или текста.*/
+    Write,  /**< Число записано в поток или текст.*/
+    Count   /**< Число видов.*/
+};
+
+/** Число видов операций. */
+const size_t kProfileOpCount = size_t(ProfileOp::Count);
+
+/** Наибольшее число замеряемых функций; остальные попадают в общую строку "other". */
+const size_t kProfileMaxKernels = 128;
+
+/**
+ * @brief Итоги по одной замеряемой функции.
+ */
+struct ProfileKernelStats {
+    string name;      /**< Имя замера (COMPLEX_PROFILE_KERNEL).*/
+    uint64_t calls;   /**< Число вызовов.*/
+    uint64_t items;   /**< Обработано элементов.*/
+    uint64_t cycles;  /**< Такты TSC (с вложенными замерами).*/
+};
+
+/**
+ * @brief Сумма счётчиков всех потоков на момент CollectProfile().
+ */
+struct ProfileSnapshot {
+    bool enabled;                        /**< Библиотека собрана с COMPLEX_PROFILE.*/
+    size_t threads;                      /**< Сколько потоков когда-либо считали.*/
+    uint64_t ops[kProfileOpCount];       /**< Вызовы операций по видам.*/
+    vector<ProfileKernelStats> kernels;  /**< Функции с хотя бы одним вызовом, по убыванию тактов.*/
+};
+
+/** Имя вида операции ("add", "mul", ...) */
+const char* ProfileOpName(ProfileOp op);
+
+/** true, если библиотека собрана с COMPLEX_PROFILE */
+bool ProfileEnabled() noexcept;
+
+/**
+ * @brief Складывает счётчики всех потоков (живых и завершившихся)
+ * за время с последнего ResetProfile(). Можно вызывать из любого потока.
+ */
+ProfileSnapshot CollectProfile();
+
+/** Начинает отсчёт заново (счётчики потоков не трогаются: запоминается их сумма) */
+void ResetProfile();
+
+/** Снимок в JSON: {"enabled", "threads", "operations": {...}, "kernels": [...]} */
+string ProfileToJson(const ProfileSnapshot& snapshot);
+
+/** Снимок в текстовом формате Prometheus (счётчики complex_operations_total, complex_kernel_*_total) */
+string ProfileToPrometheus(const ProfileSnapshot& snapshot);
+
+#ifdef COMPLEX_PROFILE
+
+/** Счётчики одной функции в блоке потока. */
+struct ProfileKernelCounters {
+    atomic<uint64_t> calls;
+    atomic<uint64_t> items;
+    atomic<uint64_t> cycles;
+};
+
+/**
+ * @brief Счётчики одного потока. Пишет только поток-владелец, читает
+ * CollectProfile(); после завершения потока блок достаётся следующему
+ * новому потоку и продолжает копиться.
+ */
+struct ProfileThreadCounters {
+    atomic<uint64_t> ops[kProfileOpCount];
+    ProfileKernelCounters kernels[kProfileMaxKernels];
+};
+
+/** Блок текущего потока (nullptr до первой операции) */
+inline thread_local ProfileThreadCounters* profileThreadCounters = nullptr;
+
+/** Выдаёт потоку блок счётчиков при первой операции */
+ProfileThreadCounters* AttachProfileThread();
+
+/** Номер замера по имени (один и тот же для одинаковых имён) */
+size_t RegisterProfileKernel(const char* name);
+
+inline ProfileThreadCounters& ProfileThread() noexcept {
+    ProfileThreadCounters* counters = profileThreadCounters;
+    return counters ? *counters : *AttachProfileThread();
+}
+
+/** Прибавляет к счётчику своего потока: обычные загрузка и запись, без lock-префикса */
+inline void ProfileBump(atomic<uint64_t>& counter, uint64_t n) noexcept {
+    counter.store(counter.load(memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+inline void ProfileCount(ProfileOp op) noexcept {
+    ProfileBump(ProfileThread().ops[size_t(op)], 1);
+}
+
+/**
+ * @brief Замер одного вызова функции: такты TSC от конструктора до деструктора.
+ */
+class ProfileTimer {
+private:
+    ProfileKernelCounters& counters_;  /**< Счётчики функции в блоке потока.*/
+    uint64_t items_;                   /**< Элементов в вызове.*/
+    uint64_t start_;                   /**< TSC в начале.*/
+
+public:
+    ProfileTimer(size_t kernel, uint64_t items) noexcept
+        : counters_(ProfileThread().kernels[kernel]), items_(items), start_(__builtin_ia32_rdtsc()) {}
+
+    ~ProfileTimer() {
+        uint64_t cycles = __builtin_ia32_rdtsc() - start_;
+        ProfileBump(counters_.calls, 1);
+        ProfileBump(counters_.items, items_);
+        ProfileBump(counters_.cycles, cycles);
+    }
+
+    ProfileTimer(const ProfileTimer&) = delete;
+    ProfileTimer& operator=(const ProfileTimer&) = delete;
+};
+
+// В constexpr-функциях Complex счётчик не трогается при вычислении на
+// этапе компиляции.
+#define COMPLEX_PROFILE_OP(op)                          \
+    do {                                                \
+        if (!__builtin_is_constant_evaluated()) {       \
+            ProfileCount(ProfileOp::op);                \
+        }                                               \
+    } while (0)
+
+#define COMPLEX_PROFILE_KERNEL(name, items)                                     \
+    static const size_t profileKernel_ = RegisterProfileKernel(name);           \
+    ProfileTimer profileTimer_(profileKernel_, uint64_t(items))
+
+#else
+
+#define COMPLEX_PROFILE_OP(op) ((void)0)
+#define COMPLEX_PROFILE_KERNEL(name, items) ((void)0)
+
+#endif // COMPLEX_PROFILE
+
+#endif // COMPLEX_PROFILE_H
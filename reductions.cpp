@@ -0,0 +1,224 @@
+#include "reductions.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "allocator.h"
+#include "profile.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+/** Блоков в одной задаче пула (kParallelGrain элементов) */
+const size_t kBlocksPerTask = 4;
+
+const double* AsDoubles(const Complex* src) {
+    return reinterpret_cast<const double*>(src);
+}
+
+/** Итог блока: сумма и накопленная ошибка (в быстром режиме нулевая) */
+struct SumPartial {
+    double re, im, reErr, imErr;
+};
+
+struct SquarePartial {
+    double sum, err;
+};
+
+struct ExtremumPartial {
+    double value;  /**< |z|^2.*/
+    double index;  /**< -1 — сравнимых элементов нет.*/
+};
+
+// Сумма без потерь (TwoSum Кнута): s + e == a + b точно.
+void TwoSum(double a, double b, double& s, double& e) {
+    s = a + b;
+    double bv = s - a;
+    e = (a - (s - bv)) + (b - bv);
+}
+
+/** Складывает итоги [0, count) деревом: половины, пока не останется один */
+template <class Partial, class Combine>
+Partial Pairwise(const Partial* partials, size_t count, const Combine& combine) {
+    if (count == 1) {
+        return partials[0];
+    }
+    size_t half = count / 2;
+    return combine(Pairwise(partials, half, combine), Pairwise(partials + half, count - half, combine));
+}
+
+/**
+ * @brief Сводит блоки [k * kReductionBlock, ...) функцией block(lo, hi)
+ * (на пуле, если он задан) и складывает итоги деревом. Итоги лежат в арене
+ * вызывающего потока, каждый блок пишет только свой.
+ */
+template <class Partial, class Block, class Combine>
+Partial Reduce(size_t n, ThreadPool* pool, const Block& block, const Combine& combine) {
+    size_t blocks = (n + kReductionBlock - 1) / kReductionBlock;
+    if (blocks <= 1) {
+        return block(0, n);
+    }
+    ArenaFrame frame;
+    Partial* partials = frame.Allocate<Partial>(blocks);
+    auto run = [&](size_t lo, size_t hi) {
+        for (size_t b = lo; b < hi; ++b) {
+            partials[b] = block(b * kReductionBlock, min(n, (b + 1) * kReductionBlock));
+        }
+    };
+    if (pool) {
+        pool->ParallelFor(0, blocks, kBlocksPerTask, run);
+    } else {
+        run(0, blocks);
+    }
+    return Pairwise(partials, blocks, combine);
+}
+
+Complex SumImpl(const Complex* x, size_t n, SumMode mode, ThreadPool* pool) {
+    COMPLEX_PROFILE_KERNEL("reduce.sum", n);
+    bool compensated = mode == SumMode::Compensated;
+    auto kernel = ActiveKernels().sumInterleaved;
+    SumPartial total = Reduce<SumPartial>(
+        n, pool,
+        [=](size_t lo, size_t hi) {
+            double out[4];
+            kernel(AsDoubles(x + lo), hi - lo, compensated, out);
+            return SumPartial{out[0], out[1], out[2], out[3]};
+        },
+        [=](const SumPartial& a, const SumPartial& b) {
+            if (!compensated) {
+                return SumPartial{a.re + b.re, a.im + b.im, 0, 0};
+            }
+            SumPartial r;
+            double e;
+            TwoSum(a.re, b.re, r.re, e);
+            r.reErr = a.reErr + b.reErr + e;
+            TwoSum(a.im, b.im, r.im, e);
+            r.imErr = a.imErr + b.imErr + e;
+            return r;
+        });
+    return Complex(total.re + total.reErr, total.im + total.imErr);
+}
+
+/** Сумма |x[i] - center|^2 */
+double SquaredDeviationImpl(const Complex* x, size_t n, const Complex& center, SumMode mode, ThreadPool* pool) {
+    bool compensated = mode == SumMode::Compensated;
+    auto kernel = ActiveKernels().sumSquaredDeviationInterleaved;
+    double cr = center.Re(), ci = center.Im();
+    SquarePartial total = Reduce<SquarePartial>(
+        n, pool,
+        [=](size_t lo, size_t hi) {
+            double out[2];
+            kernel(AsDoubles(x + lo), hi - lo, cr, ci, compensated, out);
+            return SquarePartial{out[0], out[1]};
+        },
+        [=](const SquarePartial& a, const SquarePartial& b) {
+            if (!compensated) {
+                return SquarePartial{a.sum + b.sum, 0};
+            }
+            SquarePartial r;
+            double e;
+            TwoSum(a.sum, b.sum, r.sum, e);
+            r.err = a.err + b.err + e;
+            return r;
+        });
+    return total.sum + total.err;
+}
+
+Complex MeanImpl(const Complex* x, size_t n, SumMode mode, ThreadPool* pool) {
+    if (n == 0) {
+        throw invalid_argument("Mean: пустой массив");
+    }
+    return SumImpl(x, n, mode, pool) / double(n);
+}
+
+double SumAbsSquaredImpl(const Complex* x, size_t n, SumMode mode, ThreadPool* pool) {
+    COMPLEX_PROFILE_KERNEL("reduce.sum_abs_squared", n);
+    return SquaredDeviationImpl(x, n, Complex(), mode, pool);
+}
+
+double VarianceImpl(const Complex* x, size_t n, SumMode mode, ThreadPool* pool) {
+    if (n == 0) {
+        throw invalid_argument("Variance: пустой массив");
+    }
+    Complex mean = SumImpl(x, n, mode, pool) / double(n);
+    COMPLEX_PROFILE_KERNEL("reduce.variance", n);
+    return SquaredDeviationImpl(x, n, mean, mode, pool) / double(n);
+}
+
+// Левое поддерево дерева — меньшие индексы, поэтому при равенстве остаётся a.
+MagnitudeExtremum ExtremumImpl(const Complex* x, size_t n, bool maximum, ThreadPool* pool) {
+    COMPLEX_PROFILE_KERNEL("reduce.extremum", n);
+    auto kernel = ActiveKernels().absSquaredExtremumInterleaved;
+    ExtremumPartial best = Reduce<ExtremumPartial>(
+        n, pool,
+        [=](size_t lo, size_t hi) {
+            double out[2];
+            kernel(AsDoubles(x + lo), hi - lo, maximum, out);
+            return ExtremumPartial{out[0], out[1] < 0 ? -1.0 : out[1] + double(lo)};
+        },
+        [=](const ExtremumPartial& a, const ExtremumPartial& b) {
+            if (b.index < 0) {
+                return a;
+            }
+            if (a.index < 0) {
+                return b;
+            }
+            return (maximum ? b.value > a.value : b.value < a.value) ? b : a;
+        });
+    if (best.index < 0) {
+        return MagnitudeExtremum{n, NAN};
+    }
+    size_t index = size_t(best.index);
+    return MagnitudeExtremum{index, x[index].Abs()};
+}
+
+} // namespace
+
+Complex Sum(const Complex* x, size_t n, SumMode mode) {
+    return SumImpl(x, n, mode, nullptr);
+}
+
+Complex Mean(const Complex* x, size_t n, SumMode mode) {
+    return MeanImpl(x, n, mode, nullptr);
+}
+
+double SumAbsSquared(const Complex* x, size_t n, SumMode mode) {
+    return SumAbsSquaredImpl(x, n, mode, nullptr);
+}
+
+double Variance(const Complex* x, size_t n, SumMode mode) {
+    return VarianceImpl(x, n, mode, nullptr);
+}
+
+MagnitudeExtremum MaxMagnitude(const Complex* x, size_t n) {
+    return ExtremumImpl(x, n, true, nullptr);
+}
+
+MagnitudeExtremum MinMagnitude(const Complex* x, size_t n) {
+    return ExtremumImpl(x, n, false, nullptr);
+}
+
+Complex Sum(const Complex* x, size_t n, SumMode mode, ThreadPool& pool) {
+    return SumImpl(x, n, mode, &pool);
+}
+
+Complex Mean(const Complex* x, size_t n, SumMode mode, ThreadPool& pool) {
+    return MeanImpl(x, n, mode, &pool);
+}
+
+double SumAbsSquared(const Complex* x, size_t n, SumMode mode, ThreadPool& pool) {
+    return SumAbsSquaredImpl(x, n, mode, &pool);
+}
+
+double Variance(const Complex* x, size_t n, SumMode mode, ThreadPool& pool) {
+    return VarianceImpl(x, n, mode, &pool);
+}
+
+MagnitudeExtremum MaxMagnitude(const Complex* x, size_t n, ThreadPool& pool) {
+    return ExtremumImpl(x, n, true, &pool);
+}
+
+MagnitudeExtremum MinMagnitude(const Complex* x, size_t n, ThreadPool& pool) {
+    return ExtremumImpl(x, n, false, &pool);
+}
@@ -0,0 +1,87 @@
+#ifndef COMPLEX_REDUCTIONS_H
+#define COMPLEX_REDUCTIONS_H
+
+#include <cstddef>
+#include "complexbatch.h"
+#include "mycomplex.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// Редукции массивов Complex: сумма, среднее, энергия (сумма |z|^2),
+// дисперсия и элементы наибольшего и наименьшего модуля.
+//
+// Массив делится на блоки по kReductionBlock элементов. Блок сводится
+// векторным ядром (SimdKernels::sumInterleaved и соседние) в нескольких
+// аккумуляторах, итоги блоков складываются попарным деревом. Границы блоков
+// и форма дерева зависят только от n, поэтому однопоточная версия и версия
+// с пулом дают один и тот же результат бит в бит при любом числе потоков;
+// от набора инструкций результат зависит (ширина регистров, FMA).
+//
+// SumMode::Fast — попарное суммирование блоками: ошибка растёт как
+// (kReductionBlock / ширина регистра + log2(n / kReductionBlock)) ulp, а не
+// как n ulp у цикла operator+=. SumMode::Compensated — TwoSum внутри блоков
+// и при сложении блоков: результат как посчитанный с удвоенной точностью и
+// округлённый в конце.
+
+/** Длина блока редукции (64 КБ чередующихся пар) */
+const size_t kReductionBlock = 4096;
+
+/**
+ * @brief Элемент наибольшего или наименьшего модуля.
+ */
+struct MagnitudeExtremum {
+    size_t index;      /**< Первый такой элемент; n, если массив пуст или весь из NaN.*/
+    double magnitude;  /**< Его модуль (Complex::Abs, один корень на весь поиск); NaN, если index == n.*/
+};
+
+/**
+ * @brief Сумма элементов
+ * @param x Массив
+ * @param n Число элементов (0 — нулевая сумма)
+ * @param mode Попарная или компенсированная
+ */
+Complex Sum(const Complex* x, size_t n, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Среднее: Sum(x, n, mode) / n
+ * @throws invalid_argument при n == 0
+ */
+Complex Mean(const Complex* x, size_t n, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Энергия: сумма |x[i]|^2
+ */
+double SumAbsSquared(const Complex* x, size_t n, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Дисперсия по всей совокупности: сумма |x[i] - mean|^2 / n в два
+ * прохода (сначала среднее), без потери точности на большом среднем.
+ * Несмещённая оценка — умножить на n / (n - 1).
+ * @throws invalid_argument при n == 0
+ */
+double Variance(const Complex* x, size_t n, SumMode mode = SumMode::Fast);
+
+/**
+ * @brief Элемент наибольшего модуля. Сравниваются |z|^2 без корня, поэтому
+ * при |z| > 2^511 (|z|^2 — бесконечность) выбирается первый из таких.
+ * NaN пропускаются.
+ */
+MagnitudeExtremum MaxMagnitude(const Complex* x, size_t n);
+
+/**
+ * @brief Элемент наименьшего модуля (сравнение — как у MaxMagnitude)
+ */
+MagnitudeExtremum MinMagnitude(const Complex* x, size_t n);
+
+// Те же редукции на пуле потоков: блоки сводятся параллельно, результат
+// совпадает с однопоточным бит в бит.
+
+Complex Sum(const Complex* x, size_t n, SumMode mode, ThreadPool& pool);
+Complex Mean(const Complex* x, size_t n, SumMode mode, ThreadPool& pool);
+double SumAbsSquared(const Complex* x, size_t n, SumMode mode, ThreadPool& pool);
+double Variance(const Complex* x, size_t n, SumMode mode, ThreadPool& pool);
+MagnitudeExtremum MaxMagnitude(const Complex* x, size_t n, ThreadPool& pool);
+MagnitudeExtremum MinMagnitude(const Complex* x, size_t n, ThreadPool& pool);
+
+#endif // COMPLEX_REDUCTIONS_H
@@ -0,0 +1,279 @@
+#include "ringbuffer.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p *= 2;
+    }
+    return p;
+}
+
+} // namespace
+
+void RingSignal::CpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+void RingSignal::YieldThread() noexcept {
+    this_thread::yield();
+}
+
+/**
+ * @brief Спит, пока номер события равен seen (или до ложного пробуждения)
+ */
+void RingSignal::Sleep(uint32_t seen) noexcept {
+#ifdef __linux__
+    // atomic<uint32_t> без блокировок имеет размер и представление uint32_t.
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence_), FUTEX_WAIT_PRIVATE, seen, nullptr, nullptr, 0);
+#else
+    (void)seen;
+    this_thread::yield();
+#endif
+}
+
+void RingSignal::WakeAll() noexcept {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+SpscRing::SpscRing(size_t capacity, WaitPolicy policy)
+    : data_(nullptr), capacity_(RoundUpToPowerOfTwo(capacity)), policy_(policy), tail_(0), headCache_(0), head_(0),
+      tailCache_(0), closed_(false) {
+    if (capacity == 0) {
+        throw invalid_argument("SpscRing: ёмкость должна быть больше 0");
+    }
+    data_ = static_cast<Complex*>(AllocateAligned(capacity_ * sizeof(Complex), kCacheLineAlignment));
+}
+
+SpscRing::~SpscRing() {
+    FreeAligned(data_, kCacheLineAlignment);
+}
+
+/**
+ * @brief Свободное место по кэшу head_; свежий head_ читается, только если
+ * по кэшу места не хватает.
+ */
+SpscRing::Region SpscRing::TryClaimWrite(size_t maximum) noexcept {
+    uint64_t tail = tail_.load(memory_order_relaxed);
+    if (tail - headCache_ == capacity_) {
+        headCache_ = head_.load(memory_order_acquire);
+    }
+    size_t offset = size_t(tail & (capacity_ - 1));
+    size_t count = min(min(maximum, size_t(capacity_ - (tail - headCache_))), capacity_ - offset);
+    return Region{data_ + offset, count};
+}
+
+SpscRing::Region SpscRing::ClaimWrite(size_t maximum) {
+    Region region = TryClaimWrite(maximum);
+    if (region.count == 0 && maximum > 0 && !Closed()) {
+        writable_.Wait([&] {
+            region = TryClaimWrite(maximum);
+            return region.count > 0 || Closed();
+        }, policy_);
+    }
+    return Closed() ? Region{nullptr, 0} : region;
+}
+
+void SpscRing::CommitWrite(size_t count) noexcept {
+    if (count > 0) {
+        tail_.store(tail_.load(memory_order_relaxed) + count, memory_order_release);
+        if (policy_ == WaitPolicy::Futex) {
+            readable_.Notify();
+        }
+    }
+}
+
+SpscRing::Region SpscRing::TryClaimRead(size_t maximum) noexcept {
+    uint64_t head = head_.load(memory_order_relaxed);
+    if (tailCache_ == head) {
+        tailCache_ = tail_.load(memory_order_acquire);
+    }
+    size_t offset = size_t(head & (capacity_ - 1));
+    size_t count = min(min(maximum, size_t(tailCache_ - head)), capacity_ - offset);
+    return Region{data_ + offset, count};
+}
+
+SpscRing::Region SpscRing::ClaimRead(size_t maximum) {
+    Region region = TryClaimRead(maximum);
+    if (region.count == 0 && maximum > 0) {
+        readable_.Wait([&] {
+            // Закрытие проверяется до повторного чтения: данные, опубликованные
+            // до Close(), не теряются.
+            bool closed = Closed();
+            region = TryClaimRead(maximum);
+            return region.count > 0 || closed;
+        }, policy_);
+    }
+    return region;
+}
+
+void SpscRing::CommitRead(size_t count) noexcept {
+    if (count > 0) {
+        head_.store(head_.load(memory_order_relaxed) + count, memory_order_release);
+        if (policy_ == WaitPolicy::Futex) {
+            writable_.Notify();
+        }
+    }
+}
+
+size_t SpscRing::Write(const Complex* src, size_t n) {
+    size_t done = 0;
+    while (done < n) {
+        Region region = ClaimWrite(n - done);
+        if (region.count == 0) {
+            break;
+        }
+        copy(src + done, src + done + region.count, region.data);
+        CommitWrite(region.count);
+        done += region.count;
+    }
+    return done;
+}
+
+size_t SpscRing::Read(Complex* dst, size_t n) {
+    size_t done = 0;
+    while (done < n) {
+        Region region = ClaimRead(n - done);
+        if (region.count == 0) {
+            break;
+        }
+        copy(region.data, region.data + region.count, dst + done);
+        CommitRead(region.count);
+        done += region.count;
+    }
+    return done;
+}
+
+void SpscRing::Close() noexcept {
+    closed_.store(true, memory_order_release);
+    // Будятся всегда: при WaitPolicy::Spin Notify() дешёв и никого не ждёт.
+    readable_.Notify();
+    writable_.Notify();
+}
+
+MpmcBlockRing::MpmcBlockRing(size_t slots, size_t blockSize, WaitPolicy policy)
+    : data_(nullptr), slots_(RoundUpToPowerOfTwo(max(slots, size_t(2)))), blockSize_(blockSize),
+      stride_((blockSize * sizeof(Complex) + kCacheLineAlignment - 1) / kCacheLineAlignment * kCacheLineAlignment /
+              sizeof(Complex)),
+      policy_(policy), writePos_(0), readPos_(0), closed_(false) {
+    if (slots == 0 || blockSize == 0) {
+        throw invalid_argument("MpmcBlockRing: нужны хотя бы один блок и ненулевая длина блока");
+    }
+    cells_.reset(new Cell[slots_]);
+    for (size_t i = 0; i < slots_; ++i) {
+        cells_[i].sequence.store(i, memory_order_relaxed);
+        cells_[i].count = 0;
+    }
+    data_ = static_cast<Complex*>(AllocateAligned(slots_ * stride_ * sizeof(Complex), kCacheLineAlignment));
+}
+
+MpmcBlockRing::~MpmcBlockRing() {
+    FreeAligned(data_, kCacheLineAlignment);
+}
+
+/**
+ * @brief Ячейка writePos_ свободна, если её поколение равно позиции;
+ * позиция занимается CAS, проигравший берёт следующую.
+ */
+bool MpmcBlockRing::TryClaimWrite(Block& block) noexcept {
+    if (closed_.load(memory_order_acquire)) {
+        return false;
+    }
+    uint64_t pos = writePos_.load(memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[pos & (slots_ - 1)];
+        int64_t diff = int64_t(cell.sequence.load(memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (writePos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                block = Block{data_ + (pos & (slots_ - 1)) * stride_, blockSize_, pos};
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = writePos_.load(memory_order_relaxed);
+        }
+    }
+}
+
+MpmcBlockRing::Block MpmcBlockRing::ClaimWrite() {
+    Block block{nullptr, 0, 0};
+    if (!TryClaimWrite(block)) {
+        writable_.Wait([&] { return TryClaimWrite(block) || closed_.load(memory_order_acquire); }, policy_);
+    }
+    return block;
+}
+
+void MpmcBlockRing::CommitWrite(const Block& block, size_t count) noexcept {
+    Cell& cell = cells_[block.ticket & (slots_ - 1)];
+    cell.count = min(count, blockSize_);
+    cell.sequence.store(block.ticket + 1, memory_order_release);
+    if (policy_ == WaitPolicy::Futex) {
+        readable_.Notify();
+    }
+}
+
+/**
+ * @brief Ячейка readPos_ готова, если её поколение равно позиции + 1.
+ */
+bool MpmcBlockRing::TryClaimRead(Block& block) noexcept {
+    uint64_t pos = readPos_.load(memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[pos & (slots_ - 1)];
+        int64_t diff = int64_t(cell.sequence.load(memory_order_acquire) - (pos + 1));
+        if (diff == 0) {
+            if (readPos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                block = Block{data_ + (pos & (slots_ - 1)) * stride_, cell.count, pos};
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = readPos_.load(memory_order_relaxed);
+        }
+    }
+}
+
+MpmcBlockRing::Block MpmcBlockRing::ClaimRead() {
+    Block block{nullptr, 0, 0};
+    if (!TryClaimRead(block)) {
+        readable_.Wait([&] {
+            bool closed = closed_.load(memory_order_acquire);
+            return TryClaimRead(block) || closed;
+        }, policy_);
+    }
+    return block;
+}
+
+void MpmcBlockRing::CommitRead(const Block& block) noexcept {
+    cells_[block.ticket & (slots_ - 1)].sequence.store(block.ticket + slots_, memory_order_release);
+    if (policy_ == WaitPolicy::Futex) {
+        writable_.Notify();
+    }
+}
+
+void MpmcBlockRing::Close() noexcept {
+    closed_.store(true, memory_order_release);
+    readable_.Notify();
+    writable_.Notify();
+}
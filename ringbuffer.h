@@ -0,0 +1,289 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "allocator.h"
+#include "mycomplex.h"
+
+using namespace std;
+
+// Кольца без блокировок для передачи отсчётов Complex между потоками.
+//
+// SpscRing — один писатель и один читатель, кольцо отсчётов: писатель
+// получает непрерывный участок свободного места, заполняет его на месте и
+// публикует, читатель так же читает на месте и освобождает. MpmcBlockRing —
+// любое число писателей и читателей, кольцо блоков фиксированной длины
+// (очередь Вьюкова: у каждой ячейки свой номер поколения). Счётчики
+// писателя и читателя лежат в разных строках кэша, поэтому потоки не
+// делят строки, пока кольцо не пустое и не полное.
+
+/**
+ * @brief Как ждать, когда кольцо пустое (читатель) или полное (писатель).
+ */
+enum class WaitPolicy {
+    Spin,   /**< Активное ожидание с pause; раз в kYieldInterval попыток — yield. Наименьшая задержка, ядро занято.*/
+    Futex   /**< Короткое активное ожидание, затем сон на futex (Linux); в других ОС — yield. Ядро свободно.*/
+};
+
+/**
+ * @brief Точка ожидания кольца: счётчик событий и число спящих потоков.
+ *
+ * Notify() увеличивает счётчик и будит спящих только если они есть, так что
+ * без ожидающих публикация стоит одну атомарную операцию без системного
+ * вызова. Занимает свою строку кэша.
+ */
+class alignas(kCacheLineAlignment) RingSignal {
+public:
+    /** Попыток активного ожидания перед сном (WaitPolicy::Futex). */
+    static const unsigned kSpinCount = 256;
+    /** Через сколько попыток активное ожидание уступает ядро (WaitPolicy::Spin). */
+    static const unsigned kYieldInterval = 1024;
+
+private:
+    atomic<uint32_t> sequence_;  /**< Номер события.*/
+    atomic<uint32_t> sleepers_;  /**< Сколько потоков спит или готовится уснуть.*/
+
+    void Sleep(uint32_t seen) noexcept;
+    void WakeAll() noexcept;
+
+public:
+    RingSignal() noexcept : sequence_(0), sleepers_(0) {}
+
+    /**
+    * @brief Ждёт, пока ready() не станет true
+    * @param ready Условие (проверяется повторно после каждого пробуждения);
+    *              может захватывать ресурс: после true больше не вызывается
+    * @param policy Способ ожидания
+    */
+    template <class Ready>
+    void Wait(const Ready& ready, WaitPolicy policy) {
+        for (unsigned spin = 1; !ready(); ++spin) {
+            if (policy == WaitPolicy::Spin || spin < kSpinCount) {
+                if (spin % kYieldInterval == 0) {
+                    YieldThread();
+                } else {
+                    CpuRelax();
+                }
+                continue;
+            }
+            // Сначала объявить о сне, потом запомнить номер и перепроверить:
+            // публикация после этого либо сменит номер, либо увидит спящего.
+            sleepers_.fetch_add(1);
+            uint32_t seen = sequence_.load();
+            bool done = ready();
+            if (!done) {
+                Sleep(seen);
+            }
+            sleepers_.fetch_sub(1);
+            if (done) {
+                return;
+            }
+        }
+    }
+
+    /** Сообщает о событии (после публикации данных) */
+    void Notify() noexcept {
+        sequence_.fetch_add(1);
+        if (sleepers_.load() != 0) {
+            WakeAll();
+        }
+    }
+
+    /** Подсказка процессору в цикле активного ожидания (pause) */
+    static void CpuRelax() noexcept;
+    /** Уступает ядро другим потокам */
+    static void YieldThread() noexcept;
+};
+
+/**
+ * @brief Кольцо отсчётов для одного писателя и одного читателя.
+ *
+ *     SpscRing ring(1 << 16);
+ *     // писатель                                  // читатель
+ *     SpscRing::Region w = ring.ClaimWrite(4096);  SpscRing::Region r = ring.ClaimRead(4096);
+ *     Fill(w.data, w.count);                       Use(r.data, r.count);
+ *     ring.CommitWrite(w.count);                   ring.CommitRead(r.count);
+ *
+ * Участок всегда непрерывен, поэтому у конца буфера он короче запрошенного;
+ * если блоки всегда одной длины и ёмкость кратна ей, участки не делятся.
+ * Методы писателя вызываются только из одного потока, методы читателя —
+ * только из одного (возможно, другого).
+ */
+class SpscRing {
+public:
+    /** Непрерывный участок кольца; count == 0 — места (данных) нет или кольцо закрыто. */
+    struct Region {
+        Complex* data;  /**< Начало участка.*/
+        size_t count;   /**< Длина участка в отсчётах.*/
+    };
+
+private:
+    Complex* data_;      /**< Буфер (выровнен на строку кэша).*/
+    size_t capacity_;    /**< Ёмкость, степень двойки.*/
+    WaitPolicy policy_;  /**< Способ ожидания.*/
+
+    alignas(kCacheLineAlignment) atomic<uint64_t> tail_;  /**< Опубликовано отсчётов (пишет писатель).*/
+    uint64_t headCache_;                                  /**< Последний прочитанный писателем head_.*/
+    alignas(kCacheLineAlignment) atomic<uint64_t> head_;  /**< Освобождено отсчётов (пишет читатель).*/
+    uint64_t tailCache_;                                  /**< Последний прочитанный читателем tail_.*/
+    alignas(kCacheLineAlignment) atomic<bool> closed_;    /**< Писатель закрыл кольцо.*/
+    RingSignal readable_;                                 /**< Появились данные или кольцо закрыто.*/
+    RingSignal writable_;                                 /**< Появилось место.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param capacity Ёмкость в отсчётах (округляется вверх до степени двойки, не 0)
+    * @param policy Способ ожидания
+    * @throws invalid_argument при capacity == 0
+    */
+    explicit SpscRing(size_t capacity, WaitPolicy policy = WaitPolicy::Futex);
+
+    ~SpscRing();
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+    * @brief Свободный участок без ожидания (писатель)
+    * @param maximum Наибольшая нужная длина
+    */
+    Region TryClaimWrite(size_t maximum) noexcept;
+
+    /**
+    * @brief Свободный участок; ждёт, пока освободится хотя бы один отсчёт
+    * @param maximum Наибольшая нужная длина (не 0)
+    * @return Участок; count == 0 — кольцо закрыто
+    */
+    Region ClaimWrite(size_t maximum);
+
+    /**
+    * @brief Публикует count первых отсчётов последнего участка ClaimWrite
+    */
+    void CommitWrite(size_t count) noexcept;
+
+    /**
+    * @brief Участок данных без ожидания (читатель)
+    * @param maximum Наибольшая нужная длина
+    */
+    Region TryClaimRead(size_t maximum) noexcept;
+
+    /**
+    * @brief Участок данных; ждёт, пока появится хотя бы один отсчёт
+    * @param maximum Наибольшая нужная длина (не 0)
+    * @return Участок; count == 0 — кольцо закрыто и пусто
+    */
+    Region ClaimRead(size_t maximum);
+
+    /**
+    * @brief Освобождает count первых отсчётов последнего участка ClaimRead
+    */
+    void CommitRead(size_t count) noexcept;
+
+    /**
+    * @brief Копирует n отсчётов в кольцо, ожидая места (писатель)
+    * @return Сколько записано (меньше n, только если кольцо закрыто)
+    */
+    size_t Write(const Complex* src, size_t n);
+
+    /**
+    * @brief Копирует до n отсчётов из кольца, ожидая данных (читатель)
+    * @return Сколько прочитано (меньше n, только если кольцо закрыто и опустело)
+    */
+    size_t Read(Complex* dst, size_t n);
+
+    /** Закрывает кольцо: читатель дочитывает данные, ClaimWrite больше не ждёт */
+    void Close() noexcept;
+
+    bool Closed() const noexcept { return closed_.load(memory_order_acquire); }
+    size_t Capacity() const noexcept { return capacity_; }
+    /** Отсчётов в кольце (приблизительно, если потоки работают) */
+    size_t Size() const noexcept { return size_t(tail_.load(memory_order_acquire) - head_.load(memory_order_acquire)); }
+};
+
+/**
+ * @brief Кольцо блоков фиксированной длины для нескольких писателей и
+ * нескольких читателей.
+ *
+ * Писатель захватывает свободный блок, заполняет его на месте и
+ * публикует с фактической длиной; читатель захватывает опубликованный
+ * блок, читает на месте и освобождает. Блоки выдаются читателям в порядке
+ * захвата писателями; неопубликованный блок задерживает следующие за ним.
+ * Close() вызывается, когда все писатели опубликовали свои блоки.
+ */
+class MpmcBlockRing {
+public:
+    /** Захваченный блок; data == nullptr — блока нет (кольцо закрыто). */
+    struct Block {
+        Complex* data;    /**< Отсчёты блока.*/
+        size_t count;     /**< Ёмкость (у писателя) или длина данных (у читателя).*/
+        uint64_t ticket;  /**< Номер блока в потоке (для Commit).*/
+    };
+
+private:
+    struct alignas(kCacheLineAlignment) Cell {
+        atomic<uint64_t> sequence;  /**< Поколение: ticket — свободна, ticket + 1 — опубликована.*/
+        size_t count;               /**< Длина опубликованных данных.*/
+    };
+
+    unique_ptr<Cell[]> cells_;  /**< Ячейки блоков.*/
+    Complex* data_;             /**< Блоки подряд, каждый выровнен на строку кэша.*/
+    size_t slots_;              /**< Число блоков, степень двойки.*/
+    size_t blockSize_;          /**< Ёмкость блока в отсчётах.*/
+    size_t stride_;             /**< Шаг между блоками в отсчётах.*/
+    WaitPolicy policy_;         /**< Способ ожидания.*/
+
+    alignas(kCacheLineAlignment) atomic<uint64_t> writePos_;  /**< Следующий блок для писателя.*/
+    alignas(kCacheLineAlignment) atomic<uint64_t> readPos_;   /**< Следующий блок для читателя.*/
+    alignas(kCacheLineAlignment) atomic<bool> closed_;        /**< Кольцо закрыто.*/
+    RingSignal readable_;                                     /**< Опубликован блок или кольцо закрыто.*/
+    RingSignal writable_;                                     /**< Освобождён блок.*/
+
+public:
+    /**
+    * @brief Конструктор
+    * @param slots Число блоков (округляется вверх до степени двойки, не меньше 2)
+    * @param blockSize Ёмкость блока в отсчётах (не 0)
+    * @param policy Способ ожидания
+    * @throws invalid_argument при slots == 0 или blockSize == 0
+    */
+    MpmcBlockRing(size_t slots, size_t blockSize, WaitPolicy policy = WaitPolicy::Futex);
+
+    ~MpmcBlockRing();
+
+    MpmcBlockRing(const MpmcBlockRing&) = delete;
+    MpmcBlockRing& operator=(const MpmcBlockRing&) = delete;
+
+    /** Захватывает свободный блок без ожидания; false — кольцо полное или закрыто */
+    bool TryClaimWrite(Block& block) noexcept;
+
+    /** Захватывает свободный блок, ожидая его; data == nullptr — кольцо закрыто */
+    Block ClaimWrite();
+
+    /**
+    * @brief Публикует блок из ClaimWrite
+    * @param block Блок
+    * @param count Сколько отсчётов записано (не больше BlockSize())
+    */
+    void CommitWrite(const Block& block, size_t count) noexcept;
+
+    /** Захватывает опубликованный блок без ожидания; false — готового блока нет */
+    bool TryClaimRead(Block& block) noexcept;
+
+    /** Захватывает опубликованный блок, ожидая его; data == nullptr — кольцо закрыто и пусто */
+    Block ClaimRead();
+
+    /** Освобождает блок из ClaimRead */
+    void CommitRead(const Block& block) noexcept;
+
+    /** Закрывает кольцо (после последней публикации) */
+    void Close() noexcept;
+
+    size_t Slots() const noexcept { return slots_; }
+    size_t BlockSize() const noexcept { return blockSize_; }
+};
+
+#endif // RING_BUFFER_H
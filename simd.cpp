@@ -0,0 +1,113 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+/** Таблица ActiveKernels(); nullptr — ещё не выбрана. */
+atomic<const SimdKernels*> activeKernels(nullptr);
+
+const SimdLevel kSimdLevels[] = {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512};
+
+/**
+ * @brief Уровень при первом обращении: CPUID, понижаемый переменной окружения.
+ */
+SimdLevel StartupSimdLevel() {
+    SimdLevel detected = DetectSimdLevel();
+    SimdLevel requested;
+    const char* value = getenv(kSimdEnvironmentVariable);
+    if (value && ParseSimdLevel(value, requested) && int(requested) < int(detected)) {
+        return requested;
+    }
+    return detected;
+}
+
+} // namespace
+
+/**
+ * @brief Определяет лучший уровень инструкций, поддерживаемый процессором (CPUID).
+ * CPUID опрашивается один раз.
+ * @return Уровень инструкций
+ */
+SimdLevel DetectSimdLevel() {
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SimdLevel::Avx2;
+        }
+        return SimdLevel::Sse2;
+    }();
+    return level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    return KernelsFor(level).name;
+}
+
+bool ParseSimdLevel(const char* name, SimdLevel& level) {
+    for (SimdLevel candidate : kSimdLevels) {
+        if (strcmp(name, SimdLevelName(candidate)) == 0) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Возвращает таблицу ядер для заданного уровня инструкций.
+ * @param level Уровень инструкций
+ * @return Таблица ядер
+ */
+const SimdKernels& KernelsFor(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Avx512:
+        return kSimdKernelsAvx512;
+    case SimdLevel::Avx2:
+        return kSimdKernelsAvx2;
+    default:
+        return kSimdKernelsSse2;
+    }
+}
+
+/**
+ * @brief Таблица ядер, выбранная один раз при первом обращении.
+ * @return Таблица ядер для текущего процессора
+ */
+const SimdKernels& ActiveKernels() {
+    const SimdKernels* kernels = activeKernels.load(memory_order_acquire);
+    if (!kernels) {
+        // Одновременные первые вызовы выбирают одну и ту же таблицу; если
+        // раньше успел SetActiveSimdLevel(), остаётся его выбор.
+        const SimdKernels* expected = nullptr;
+        kernels = &KernelsFor(StartupSimdLevel());
+        if (!activeKernels.compare_exchange_strong(expected, kernels, memory_order_acq_rel)) {
+            kernels = expected;
+        }
+    }
+    return *kernels;
+}
+
+SimdLevel ActiveSimdLevel() {
+    const SimdKernels& kernels = ActiveKernels();
+    for (SimdLevel level : kSimdLevels) {
+        if (&KernelsFor(level) == &kernels) {
+            return level;
+        }
+    }
+    return SimdLevel::Sse2;
+}
+
+bool SetActiveSimdLevel(SimdLevel level) {
+    if (int(level) > int(DetectSimdLevel())) {
+        return false;
+    }
+    activeKernels.store(&KernelsFor(level), memory_order_release);
+    return true;
+}
@@ -0,0 +1,262 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Ядра собраны для нескольких уровней x86-64 (simdkernels_*.cpp с разными
+// флагами процессора) в один исполняемый файл. Уровень определяется по CPUID
+// один раз, при первом обращении к ActiveKernels(), и дальше вызовы идут
+// через указатели закэшированной таблицы. Переменная окружения
+// kSimdEnvironmentVariable (COMPLEX_SIMD=sse2|avx2|avx512) понижает уровень,
+// чтобы на одной машине замерить и проверить каждый вариант; то же делает
+// SetActiveSimdLevel() (ключ --simd= у тестов и замеров).
+
+/**
+ * @brief Уровни набора векторных инструкций x86-64, для которых собраны ядра.
+ */
+enum class SimdLevel {
+    Sse2,    /**< Базовый уровень x86-64 (2 double в регистре).*/
+    Avx2,    /**< AVX2 + FMA (4 double в регистре).*/
+    Avx512   /**< AVX-512F (8 double в регистре).*/
+};
+
+/** Переменная окружения, задающая уровень инструкций (имя как у SimdLevelName). */
+const char* const kSimdEnvironmentVariable = "COMPLEX_SIMD";
+
+/** Строк в плитке комплексного микроядра GEMM (SimdKernels::gemmTile). */
+const size_t kGemmRows = 4;
+
+/**
+ * @brief Таблица поэлементных ядер над раздельными массивами re/im.
+ *
+ * Одна и та же таблица собирается несколько раз с разными флагами
+ * процессора (simdkernels_*.cpp), а нужная выбирается во время выполнения.
+ * Выходные массивы могут совпадать с входными (вычисление на месте).
+ */
+struct SimdKernels {
+    const char* name;  /**< Имя набора инструкций.*/
+
+    /** c = a + b */
+    void (*add)(const double* ar, const double* ai, const double* br, const double* bi,
+                double* cr, double* ci, size_t n);
+    /** c = a - b */
+    void (*sub)(const double* ar, const double* ai, const double* br, const double* bi,
+                double* cr, double* ci, size_t n);
+    /** c = a * b */
+    void (*mul)(const double* ar, const double* ai, const double* br, const double* bi,
+                double* cr, double* ci, size_t n);
+    /** c = a * conj(b) */
+    void (*conjMul)(const double* ar, const double* ai, const double* br, const double* bi,
+                    double* cr, double* ci, size_t n);
+    /** c = a * k, k вещественное */
+    void (*scale)(const double* ar, const double* ai, double k, double* cr, double* ci, size_t n);
+    /** c = k * a, k — одно комплексное число (как Complex::operator*) */
+    void (*scaleComplex)(double kr, double ki, const double* ar, const double* ai, double* cr, double* ci, size_t n);
+    /** c = a / b (устойчиво, как Complex::operator/) */
+    void (*div)(const double* ar, const double* ai, const double* br, const double* bi,
+                double* cr, double* ci, size_t n);
+    /** c = a / b через 1/|b|^2 (как Complex::FastDivide) */
+    void (*divFast)(const double* ar, const double* ai, const double* br, const double* bi,
+                    double* cr, double* ci, size_t n);
+    /** c = 1 / a (как Complex::Reciprocal) */
+    void (*reciprocal)(const double* ar, const double* ai, double* cr, double* ci, size_t n);
+    /** c = 1 / a (как Complex::FastReciprocal) */
+    void (*reciprocalFast)(const double* ar, const double* ai, double* cr, double* ci, size_t n);
+    /** y += a * x, a — одно комплексное число; через FMA, где оно есть */
+    void (*axpy)(double ar, double ai, const double* xr, const double* xi, double* yr, double* yi, size_t n);
+    /**
+    * out[0] + i*out[1] = sum x * y (при conj — sum x * conj(y)); compensated —
+    * точные ошибки произведений и сумм копятся отдельно (как Dot2 / Neumaier)
+    */
+    void (*dot)(const double* xr, const double* xi, const double* yr, const double* yi, size_t n,
+                bool conj, bool compensated, double* out);
+    /** out = |a| (без ложного переполнения, как Complex::Abs) */
+    void (*abs)(const double* ar, const double* ai, double* out, size_t n);
+    /** out = |a|^2 */
+    void (*absSquared)(const double* ar, const double* ai, double* out, size_t n);
+    /** out ~ |a| по формуле alpha*max + beta*min (отн. погрешность <= 3.96%) */
+    void (*absApprox)(const double* ar, const double* ai, double* out, size_t n);
+    /** out = |z| для чередующихся пар (re, im) */
+    void (*absInterleaved)(const double* z, double* out, size_t n);
+    /** out = |z|^2 для чередующихся пар (re, im) */
+    void (*absSquaredInterleaved)(const double* z, double* out, size_t n);
+    /** out ~ |z| для чередующихся пар (re, im), как absApprox */
+    void (*absApproxInterleaved)(const double* z, double* out, size_t n);
+    /** out = a * b для чередующихся пар */
+    void (*mulInterleaved)(const double* a, const double* b, double* out, size_t n);
+    /** out = a / b для чередующихся пар, устойчиво */
+    void (*divInterleaved)(const double* a, const double* b, double* out, size_t n);
+    /** out = a / b для чередующихся пар, быстрый режим */
+    void (*divFastInterleaved)(const double* a, const double* b, double* out, size_t n);
+    /** out = 1 / z для чередующихся пар, устойчиво */
+    void (*reciprocalInterleaved)(const double* z, double* out, size_t n);
+    /** out = 1 / z для чередующихся пар, быстрый режим */
+    void (*reciprocalFastInterleaved)(const double* z, double* out, size_t n);
+    /** y += a * x для чередующихся пар */
+    void (*axpyInterleaved)(double ar, double ai, const double* x, double* y, size_t n);
+    /** out = k * z для чередующихся пар, как scaleComplex */
+    void (*scaleComplexInterleaved)(double kr, double ki, const double* z, double* out, size_t n);
+    /** Скалярное произведение чередующихся пар, как dot */
+    void (*dotInterleaved)(const double* x, const double* y, size_t n, bool conj, bool compensated, double* out);
+    /** Разбор чередующихся пар (re, im) на два массива */
+    void (*deinterleave)(const double* src, double* re, double* im, size_t n);
+    /** Сборка чередующихся пар (re, im) из двух массивов */
+    void (*interleave)(const double* re, const double* im, double* dst, size_t n);
+    // Преобразования типов частей (n — число скалярных частей, по две на
+    // комплексное число). В Q15 и binary16 — округление к ближайшему чётному,
+    // в Q15 с насыщением и NaN -> 0, как в complexstorage.h.
+    void (*f64ToF32)(const double* src, float* dst, size_t n);
+    void (*f32ToF64)(const float* src, double* dst, size_t n);
+    void (*q15ToF32)(const int16_t* src, float* dst, size_t n);
+    void (*f32ToQ15)(const float* src, int16_t* dst, size_t n);
+    void (*q15ToF64)(const int16_t* src, double* dst, size_t n);
+    void (*f64ToQ15)(const double* src, int16_t* dst, size_t n);
+    void (*f16ToF32)(const uint16_t* src, float* dst, size_t n);
+    void (*f32ToF16)(const float* src, uint16_t* dst, size_t n);
+    /** Одно округление, как Half::FromDouble (не через f64ToF32 и f32ToF16) */
+    void (*f64ToF16)(const double* src, uint16_t* dst, size_t n);
+    // Элементарные функции (точность — см. MathAccuracy в complexbatch.h):
+    // approx — укороченные полиномы; элементы вне диапазона векторной ветви,
+    // бесконечности и NaN считаются скалярно, как в complexmath.h.
+    /** out = arg(a) в [-pi, pi] */
+    void (*arg)(const double* ar, const double* ai, double* out, size_t n, bool approx);
+    /** c = r * e^(i t); r == nullptr — единичный модуль */
+    void (*polar)(const double* r, const double* t, double* cr, double* ci, size_t n, bool approx);
+    /** c = a * e^(i t) — поворот фазы */
+    void (*rotate)(const double* ar, const double* ai, const double* t, double* cr, double* ci, size_t n,
+                   bool approx);
+    /** c = e^a */
+    void (*exp)(const double* ar, const double* ai, double* cr, double* ci, size_t n, bool approx);
+    /** c = log a (главная ветвь) */
+    void (*log)(const double* ar, const double* ai, double* cr, double* ci, size_t n, bool approx);
+    /** c = sqrt(a) (главная ветвь) */
+    void (*sqrt)(const double* ar, const double* ai, double* cr, double* ci, size_t n);
+    /** c = a^p, p вещественное */
+    void (*pow)(const double* ar, const double* ai, double p, double* cr, double* ci, size_t n, bool approx);
+    /** Те же функции для чередующихся пар (re, im) */
+    void (*argInterleaved)(const double* z, double* out, size_t n, bool approx);
+    void (*polarInterleaved)(const double* r, const double* t, double* out, size_t n, bool approx);
+    void (*rotateInterleaved)(const double* z, const double* t, double* out, size_t n, bool approx);
+    void (*expInterleaved)(const double* z, double* out, size_t n, bool approx);
+    void (*logInterleaved)(const double* z, double* out, size_t n, bool approx);
+    void (*sqrtInterleaved)(const double* z, double* out, size_t n);
+    void (*powInterleaved)(const double* z, double p, double* out, size_t n, bool approx);
+    // Матричные ядра (matrix.cpp). Панель A на шаг k — kGemmRows частей re,
+    // затем kGemmRows частей im (у gemmTileReal — gemmRealRows чисел); панель B
+    // на шаг k — gemmCols частей re, затем gemmCols частей im (у gemmTileReal —
+    // 2 * gemmCols чисел). Плитка результата пишется построчно, подряд.
+    size_t gemmCols;      /**< Ширина плитки микроядер (число double в регистре).*/
+    size_t gemmRealRows;  /**< Строк в плитке gemmTileReal.*/
+    /** cr + i*ci = A * B для плитки kGemmRows x gemmCols по k шагам */
+    void (*gemmTile)(size_t k, const double* a, const double* b, double* cr, double* ci);
+    /** c = A * B для вещественной плитки gemmRealRows x (2 * gemmCols) по k шагам (для 3M) */
+    void (*gemmTileReal)(size_t k, const double* a, const double* b, double* c);
+    /**
+    * C_t = A_t * B_t для count матриц m x k и k x n; элемент (i, j) матрицы t
+    * лежит в x[(i * cols + j) * stride + t] (stride >= count)
+    */
+    void (*gemmBatch)(size_t m, size_t k, size_t n, const double* ar, const double* ai, const double* br,
+                      const double* bi, double* cr, double* ci, size_t stride, size_t count);
+    /**
+    * Этап radix-4 БПФ (fft.cpp) над n чередующимися парами в бит-реверсном
+    * порядке: бабочки с шагом h, w — множители этапа [w1r w1i w2r w2i w3r w3i]
+    * по h чисел; при inverse множители сопрягаются. Без FMA и в порядке
+    * операций Complex::operator*, поэтому результат одинаков на всех уровнях.
+    */
+    void (*fftRadix4Stage)(double* data, size_t n, size_t h, const double* w, bool inverse);
+    /**
+    * Значения многочлена с count коэффициентами c (пары, c[0] — свободный
+    * член) в n точках z: p — значения, dp — производные (может быть nullptr,
+    * производная всегда по Горнеру); estrin — значения по схеме Эстрина
+    */
+    void (*polyEvalInterleaved)(const double* c, size_t count, const double* z, double* p, double* dp, size_t n,
+                                bool estrin);
+    /** out = сумма 1 / (x - z_j) по n точкам z (поправка Аберта в polynomial.cpp) */
+    void (*reciprocalSumInterleaved)(double xr, double xi, const double* z, size_t n, double* out);
+    /** acc += a * b поэлементно (спектры в свёртке по разбиениям, convolution.cpp) */
+    void (*mulAccumulateInterleaved)(const double* a, const double* b, double* acc, size_t n);
+    /**
+    * Сумма n пар (reductions.cpp): out = [re, im, ошибка re, ошибка im];
+    * compensated — TwoSum с накоплением ошибок, иначе ошибки нулевые
+    */
+    void (*sumInterleaved)(const double* z, size_t n, bool compensated, double* out);
+    /** out = [сумма |z - (cr, ci)|^2, её ошибка] по n парам */
+    void (*sumSquaredDeviationInterleaved)(const double* z, size_t n, double cr, double ci, bool compensated,
+                                           double* out);
+    /**
+    * Наибольший (maximum) или наименьший |z|^2 по n парам без корня:
+    * out = [|z|^2, индекс первого такого]; NaN пропускаются, без сравнимых — [NaN, -1]
+    */
+    void (*absSquaredExtremumInterleaved)(const double* z, size_t n, bool maximum, double* out);
+    /** r = |z|, theta = arg z за один проход (точность arg — как у argInterleaved) */
+    void (*toPolarInterleaved)(const double* z, double* r, double* theta, size_t n, bool approx);
+    /**
+    * out[i] = gain * arg(z[i] * conj(z[i - 1])), где z[-1] — пара previous
+    * (частотный дискриминатор, phase.cpp)
+    */
+    void (*fmDiscriminateInterleaved)(const double* z, const double* previous, double gain, double* out, size_t n,
+                                      bool approx);
+    /**
+    * Развёртка фазы: out[i] = in[i] + 2pi * k, k меняется при скачке больше pi;
+    * state = [последняя фаза, k] переносится между вызовами; out может совпадать с in
+    */
+    void (*unwrapPhase)(const double* in, double* out, size_t n, double* state);
+};
+
+extern const SimdKernels kSimdKernelsSse2;
+extern const SimdKernels kSimdKernelsAvx2;
+extern const SimdKernels kSimdKernelsAvx512;
+
+/**
+ * @brief Определяет лучший уровень инструкций, поддерживаемый процессором (CPUID).
+ * @return Уровень инструкций
+ */
+SimdLevel DetectSimdLevel();
+
+/**
+ * @brief Имя уровня инструкций ("sse2", "avx2", "avx512").
+ */
+const char* SimdLevelName(SimdLevel level);
+
+/**
+ * @brief Разбирает имя уровня инструкций (как у SimdLevelName).
+ * @param name Имя
+ * @param level Результат
+ * @return false, если имя неизвестно
+ */
+bool ParseSimdLevel(const char* name, SimdLevel& level);
+
+/**
+ * @brief Возвращает таблицу ядер для заданного уровня инструкций.
+ * @param level Уровень инструкций
+ * @return Таблица ядер
+ */
+const SimdKernels& KernelsFor(SimdLevel level);
+
+/**
+ * @brief Таблица ядер, выбранная один раз при первом обращении.
+ *
+ * По умолчанию — для DetectSimdLevel(); если задана переменная окружения
+ * COMPLEX_SIMD, то для её уровня, но не выше поддерживаемого (неизвестное
+ * имя не учитывается).
+ * @return Таблица ядер для текущего процессора
+ */
+const SimdKernels& ActiveKernels();
+
+/**
+ * @brief Уровень инструкций таблицы ActiveKernels().
+ */
+SimdLevel ActiveSimdLevel();
+
+/**
+ * @brief Заменяет таблицу ActiveKernels() (для тестов и замеров).
+ *
+ * Вызывается, пока другие потоки не считают ядрами: текущие вызовы
+ * доработают по старой таблице.
+ * @param level Уровень инструкций
+ * @return false, если процессор его не поддерживает (таблица не меняется)
+ */
+bool SetActiveSimdLevel(SimdLevel level);
+
+#endif // SIMD_H
@@ -0,0 +1,2285 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+// Тела поэлементных ядер. Файл подключается в каждый simdkernels_*.cpp,
+// который собирается со своими флагами процессора, поэтому здесь нельзя
+// использовать внешние inline-функции (в том числе из mycomplex.h) —
+// только Vec из simdvec.h и функции библиотеки C.
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "simd.h"
+#include "simdvec.h"
+
+namespace {
+
+void AddKernel(const double* ar, const double* ai, const double* br, const double* bi,
+               double* cr, double* ci, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        (Vec::Load(ar + i) + Vec::Load(br + i)).Store(cr + i);
+        (Vec::Load(ai + i) + Vec::Load(bi + i)).Store(ci + i);
+    }
+    for (; i < n; ++i) {
+        cr[i] = ar[i] + br[i];
+        ci[i] = ai[i] + bi[i];
+    }
+}
+
+void SubKernel(const double* ar, const double* ai, const double* br, const double* bi,
+               double* cr, double* ci, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        (Vec::Load(ar + i) - Vec::Load(br + i)).Store(cr + i);
+        (Vec::Load(ai + i) - Vec::Load(bi + i)).Store(ci + i);
+    }
+    for (; i < n; ++i) {
+        cr[i] = ar[i] - br[i];
+        ci[i] = ai[i] - bi[i];
+    }
+}
+
+// Умножение без FMA: результат побитово совпадает с Complex::operator*.
+void MulKernel(const double* ar, const double* ai, const double* br, const double* bi,
+               double* cr, double* ci, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr = Vec::Load(ar + i), xi = Vec::Load(ai + i);
+        Vec yr = Vec::Load(br + i), yi = Vec::Load(bi + i);
+        (xr * yr - xi * yi).Store(cr + i);
+        (xr * yi + xi * yr).Store(ci + i);
+    }
+    for (; i < n; ++i) {
+        double xr = ar[i], xi = ai[i], yr = br[i], yi = bi[i];
+        cr[i] = xr * yr - xi * yi;
+        ci[i] = xr * yi + xi * yr;
+    }
+}
+
+void ConjMulKernel(const double* ar, const double* ai, const double* br, const double* bi,
+                   double* cr, double* ci, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr = Vec::Load(ar + i), xi = Vec::Load(ai + i);
+        Vec yr = Vec::Load(br + i), yi = Vec::Load(bi + i);
+        (xr * yr + xi * yi).Store(cr + i);
+        (xi * yr - xr * yi).Store(ci + i);
+    }
+    for (; i < n; ++i) {
+        double xr = ar[i], xi = ai[i], yr = br[i], yi = bi[i];
+        cr[i] = xr * yr + xi * yi;
+        ci[i] = xi * yr - xr * yi;
+    }
+}
+
+void ScaleKernel(const double* ar, const double* ai, double k, double* cr, double* ci, size_t n) {
+    Vec vk = Vec::Set1(k);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        (Vec::Load(ar + i) * vk).Store(cr + i);
+        (Vec::Load(ai + i) * vk).Store(ci + i);
+    }
+    for (; i < n; ++i) {
+        cr[i] = ar[i] * k;
+        ci[i] = ai[i] * k;
+    }
+}
+
+// c = k * a в порядке операций Complex::operator* (k — левый множитель).
+void ScaleComplexKernel(double kr, double ki, const double* ar, const double* ai, double* cr, double* ci, size_t n) {
+    Vec vr = Vec::Set1(kr), vi = Vec::Set1(ki);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec x = Vec::Load(ar + i), y = Vec::Load(ai + i);
+        (vr * x - vi * y).Store(cr + i);
+        (vr * y + vi * x).Store(ci + i);
+    }
+    for (; i < n; ++i) {
+        double x = ar[i], y = ai[i];
+        cr[i] = kr * x - ki * y;
+        ci[i] = kr * y + ki * x;
+    }
+}
+
+void AbsSquaredKernel(const double* ar, const double* ai, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr = Vec::Load(ar + i), xi = Vec::Load(ai + i);
+        (xr * xr + xi * xi).Store(out + i);
+    }
+    for (; i < n; ++i) {
+        out[i] = ar[i] * ar[i] + ai[i] * ai[i];
+    }
+}
+
+// Скалярный модуль, повторяющий Complex::Abs (mycomplex.h сюда подключать нельзя).
+double SafeAbs(double re, double im) {
+    double sum = re * re + im * im;
+    if ((sum >= DBL_MIN || (re == 0 && im == 0)) && sum <= DBL_MAX) {
+        return sqrt(sum);
+    }
+    re = fabs(re);
+    im = fabs(im);
+    if (isinf(re) || isinf(im)) {
+        return HUGE_VAL;
+    }
+    if (isnan(re) || isnan(im)) {
+        return re + im;
+    }
+    double scale = (re > 1 || im > 1) ? 0x1p-600 : 0x1p600;
+    re *= scale;
+    im *= scale;
+    return sqrt(re * re + im * im) / scale;
+}
+
+// Векторный корень по всему регистру; если хоть одна сумма квадратов вышла
+// за нормальный диапазон (кроме честных нулей), регистр пересчитывается скалярно.
+void AbsKernel(const double* ar, const double* ai, double* out, size_t n) {
+    Vec lo = Vec::Set1(DBL_MIN), hi = Vec::Set1(DBL_MAX);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr = Vec::Load(ar + i), xi = Vec::Load(ai + i);
+        Vec sum = xr * xr + xi * xi;
+        if (AllInRangeOrZero(sum, lo, hi, Max(Abs(xr), Abs(xi)))) {
+            Sqrt(sum).Store(out + i);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                out[j] = SafeAbs(ar[j], ai[j]);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        out[i] = SafeAbs(ar[i], ai[i]);
+    }
+}
+
+void AbsInterleavedKernel(const double* z, double* out, size_t n) {
+    Vec lo = Vec::Set1(DBL_MIN), hi = Vec::Set1(DBL_MAX);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi;
+        Vec::LoadInterleaved(z + 2 * i, xr, xi);
+        Vec sum = xr * xr + xi * xi;
+        if (AllInRangeOrZero(sum, lo, hi, Max(Abs(xr), Abs(xi)))) {
+            Sqrt(sum).Store(out + i);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                out[j] = SafeAbs(z[2 * j], z[2 * j + 1]);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        out[i] = SafeAbs(z[2 * i], z[2 * i + 1]);
+    }
+}
+
+void AbsSquaredInterleavedKernel(const double* z, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi;
+        Vec::LoadInterleaved(z + 2 * i, xr, xi);
+        (xr * xr + xi * xi).Store(out + i);
+    }
+    for (; i < n; ++i) {
+        out[i] = z[2 * i] * z[2 * i] + z[2 * i + 1] * z[2 * i + 1];
+    }
+}
+
+// Приближение alpha*max(|x|,|y|) + beta*min(|x|,|y|) с коэффициентами,
+// минимизирующими максимальную относительную погрешность: она не превышает
+// 3.96% в обе стороны. Переполнения нет, корень не нужен.
+const double kAbsAlpha = 0.96043387010342;
+const double kAbsBeta = 0.397824734759316;
+
+void AbsApproxKernel(const double* ar, const double* ai, double* out, size_t n) {
+    Vec alpha = Vec::Set1(kAbsAlpha), beta = Vec::Set1(kAbsBeta);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr = Abs(Vec::Load(ar + i)), xi = Abs(Vec::Load(ai + i));
+        (alpha * Max(xr, xi) + beta * Min(xr, xi)).Store(out + i);
+    }
+    for (; i < n; ++i) {
+        double xr = fabs(ar[i]), xi = fabs(ai[i]);
+        out[i] = kAbsAlpha * fmax(xr, xi) + kAbsBeta * fmin(xr, xi);
+    }
+}
+
+void AbsApproxInterleavedKernel(const double* z, double* out, size_t n) {
+    Vec alpha = Vec::Set1(kAbsAlpha), beta = Vec::Set1(kAbsBeta);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi;
+        Vec::LoadInterleaved(z + 2 * i, xr, xi);
+        xr = Abs(xr);
+        xi = Abs(xi);
+        (alpha * Max(xr, xi) + beta * Min(xr, xi)).Store(out + i);
+    }
+    for (; i < n; ++i) {
+        double xr = fabs(z[2 * i]), xi = fabs(z[2 * i + 1]);
+        out[i] = kAbsAlpha * fmax(xr, xi) + kAbsBeta * fmin(xr, xi);
+    }
+}
+
+void DeinterleaveKernel(const double* src, double* re, double* im, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec r, m;
+        Vec::LoadInterleaved(src + 2 * i, r, m);
+        r.Store(re + i);
+        m.Store(im + i);
+    }
+    for (; i < n; ++i) {
+        re[i] = src[2 * i];
+        im[i] = src[2 * i + 1];
+    }
+}
+
+void InterleaveKernel(const double* re, const double* im, double* dst, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec::StoreInterleaved(dst + 2 * i, Vec::Load(re + i), Vec::Load(im + i));
+    }
+    for (; i < n; ++i) {
+        dst[2 * i] = re[i];
+        dst[2 * i + 1] = im[i];
+    }
+}
+
+// Деление. Скалярная ветвь повторяет Complex::Divide (Смит с масштабированием
+// и поправками C99 Annex G); векторная считает тот же шаг Смита без
+// масштабирования и годится, когда масштабирование не понадобилось бы и r не
+// ушло в ноль, — тогда результат совпадает со скалярным бит в бит.
+const double kDivLow = 0x1p-968;
+const double kDivHigh = DBL_MAX / 2;
+
+void SmithStep(double a, double b, double c, double d, double& x, double& y) {
+    double r = d / c;
+    double den = c + d * r;
+    if (r != 0 || d == 0) {
+        x = (a + b * r) / den;
+        y = (b - a * r) / den;
+    } else {
+        x = (a + d * (b / c)) / den;
+        y = (b - d * (a / c)) / den;
+    }
+}
+
+void SafeDiv(double a, double b, double c, double d, double& x, double& y) {
+    const double kScale = 0x1p107;
+    double a0 = a, b0 = b, c0 = c, d0 = d;
+    // Максимумы модулей частей (при NaN — как maxpd, без вызова fmax).
+    double ab = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+    double cd = fabs(c) > fabs(d) ? fabs(c) : fabs(d);
+    double s = 1;
+    if (ab > kDivHigh) {
+        a *= 0.5;
+        b *= 0.5;
+        s *= 2;
+    }
+    if (cd > kDivHigh) {
+        c *= 0.5;
+        d *= 0.5;
+        s *= 0.5;
+    }
+    if (ab < kDivLow) {
+        a *= kScale;
+        b *= kScale;
+        s /= kScale;
+    }
+    if (cd < kDivLow) {
+        c *= kScale;
+        d *= kScale;
+        s *= kScale;
+    }
+    // При |d| > |c| тот же шаг с переставленными частями и сменой знака y;
+    // выбор без ветвления, потому что на случайных данных он непредсказуем.
+    bool swap = fabs(d) > fabs(c);
+    SmithStep(swap ? b : a, swap ? a : b, swap ? d : c, swap ? c : d, x, y);
+    y = swap ? -y : y;
+    x *= s;
+    y *= s;
+    if (isnan(x) && isnan(y)) {
+        if (c0 == 0 && d0 == 0 && (!isnan(a0) || !isnan(b0))) {
+            x = copysign(HUGE_VAL, c0) * a0;
+            y = copysign(HUGE_VAL, c0) * b0;
+        } else if ((isinf(a0) || isinf(b0)) && isfinite(c0) && isfinite(d0)) {
+            a = copysign(isinf(a0) ? 1.0 : 0.0, a0);
+            b = copysign(isinf(b0) ? 1.0 : 0.0, b0);
+            x = HUGE_VAL * (a * c0 + b * d0);
+            y = HUGE_VAL * (b * c0 - a * d0);
+        } else if ((isinf(c0) || isinf(d0)) && isfinite(a0) && isfinite(b0)) {
+            c = copysign(isinf(c0) ? 1.0 : 0.0, c0);
+            d = copysign(isinf(d0) ? 1.0 : 0.0, d0);
+            // Масштабированные a, b, как в ScaledDivide: суммы не переполняются.
+            x = 0.0 * (a * c + b * d);
+            y = 0.0 * (b * c - a * d);
+        }
+    }
+}
+
+void FastDiv(double a, double b, double c, double d, double& x, double& y) {
+    double s = 1.0 / (c * c + d * d);
+    x = (a * c + b * d) * s;
+    y = (b * c - a * d) * s;
+}
+
+template <bool kFast>
+inline void ScalarDiv(double a, double b, double c, double d, double& x, double& y) {
+    if (kFast) {
+        FastDiv(a, b, c, d, x, y);
+    } else {
+        SafeDiv(a, b, c, d, x, y);
+    }
+}
+
+// Деление по всему регистру; false — хоть один элемент требует скалярной ветви.
+template <bool kFast>
+inline bool VecDiv(Vec a, Vec b, Vec c, Vec d, Vec& x, Vec& y) {
+    if (kFast) {
+        Vec s = Vec::Set1(1.0) / (c * c + d * d);
+        x = (a * c + b * d) * s;
+        y = (b * c - a * d) * s;
+        return true;
+    }
+    // Ветвь |d| > |c| — тот же шаг с переставленными частями и сменой знака y.
+    Vec ac = Abs(c), ad = Abs(d);
+    Vec p = SelectGreater(ad, ac, d, c), q = SelectGreater(ad, ac, c, d);
+    Vec u = SelectGreater(ad, ac, b, a), v = SelectGreater(ad, ac, a, b);
+    Vec r = q / p;
+    Vec den = p + q * r;
+    x = (u + v * r) / den;
+    y = (v - u * r) / den;
+    y = SelectGreater(ad, ac, Neg(y), y);
+    Vec lo = Vec::Set1(kDivLow), hi = Vec::Set1(kDivHigh), one = Vec::Set1(1.0);
+    Vec ab = Max(Abs(a), Abs(b));
+    return AllInRangeOrZero(ab, lo, hi, ab) && AllInRangeOrZero(Max(ac, ad), lo, hi, one) &&
+           AllInRangeOrZero(Abs(r), Vec::Set1(DBL_TRUE_MIN), one, q);
+}
+
+template <bool kFast>
+void DivKernel(const double* ar, const double* ai, const double* br, const double* bi,
+               double* cr, double* ci, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec x, y;
+        if (VecDiv<kFast>(Vec::Load(ar + i), Vec::Load(ai + i), Vec::Load(br + i), Vec::Load(bi + i), x, y)) {
+            x.Store(cr + i);
+            y.Store(ci + i);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                ScalarDiv<kFast>(ar[j], ai[j], br[j], bi[j], cr[j], ci[j]);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        ScalarDiv<kFast>(ar[i], ai[i], br[i], bi[i], cr[i], ci[i]);
+    }
+}
+
+// Обратное число: устойчивый режим — деление 1 / z, быстрый — conj(z) / |z|^2,
+// как Complex::FastReciprocal.
+template <bool kFast>
+inline void ScalarReciprocal(double c, double d, double& x, double& y) {
+    if (kFast) {
+        double s = 1.0 / (c * c + d * d);
+        x = c * s;
+        y = -d * s;
+    } else {
+        SafeDiv(1.0, 0.0, c, d, x, y);
+    }
+}
+
+template <bool kFast>
+inline bool VecReciprocal(Vec c, Vec d, Vec& x, Vec& y) {
+    if (kFast) {
+        Vec s = Vec::Set1(1.0) / (c * c + d * d);
+        x = c * s;
+        y = Neg(d) * s;
+        return true;
+    }
+    return VecDiv<false>(Vec::Set1(1.0), Vec::Set1(0.0), c, d, x, y);
+}
+
+template <bool kFast>
+void ReciprocalKernel(const double* ar, const double* ai, double* cr, double* ci, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec x, y;
+        if (VecReciprocal<kFast>(Vec::Load(ar + i), Vec::Load(ai + i), x, y)) {
+            x.Store(cr + i);
+            y.Store(ci + i);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                ScalarReciprocal<kFast>(ar[j], ai[j], cr[j], ci[j]);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        ScalarReciprocal<kFast>(ar[i], ai[i], cr[i], ci[i]);
+    }
+}
+
+// Хвост — тем же векторным кодом через буфер (см. ScaleComplexInterleavedKernel).
+void MulInterleavedKernel(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi, yr, yi;
+        Vec::LoadInterleaved(a + 2 * i, xr, xi);
+        Vec::LoadInterleaved(b + 2 * i, yr, yi);
+        Vec::StoreInterleaved(out + 2 * i, xr * yr - xi * yi, xr * yi + xi * yr);
+    }
+    if (i < n) {
+        double bufferA[2 * Vec::kWidth] = {}, bufferB[2 * Vec::kWidth] = {};
+        memcpy(bufferA, a + 2 * i, 2 * (n - i) * sizeof(double));
+        memcpy(bufferB, b + 2 * i, 2 * (n - i) * sizeof(double));
+        Vec xr, xi, yr, yi;
+        Vec::LoadInterleaved(bufferA, xr, xi);
+        Vec::LoadInterleaved(bufferB, yr, yi);
+        Vec::StoreInterleaved(bufferA, xr * yr - xi * yi, xr * yi + xi * yr);
+        memcpy(out + 2 * i, bufferA, 2 * (n - i) * sizeof(double));
+    }
+}
+
+template <bool kFast>
+void DivInterleavedKernel(const double* a, const double* b, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi, yr, yi, x, y;
+        Vec::LoadInterleaved(a + 2 * i, xr, xi);
+        Vec::LoadInterleaved(b + 2 * i, yr, yi);
+        if (VecDiv<kFast>(xr, xi, yr, yi, x, y)) {
+            Vec::StoreInterleaved(out + 2 * i, x, y);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                ScalarDiv<kFast>(a[2 * j], a[2 * j + 1], b[2 * j], b[2 * j + 1], out[2 * j], out[2 * j + 1]);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        ScalarDiv<kFast>(a[2 * i], a[2 * i + 1], b[2 * i], b[2 * i + 1], out[2 * i], out[2 * i + 1]);
+    }
+}
+
+template <bool kFast>
+void ReciprocalInterleavedKernel(const double* z, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec zr, zi, x, y;
+        Vec::LoadInterleaved(z + 2 * i, zr, zi);
+        if (VecReciprocal<kFast>(zr, zi, x, y)) {
+            Vec::StoreInterleaved(out + 2 * i, x, y);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                ScalarReciprocal<kFast>(z[2 * j], z[2 * j + 1], out[2 * j], out[2 * j + 1]);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        ScalarReciprocal<kFast>(z[2 * i], z[2 * i + 1], out[2 * i], out[2 * i + 1]);
+    }
+}
+
+// y += a * x через FMA (на SSE2 — умножение и сложение): порядок операций
+// тот же, что в FusedMulAdd из mycomplex.h.
+void AxpyKernel(double ar, double ai, const double* xr, const double* xi, double* yr, double* yi, size_t n) {
+    Vec vr = Vec::Set1(ar), vi = Vec::Set1(ai), vni = Vec::Set1(-ai);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec x = Vec::Load(xr + i), y = Vec::Load(xi + i);
+        MulAdd(vr, x, MulAdd(vni, y, Vec::Load(yr + i))).Store(yr + i);
+        MulAdd(vr, y, MulAdd(vi, x, Vec::Load(yi + i))).Store(yi + i);
+    }
+    for (; i < n; ++i) {
+        double x = xr[i], y = xi[i];
+        yr[i] = ScalarMulAdd(ar, x, ScalarMulAdd(-ai, y, yr[i]));
+        yi[i] = ScalarMulAdd(ar, y, ScalarMulAdd(ai, x, yi[i]));
+    }
+}
+
+void AxpyInterleavedKernel(double ar, double ai, const double* x, double* y, size_t n) {
+    Vec vr = Vec::Set1(ar), vi = Vec::Set1(ai), vni = Vec::Set1(-ai);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi, yr, yi;
+        Vec::LoadInterleaved(x + 2 * i, xr, xi);
+        Vec::LoadInterleaved(y + 2 * i, yr, yi);
+        Vec::StoreInterleaved(y + 2 * i, MulAdd(vr, xr, MulAdd(vni, xi, yr)), MulAdd(vr, xi, MulAdd(vi, xr, yi)));
+    }
+    for (; i < n; ++i) {
+        double xr = x[2 * i], xi = x[2 * i + 1];
+        y[2 * i] = ScalarMulAdd(ar, xr, ScalarMulAdd(-ai, xi, y[2 * i]));
+        y[2 * i + 1] = ScalarMulAdd(ar, xi, ScalarMulAdd(ai, xr, y[2 * i + 1]));
+    }
+}
+
+void ScaleComplexInterleavedKernel(double kr, double ki, const double* z, double* out, size_t n) {
+    Vec vr = Vec::Set1(kr), vi = Vec::Set1(ki);
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec x, y;
+        Vec::LoadInterleaved(z + 2 * i, x, y);
+        Vec::StoreInterleaved(out + 2 * i, vr * x - vi * y, vr * y + vi * x);
+    }
+    if (i < n) {
+        // Хвост — тем же векторным кодом через буфер: скалярный цикл GCC
+        // векторизует в vfmaddsub даже с -ffp-contract=off, а генератор
+        // несущей (Oscillator) требует одинаковых результатов при любом
+        // разбиении на блоки.
+        double buffer[2 * Vec::kWidth] = {};
+        memcpy(buffer, z + 2 * i, 2 * (n - i) * sizeof(double));
+        Vec x, y;
+        Vec::LoadInterleaved(buffer, x, y);
+        Vec::StoreInterleaved(buffer, vr * x - vi * y, vr * y + vi * x);
+        memcpy(out + 2 * i, buffer, 2 * (n - i) * sizeof(double));
+    }
+}
+
+// Источники данных для скалярного произведения: раздельные массивы или пары.
+struct SplitData {
+    const double* re;
+    const double* im;
+
+    void Load(size_t i, Vec& r, Vec& m) const {
+        r = Vec::Load(re + i);
+        m = Vec::Load(im + i);
+    }
+    double Re(size_t i) const { return re[i]; }
+    double Im(size_t i) const { return im[i]; }
+};
+
+struct InterleavedData {
+    const double* z;
+
+    void Load(size_t i, Vec& r, Vec& m) const { Vec::LoadInterleaved(z + 2 * i, r, m); }
+    double Re(size_t i) const { return z[2 * i]; }
+    double Im(size_t i) const { return z[2 * i + 1]; }
+};
+
+// Число независимых аккумуляторов: скрывает задержку FMA (4 такта) при
+// двух FMA в такт. Свёртка аккумуляторов в DotFast написана под четыре.
+const size_t kDotAccumulators = 4;
+static_assert(kDotAccumulators == 4, "свёртка аккумуляторов в DotFast рассчитана на 4");
+
+// Сумма элементов регистра слева направо.
+inline double SumLanes(Vec v) {
+    double lanes[Vec::kWidth];
+    v.Store(lanes);
+    double sum = 0;
+    for (size_t k = 0; k < Vec::kWidth; ++k) {
+        sum += lanes[k];
+    }
+    return sum;
+}
+
+// Быстрый режим: re += xr*yr - xi*yi, im += xr*yi + xi*yr цепочками FMA
+// в kDotAccumulators независимых аккумуляторах. Сопряжение y — смена знака
+// его мнимой части (умножение на -1 точное).
+template <class Data>
+void DotFast(Data x, Data y, size_t n, double sign, double* out) {
+    Vec zero = Vec::Set1(0.0), vs = Vec::Set1(sign);
+    Vec accR[kDotAccumulators], accI[kDotAccumulators];
+    for (size_t k = 0; k < kDotAccumulators; ++k) {
+        accR[k] = accI[k] = zero;
+    }
+    const size_t kStep = kDotAccumulators * Vec::kWidth;
+    size_t i = 0;
+    for (; i + kStep <= n; i += kStep) {
+        for (size_t k = 0; k < kDotAccumulators; ++k) {
+            Vec xr, xi, yr, yi;
+            x.Load(i + k * Vec::kWidth, xr, xi);
+            y.Load(i + k * Vec::kWidth, yr, yi);
+            yi = yi * vs;
+            accR[k] = MulAdd(Neg(xi), yi, MulAdd(xr, yr, accR[k]));
+            accI[k] = MulAdd(xi, yr, MulAdd(xr, yi, accI[k]));
+        }
+    }
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi, yr, yi;
+        x.Load(i, xr, xi);
+        y.Load(i, yr, yi);
+        yi = yi * vs;
+        accR[0] = MulAdd(Neg(xi), yi, MulAdd(xr, yr, accR[0]));
+        accI[0] = MulAdd(xi, yr, MulAdd(xr, yi, accI[0]));
+    }
+    Vec sumR = (accR[0] + accR[1]) + (accR[2] + accR[3]);
+    Vec sumI = (accI[0] + accI[1]) + (accI[2] + accI[3]);
+    double re = SumLanes(sumR), im = SumLanes(sumI);
+    for (; i < n; ++i) {
+        double xr = x.Re(i), xi = x.Im(i), yr = y.Re(i), yi = y.Im(i) * sign;
+        re = ScalarMulAdd(-xi, yi, ScalarMulAdd(xr, yr, re));
+        im = ScalarMulAdd(xi, yr, ScalarMulAdd(xr, yi, im));
+    }
+    out[0] = re;
+    out[1] = im;
+}
+
+// Сумма без потерь (TwoSum Кнута): s + e == a + b точно.
+template <class T>
+inline void TwoSum(T a, T b, T& s, T& e) {
+    s = a + b;
+    T bv = s - a;
+    e = (a - (s - bv)) + (b - bv);
+}
+
+// Прибавляет a*b к сумме s; ошибки произведения и сложения копятся в c.
+template <class T>
+inline void CompensatedMulAdd(T a, T b, T& s, T& c) {
+    T p = a * b;
+    T ep = ProductError(a, b, p);
+    T e;
+    TwoSum(s, p, s, e);
+    c = c + (ep + e);
+}
+
+// Компенсированный режим (Dot2, Ogita–Rump–Oishi): результат точен, как если
+// бы считался с удвоенной точностью и округлялся в конце.
+template <class Data>
+void DotCompensated(Data x, Data y, size_t n, double sign, double* out) {
+    Vec vs = Vec::Set1(sign);
+    Vec sr = Vec::Set1(0.0), cr = sr, si = sr, ci = sr;
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec xr, xi, yr, yi;
+        x.Load(i, xr, xi);
+        y.Load(i, yr, yi);
+        yi = yi * vs;
+        CompensatedMulAdd(xr, yr, sr, cr);
+        CompensatedMulAdd(Neg(xi), yi, sr, cr);
+        CompensatedMulAdd(xr, yi, si, ci);
+        CompensatedMulAdd(xi, yr, si, ci);
+    }
+    double lanes[4][Vec::kWidth];
+    sr.Store(lanes[0]);
+    cr.Store(lanes[1]);
+    si.Store(lanes[2]);
+    ci.Store(lanes[3]);
+    double re = 0, reErr = 0, im = 0, imErr = 0;
+    for (size_t k = 0; k < Vec::kWidth; ++k) {
+        double e;
+        TwoSum(re, lanes[0][k], re, e);
+        reErr += e + lanes[1][k];
+        TwoSum(im, lanes[2][k], im, e);
+        imErr += e + lanes[3][k];
+    }
+    for (; i < n; ++i) {
+        double xr = x.Re(i), xi = x.Im(i), yr = y.Re(i), yi = y.Im(i) * sign;
+        CompensatedMulAdd(xr, yr, re, reErr);
+        CompensatedMulAdd(-xi, yi, re, reErr);
+        CompensatedMulAdd(xr, yi, im, imErr);
+        CompensatedMulAdd(xi, yr, im, imErr);
+    }
+    out[0] = re + reErr;
+    out[1] = im + imErr;
+}
+
+template <class Data>
+void DotBody(Data x, Data y, size_t n, bool conj, bool compensated, double* out) {
+    double sign = conj ? -1.0 : 1.0;
+    if (compensated) {
+        DotCompensated(x, y, n, sign, out);
+    } else {
+        DotFast(x, y, n, sign, out);
+    }
+}
+
+void DotKernel(const double* xr, const double* xi, const double* yr, const double* yi, size_t n,
+               bool conj, bool compensated, double* out) {
+    DotBody(SplitData{xr, xi}, SplitData{yr, yi}, n, conj, compensated, out);
+}
+
+void DotInterleavedKernel(const double* x, const double* y, size_t n, bool conj, bool compensated, double* out) {
+    DotBody(InterleavedData{x}, InterleavedData{y}, n, conj, compensated, out);
+}
+
+// Преобразования типов частей. Тут нет ручных интринсиков: циклы разбиты на
+// блоки постоянной длины, и GCC векторизует их под флаги конкретного файла
+// даже при -O2. Округление и насыщение повторяют Q15 и Half из
+// complexstorage.h бит в бит (подключать его сюда нельзя).
+const size_t kConvertBlock = 16;
+
+template <class Op>
+void ConvertLoop(size_t n, Op op) {
+    size_t i = 0;
+    for (; i + kConvertBlock <= n; i += kConvertBlock) {
+#pragma GCC ivdep
+        for (size_t j = i; j < i + kConvertBlock; ++j) {
+            op(j);
+        }
+    }
+    for (; i < n; ++i) {
+        op(i);
+    }
+}
+
+/**
+ * @brief x * 2^15 -> int16 с насыщением, NaN -> 0. Округление к чётному —
+ * прибавлением и вычитанием 1.5 * 2^мантисса (после насыщения |y| мало).
+ */
+template <class T>
+int16_t ToQ15(T x) {
+    const T kRound = sizeof(T) == 4 ? T(0x1.8p23) : T(0x1.8p52);
+    T y = x * T(32768);
+    y = y == y ? y : T(0);
+    y = y < T(-32768) ? T(-32768) : y;
+    y = y > T(32767) ? T(32767) : y;
+    return int16_t(int32_t((y + kRound) - kRound));
+}
+
+void F64ToF32Kernel(const double* src, float* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = float(src[i]); });
+}
+
+void F32ToF64Kernel(const float* src, double* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = src[i]; });
+}
+
+void Q15ToF32Kernel(const int16_t* src, float* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = src[i] * (1.0f / 32768); });
+}
+
+void F32ToQ15Kernel(const float* src, int16_t* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = ToQ15(src[i]); });
+}
+
+void Q15ToF64Kernel(const int16_t* src, double* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = src[i] * (1.0 / 32768); });
+}
+
+void F64ToQ15Kernel(const double* src, int16_t* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = ToQ15(src[i]); });
+}
+
+float BitsToFloat(uint32_t bits) {
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+uint32_t FloatToBits(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+/** Half::ToFloat без ветвлений: все три случая считаются, нужный выбирается */
+float HalfToFloat(uint16_t h) {
+    uint32_t bits = uint32_t(h & 0x7fff) << 13;
+    uint32_t exponent = bits & 0x0f800000u;
+    bits += 0x38000000u;
+    uint32_t special = bits + 0x38000000u;
+    uint32_t subnormal = FloatToBits(BitsToFloat(bits + 0x00800000u) - 0x1p-14f);
+    bits = exponent == 0x0f800000u ? special : exponent == 0 ? subnormal : bits;
+    return BitsToFloat(bits | uint32_t(h & 0x8000) << 16);
+}
+
+/** Half::FromFloat без ветвлений */
+uint16_t FloatToHalf(float x) {
+    uint32_t f = FloatToBits(x);
+    uint32_t sign = f & 0x80000000u;
+    f ^= sign;
+    uint32_t special = f > 0x7f800000u ? 0x7e00u : 0x7c00u;
+    uint32_t subnormal = FloatToBits(BitsToFloat(f) + 0.5f) - 0x3f000000u;
+    uint32_t normal = (f + 0xc8000fffu + ((f >> 13) & 1)) >> 13;
+    uint32_t out = f >= 0x47800000u ? special : f < 0x38800000u ? subnormal : normal;
+    return uint16_t(out | sign >> 16);
+}
+
+void F16ToF32Kernel(const uint16_t* src, float* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = HalfToFloat(src[i]); });
+}
+
+void F32ToF16Kernel(const float* src, uint16_t* dst, size_t n) {
+    ConvertLoop(n, [=](size_t i) { dst[i] = FloatToHalf(src[i]); });
+}
+
+/** double -> float с округлением к нечётному, как в Half::FromDouble */
+float DoubleToFloatOdd(double x) {
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    uint64_t low = bits & 0x1fffffffu;
+    bits = (bits - low) | (low ? 0x20000000u : 0);
+    memcpy(&x, &bits, sizeof(x));
+    return float(x);
+}
+
+// Два прохода по куску через буфер: быстрее слитого цикла double -> uint16,
+// где оба сужения идут в одном регистре.
+void F64ToF16Kernel(const double* src, uint16_t* dst, size_t n) {
+    const size_t kChunk = 256;
+    float buffer[kChunk];
+    for (size_t i = 0; i < n; i += kChunk) {
+        size_t m = n - i < kChunk ? n - i : kChunk;
+        const double* s = src + i;
+        uint16_t* d = dst + i;
+        ConvertLoop(m, [&](size_t j) { buffer[j] = DoubleToFloatOdd(s[j]); });
+        ConvertLoop(m, [&](size_t j) { d[j] = FloatToHalf(buffer[j]); });
+    }
+}
+
+// Элементарные функции. Векторная ветвь считает полиномы по всему регистру и
+// годится для обычных аргументов; если хоть один элемент вне её диапазона
+// (или это inf/NaN), регистр пересчитывается скалярно через libm — с теми же
+// разрезами и особыми случаями, что в complexmath.h (подключать его сюда
+// нельзя). В полиномах используется MulAdd, поэтому на AVX2/AVX-512 (FMA)
+// результат может отличаться от SSE2 в последнем бите.
+
+// Приёмники результатов: раздельные массивы, пары (re, im) или один массив
+// вещественных значений (берётся только первая часть).
+struct SplitOut {
+    double* re;
+    double* im;
+
+    void Store(size_t i, Vec r, Vec m) const {
+        r.Store(re + i);
+        m.Store(im + i);
+    }
+    void Set(size_t i, double r, double m) const {
+        re[i] = r;
+        im[i] = m;
+    }
+};
+
+struct InterleavedOut {
+    double* z;
+
+    void Store(size_t i, Vec r, Vec m) const { Vec::StoreInterleaved(z + 2 * i, r, m); }
+    void Set(size_t i, double r, double m) const {
+        z[2 * i] = r;
+        z[2 * i + 1] = m;
+    }
+};
+
+struct RealOut {
+    double* out;
+
+    void Store(size_t i, Vec r, Vec) const { r.Store(out + i); }
+    void Set(size_t i, double r, double) const { out[i] = r; }
+};
+
+// Аргументы Polar без массива модулей: модуль 1.
+struct UnitPolarData {
+    const double* t;
+
+    void Load(size_t i, Vec& r, Vec& m) const {
+        r = Vec::Set1(1.0);
+        m = Vec::Load(t + i);
+    }
+    double Re(size_t) const { return 1.0; }
+    double Im(size_t i) const { return t[i]; }
+};
+
+/**
+ * @brief Поэлементная функция пары (x, y) -> (u, v): vecFn считает регистр
+ * и возвращает false, если регистр надо пересчитать скалярно (scalarFn).
+ */
+template <class In, class Out, class VecFn, class ScalarFn>
+void MapComplex(In in, Out out, size_t n, VecFn vecFn, ScalarFn scalarFn) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec x, y, u, v;
+        in.Load(i, x, y);
+        if (vecFn(x, y, u, v)) {
+            out.Store(i, u, v);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                double r, m;
+                scalarFn(in.Re(j), in.Im(j), r, m);
+                out.Set(j, r, m);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        double r, m;
+        scalarFn(in.Re(i), in.Im(i), r, m);
+        out.Set(i, r, m);
+    }
+}
+
+/** Округление к ближайшему целому для |x| < 2^51 (через 1.5 * 2^52) */
+inline Vec RoundToInt(Vec x) {
+    Vec k = Vec::Set1(0x1.8p52);
+    return (x + k) - k;
+}
+
+/** true, если все элементы |a| <= limit (NaN не проходит) */
+inline bool AllWithin(Vec a, double limit) {
+    return AllInRangeOrZero(a, Vec::Set1(-limit), Vec::Set1(limit), Vec::Set1(1.0));
+}
+
+// sin и cos. Приведение к |r| <= pi/4 по Коди–Уэйту: pi/2 разбито на три
+// части по 33 бита (fdlibm), поэтому q * часть точны при |q| <= 2^20, а
+// остаток r + tail сохраняет ~100 бит. Полиномы — ядра __kernel_sin/cos из
+// fdlibm (погрешность ядра < 2^-58). Укороченный режим — первые члены тех же
+// рядов без хвоста приведения: абсолютная погрешность ~2e-9.
+const double kSinCosMax = 0x1p20;
+const double kTwoOverPi = 6.36619772367581382433e-01;
+const double kPio2Hi = 1.57079632673412561417e+00;
+const double kPio2Mid = 6.07710050630396597660e-11;
+const double kPio2Lo = 2.02226624871116645580e-21;
+const double kSin[6] = {-1.66666666666666324348e-01, 8.33333333332248946124e-03, -1.98412698298579493134e-04,
+                        2.75573137070700676789e-06, -2.50507602534068634195e-08, 1.58969099521155010221e-10};
+const double kCos[6] = {4.16666666666666019037e-02, -1.38888888888741095749e-03, 2.48015872894767294178e-05,
+                        -2.75573143513906633035e-07, 2.08757232129817482790e-09, -1.13596475577881948265e-11};
+
+/** c[0] + z * (c[1] + ... + z * c[count - 1]) */
+inline Vec Horner(Vec z, const double* c, size_t count) {
+    Vec p = Vec::Set1(c[count - 1]);
+    for (size_t k = count - 1; k-- > 0;) {
+        p = MulAdd(p, z, Vec::Set1(c[k]));
+    }
+    return p;
+}
+
+/** Скалярный повтор Horner для хвостов */
+inline double Horner(double z, const double* c, size_t count) {
+    double p = c[count - 1];
+    for (size_t k = count - 1; k-- > 0;) {
+        p = ScalarMulAdd(p, z, c[k]);
+    }
+    return p;
+}
+
+/** sin и cos для |t| <= kSinCosMax */
+template <bool kApprox>
+inline void VecSinCos(Vec t, Vec& s, Vec& c) {
+    Vec zero = Vec::Set1(0.0), one = Vec::Set1(1.0), half = Vec::Set1(0.5);
+    Vec q = RoundToInt(t * Vec::Set1(kTwoOverPi));
+    Vec r1 = t - q * Vec::Set1(kPio2Hi);
+    Vec r, tail;
+    if (kApprox) {
+        r = r1 - q * Vec::Set1(kPio2Mid);
+        tail = zero;
+    } else {
+        TwoSum(r1, Neg(q * Vec::Set1(kPio2Mid)), r, tail);
+        tail = tail - q * Vec::Set1(kPio2Lo);
+        // При больших q хвост больше ulp(r): переносим его в r (Fast2Sum),
+        // иначе поправки первого порядка ниже теряют точность.
+        Vec sum = r + tail;
+        tail = tail - (sum - r);
+        r = sum;
+    }
+    Vec z = r * r;
+    // sin(r + tail) ~ r + r^3 * S(z) + tail, cos(r + tail) ~ 1 - z/2 + z^2 * C(z) - r * tail.
+    Vec sinR = r + MulAdd(r * z, Horner(z, kSin, kApprox ? 4 : 6), tail);
+    Vec hz = z * half, w = one - hz;
+    Vec cosR = w + (((one - w) - hz) + (z * z * Horner(z, kCos, kApprox ? 4 : 6) - r * tail));
+    // Четверть q mod 4: в нечётных sin и cos меняются местами; sin
+    // отрицателен в 2 и 3, cos — в 1 и 2.
+    Vec quadrant = q - Vec::Set1(4.0) * RoundToInt(q * Vec::Set1(0.25) - Vec::Set1(0.375));
+    Vec odd = quadrant - Vec::Set1(2.0) * RoundToInt(quadrant * half - Vec::Set1(0.25));
+    Vec sv = SelectGreater(odd, half, cosR, sinR);
+    Vec cv = SelectGreater(odd, half, sinR, cosR);
+    s = SelectGreater(quadrant, Vec::Set1(1.5), Neg(sv), sv);
+    c = SelectGreater(one, Abs(quadrant - Vec::Set1(1.5)), Neg(cv), cv);
+    // sin(-0) = -0: сумма r + (+0) теряла бы знак нуля.
+    s = SelectGreater(Abs(t), zero, s, t);
+}
+
+// e^x для |x| <= kExpMax (результат нормальный): x = n ln2 + r, |r| <= ln2/2,
+// ln2 из двух частей (fdlibm), e^r — ряд Тейлора до r^13 (до r^8 в
+// укороченном режиме, отн. погрешность ~2e-10), 2^n — сборкой порядка.
+const double kExpMax = 708;
+const double kLog2e = 1.44269504088896338700e+00;
+const double kLn2Hi = 6.93147180369123816490e-01;
+const double kLn2Lo = 1.90821492927058770002e-10;
+const double kExpTaylor[12] = {1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, 1.0 / 40320,
+                               1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600, 1.0 / 6227020800};
+
+template <bool kApprox>
+inline Vec VecExpReal(Vec x) {
+    Vec n = RoundToInt(x * Vec::Set1(kLog2e));
+    Vec r = (x - n * Vec::Set1(kLn2Hi)) - n * Vec::Set1(kLn2Lo);
+    Vec p = r * r * Horner(r, kExpTaylor, kApprox ? 7 : 12);
+    return (Vec::Set1(1.0) + (r + p)) * Pow2(n);
+}
+
+// log(hi + lo) для нормального hi > 0 и |lo| << hi: hi = m * 2^k с m в
+// [sqrt(1/2), sqrt(2)), log m = log1p(f) — ядро __ieee754_log из fdlibm
+// (погрешность < 1 ULP), вклад lo — поправкой lo / hi. Укороченный режим
+// берёт первые четыре члена ряда (абсолютная погрешность ~1e-9).
+const double kLog[7] = {6.666666666666735130e-01, 3.999999999940941908e-01, 2.857142874366239149e-01,
+                        2.222219843214978396e-01, 1.818357216161805012e-01, 1.531383769920937332e-01,
+                        1.479819860511658591e-01};
+
+template <bool kApprox>
+inline Vec VecLog(Vec hi, Vec lo) {
+    Vec one = Vec::Set1(1.0);
+    Vec k = Exponent(hi), m = Mantissa(hi);
+    Vec sqrt2 = Vec::Set1(1.41421356237309504880);
+    k = SelectGreater(m, sqrt2, k + one, k);
+    m = SelectGreater(m, sqrt2, m * Vec::Set1(0.5), m);
+    Vec f = m - one;
+    Vec s = f / (Vec::Set1(2.0) + f);
+    Vec z = s * s;
+    Vec R;
+    if (kApprox) {
+        R = z * Horner(z, kLog, 4);
+    } else {
+        Vec w = z * z;
+        Vec odd = Vec::Set1(kLog[0]) + w * (Vec::Set1(kLog[2]) + w * (Vec::Set1(kLog[4]) + w * Vec::Set1(kLog[6])));
+        Vec even = Vec::Set1(kLog[1]) + w * (Vec::Set1(kLog[3]) + w * Vec::Set1(kLog[5]));
+        R = z * odd + w * even;
+    }
+    Vec hfsq = Vec::Set1(0.5) * f * f;
+    Vec low = k * Vec::Set1(kLn2Lo) + lo / hi;
+    return k * Vec::Set1(kLn2Hi) - ((hfsq - (s * (hfsq + R) + low)) - f);
+}
+
+// atan2 через atan из Cephes: |y|, |x| сводятся к t = min/max в [0, 1], при
+// t > 0.66 — к (t - 1) / (t + 1) со сдвигом pi/4; рациональная функция на
+// приведённом отрезке даёт < 1 ULP. Четверти — через pi/2 - a и pi - a с
+// младшими частями pi. Укороченный режим сводит к |t| <= tan(pi/8) и берёт
+// многочлен t + t^3 P(t^2) степени 4 по P (интерполяция в узлах Чебышёва):
+// отн. погрешность ~2.5e-9 и одно деление вместо двух.
+const double kAtanP[5] = {-6.485021904942025371773e+01, -1.228866684490136173410e+02, -7.500855792314704667340e+01,
+                          -1.615753718733365076637e+01, -8.750608600031904122785e-01};
+const double kAtanQ[6] = {1.945506571482613964425e+02, 4.853903996359136964868e+02, 4.328810604912902668951e+02,
+                          1.650270098316988542046e+02, 2.485846490142306297962e+01, 1.0};
+const double kAtanApprox[5] = {-3.333333176116627e-01, 1.9999540483500663e-01, -1.4263955595225722e-01,
+                              1.0743731471263171e-01, -6.451928161196320e-02};
+const double kTanPio8 = 4.14213562373095048802e-01;
+const double kPio4 = 7.85398163397448278999e-01;
+const double kPio2 = 1.57079632679489655800e+00;
+const double kPi = 3.14159265358979311600e+00;
+const double kPio2Tail = 6.123233995736765886130e-17;
+
+template <bool kApprox>
+inline Vec VecAtan2(Vec y, Vec x) {
+    Vec zero = Vec::Set1(0.0);
+    Vec ax = Abs(x), ay = Abs(y);
+    Vec mx = Max(ax, ay), mn = Min(ax, ay);
+    Vec bound = mx * Vec::Set1(kApprox ? kTanPio8 : 0.66);
+    Vec t = SelectGreater(mn, bound, mn - mx, mn) / SelectGreater(mn, bound, mn + mx, mx);
+    t = SelectGreater(mx, zero, t, zero);
+    Vec z = t * t;
+    Vec a = kApprox ? MulAdd(t, z * Horner(z, kAtanApprox, 5), t)
+                    : MulAdd(t, z * Horner(z, kAtanP, 5) / Horner(z, kAtanQ, 6), t);
+    a = SelectGreater(mn, bound, Vec::Set1(kPio4) + (a + Vec::Set1(kPio2Tail / 2)), a);
+    a = SelectGreater(ay, ax, (Vec::Set1(kPio2) - a) + Vec::Set1(kPio2Tail), a);
+    a = SelectGreater(zero, CopySign(Vec::Set1(1.0), x), (Vec::Set1(kPi) - a) + Vec::Set1(2 * kPio2Tail), a);
+    return CopySign(a, y);
+}
+
+/**
+ * max(|x|, |y|), равный NaN при NaN в любой части: maxpd при NaN возвращает
+ * второй операнд, поэтому NaN в x добавляется через x - x.
+ */
+inline Vec MaxAbs(Vec x, Vec y) {
+    return Max(Abs(x), Abs(y)) + (x - x);
+}
+
+/** Диапазон атан2 без потери точности в min/max и без inf/NaN */
+inline bool Atan2InRange(Vec y, Vec x) {
+    Vec mx = MaxAbs(x, y);
+    return AllInRangeOrZero(mx, Vec::Set1(DBL_MIN), Vec::Set1(DBL_MAX), mx);
+}
+
+// Скалярные ветви — повтор функций из complexmath.h для double.
+void ScalarArg(double x, double y, double& u, double& v) {
+    u = atan2(y, x);
+    v = 0;
+}
+
+void ScalarPolar(double r, double t, double& u, double& v) {
+    u = r * cos(t);
+    v = r * sin(t);
+}
+
+void ScalarExp(double x, double y, double& u, double& v) {
+    if (y == 0) {
+        u = exp(x);
+        v = y;
+    } else if (isinf(x) && !isfinite(y)) {
+        u = x < 0 ? 0.0 : x;
+        v = x < 0 ? copysign(0.0, y) : y - y;
+    } else if (isinf(exp(x)) && isfinite(x)) {
+        double half = exp(x / 2);
+        u = half * cos(y) * half;
+        v = half * sin(y) * half;
+    } else {
+        double e = exp(x);
+        u = e * cos(y);
+        v = e * sin(y);
+    }
+}
+
+void ScalarLog(double x, double y, double& u, double& v) {
+    double s = x * x + y * y;
+    if (s > 0.25 && s < 4) {
+        // Сумма пяти слагаемых как AccurateSum из complexmath.h (SumK, K = 3).
+        double xx = x * x, yy = y * y;
+        double p[5] = {ProductError(x, x, xx), ProductError(y, y, yy), yy, -1.0, xx};
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int i = 1; i < 5; ++i) {
+                TwoSum(p[i], p[i - 1], p[i], p[i - 1]);
+            }
+        }
+        u = log1p((((p[0] + p[1]) + p[2]) + p[3]) + p[4]) / 2;
+    } else if (s >= DBL_MIN && s <= DBL_MAX) {
+        u = log(s) / 2;
+    } else if (isfinite(x) && isfinite(y) && (x != 0 || y != 0)) {
+        double scale = s > 1 ? 0x1p-600 : 0x1p600;
+        u = log(SafeAbs(x * scale, y * scale)) - log(scale);
+    } else {
+        u = log(SafeAbs(x, y));
+    }
+    v = atan2(y, x);
+}
+
+void ScalarSqrt(double x, double y, double& u, double& v) {
+    if (isinf(y)) {
+        u = HUGE_VAL;
+        v = y;
+        return;
+    }
+    if (isinf(x)) {
+        u = x > 0 ? x : isnan(y) ? y : 0.0;
+        v = x > 0 ? (isnan(y) ? y : copysign(0.0, y)) : copysign(HUGE_VAL, y);
+        return;
+    }
+    if (isnan(x) || isnan(y)) {
+        u = v = x + y;
+        return;
+    }
+    if (x == 0 && y == 0) {
+        u = 0;
+        v = y;
+        return;
+    }
+    double ax = fabs(x), ay = fabs(y);
+    double scale = 1;
+    if (ax > DBL_MAX / 4 || ay > DBL_MAX / 4) {
+        ax /= 4;
+        ay /= 4;
+        scale = 2;
+    } else if (ax < kDivLow && ay < kDivLow) {
+        ax *= 0x1p600;
+        ay *= 0x1p600;
+        scale = 0x1p-300;
+    }
+    double t = sqrt((ax + SafeAbs(ax, ay)) / 2);
+    double a = t * scale, b = ay / (2 * t) * scale;
+    u = x >= 0 ? a : b;
+    v = copysign(x >= 0 ? b : a, y);
+}
+
+void ScalarPow(double x, double y, double p, double& u, double& v) {
+    if (p == 0) {
+        u = 1;
+        v = 0;
+    } else {
+        ScalarPolar(pow(SafeAbs(x, y), p), p * atan2(y, x), u, v);
+    }
+}
+
+void ScalarRotate(double x, double y, double t, double& u, double& v) {
+    double c = cos(t), s = sin(t);
+    u = x * c - y * s;
+    v = x * s + y * c;
+}
+
+template <bool kApprox>
+inline bool VecPolar(Vec r, Vec t, Vec& u, Vec& v) {
+    Vec s, c;
+    VecSinCos<kApprox>(t, s, c);
+    u = r * c;
+    v = r * s;
+    return AllWithin(t, kSinCosMax);
+}
+
+template <bool kApprox>
+inline bool VecExp(Vec x, Vec y, Vec& u, Vec& v) {
+    Vec s, c;
+    VecSinCos<kApprox>(y, s, c);
+    Vec e = VecExpReal<kApprox>(x);
+    u = e * c;
+    v = e * s;
+    return AllWithin(x, kExpMax) && AllWithin(y, kSinCosMax);
+}
+
+// log|z| = log(x^2 + y^2) / 2, где x^2 + y^2 = hi + lo без ошибок округления,
+// поэтому и около |z| = 1 погрешность относительная.
+template <bool kApprox>
+inline bool VecLogParts(Vec x, Vec y, Vec& u, Vec& v) {
+    Vec xx = x * x, yy = y * y;
+    Vec hi, lo;
+    TwoSum(xx, yy, hi, lo);
+    lo = lo + ProductError(x, x, xx) + ProductError(y, y, yy);
+    u = Vec::Set1(0.5) * VecLog<kApprox>(hi, lo);
+    v = VecAtan2<false>(y, x);
+    Vec mx = MaxAbs(x, y);
+    // При |z| -> 1 ошибка самого lo (~2^-106) сравнима с log|z|; такие блоки
+    // полной точности считаются скалярно, через точную сумму.
+    Vec one = Vec::Set1(1.0);
+    bool farFromOne = kApprox || AllInRangeOrZero(Abs(hi - one), Vec::Set1(0x1p-48), Vec::Set1(DBL_MAX), one);
+    return AllInRangeOrZero(mx, Vec::Set1(0x1p-480), Vec::Set1(0x1p500), one) && farFromOne;
+}
+
+template <bool kApprox>
+inline bool VecArg(Vec x, Vec y, Vec& u, Vec& v) {
+    u = VecAtan2<kApprox>(y, x);
+    v = u;
+    return Atan2InRange(y, x);
+}
+
+// Корень по Кэхэну, как Sqrt из complexmath.h, без масштабирования.
+inline bool VecSqrt(Vec x, Vec y, Vec& u, Vec& v) {
+    Vec zero = Vec::Set1(0.0);
+    Vec ax = Abs(x), ay = Abs(y);
+    Vec t = Sqrt((ax + Sqrt(ax * ax + ay * ay)) * Vec::Set1(0.5));
+    Vec d = SelectGreater(t, zero, ay / (t + t), zero);
+    u = SelectGreater(zero, x, d, t);
+    v = CopySign(SelectGreater(zero, x, t, d), y);
+    Vec mx = MaxAbs(x, y);
+    return AllInRangeOrZero(mx, Vec::Set1(0x1p-500), Vec::Set1(0x1p500), mx);
+}
+
+// z^p = e^(p * Log z): ошибка log|z| умножается на |p * log|z||.
+template <bool kApprox>
+inline bool VecPow(Vec x, Vec y, Vec p, Vec& u, Vec& v) {
+    Vec l, a;
+    bool ok = VecLogParts<kApprox>(x, y, l, a);
+    return VecExp<kApprox>(p * l, p * a, u, v) && ok;
+}
+
+template <class In, class Out>
+void ArgBody(In in, Out out, size_t n, bool approx) {
+    if (approx) {
+        MapComplex(in, out, n, VecArg<true>, ScalarArg);
+    } else {
+        MapComplex(in, out, n, VecArg<false>, ScalarArg);
+    }
+}
+
+void ArgKernel(const double* ar, const double* ai, double* out, size_t n, bool approx) {
+    ArgBody(SplitData{ar, ai}, RealOut{out}, n, approx);
+}
+
+void ArgInterleavedKernel(const double* z, double* out, size_t n, bool approx) {
+    ArgBody(InterleavedData{z}, RealOut{out}, n, approx);
+}
+
+// Модуль и аргумент за один проход: корень суммы квадратов (как AbsKernel)
+// и atan2; регистр с суммой вне нормального диапазона — скалярно.
+template <bool kApprox>
+inline bool VecToPolar(Vec x, Vec y, Vec& u, Vec& v) {
+    Vec sum = x * x + y * y;
+    u = Sqrt(sum);
+    v = VecAtan2<kApprox>(y, x);
+    Vec mx = MaxAbs(x, y);
+    return AllInRangeOrZero(sum, Vec::Set1(DBL_MIN), Vec::Set1(DBL_MAX), mx) && Atan2InRange(y, x);
+}
+
+void ScalarToPolar(double x, double y, double& u, double& v) {
+    u = SafeAbs(x, y);
+    v = atan2(y, x);
+}
+
+void ToPolarInterleavedKernel(const double* z, double* r, double* theta, size_t n, bool approx) {
+    if (approx) {
+        MapComplex(InterleavedData{z}, SplitOut{r, theta}, n, VecToPolar<true>, ScalarToPolar);
+    } else {
+        MapComplex(InterleavedData{z}, SplitOut{r, theta}, n, VecToPolar<false>, ScalarToPolar);
+    }
+}
+
+template <class In, class Out>
+void PolarBody(In in, Out out, size_t n, bool approx) {
+    if (approx) {
+        MapComplex(in, out, n, VecPolar<true>, ScalarPolar);
+    } else {
+        MapComplex(in, out, n, VecPolar<false>, ScalarPolar);
+    }
+}
+
+void PolarKernel(const double* r, const double* t, double* cr, double* ci, size_t n, bool approx) {
+    if (r) {
+        PolarBody(SplitData{r, t}, SplitOut{cr, ci}, n, approx);
+    } else {
+        PolarBody(UnitPolarData{t}, SplitOut{cr, ci}, n, approx);
+    }
+}
+
+void PolarInterleavedKernel(const double* r, const double* t, double* out, size_t n, bool approx) {
+    if (r) {
+        PolarBody(SplitData{r, t}, InterleavedOut{out}, n, approx);
+    } else {
+        PolarBody(UnitPolarData{t}, InterleavedOut{out}, n, approx);
+    }
+}
+
+// Поворот фазы a * e^(i t): sin/cos и умножение без FMA, как operator*.
+template <bool kApprox, class In, class Out>
+void RotateLoop(In in, const double* t, Out out, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec x, y, s, c;
+        in.Load(i, x, y);
+        Vec phase = Vec::Load(t + i);
+        VecSinCos<kApprox>(phase, s, c);
+        if (AllWithin(phase, kSinCosMax)) {
+            out.Store(i, x * c - y * s, x * s + y * c);
+        } else {
+            for (size_t j = i; j < i + Vec::kWidth; ++j) {
+                double u, v;
+                ScalarRotate(in.Re(j), in.Im(j), t[j], u, v);
+                out.Set(j, u, v);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        double u, v;
+        ScalarRotate(in.Re(i), in.Im(i), t[i], u, v);
+        out.Set(i, u, v);
+    }
+}
+
+void RotateKernel(const double* ar, const double* ai, const double* t, double* cr, double* ci, size_t n,
+                  bool approx) {
+    if (approx) {
+        RotateLoop<true>(SplitData{ar, ai}, t, SplitOut{cr, ci}, n);
+    } else {
+        RotateLoop<false>(SplitData{ar, ai}, t, SplitOut{cr, ci}, n);
+    }
+}
+
+void RotateInterleavedKernel(const double* z, const double* t, double* out, size_t n, bool approx) {
+    if (approx) {
+        RotateLoop<true>(InterleavedData{z}, t, InterleavedOut{out}, n);
+    } else {
+        RotateLoop<false>(InterleavedData{z}, t, InterleavedOut{out}, n);
+    }
+}
+
+template <class In, class Out>
+void ExpBody(In in, Out out, size_t n, bool approx) {
+    if (approx) {
+        MapComplex(in, out, n, VecExp<true>, ScalarExp);
+    } else {
+        MapComplex(in, out, n, VecExp<false>, ScalarExp);
+    }
+}
+
+void ExpKernel(const double* ar, const double* ai, double* cr, double* ci, size_t n, bool approx) {
+    ExpBody(SplitData{ar, ai}, SplitOut{cr, ci}, n, approx);
+}
+
+void ExpInterleavedKernel(const double* z, double* out, size_t n, bool approx) {
+    ExpBody(InterleavedData{z}, InterleavedOut{out}, n, approx);
+}
+
+template <class In, class Out>
+void LogBody(In in, Out out, size_t n, bool approx) {
+    if (approx) {
+        MapComplex(in, out, n, VecLogParts<true>, ScalarLog);
+    } else {
+        MapComplex(in, out, n, VecLogParts<false>, ScalarLog);
+    }
+}
+
+void LogKernel(const double* ar, const double* ai, double* cr, double* ci, size_t n, bool approx) {
+    LogBody(SplitData{ar, ai}, SplitOut{cr, ci}, n, approx);
+}
+
+void LogInterleavedKernel(const double* z, double* out, size_t n, bool approx) {
+    LogBody(InterleavedData{z}, InterleavedOut{out}, n, approx);
+}
+
+void SqrtKernel(const double* ar, const double* ai, double* cr, double* ci, size_t n) {
+    MapComplex(SplitData{ar, ai}, SplitOut{cr, ci}, n, VecSqrt, ScalarSqrt);
+}
+
+void SqrtInterleavedKernel(const double* z, double* out, size_t n) {
+    MapComplex(InterleavedData{z}, InterleavedOut{out}, n, VecSqrt, ScalarSqrt);
+}
+
+template <bool kApprox, class In, class Out>
+void PowLoop(In in, double p, Out out, size_t n) {
+    Vec vp = Vec::Set1(p);
+    MapComplex(
+        in, out, n, [=](Vec x, Vec y, Vec& u, Vec& v) { return VecPow<kApprox>(x, y, vp, u, v); },
+        [=](double x, double y, double& u, double& v) { ScalarPow(x, y, p, u, v); });
+}
+
+void PowKernel(const double* ar, const double* ai, double p, double* cr, double* ci, size_t n, bool approx) {
+    if (approx) {
+        PowLoop<true>(SplitData{ar, ai}, p, SplitOut{cr, ci}, n);
+    } else {
+        PowLoop<false>(SplitData{ar, ai}, p, SplitOut{cr, ci}, n);
+    }
+}
+
+void PowInterleavedKernel(const double* z, double p, double* out, size_t n, bool approx) {
+    if (approx) {
+        PowLoop<true>(InterleavedData{z}, p, InterleavedOut{out}, n);
+    } else {
+        PowLoop<false>(InterleavedData{z}, p, InterleavedOut{out}, n);
+    }
+}
+
+// Матричные ядра (matrix.cpp). Панели упакованы так, что на каждом шаге по
+// общему измерению k ядро читает подряд: из A — части kGemmRows строк
+// (сначала все re, потом все im), из B — части Vec::kWidth столбцов.
+
+/** Шаг 4M-микроядра для одной строки плитки */
+inline void GemmRowStep(double ar, double ai, Vec br, Vec bi, Vec nbi, Vec& cr, Vec& ci) {
+    Vec xr = Vec::Set1(ar), xi = Vec::Set1(ai);
+    cr = MulAdd(xi, nbi, MulAdd(xr, br, cr));
+    ci = MulAdd(xi, br, MulAdd(xr, bi, ci));
+}
+
+// Плитка kGemmRows x kWidth: 8 аккумуляторов (re и im на строку), B — два
+// регистра на шаг, -Im(B) считается один раз на все строки.
+void GemmTileKernel(size_t k, const double* a, const double* b, double* cr, double* ci) {
+    static_assert(kGemmRows == 4, "микроядро развёрнуто на 4 строки");
+    Vec zero = Vec::Set1(0.0);
+    Vec r0 = zero, r1 = zero, r2 = zero, r3 = zero;
+    Vec i0 = zero, i1 = zero, i2 = zero, i3 = zero;
+    for (size_t p = 0; p < k; ++p, a += 2 * kGemmRows, b += 2 * Vec::kWidth) {
+        Vec br = Vec::Load(b), bi = Vec::Load(b + Vec::kWidth), nbi = Neg(bi);
+        GemmRowStep(a[0], a[4], br, bi, nbi, r0, i0);
+        GemmRowStep(a[1], a[5], br, bi, nbi, r1, i1);
+        GemmRowStep(a[2], a[6], br, bi, nbi, r2, i2);
+        GemmRowStep(a[3], a[7], br, bi, nbi, r3, i3);
+    }
+    const size_t w = Vec::kWidth;
+    r0.Store(cr);
+    r1.Store(cr + w);
+    r2.Store(cr + 2 * w);
+    r3.Store(cr + 3 * w);
+    i0.Store(ci);
+    i1.Store(ci + w);
+    i2.Store(ci + 2 * w);
+    i3.Store(ci + 3 * w);
+}
+
+// Вещественная плитка для 3M: kRealRows x 2 kWidth. На AVX-512 (32
+// регистра) — 8 строк и 16 аккумуляторов, иначе 4 строки и 8: одна загрузка
+// множителя из A на два FMA, и задержка FMA не простаивает.
+const size_t kGemmRealTileRows = Vec::kWidth == 8 ? 8 : 4;
+
+inline void GemmRealRowStep(double a, Vec x, Vec y, Vec& c0, Vec& c1) {
+    Vec s = Vec::Set1(a);
+    c0 = MulAdd(s, x, c0);
+    c1 = MulAdd(s, y, c1);
+}
+
+void GemmTileRealKernel(size_t k, const double* a, const double* b, double* c) {
+    const size_t w = Vec::kWidth, rows = kGemmRealTileRows;
+    Vec zero = Vec::Set1(0.0);
+    Vec c0 = zero, c1 = zero, c2 = zero, c3 = zero, c4 = zero, c5 = zero, c6 = zero, c7 = zero;
+    Vec c8 = zero, c9 = zero, c10 = zero, c11 = zero, c12 = zero, c13 = zero, c14 = zero, c15 = zero;
+    for (size_t p = 0; p < k; ++p, a += rows, b += 2 * w) {
+        Vec x = Vec::Load(b), y = Vec::Load(b + w);
+        GemmRealRowStep(a[0], x, y, c0, c1);
+        GemmRealRowStep(a[1], x, y, c2, c3);
+        GemmRealRowStep(a[2], x, y, c4, c5);
+        GemmRealRowStep(a[3], x, y, c6, c7);
+        if (rows == 8) {
+            GemmRealRowStep(a[4], x, y, c8, c9);
+            GemmRealRowStep(a[5], x, y, c10, c11);
+            GemmRealRowStep(a[6], x, y, c12, c13);
+            GemmRealRowStep(a[7], x, y, c14, c15);
+        }
+    }
+    c0.Store(c);
+    c1.Store(c + w);
+    c2.Store(c + 2 * w);
+    c3.Store(c + 3 * w);
+    c4.Store(c + 4 * w);
+    c5.Store(c + 5 * w);
+    c6.Store(c + 6 * w);
+    c7.Store(c + 7 * w);
+    if (rows == 8) {
+        c8.Store(c + 8 * w);
+        c9.Store(c + 9 * w);
+        c10.Store(c + 10 * w);
+        c11.Store(c + 11 * w);
+        c12.Store(c + 12 * w);
+        c13.Store(c + 13 * w);
+        c14.Store(c + 14 * w);
+        c15.Store(c + 15 * w);
+    }
+}
+
+// Пакет малых матриц: элемент (i, j) матрицы t лежит в x[(i * cols + j) *
+// stride + t], поэтому kWidth матриц подряд — один векторный регистр, и
+// каждая матрица считается целиком в своей дорожке без перестановок.
+
+/** Шаг 4M для одного элемента пакета: s += x * y */
+inline void GemmBatchStep(Vec xr, Vec xi, Vec nxi, Vec yr, Vec yi, Vec& sr, Vec& si) {
+    sr = MulAdd(nxi, yi, MulAdd(xr, yr, sr));
+    si = MulAdd(xi, yr, MulAdd(xr, yi, si));
+}
+
+/** Элемент (i, j) для kWidth матриц от t */
+inline void GemmBatchElement(size_t i, size_t j, size_t k, size_t n, const double* ar, const double* ai,
+                             const double* br, const double* bi, double* cr, double* ci, size_t stride, size_t t) {
+    Vec sr = Vec::Set1(0.0), si = sr;
+    for (size_t p = 0; p < k; ++p) {
+        size_t x = (i * k + p) * stride + t, y = (p * n + j) * stride + t;
+        Vec xi = Vec::Load(ai + x);
+        GemmBatchStep(Vec::Load(ar + x), xi, Neg(xi), Vec::Load(br + y), Vec::Load(bi + y), sr, si);
+    }
+    sr.Store(cr + (i * n + j) * stride + t);
+    si.Store(ci + (i * n + j) * stride + t);
+}
+
+/**
+ * @brief Блок 2 x 2 от (i, j) для kWidth матриц от t: на шаге 8 загрузок
+ * на 16 умножений со сложением вместо 4 на 4 у отдельного элемента.
+ */
+inline void GemmBatchQuad(size_t i, size_t j, size_t k, size_t n, const double* ar, const double* ai,
+                          const double* br, const double* bi, double* cr, double* ci, size_t stride, size_t t) {
+    Vec zero = Vec::Set1(0.0);
+    Vec r00 = zero, i00 = zero, r01 = zero, i01 = zero, r10 = zero, i10 = zero, r11 = zero, i11 = zero;
+    const size_t rowA = k * stride;
+    for (size_t p = 0; p < k; ++p) {
+        size_t x = (i * k + p) * stride + t, y = (p * n + j) * stride + t;
+        Vec xr0 = Vec::Load(ar + x), xi0 = Vec::Load(ai + x), nxi0 = Neg(xi0);
+        Vec xr1 = Vec::Load(ar + x + rowA), xi1 = Vec::Load(ai + x + rowA), nxi1 = Neg(xi1);
+        Vec yr0 = Vec::Load(br + y), yi0 = Vec::Load(bi + y);
+        Vec yr1 = Vec::Load(br + y + stride), yi1 = Vec::Load(bi + y + stride);
+        GemmBatchStep(xr0, xi0, nxi0, yr0, yi0, r00, i00);
+        GemmBatchStep(xr0, xi0, nxi0, yr1, yi1, r01, i01);
+        GemmBatchStep(xr1, xi1, nxi1, yr0, yi0, r10, i10);
+        GemmBatchStep(xr1, xi1, nxi1, yr1, yi1, r11, i11);
+    }
+    size_t z = (i * n + j) * stride + t, rowC = n * stride;
+    r00.Store(cr + z);
+    i00.Store(ci + z);
+    r01.Store(cr + z + stride);
+    i01.Store(ci + z + stride);
+    r10.Store(cr + z + rowC);
+    i10.Store(ci + z + rowC);
+    r11.Store(cr + z + rowC + stride);
+    i11.Store(ci + z + rowC + stride);
+}
+
+void GemmBatchKernel(size_t m, size_t k, size_t n, const double* ar, const double* ai, const double* br,
+                     const double* bi, double* cr, double* ci, size_t stride, size_t count) {
+    size_t t = 0;
+    for (; t + Vec::kWidth <= count; t += Vec::kWidth) {
+        size_t i = 0;
+        for (; i + 2 <= m; i += 2) {
+            size_t j = 0;
+            for (; j + 2 <= n; j += 2) {
+                GemmBatchQuad(i, j, k, n, ar, ai, br, bi, cr, ci, stride, t);
+            }
+            if (j < n) {
+                GemmBatchElement(i, j, k, n, ar, ai, br, bi, cr, ci, stride, t);
+                GemmBatchElement(i + 1, j, k, n, ar, ai, br, bi, cr, ci, stride, t);
+            }
+        }
+        if (i < m) {
+            for (size_t j = 0; j < n; ++j) {
+                GemmBatchElement(i, j, k, n, ar, ai, br, bi, cr, ci, stride, t);
+            }
+        }
+    }
+    for (; t < count; ++t) {
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double sr = 0, si = 0;
+                for (size_t p = 0; p < k; ++p) {
+                    size_t x = (i * k + p) * stride + t, y = (p * n + j) * stride + t;
+                    sr = ScalarMulAdd(-ai[x], bi[y], ScalarMulAdd(ar[x], br[y], sr));
+                    si = ScalarMulAdd(ai[x], br[y], ScalarMulAdd(ar[x], bi[y], si));
+                }
+                cr[(i * n + j) * stride + t] = sr;
+                ci[(i * n + j) * stride + t] = si;
+            }
+        }
+    }
+}
+
+// Этап radix-4 БПФ (fft.cpp). Бабочки этапа с разными k независимы, поэтому
+// при h >= kWidth соседние kWidth бабочек считаются в дорожках регистров;
+// на малых h (первые этапы) — скалярно. Умножение на множитель — в порядке
+// Complex::operator* и без FMA: результат не зависит от уровня инструкций.
+
+inline void FftTwiddle(Vec xr, Vec xi, Vec wr, Vec wi, Vec& yr, Vec& yi) {
+    yr = xr * wr - xi * wi;
+    yi = xr * wi + xi * wr;
+}
+
+inline void FftTwiddle(double xr, double xi, double wr, double wi, double& yr, double& yi) {
+    yr = xr * wr - xi * wi;
+    yi = xr * wi + xi * wr;
+}
+
+// Бабочка над x[k], x[k + h], x[k + 2h], x[k + 3h] (T — Vec или double).
+// В бит-реверсном порядке подпоследовательности x[4m + r] лежат в блоке в
+// порядке r = 0, 2, 1, 3; d13 умножается на -i (прямое) или +i (обратное).
+template <bool kInverse, class T>
+inline void FftButterfly(T a0r, T a0i, T x1r, T x1i, T x2r, T x2i, T x3r, T x3i, T w1r, T w1i, T w2r, T w2i,
+                         T w3r, T w3i, T& y0r, T& y0i, T& y1r, T& y1i, T& y2r, T& y2i, T& y3r, T& y3i) {
+    T a1r, a1i, a2r, a2i, a3r, a3i;
+    FftTwiddle(x2r, x2i, w1r, w1i, a1r, a1i);
+    FftTwiddle(x1r, x1i, w2r, w2i, a2r, a2i);
+    FftTwiddle(x3r, x3i, w3r, w3i, a3r, a3i);
+    T s02r = a0r + a2r, s02i = a0i + a2i, d02r = a0r - a2r, d02i = a0i - a2i;
+    T s13r = a1r + a3r, s13i = a1i + a3i, d13r = a1r - a3r, d13i = a1i - a3i;
+    y0r = s02r + s13r;
+    y0i = s02i + s13i;
+    y2r = s02r - s13r;
+    y2i = s02i - s13i;
+    if (kInverse) {
+        y1r = d02r - d13i;
+        y1i = d02i + d13r;
+        y3r = d02r + d13i;
+        y3i = d02i - d13r;
+    } else {
+        y1r = d02r + d13i;
+        y1i = d02i - d13r;
+        y3r = d02r - d13i;
+        y3i = d02i + d13r;
+    }
+}
+
+template <bool kInverse>
+void FftRadix4Butterflies(double* data, size_t n, size_t h, const double* w) {
+    const double* w1r = w;
+    const double* w1i = w + h;
+    const double* w2r = w + 2 * h;
+    const double* w2i = w + 3 * h;
+    const double* w3r = w + 4 * h;
+    const double* w3i = w + 5 * h;
+    for (size_t j = 0; j < n; j += 4 * h) {
+        double* x0 = data + 2 * j;
+        double* x1 = x0 + 2 * h;
+        double* x2 = x1 + 2 * h;
+        double* x3 = x2 + 2 * h;
+        size_t k = 0;
+        if (h >= Vec::kWidth) {
+            for (; k < h; k += Vec::kWidth) {
+                Vec vw1i = Vec::Load(w1i + k), vw2i = Vec::Load(w2i + k), vw3i = Vec::Load(w3i + k);
+                if (kInverse) {
+                    vw1i = Neg(vw1i);
+                    vw2i = Neg(vw2i);
+                    vw3i = Neg(vw3i);
+                }
+                Vec a0r, a0i, x1r, x1i, x2r, x2i, x3r, x3i;
+                Vec::LoadInterleaved(x0 + 2 * k, a0r, a0i);
+                Vec::LoadInterleaved(x1 + 2 * k, x1r, x1i);
+                Vec::LoadInterleaved(x2 + 2 * k, x2r, x2i);
+                Vec::LoadInterleaved(x3 + 2 * k, x3r, x3i);
+                FftButterfly<kInverse>(a0r, a0i, x1r, x1i, x2r, x2i, x3r, x3i, Vec::Load(w1r + k), vw1i,
+                                       Vec::Load(w2r + k), vw2i, Vec::Load(w3r + k), vw3i, a0r, a0i, x1r, x1i,
+                                       x2r, x2i, x3r, x3i);
+                Vec::StoreInterleaved(x0 + 2 * k, a0r, a0i);
+                Vec::StoreInterleaved(x1 + 2 * k, x1r, x1i);
+                Vec::StoreInterleaved(x2 + 2 * k, x2r, x2i);
+                Vec::StoreInterleaved(x3 + 2 * k, x3r, x3i);
+            }
+        }
+        for (; k < h; ++k) {
+            FftButterfly<kInverse>(x0[2 * k], x0[2 * k + 1], x1[2 * k], x1[2 * k + 1], x2[2 * k], x2[2 * k + 1],
+                                   x3[2 * k], x3[2 * k + 1], w1r[k], kInverse ? -w1i[k] : w1i[k], w2r[k],
+                                   kInverse ? -w2i[k] : w2i[k], w3r[k], kInverse ? -w3i[k] : w3i[k], x0[2 * k],
+                                   x0[2 * k + 1], x1[2 * k], x1[2 * k + 1], x2[2 * k], x2[2 * k + 1], x3[2 * k],
+                                   x3[2 * k + 1]);
+        }
+    }
+}
+
+void FftRadix4StageKernel(double* data, size_t n, size_t h, const double* w, bool inverse) {
+    if (inverse) {
+        FftRadix4Butterflies<true>(data, n, h, w);
+    } else {
+        FftRadix4Butterflies<false>(data, n, h, w);
+    }
+}
+
+// Многочлены (polynomial.cpp). Коэффициенты c[0..count) — пары (re, im),
+// c[0] — свободный член. Разные точки идут по дорожкам регистров, поэтому
+// шаг Горнера — четыре FMA на точку без перестановок внутри регистра.
+
+// a = a * z + (cr + i*ci); nzi = -zi
+inline void PolyStep(Vec zr, Vec zi, Vec nzi, Vec cr, Vec ci, Vec& ar, Vec& ai) {
+    Vec r = MulAdd(ar, zr, MulAdd(ai, nzi, cr));
+    ai = MulAdd(ar, zi, MulAdd(ai, zr, ci));
+    ar = r;
+}
+
+// Горнер по двум регистрам точек сразу: две независимые цепочки FMA. При
+// kDerivative рядом считается производная: d = d * z + a до шага a.
+template <bool kDerivative>
+void PolyHornerBlock(const double* c, size_t count, const double* z, double* p, double* dp) {
+    Vec zr0, zi0, zr1, zi1;
+    Vec::LoadInterleaved(z, zr0, zi0);
+    Vec::LoadInterleaved(z + 2 * Vec::kWidth, zr1, zi1);
+    Vec nzi0 = Neg(zi0), nzi1 = Neg(zi1);
+    Vec ar0 = Vec::Set1(c[2 * count - 2]), ai0 = Vec::Set1(c[2 * count - 1]);
+    Vec ar1 = ar0, ai1 = ai0;
+    Vec dr0 = Vec::Set1(0.0), di0 = dr0, dr1 = dr0, di1 = dr0;
+    for (size_t k = count - 1; k-- > 0;) {
+        if (kDerivative) {
+            PolyStep(zr0, zi0, nzi0, ar0, ai0, dr0, di0);
+            PolyStep(zr1, zi1, nzi1, ar1, ai1, dr1, di1);
+        }
+        Vec cr = Vec::Set1(c[2 * k]), ci = Vec::Set1(c[2 * k + 1]);
+        PolyStep(zr0, zi0, nzi0, cr, ci, ar0, ai0);
+        PolyStep(zr1, zi1, nzi1, cr, ci, ar1, ai1);
+    }
+    Vec::StoreInterleaved(p, ar0, ai0);
+    Vec::StoreInterleaved(p + 2 * Vec::kWidth, ar1, ai1);
+    if (kDerivative) {
+        Vec::StoreInterleaved(dp, dr0, di0);
+        Vec::StoreInterleaved(dp + 2 * Vec::kWidth, dr1, di1);
+    }
+}
+
+// Схема Эстрина по одному регистру точек: q_k = c_2k + c_2k+1 z, затем
+// попарно q + z^2 q', (..) + z^4 (..) и т. д. — цепочка зависимостей
+// длины log2(count) вместо count. Поддеревья собираются двоичным счётчиком:
+// узлы равного уровня l (2^(l+1) коэффициентов) сливаются как
+// левый + z^(2^(l+1)) * правый; степени z^(2^l) считаются по мере надобности.
+const size_t kPolyEstrinLevels = 64;
+
+inline void PolyMulAdd(Vec xr, Vec xi, Vec yr, Vec yi, Vec& ar, Vec& ai) {
+    Vec r = MulAdd(xr, yr, MulAdd(Neg(xi), yi, ar));
+    ai = MulAdd(xr, yi, MulAdd(xi, yr, ai));
+    ar = r;
+}
+
+void PolyEstrinVector(const double* c, size_t count, const double* z, double* p) {
+    Vec powR[kPolyEstrinLevels], powI[kPolyEstrinLevels];
+    Vec nodeR[kPolyEstrinLevels], nodeI[kPolyEstrinLevels];
+    size_t nodeLevel[kPolyEstrinLevels];
+    Vec::LoadInterleaved(z, powR[0], powI[0]);
+    size_t powers = 1, top = 0;
+    for (size_t k = 0; k + 1 < count; k += 2) {
+        Vec r = Vec::Set1(c[2 * k]), i = Vec::Set1(c[2 * k + 1]);
+        PolyMulAdd(Vec::Set1(c[2 * k + 2]), Vec::Set1(c[2 * k + 3]), powR[0], powI[0], r, i);
+        size_t level = 0;
+        for (; top > 0 && nodeLevel[top - 1] == level; ++level) {
+            if (powers == level + 1) {
+                powR[powers] = MulAdd(powR[level], powR[level], Neg(powI[level] * powI[level]));
+                powI[powers] = (powR[level] + powR[level]) * powI[level];
+                ++powers;
+            }
+            --top;
+            Vec sr = nodeR[top], si = nodeI[top];
+            PolyMulAdd(powR[level + 1], powI[level + 1], r, i, sr, si);
+            r = sr;
+            i = si;
+        }
+        nodeR[top] = r;
+        nodeI[top] = i;
+        nodeLevel[top++] = level;
+    }
+    Vec ar, ai;
+    if (count % 2) {
+        ar = Vec::Set1(c[2 * count - 2]);
+        ai = Vec::Set1(c[2 * count - 1]);
+    } else {
+        --top;
+        ar = nodeR[top];
+        ai = nodeI[top];
+    }
+    while (top > 0) {
+        --top;
+        size_t level = nodeLevel[top];
+        while (powers <= level + 1) {
+            powR[powers] = MulAdd(powR[powers - 1], powR[powers - 1], Neg(powI[powers - 1] * powI[powers - 1]));
+            powI[powers] = (powR[powers - 1] + powR[powers - 1]) * powI[powers - 1];
+            ++powers;
+        }
+        Vec sr = nodeR[top], si = nodeI[top];
+        PolyMulAdd(powR[level + 1], powI[level + 1], ar, ai, sr, si);
+        ar = sr;
+        ai = si;
+    }
+    Vec::StoreInterleaved(p, ar, ai);
+}
+
+void PolyBlock(const double* c, size_t count, const double* z, double* p, double* dp, bool estrin) {
+    if (dp) {
+        PolyHornerBlock<true>(c, count, z, p, dp);
+        if (!estrin) {
+            return;
+        }
+    } else if (!estrin) {
+        PolyHornerBlock<false>(c, count, z, p, dp);
+        return;
+    }
+    PolyEstrinVector(c, count, z, p);
+    PolyEstrinVector(c, count, z + 2 * Vec::kWidth, p + 2 * Vec::kWidth);
+}
+
+// Хвост — тем же кодом через буфер из нулевых точек.
+void PolyEvalInterleavedKernel(const double* c, size_t count, const double* z, double* p, double* dp, size_t n,
+                               bool estrin) {
+    if (count == 0) {
+        memset(p, 0, 2 * n * sizeof(double));
+        if (dp) {
+            memset(dp, 0, 2 * n * sizeof(double));
+        }
+        return;
+    }
+    const size_t kBlock = 2 * Vec::kWidth;
+    size_t i = 0;
+    for (; i + kBlock <= n; i += kBlock) {
+        PolyBlock(c, count, z + 2 * i, p + 2 * i, dp ? dp + 2 * i : nullptr, estrin);
+    }
+    if (i < n) {
+        double bufferZ[2 * kBlock] = {}, bufferP[2 * kBlock], bufferD[2 * kBlock];
+        memcpy(bufferZ, z + 2 * i, 2 * (n - i) * sizeof(double));
+        PolyBlock(c, count, bufferZ, bufferP, dp ? bufferD : nullptr, estrin);
+        memcpy(p + 2 * i, bufferP, 2 * (n - i) * sizeof(double));
+        if (dp) {
+            memcpy(dp + 2 * i, bufferD, 2 * (n - i) * sizeof(double));
+        }
+    }
+}
+
+// Сумма 1 / (x - z_j) = conj(d) / |d|^2, d = x - z_j (поправка Аберта).
+void ReciprocalSumInterleavedKernel(double xr, double xi, const double* z, size_t n, double* out) {
+    Vec vxr = Vec::Set1(xr), vxi = Vec::Set1(xi), one = Vec::Set1(1.0);
+    Vec sr = Vec::Set1(0.0), si = sr;
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        Vec zr, zi;
+        Vec::LoadInterleaved(z + 2 * i, zr, zi);
+        Vec dr = vxr - zr, di = vxi - zi;
+        Vec s = one / MulAdd(dr, dr, di * di);
+        sr = MulAdd(dr, s, sr);
+        si = MulAdd(Neg(di), s, si);
+    }
+    double re = SumLanes(sr), im = SumLanes(si);
+    for (; i < n; ++i) {
+        double dr = xr - z[2 * i], di = xi - z[2 * i + 1];
+        double s = 1.0 / ScalarMulAdd(dr, dr, di * di);
+        re = ScalarMulAdd(dr, s, re);
+        im = ScalarMulAdd(-di, s, im);
+    }
+    out[0] = re;
+    out[1] = im;
+}
+
+// acc += a * b поэлементно (свёртка по разбиениям в convolution.cpp).
+inline void MulAccumulateStep(const double* a, const double* b, double* acc) {
+    Vec ar, ai, br, bi, cr, ci;
+    Vec::LoadInterleaved(a, ar, ai);
+    Vec::LoadInterleaved(b, br, bi);
+    Vec::LoadInterleaved(acc, cr, ci);
+    Vec::StoreInterleaved(acc, MulAdd(ar, br, MulAdd(Neg(ai), bi, cr)), MulAdd(ar, bi, MulAdd(ai, br, ci)));
+}
+
+void MulAccumulateInterleavedKernel(const double* a, const double* b, double* acc, size_t n) {
+    size_t i = 0;
+    for (; i + Vec::kWidth <= n; i += Vec::kWidth) {
+        MulAccumulateStep(a + 2 * i, b + 2 * i, acc + 2 * i);
+    }
+    if (i < n) {
+        double bufferA[2 * Vec::kWidth] = {}, bufferB[2 * Vec::kWidth] = {}, bufferC[2 * Vec::kWidth] = {};
+        memcpy(bufferA, a + 2 * i, 2 * (n - i) * sizeof(double));
+        memcpy(bufferB, b + 2 * i, 2 * (n - i) * sizeof(double));
+        memcpy(bufferC, acc + 2 * i, 2 * (n - i) * sizeof(double));
+        MulAccumulateStep(bufferA, bufferB, bufferC);
+        memcpy(acc + 2 * i, bufferC, 2 * (n - i) * sizeof(double));
+    }
+}
+
+// Сумма n пар (reductions.cpp). Части не разделяются: регистр складывается
+// как есть, чётные дорожки — Re, нечётные — Im. out = [re, im, reErr, imErr];
+// быстрый режим — kDotAccumulators аккумуляторов, ошибки нулевые,
+// компенсированный — TwoSum с накоплением ошибок (Нёймайер).
+void SumInterleavedKernel(const double* z, size_t n, bool compensated, double* out) {
+    const size_t count = 2 * n;
+    Vec zero = Vec::Set1(0.0);
+    double lanes[2][Vec::kWidth];
+    size_t i = 0;
+    if (compensated) {
+        Vec s = zero, c = zero;
+        for (; i + Vec::kWidth <= count; i += Vec::kWidth) {
+            Vec e;
+            TwoSum(s, Vec::Load(z + i), s, e);
+            c = c + e;
+        }
+        s.Store(lanes[0]);
+        c.Store(lanes[1]);
+    } else {
+        Vec acc[kDotAccumulators];
+        for (size_t k = 0; k < kDotAccumulators; ++k) {
+            acc[k] = zero;
+        }
+        const size_t kStep = kDotAccumulators * Vec::kWidth;
+        for (; i + kStep <= count; i += kStep) {
+            for (size_t k = 0; k < kDotAccumulators; ++k) {
+                acc[k] = acc[k] + Vec::Load(z + i + k * Vec::kWidth);
+            }
+        }
+        for (; i + Vec::kWidth <= count; i += Vec::kWidth) {
+            acc[0] = acc[0] + Vec::Load(z + i);
+        }
+        ((acc[0] + acc[1]) + (acc[2] + acc[3])).Store(lanes[0]);
+        zero.Store(lanes[1]);
+    }
+    double sum[2] = {0, 0}, err[2] = {0, 0};
+    for (size_t k = 0; k < Vec::kWidth; ++k) {
+        if (compensated) {
+            double e;
+            TwoSum(sum[k & 1], lanes[0][k], sum[k & 1], e);
+            err[k & 1] += e + lanes[1][k];
+        } else {
+            sum[k & 1] += lanes[0][k];
+        }
+    }
+    for (; i < count; ++i) {
+        if (compensated) {
+            double e;
+            TwoSum(sum[i & 1], z[i], sum[i & 1], e);
+            err[i & 1] += e;
+        } else {
+            sum[i & 1] += z[i];
+        }
+    }
+    out[0] = sum[0];
+    out[1] = sum[1];
+    out[2] = err[0];
+    out[3] = err[1];
+}
+
+// Сумма |z - center|^2 по n парам (энергия при center = 0, дисперсия).
+// Как и в SumInterleavedKernel, регистр берётся целиком: вычитается
+// чередующийся [cr ci cr ci ...]. out = [сумма, ошибка] (в быстром режиме 0).
+void SumSquaredDeviationInterleavedKernel(const double* z, size_t n, double cr, double ci, bool compensated,
+                                          double* out) {
+    const size_t count = 2 * n;
+    double pattern[Vec::kWidth];
+    for (size_t k = 0; k < Vec::kWidth; ++k) {
+        pattern[k] = k & 1 ? ci : cr;
+    }
+    Vec center = Vec::Load(pattern), zero = Vec::Set1(0.0);
+    double sum = 0, err = 0;
+    size_t i = 0;
+    if (compensated) {
+        Vec s = zero, c = zero;
+        for (; i + Vec::kWidth <= count; i += Vec::kWidth) {
+            Vec d = Vec::Load(z + i) - center;
+            CompensatedMulAdd(d, d, s, c);
+        }
+        double lanes[2][Vec::kWidth];
+        s.Store(lanes[0]);
+        c.Store(lanes[1]);
+        for (size_t k = 0; k < Vec::kWidth; ++k) {
+            double e;
+            TwoSum(sum, lanes[0][k], sum, e);
+            err += e + lanes[1][k];
+        }
+        for (; i < count; ++i) {
+            double d = z[i] - pattern[i & 1];
+            CompensatedMulAdd(d, d, sum, err);
+        }
+    } else {
+        Vec acc[kDotAccumulators];
+        for (size_t k = 0; k < kDotAccumulators; ++k) {
+            acc[k] = zero;
+        }
+        const size_t kStep = kDotAccumulators * Vec::kWidth;
+        for (; i + kStep <= count; i += kStep) {
+            for (size_t k = 0; k < kDotAccumulators; ++k) {
+                Vec d = Vec::Load(z + i + k * Vec::kWidth) - center;
+                acc[k] = MulAdd(d, d, acc[k]);
+            }
+        }
+        for (; i + Vec::kWidth <= count; i += Vec::kWidth) {
+            Vec d = Vec::Load(z + i) - center;
+            acc[0] = MulAdd(d, d, acc[0]);
+        }
+        sum = SumLanes((acc[0] + acc[1]) + (acc[2] + acc[3]));
+        for (; i < count; ++i) {
+            double d = z[i] - pattern[i & 1];
+            sum = ScalarMulAdd(d, d, sum);
+        }
+    }
+    out[0] = sum;
+    out[1] = err;
+}
+
+// Лучший |z|^2 по сравнению без корня: в каждой дорожке хранятся лучшее
+// значение и индекс (как double, точен до 2^53); строгое сравнение оставляет
+// первый из равных. NaN не выбирается никогда. out = [|z|^2, индекс] или
+// [NaN, -1], если сравнимых элементов нет.
+void AbsSquaredExtremumInterleavedKernel(const double* z, size_t n, bool maximum, double* out) {
+    const double start = maximum ? -1.0 : HUGE_VAL;
+    double offsets[Vec::kWidth];
+    for (size_t k = 0; k < Vec::kWidth; ++k) {
+        offsets[k] = double(k);
+    }
+    Vec laneOffset = Vec::Load(offsets), missing = Vec::Set1(-1.0);
+    Vec best[kDotAccumulators], index[kDotAccumulators];
+    for (size_t k = 0; k < kDotAccumulators; ++k) {
+        best[k] = Vec::Set1(start);
+        index[k] = missing;
+    }
+    const size_t kStep = kDotAccumulators * Vec::kWidth;
+    size_t i = 0;
+    for (; i + kStep <= n; i += kStep) {
+        for (size_t k = 0; k < kDotAccumulators; ++k) {
+            Vec re, im;
+            Vec::LoadInterleaved(z + 2 * (i + k * Vec::kWidth), re, im);
+            Vec v = MulAdd(re, re, im * im);
+            Vec at = Vec::Set1(double(i + k * Vec::kWidth)) + laneOffset;
+            if (maximum) {
+                index[k] = SelectGreater(v, best[k], at, index[k]);
+                best[k] = SelectGreater(v, best[k], v, best[k]);
+            } else {
+                index[k] = SelectGreater(best[k], v, at, index[k]);
+                best[k] = SelectGreater(best[k], v, v, best[k]);
+            }
+        }
+    }
+    double value = start, position = -1;
+    for (size_t k = 0; k < kDotAccumulators; ++k) {
+        double values[Vec::kWidth], positions[Vec::kWidth];
+        best[k].Store(values);
+        index[k].Store(positions);
+        for (size_t lane = 0; lane < Vec::kWidth; ++lane) {
+            if (positions[lane] < 0) {
+                continue;
+            }
+            bool better = maximum ? values[lane] > value : values[lane] < value;
+            if (better || (values[lane] == value && (position < 0 || positions[lane] < position))) {
+                value = values[lane];
+                position = positions[lane];
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        double v = ScalarMulAdd(z[2 * i], z[2 * i], z[2 * i + 1] * z[2 * i + 1]);
+        if (maximum ? v > value : v < value) {
+            value = v;
+            position = double(i);
+        }
+    }
+    // Без сравнимых со стартовым значением остаются NaN и (для минимума)
+    // одни бесконечные модули: тогда первый не-NaN.
+    for (i = 0; position < 0 && i < n; ++i) {
+        double v = ScalarMulAdd(z[2 * i], z[2 * i], z[2 * i + 1] * z[2 * i + 1]);
+        if (v == v) {
+            value = v;
+            position = double(i);
+        }
+    }
+    out[0] = position < 0 ? NAN : value;
+    out[1] = position;
+}
+
+// Частотный дискриминатор: arg(z[i] * conj(z[i - 1])) * gain. Произведение
+// соседних пар считается при загрузке, дальше — как VecArg. Первый регистр
+// (с парой previous) и хвост идут тем же кодом через буфер, поэтому каждый
+// отсчёт считается одинаково при любом разбиении входа на блоки.
+struct ConjProductData {
+    const double* z;  /**< Пара i — z[i + 1] * conj(z[i]).*/
+
+    void Load(size_t i, Vec& r, Vec& m) const {
+        Vec a, b, c, d;
+        Vec::LoadInterleaved(z + 2 * (i + 1), a, b);
+        Vec::LoadInterleaved(z + 2 * i, c, d);
+        r = MulAdd(a, c, b * d);
+        m = MulAdd(b, c, Neg(a * d));
+    }
+    double Re(size_t i) const { return ScalarMulAdd(z[2 * i + 2], z[2 * i], z[2 * i + 3] * z[2 * i + 1]); }
+    double Im(size_t i) const { return ScalarMulAdd(z[2 * i + 3], z[2 * i], -(z[2 * i + 2] * z[2 * i + 1])); }
+};
+
+/** Vec::kWidth частот по Vec::kWidth + 1 парам */
+template <bool kApprox>
+inline void FmDiscriminateStep(const double* pairs, double gain, double* out) {
+    ConjProductData data{pairs};
+    Vec x, y, u, v;
+    data.Load(0, x, y);
+    if (VecArg<kApprox>(x, y, u, v)) {
+        (u * Vec::Set1(gain)).Store(out);
+    } else {
+        for (size_t j = 0; j < Vec::kWidth; ++j) {
+            double m;
+            ScalarArg(data.Re(j), data.Im(j), out[j], m);
+            out[j] *= gain;
+        }
+    }
+}
+
+template <bool kApprox>
+void FmDiscriminateBody(const double* z, const double* previous, double gain, double* out, size_t n) {
+    double pairs[2 * (Vec::kWidth + 1)], result[Vec::kWidth];
+    for (size_t i = 0; i < n;) {
+        size_t count = n - i < Vec::kWidth ? n - i : Vec::kWidth;
+        if (i > 0 && count == Vec::kWidth) {
+            FmDiscriminateStep<kApprox>(z + 2 * (i - 1), gain, out + i);
+        } else {
+            memset(pairs, 0, sizeof(pairs));
+            memcpy(pairs, i > 0 ? z + 2 * (i - 1) : previous, 2 * sizeof(double));
+            memcpy(pairs + 2, z + 2 * i, 2 * count * sizeof(double));
+            FmDiscriminateStep<kApprox>(pairs, gain, result);
+            memcpy(out + i, result, count * sizeof(double));
+        }
+        i += count;
+    }
+}
+
+// previous — пара перед z[0] (последний отсчёт прошлого блока).
+void FmDiscriminateInterleavedKernel(const double* z, const double* previous, double gain, double* out, size_t n,
+                                     bool approx) {
+    if (approx) {
+        FmDiscriminateBody<true>(z, previous, gain, out, n);
+    } else {
+        FmDiscriminateBody<false>(z, previous, gain, out, n);
+    }
+}
+
+// Развёртка фазы: скачок между соседними отсчётами больше pi (по модулю)
+// считается переходом через +-pi, и к выходу прибавляется 2pi * turns.
+// Кусок в три прохода: векторно число оборотов round((p[i] - p[i - 1]) / 2pi)
+// (скачок через NaN — ноль), скалярно накопление по четвёркам (обороты целые,
+// сумма точна в любом порядке, зависимость через turns — одно сложение на
+// четыре отсчёта), векторно p[i] + 2pi * turns. Кусок читает вход до записи,
+// поэтому out может совпадать с in. state = [последняя фаза, накопленные обороты].
+const double kTwoPi = 6.28318530717958647693;
+const size_t kUnwrapChunk = 256;
+
+inline double ScalarRoundToInt(double x) {
+    const double k = 0x1.8p52;
+    return (x + k) - k;
+}
+
+/** Обороты скачка; NaN — ноль (сравнение с NaN ложно) */
+inline Vec VecUnwrapJump(Vec d, Vec scale) {
+    Vec jump = RoundToInt(d * scale);
+    return SelectGreater(Abs(jump), Vec::Set1(-1), jump, Vec::Set1(0));
+}
+
+inline double ScalarUnwrapJump(double d, double scale) {
+    double jump = ScalarRoundToInt(d * scale);
+    return jump == jump ? jump : 0;
+}
+
+void UnwrapPhaseKernel(const double* in, double* out, size_t n, double* state) {
+    const double scale = 1 / kTwoPi;
+    const Vec vscale = Vec::Set1(scale), vtwoPi = Vec::Set1(kTwoPi);
+    double last = state[0], turns = state[1];
+    double t[kUnwrapChunk];
+    for (size_t start = 0; start < n; start += kUnwrapChunk) {
+        size_t count = n - start < kUnwrapChunk ? n - start : kUnwrapChunk;
+        const double* p = in + start;
+        t[0] = ScalarUnwrapJump(p[0] - last, scale);
+        size_t i = 1;
+        for (; i + Vec::kWidth <= count; i += Vec::kWidth) {
+            VecUnwrapJump(Vec::Load(p + i) - Vec::Load(p + i - 1), vscale).Store(t + i);
+        }
+        for (; i < count; ++i) {
+            t[i] = ScalarUnwrapJump(p[i] - p[i - 1], scale);
+        }
+        last = p[count - 1];
+
+        for (i = 0; i + 4 <= count; i += 4) {
+            double a = t[i], b = a + t[i + 1], c = b + t[i + 2], d = c + t[i + 3];
+            t[i] = turns - a;
+            t[i + 1] = turns - b;
+            t[i + 2] = turns - c;
+            t[i + 3] = turns - d;
+            turns -= d;
+        }
+        for (; i < count; ++i) {
+            turns -= t[i];
+            t[i] = turns;
+        }
+
+        double* o = out + start;
+        for (i = 0; i + Vec::kWidth <= count; i += Vec::kWidth) {
+            MulAdd(Vec::Load(t + i), vtwoPi, Vec::Load(p + i)).Store(o + i);
+        }
+        for (; i < count; ++i) {
+            o[i] = ScalarMulAdd(t[i], kTwoPi, p[i]);
+        }
+    }
+    state[0] = last;
+    state[1] = turns;
+}
+
+/**
+ * @brief Собирает таблицу ядер текущей единицы трансляции
+ * (constexpr, чтобы таблица инициализировалась статически).
+ * @param name Имя набора инструкций
+ * @return Таблица ядер
+ */
+constexpr SimdKernels MakeSimdKernels(const char* name) {
+    return SimdKernels{
+        name,
+        AddKernel,
+        SubKernel,
+        MulKernel,
+        ConjMulKernel,
+        ScaleKernel,
+        ScaleComplexKernel,
+        DivKernel<false>,
+        DivKernel<true>,
+        ReciprocalKernel<false>,
+        ReciprocalKernel<true>,
+        AxpyKernel,
+        DotKernel,
+        AbsKernel,
+        AbsSquaredKernel,
+        AbsApproxKernel,
+        AbsInterleavedKernel,
+        AbsSquaredInterleavedKernel,
+        AbsApproxInterleavedKernel,
+        MulInterleavedKernel,
+        DivInterleavedKernel<false>,
+        DivInterleavedKernel<true>,
+        ReciprocalInterleavedKernel<false>,
+        ReciprocalInterleavedKernel<true>,
+        AxpyInterleavedKernel,
+        ScaleComplexInterleavedKernel,
+        DotInterleavedKernel,
+        DeinterleaveKernel,
+        InterleaveKernel,
+        F64ToF32Kernel,
+        F32ToF64Kernel,
+        Q15ToF32Kernel,
+        F32ToQ15Kernel,
+        Q15ToF64Kernel,
+        F64ToQ15Kernel,
+        F16ToF32Kernel,
+        F32ToF16Kernel,
+        F64ToF16Kernel,
+        ArgKernel,
+        PolarKernel,
+        RotateKernel,
+        ExpKernel,
+        LogKernel,
+        SqrtKernel,
+        PowKernel,
+        ArgInterleavedKernel,
+        PolarInterleavedKernel,
+        RotateInterleavedKernel,
+        ExpInterleavedKernel,
+        LogInterleavedKernel,
+        SqrtInterleavedKernel,
+        PowInterleavedKernel,
+        Vec::kWidth,
+        kGemmRealTileRows,
+        GemmTileKernel,
+        GemmTileRealKernel,
+        GemmBatchKernel,
+        FftRadix4StageKernel,
+        PolyEvalInterleavedKernel,
+        ReciprocalSumInterleavedKernel,
+        MulAccumulateInterleavedKernel,
+        SumInterleavedKernel,
+        SumSquaredDeviationInterleavedKernel,
+        AbsSquaredExtremumInterleavedKernel,
+        ToPolarInterleavedKernel,
+        FmDiscriminateInterleavedKernel,
+        UnwrapPhaseKernel,
+    };
+}
+
+} // namespace
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,4 @@
+// Ядра для уровня Avx2 (флаги процессора задаются в Makefile).
+#include "simdkernels.h"
+
+const SimdKernels kSimdKernelsAvx2 = MakeSimdKernels("avx2");
@@ -0,0 +1,4 @@
+// Ядра для уровня Avx512 (флаги процессора задаются в Makefile).
+#include "simdkernels.h"
+
+const SimdKernels kSimdKernelsAvx512 = MakeSimdKernels("avx512");
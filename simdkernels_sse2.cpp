@@ -0,0 +1,4 @@
+// Ядра для уровня Sse2 (флаги процессора задаются в Makefile).
+#include "simdkernels.h"
+
+const SimdKernels kSimdKernelsSse2 = MakeSimdKernels("sse2");
@@ -0,0 +1,257 @@
+#ifndef SIMD_VEC_H
+#define SIMD_VEC_H
+
+// Обёртка над векторным регистром из double для текущих флагов компиляции.
+// Подключается только из simdkernels_*.cpp: всё объявлено во внутреннем
+// пространстве имён, чтобы функции, собранные с -mavx2/-mavx512f, не
+// смешивались компоновщиком с базовыми версиями.
+
+#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+#if defined(__AVX512F__)
+
+// Немаскированные интринсики AVX-512 в GCC 12 передают встроенной функции
+// _mm512_undefined_pd() как источник для маски, и после встраивания это даёт
+// ложные -Wmaybe-uninitialized и -Wuninitialized. Поэтому функции ниже, где
+// они возникали, вызывают маскированные варианты с полной маской и
+// определённым источником: команда та же, предупреждений нет.
+
+struct Vec {
+    __m512d v;
+    static const size_t kWidth = 8;
+
+    static Vec Load(const double* p) { return Vec{_mm512_loadu_pd(p)}; }
+    static Vec Set1(double x) { return Vec{_mm512_set1_pd(x)}; }
+    void Store(double* p) const { _mm512_storeu_pd(p, v); }
+
+    /** Читает kWidth пар (re, im) и раскладывает их по двум регистрам */
+    static void LoadInterleaved(const double* p, Vec& re, Vec& im) {
+        __m512d a = _mm512_loadu_pd(p);
+        __m512d b = _mm512_loadu_pd(p + 8);
+        re.v = _mm512_permutex2var_pd(a, _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14), b);
+        im.v = _mm512_permutex2var_pd(a, _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15), b);
+    }
+
+    /** Записывает kWidth пар (re, im) из двух регистров */
+    static void StoreInterleaved(double* p, Vec re, Vec im) {
+        _mm512_storeu_pd(p, _mm512_permutex2var_pd(re.v, _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11), im.v));
+        _mm512_storeu_pd(p + 8, _mm512_permutex2var_pd(re.v, _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15), im.v));
+    }
+};
+
+inline Vec operator+(Vec a, Vec b) { return Vec{_mm512_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return Vec{_mm512_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return Vec{_mm512_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return Vec{_mm512_div_pd(a.v, b.v)}; }
+inline Vec Sqrt(Vec a) { return Vec{_mm512_mask_sqrt_pd(a.v, 0xFF, a.v)}; }
+inline Vec Min(Vec a, Vec b) { return Vec{_mm512_mask_min_pd(a.v, 0xFF, a.v, b.v)}; }
+inline Vec Max(Vec a, Vec b) { return Vec{_mm512_mask_max_pd(a.v, 0xFF, a.v, b.v)}; }
+inline Vec Abs(Vec a) { return Vec{_mm512_abs_pd(a.v)}; }
+/** Смена знака (через бит знака, поэтому -0.0 и +0.0 различаются) */
+inline Vec Neg(Vec a) {
+    return Vec{_mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a.v), _mm512_set1_epi64(INT64_MIN)))};
+}
+/** Поэлементно a > b ? x : y */
+inline Vec SelectGreater(Vec a, Vec b, Vec x, Vec y) {
+    return Vec{_mm512_mask_blend_pd(_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ), y.v, x.v)};
+}
+/** true, если каждый элемент a лежит в [lo, hi] или соответствующий элемент z равен нулю */
+inline bool AllInRangeOrZero(Vec a, Vec lo, Vec hi, Vec z) {
+    __mmask8 ok = _mm512_cmp_pd_mask(a.v, lo.v, _CMP_GE_OQ) & _mm512_cmp_pd_mask(a.v, hi.v, _CMP_LE_OQ);
+    return (ok | _mm512_cmp_pd_mask(z.v, _mm512_setzero_pd(), _CMP_EQ_OQ)) == 0xFF;
+}
+/** a * b + c с одним округлением */
+inline Vec MulAdd(Vec a, Vec b, Vec c) { return Vec{_mm512_fmadd_pd(a.v, b.v, c.v)}; }
+/** Точная ошибка округления произведения p = fl(a * b): a * b - p */
+inline Vec ProductError(Vec a, Vec b, Vec p) { return Vec{_mm512_fmsub_pd(a.v, b.v, p.v)}; }
+inline double ScalarMulAdd(double a, double b, double c) { return __builtin_fma(a, b, c); }
+inline double ProductError(double a, double b, double p) { return __builtin_fma(a, b, -p); }
+/** Модуль mag со знаком sign (через бит знака) */
+inline Vec CopySign(Vec mag, Vec sign) {
+    __m512i mask = _mm512_set1_epi64(INT64_MIN);
+    // Побитовый выбор mask ? sign : mag одной командой.
+    return Vec{_mm512_castsi512_pd(
+        _mm512_ternarylogic_epi64(mask, _mm512_castpd_si512(sign.v), _mm512_castpd_si512(mag.v), 0xCA))};
+}
+/** 2^n для целых n в [-1022, 1023] */
+inline Vec Pow2(Vec n) { return Vec{_mm512_mask_scalef_pd(n.v, 0xFF, _mm512_set1_pd(1.0), n.v)}; }
+/** Двоичный порядок floor(log2 x) положительного нормального x */
+inline Vec Exponent(Vec x) { return Vec{_mm512_mask_getexp_pd(x.v, 0xFF, x.v)}; }
+/** Мантисса положительного нормального x в [1, 2) */
+inline Vec Mantissa(Vec x) { return Vec{_mm512_mask_getmant_pd(x.v, 0xFF, x.v, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src)}; }
+
+#elif defined(__AVX2__)
+
+struct Vec {
+    __m256d v;
+    static const size_t kWidth = 4;
+
+    static Vec Load(const double* p) { return Vec{_mm256_loadu_pd(p)}; }
+    static Vec Set1(double x) { return Vec{_mm256_set1_pd(x)}; }
+    void Store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    /** Читает kWidth пар (re, im) и раскладывает их по двум регистрам */
+    static void LoadInterleaved(const double* p, Vec& re, Vec& im) {
+        __m256d a = _mm256_loadu_pd(p);      // r0 i0 r1 i1
+        __m256d b = _mm256_loadu_pd(p + 4);  // r2 i2 r3 i3
+        re.v = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        im.v = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+    }
+
+    /** Записывает kWidth пар (re, im) из двух регистров */
+    static void StoreInterleaved(double* p, Vec re, Vec im) {
+        __m256d r = _mm256_permute4x64_pd(re.v, _MM_SHUFFLE(3, 1, 2, 0));  // r0 r2 r1 r3
+        __m256d i = _mm256_permute4x64_pd(im.v, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_pd(p, _mm256_unpacklo_pd(r, i));
+        _mm256_storeu_pd(p + 4, _mm256_unpackhi_pd(r, i));
+    }
+};
+
+inline Vec operator+(Vec a, Vec b) { return Vec{_mm256_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return Vec{_mm256_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return Vec{_mm256_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return Vec{_mm256_div_pd(a.v, b.v)}; }
+inline Vec Sqrt(Vec a) { return Vec{_mm256_sqrt_pd(a.v)}; }
+inline Vec Min(Vec a, Vec b) { return Vec{_mm256_min_pd(a.v, b.v)}; }
+inline Vec Max(Vec a, Vec b) { return Vec{_mm256_max_pd(a.v, b.v)}; }
+inline Vec Abs(Vec a) { return Vec{_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+/** Смена знака (через бит знака, поэтому -0.0 и +0.0 различаются) */
+inline Vec Neg(Vec a) { return Vec{_mm256_xor_pd(_mm256_set1_pd(-0.0), a.v)}; }
+/** Поэлементно a > b ? x : y */
+inline Vec SelectGreater(Vec a, Vec b, Vec x, Vec y) {
+    return Vec{_mm256_blendv_pd(y.v, x.v, _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ))};
+}
+/** true, если каждый элемент a лежит в [lo, hi] или соответствующий элемент z равен нулю */
+inline bool AllInRangeOrZero(Vec a, Vec lo, Vec hi, Vec z) {
+    __m256d ok = _mm256_and_pd(_mm256_cmp_pd(a.v, lo.v, _CMP_GE_OQ), _mm256_cmp_pd(a.v, hi.v, _CMP_LE_OQ));
+    ok = _mm256_or_pd(ok, _mm256_cmp_pd(z.v, _mm256_setzero_pd(), _CMP_EQ_OQ));
+    return _mm256_movemask_pd(ok) == 0xF;
+}
+/** a * b + c с одним округлением */
+inline Vec MulAdd(Vec a, Vec b, Vec c) { return Vec{_mm256_fmadd_pd(a.v, b.v, c.v)}; }
+/** Точная ошибка округления произведения p = fl(a * b): a * b - p */
+inline Vec ProductError(Vec a, Vec b, Vec p) { return Vec{_mm256_fmsub_pd(a.v, b.v, p.v)}; }
+inline double ScalarMulAdd(double a, double b, double c) { return __builtin_fma(a, b, c); }
+inline double ProductError(double a, double b, double p) { return __builtin_fma(a, b, -p); }
+/** Модуль mag со знаком sign (через бит знака) */
+inline Vec CopySign(Vec mag, Vec sign) {
+    __m256d mask = _mm256_set1_pd(-0.0);
+    return Vec{_mm256_or_pd(_mm256_andnot_pd(mask, mag.v), _mm256_and_pd(mask, sign.v))};
+}
+/**
+ * @brief 2^n для целых n в [-1022, 1023]: после прибавления 2^52 + 1023
+ * младшие биты числа равны смещённому порядку, сдвиг ставит их на место
+ */
+inline Vec Pow2(Vec n) {
+    __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n.v, _mm256_set1_pd(0x1p52 + 1023)));
+    return Vec{_mm256_castsi256_pd(_mm256_slli_epi64(bits, 52))};
+}
+/** Двоичный порядок floor(log2 x) положительного нормального x (обратный приём к Pow2) */
+inline Vec Exponent(Vec x) {
+    __m256i biased = _mm256_srli_epi64(_mm256_castpd_si256(x.v), 52);
+    __m256d shifted = _mm256_or_pd(_mm256_castsi256_pd(biased), _mm256_set1_pd(0x1p52));
+    return Vec{_mm256_sub_pd(shifted, _mm256_set1_pd(0x1p52 + 1023))};
+}
+/** Мантисса положительного нормального x в [1, 2) */
+inline Vec Mantissa(Vec x) {
+    __m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x000fffffffffffffLL));
+    return Vec{_mm256_or_pd(_mm256_and_pd(x.v, mask), _mm256_set1_pd(1.0))};
+}
+
+#else
+
+struct Vec {
+    __m128d v;
+    static const size_t kWidth = 2;
+
+    static Vec Load(const double* p) { return Vec{_mm_loadu_pd(p)}; }
+    static Vec Set1(double x) { return Vec{_mm_set1_pd(x)}; }
+    void Store(double* p) const { _mm_storeu_pd(p, v); }
+
+    /** Читает kWidth пар (re, im) и раскладывает их по двум регистрам */
+    static void LoadInterleaved(const double* p, Vec& re, Vec& im) {
+        __m128d a = _mm_loadu_pd(p);
+        __m128d b = _mm_loadu_pd(p + 2);
+        re.v = _mm_unpacklo_pd(a, b);
+        im.v = _mm_unpackhi_pd(a, b);
+    }
+
+    /** Записывает kWidth пар (re, im) из двух регистров */
+    static void StoreInterleaved(double* p, Vec re, Vec im) {
+        _mm_storeu_pd(p, _mm_unpacklo_pd(re.v, im.v));
+        _mm_storeu_pd(p + 2, _mm_unpackhi_pd(re.v, im.v));
+    }
+};
+
+inline Vec operator+(Vec a, Vec b) { return Vec{_mm_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return Vec{_mm_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return Vec{_mm_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return Vec{_mm_div_pd(a.v, b.v)}; }
+inline Vec Sqrt(Vec a) { return Vec{_mm_sqrt_pd(a.v)}; }
+inline Vec Min(Vec a, Vec b) { return Vec{_mm_min_pd(a.v, b.v)}; }
+inline Vec Max(Vec a, Vec b) { return Vec{_mm_max_pd(a.v, b.v)}; }
+inline Vec Abs(Vec a) { return Vec{_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)}; }
+/** Смена знака (через бит знака, поэтому -0.0 и +0.0 различаются) */
+inline Vec Neg(Vec a) { return Vec{_mm_xor_pd(_mm_set1_pd(-0.0), a.v)}; }
+/** Поэлементно a > b ? x : y (в SSE2 нет blendv, поэтому через маски) */
+inline Vec SelectGreater(Vec a, Vec b, Vec x, Vec y) {
+    __m128d mask = _mm_cmpgt_pd(a.v, b.v);
+    return Vec{_mm_or_pd(_mm_and_pd(mask, x.v), _mm_andnot_pd(mask, y.v))};
+}
+/** true, если каждый элемент a лежит в [lo, hi] или соответствующий элемент z равен нулю */
+inline bool AllInRangeOrZero(Vec a, Vec lo, Vec hi, Vec z) {
+    __m128d ok = _mm_and_pd(_mm_cmpge_pd(a.v, lo.v), _mm_cmple_pd(a.v, hi.v));
+    ok = _mm_or_pd(ok, _mm_cmpeq_pd(z.v, _mm_setzero_pd()));
+    return _mm_movemask_pd(ok) == 0x3;
+}
+/** a * b + c (в SSE2 нет FMA, поэтому с двумя округлениями) */
+inline Vec MulAdd(Vec a, Vec b, Vec c) { return Vec{_mm_add_pd(_mm_mul_pd(a.v, b.v), c.v)}; }
+inline double ScalarMulAdd(double a, double b, double c) { return a * b + c; }
+
+/**
+ * @brief Точная ошибка округления произведения p = fl(a * b) без FMA:
+ * разбиение Деккера на половины по 26 бит (годится, пока a*b не переполняется).
+ */
+template <class T>
+inline T DekkerProductError(T a, T b, T p, T split) {
+    T ta = a * split, tb = b * split;
+    T ah = ta - (ta - a), bh = tb - (tb - b);
+    T al = a - ah, bl = b - bh;
+    return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+}
+inline Vec ProductError(Vec a, Vec b, Vec p) { return DekkerProductError(a, b, p, Vec::Set1(134217729.0)); }
+inline double ProductError(double a, double b, double p) { return DekkerProductError(a, b, p, 134217729.0); }
+/** Модуль mag со знаком sign (через бит знака) */
+inline Vec CopySign(Vec mag, Vec sign) {
+    __m128d mask = _mm_set1_pd(-0.0);
+    return Vec{_mm_or_pd(_mm_andnot_pd(mask, mag.v), _mm_and_pd(mask, sign.v))};
+}
+/**
+ * @brief 2^n для целых n в [-1022, 1023]: после прибавления 2^52 + 1023
+ * младшие биты числа равны смещённому порядку, сдвиг ставит их на место
+ */
+inline Vec Pow2(Vec n) {
+    __m128i bits = _mm_castpd_si128(_mm_add_pd(n.v, _mm_set1_pd(0x1p52 + 1023)));
+    return Vec{_mm_castsi128_pd(_mm_slli_epi64(bits, 52))};
+}
+/** Двоичный порядок floor(log2 x) положительного нормального x (обратный приём к Pow2) */
+inline Vec Exponent(Vec x) {
+    __m128i biased = _mm_srli_epi64(_mm_castpd_si128(x.v), 52);
+    __m128d shifted = _mm_or_pd(_mm_castsi128_pd(biased), _mm_set1_pd(0x1p52));
+    return Vec{_mm_sub_pd(shifted, _mm_set1_pd(0x1p52 + 1023))};
+}
+/** Мантисса положительного нормального x в [1, 2) */
+inline Vec Mantissa(Vec x) {
+    __m128d mask = _mm_castsi128_pd(_mm_set1_epi64x(0x000fffffffffffffLL));
+    return Vec{_mm_or_pd(_mm_and_pd(x.v, mask), _mm_set1_pd(1.0))};
+}
+
+#endif
+
+} // namespace
+
+#endif // SIMD_VEC_H
@@ -0,0 +1,309 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "test.h"
+#include "../simd.h"
+
+using namespace std;
+
+namespace {
+
+struct TestEntry {
+    const char* name;
+    void (*fn)(TestState&);
+};
+
+vector<TestEntry>& Registry() {
+    static vector<TestEntry> entries;
+    return entries;
+}
+
+/**
+ * @brief Допустимая погрешность метрики.
+ */
+struct Budget {
+    double max;   /**< Предел максимальной погрешности.*/
+    double mean;  /**< Предел средней погрешности.*/
+};
+
+map<string, Budget> budgets;
+set<string> usedBudgets;
+uint64_t seed = 1;
+size_t samples = 100000;
+bool verbose = false;
+
+/**
+ * @brief Читает бюджеты: строки "метрика max mean", # — комментарий
+ * @return false, если файл не открылся или строка некорректна
+ */
+bool LoadBudgets(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "не удалось открыть файл бюджетов %s\n", path);
+        return false;
+    }
+    char line[512];
+    int lineNumber = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file)) {
+        ++lineNumber;
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        char name[256];
+        Budget budget;
+        int fields = sscanf(line, "%255s %lf %lf", name, &budget.max, &budget.mean);
+        if (fields <= 0) {
+            continue;
+        }
+        if (fields != 3) {
+            fprintf(stderr, "%s:%d: ожидается \"метрика max mean\"\n", path, lineNumber);
+            ok = false;
+            continue;
+        }
+        budgets[name] = budget;
+    }
+    fclose(file);
+    return ok;
+}
+
+long double UlpOf(long double x, int mantissaBits, int minExponent) {
+    x = fabsl(x);
+    int e = minExponent;
+    if (x >= ldexpl(1, minExponent)) {
+        frexpl(x, &e);
+        --e;
+    }
+    return ldexpl(1, e - mantissaBits + 1);
+}
+
+template <class T>
+double UlpErrorOf(T got, long double ref, int mantissaBits, int minExponent) {
+    if (isnan(ref)) {
+        return isnan(got) ? 0 : numeric_limits<double>::infinity();
+    }
+    // Эталон за пределами диапазона T должен дать бесконечность.
+    if (isinf(T(ref)) || !isfinite(got)) {
+        return got == T(ref) ? 0 : numeric_limits<double>::infinity();
+    }
+    return double(fabsl(got - ref) / UlpOf(ref, mantissaBits, minExponent));
+}
+
+template <class T>
+double ComplexUlpError(T gotRe, T gotIm, const RefComplex& ref, int mantissaBits, int minExponent) {
+    if (!isfinite(T(ref.re)) || !isfinite(T(ref.im)) || !isfinite(gotRe) || !isfinite(gotIm)) {
+        double re = UlpErrorOf(gotRe, ref.re, mantissaBits, minExponent);
+        double im = UlpErrorOf(gotIm, ref.im, mantissaBits, minExponent);
+        // Модуль эталона вне диапазона T: конечная часть по сравнению с ним
+        // пренебрежимо мала, проверяются только бесконечные части.
+        bool overflow = isinf(T(ref.re)) || isinf(T(ref.im));
+        if (overflow && isfinite(gotRe) && !isnan(ref.re) && !isinf(T(ref.re))) {
+            re = 0;
+        }
+        if (overflow && isfinite(gotIm) && !isnan(ref.im) && !isinf(T(ref.im))) {
+            im = 0;
+        }
+        return re > im ? re : im;
+    }
+    long double dr = gotRe - ref.re, di = gotIm - ref.im;
+    long double error = sqrtl(dr * dr + di * di);
+    return double(error / UlpOf(RefAbs(ref), mantissaBits, minExponent));
+}
+
+} // namespace
+
+void TestState::Fail(const string& message) {
+    // Первые kMaxMessages сообщений: дальше обычно повторяется та же ошибка.
+    const size_t kMaxMessages = 20;
+    if (++failures_ <= kMaxMessages) {
+        printf("    %s: %s\n", name_, message.c_str());
+    }
+}
+
+void TestState::CheckBudget(const string& metric, const ErrorStats& stats, const string& label) {
+    usedBudgets.insert(metric);
+    auto it = budgets.find(metric);
+    if (it == budgets.end()) {
+        Fail("нет бюджета для метрики " + metric + " (tests/budgets.txt)");
+        return;
+    }
+    const Budget& budget = it->second;
+    bool ok = stats.Max() <= budget.max && stats.Mean() <= budget.mean;
+    if (verbose || !ok) {
+        printf("    %-36s max %10.4g  mean %10.4g  (бюджет %g / %g, n = %zu)\n", (metric + label).c_str(),
+               stats.Max(), stats.Mean(), budget.max, budget.mean, stats.Count());
+    }
+    if (!ok) {
+        char worst[256];
+        snprintf(worst, sizeof(worst), "превышен бюджет %s; худший случай a = (%.17g, %.17g), b = (%.17g, %.17g)",
+                 (metric + label).c_str(), stats.WorstA().Re(), stats.WorstA().Im(), stats.WorstB().Re(), stats.WorstB().Im());
+        Fail(worst);
+    }
+}
+
+bool RegisterTest(const char* name, void (*fn)(TestState&)) {
+    Registry().push_back(TestEntry{name, fn});
+    return true;
+}
+
+uint64_t TestSeed() {
+    return seed;
+}
+
+size_t TestSamples() {
+    return samples;
+}
+
+vector<double> EdgeValues() {
+    const double kInf = numeric_limits<double>::infinity();
+    const double kNan = numeric_limits<double>::quiet_NaN();
+    return {0.0,     -0.0,     DBL_TRUE_MIN, -DBL_TRUE_MIN, 0x1p-1060, DBL_MIN, -DBL_MIN, 0x1p-600, 0.5,
+            1.0,     -1.0,     2.0,          -3.0,          0x1p600,   DBL_MAX, -DBL_MAX, kInf,     -kInf,
+            kNan,    -kNan};
+}
+
+double UlpError(double got, long double ref) {
+    return UlpErrorOf(got, ref, DBL_MANT_DIG, DBL_MIN_EXP - 1);
+}
+
+double UlpError(float got, long double ref) {
+    return UlpErrorOf(got, ref, FLT_MANT_DIG, FLT_MIN_EXP - 1);
+}
+
+double UlpError(const Complex& got, const RefComplex& ref) {
+    return ComplexUlpError(got.Re(), got.Im(), ref, DBL_MANT_DIG, DBL_MIN_EXP - 1);
+}
+
+double UlpError(const ComplexF& got, const RefComplex& ref) {
+    return ComplexUlpError(got.Re(), got.Im(), ref, FLT_MANT_DIG, FLT_MIN_EXP - 1);
+}
+
+bool SameValue(double a, double b) {
+    if (isnan(a) || isnan(b)) {
+        return isnan(a) && isnan(b);
+    }
+    return a == b && signbit(a) == signbit(b);
+}
+
+bool SameValue(const Complex& a, const Complex& b) {
+    return SameValue(a.Re(), b.Re()) && SameValue(a.Im(), b.Im());
+}
+
+long double RefArg(const Complex& z) {
+    return atan2l(z.Im(), z.Re());
+}
+
+RefComplex RefPolar(long double r, long double theta) {
+    return RefComplex{r * cosl(theta), r * sinl(theta)};
+}
+
+RefComplex RefExp(const Complex& z) {
+    return RefPolar(expl(z.Re()), z.Im());
+}
+
+RefComplex RefLog(const Complex& z) {
+    long double x = z.Re(), y = z.Im();
+    long double s = x * x + y * y;
+    if (s <= 0.25L || s >= 4) {
+        return RefComplex{logl(s) / 2, RefArg(z)};
+    }
+    // Произведения частей double точны в двух long double (fmal), а сумма
+    // x^2 + y^2 - 1 копится с точными ошибками сложений (TwoSum).
+    long double xx = x * x, yy = y * y;
+    long double terms[] = {xx, yy, -1.0L, fmal(x, x, -xx), fmal(y, y, -yy)};
+    long double sum = 0, error = 0;
+    for (long double t : terms) {
+        long double next = sum + t;
+        long double v = next - sum;
+        error += (sum - (next - v)) + (t - v);
+        sum = next;
+    }
+    return RefComplex{log1pl(sum + error) / 2, RefArg(z)};
+}
+
+RefComplex RefSqrt(const Complex& z) {
+    long double x = z.Re(), y = z.Im();
+    long double t = sqrtl((fabsl(x) + hypotl(x, y)) / 2);
+    if (t == 0) {
+        return RefComplex{0, y};
+    }
+    long double u = fabsl(y) / (2 * t);
+    return x >= 0 ? RefComplex{t, copysignl(u, y)} : RefComplex{u, copysignl(t, y)};
+}
+
+RefComplex RefPow(const Complex& z, double p) {
+    return RefPolar(powl(hypotl(z.Re(), z.Im()), p), p * RefArg(z));
+}
+
+/**
+ * @brief Запускает тесты (все или с подстрокой-фильтром в имени) и
+ * возвращает 1, если хоть один провален.
+ */
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* budgetPath = "tests/budgets.txt";
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--budgets=", 10) == 0) {
+            budgetPath = arg + 10;
+        } else if (strncmp(arg, "--seed=", 7) == 0) {
+            seed = strtoull(arg + 7, nullptr, 10);
+        } else if (strncmp(arg, "--samples=", 10) == 0) {
+            samples = strtoull(arg + 10, nullptr, 10);
+        } else if (strcmp(arg, "--verbose") == 0) {
+            verbose = true;
+        } else if (strncmp(arg, "--simd=", 7) == 0) {
+            SimdLevel level;
+            if (!ParseSimdLevel(arg + 7, level) || !SetActiveSimdLevel(level)) {
+                printf("уровень %s неизвестен или не поддерживается процессором\n", arg + 7);
+                return 2;
+            }
+        } else if (arg[0] == '-') {
+            printf("usage: %s [filter] [--budgets=FILE] [--seed=N] [--samples=N] [--simd=LEVEL] [--verbose]\n",
+                   argv[0]);
+            return 2;
+        } else {
+            filter = arg;
+        }
+    }
+    if (!LoadBudgets(budgetPath)) {
+        return 2;
+    }
+    size_t run = 0, failed = 0;
+    for (const TestEntry& entry : Registry()) {
+        if (filter && !strstr(entry.name, filter)) {
+            continue;
+        }
+        TestState state(entry.name);
+        try {
+            entry.fn(state);
+        } catch (const exception& e) {
+            state.Fail(string("исключение: ") + e.what());
+        }
+        ++run;
+        if (state.Failures()) {
+            ++failed;
+        }
+        printf("[%s] %s\n", state.Failures() ? "FAIL" : " OK ", entry.name);
+        fflush(stdout);
+    }
+    if (!filter) {
+        for (const auto& budget : budgets) {
+            if (!usedBudgets.count(budget.first)) {
+                printf("предупреждение: бюджет %s ни разу не проверен\n", budget.first.c_str());
+            }
+        }
+    }
+    printf("%zu тестов, провалено %zu (seed %llu, simd %s)\n", run, failed, (unsigned long long)seed,
+           ActiveKernels().name);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../mycomplex.h"
+
+// Проверки корректности и точности (make test).
+//
+// Тест — функция void Name(TestState&), зарегистрированная макросом TEST.
+// Точные свойства проверяются EXPECT, а погрешность — статистикой ErrorStats
+// по случайным и граничным входам против эталона в long double; итог
+// сверяется с бюджетом из tests/budgets.txt (TestState::CheckBudget).
+// Метрика без бюджета — ошибка: новый быстрый путь нельзя добавить, не
+// указав его допустимую погрешность.
+
+/**
+ * @brief Эталонное комплексное значение в повышенной точности.
+ */
+struct RefComplex {
+    long double re;
+    long double im;
+};
+
+/**
+ * @brief Статистика погрешности: максимум, среднее и вход с наибольшей ошибкой.
+ */
+class ErrorStats {
+private:
+    double max_;      /**< Наибольшая погрешность.*/
+    double sum_;      /**< Сумма погрешностей (для среднего).*/
+    size_t count_;    /**< Число измерений.*/
+    Complex worstA_;  /**< Первый аргумент худшего случая.*/
+    Complex worstB_;  /**< Второй аргумент худшего случая.*/
+
+public:
+    ErrorStats() : max_(0), sum_(0), count_(0) {}
+
+    /**
+    * @brief Добавляет одно измерение
+    * @param error Погрешность (бесконечность — неверный особый случай)
+    * @param a, b Аргументы (для отчёта о худшем случае)
+    */
+    void Add(double error, const Complex& a = Complex(), const Complex& b = Complex()) {
+        if (!(error <= max_)) {
+            max_ = error;
+            worstA_ = a;
+            worstB_ = b;
+        }
+        sum_ += error;
+        ++count_;
+    }
+
+    double Max() const { return max_; }
+    double Mean() const { return count_ ? sum_ / count_ : 0; }
+    size_t Count() const { return count_; }
+    const Complex& WorstA() const { return worstA_; }
+    const Complex& WorstB() const { return worstB_; }
+};
+
+/**
+ * @brief Состояние одного теста: число ошибок и проверка бюджетов.
+ */
+class TestState {
+private:
+    const char* name_;  /**< Имя теста.*/
+    size_t failures_;   /**< Число проваленных проверок.*/
+
+public:
+    explicit TestState(const char* name) : name_(name), failures_(0) {}
+
+    /**
+    * @brief Проваливает тест с сообщением
+    */
+    void Fail(const string& message);
+
+    /**
+    * @brief Точная проверка (через макрос EXPECT)
+    */
+    void Check(bool ok, const char* file, int line, const char* expression) {
+        if (!ok) {
+            Fail(string(file) + ":" + to_string(line) + ": " + expression);
+        }
+    }
+
+    /**
+    * @brief Сверяет максимум и среднее погрешности с бюджетом метрики из
+    * budgets.txt; печатает строку отчёта. Метрика без бюджета — провал.
+    * @param metric Имя метрики
+    * @param stats Накопленная статистика
+    * @param label Уточнение для отчёта (например, набор инструкций)
+    */
+    void CheckBudget(const string& metric, const ErrorStats& stats, const string& label = "");
+
+    const char* Name() const { return name_; }
+    size_t Failures() const { return failures_; }
+};
+
+/**
+ * @brief Регистрирует тест под заданным именем.
+ * @return Всегда true (для статической регистрации)
+ */
+bool RegisterTest(const char* name, void (*fn)(TestState&));
+
+#define TEST(fn) static const bool fn##_registered = RegisterTest(#fn, fn)
+#define EXPECT(state, condition) (state).Check((condition), __FILE__, __LINE__, #condition)
+
+/**
+ * @brief Зерно случайных входов (--seed=N, по умолчанию фиксированное)
+ */
+uint64_t TestSeed();
+
+/**
+ * @brief Число случайных входов на метрику (--samples=N)
+ */
+size_t TestSamples();
+
+/**
+ * @brief Детерминированный генератор случайных чисел (xorshift64*).
+ */
+class TestRandom {
+private:
+    uint64_t state_;
+
+public:
+    explicit TestRandom(uint64_t seed = TestSeed()) : state_(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+
+    uint64_t Next() {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 0x2545F4914F6CDD1DULL;
+    }
+
+    /** Равномерно в [lo, hi) */
+    double Uniform(double lo, double hi) { return lo + (hi - lo) * ((Next() >> 11) * 0x1p-53); }
+
+    /**
+    * @brief Случайный знак, мантисса и порядок в [minExp, maxExp]: покрывает
+    * весь диапазон порядков равномерно, включая субнормальные при minExp < -1022
+    */
+    double LogUniform(int minExp, int maxExp) {
+        int e = minExp + int(Next() % uint64_t(maxExp - minExp + 1));
+        double x = ldexp(Uniform(1, 2), e);
+        return Next() & 1 ? -x : x;
+    }
+
+    Complex LogUniformComplex(int minExp, int maxExp) {
+        double re = LogUniform(minExp, maxExp);
+        return Complex(re, LogUniform(minExp, maxExp));
+    }
+
+    Complex UniformComplex(double lo, double hi) {
+        double re = Uniform(lo, hi);
+        return Complex(re, Uniform(lo, hi));
+    }
+};
+
+/**
+ * @brief Граничные значения: нули со знаком, субнормальные, границы
+ * диапазона, бесконечности и NaN
+ */
+vector<double> EdgeValues();
+
+/**
+ * @brief Погрешность double в ULP эталона. Эталон inf или NaN требует
+ * того же результата (иначе бесконечная ошибка), как и результат inf/NaN
+ * при конечном эталоне.
+ */
+double UlpError(double got, long double ref);
+
+/**
+ * @brief То же для float
+ */
+double UlpError(float got, long double ref);
+
+/**
+ * @brief Нормированная погрешность: |got - ref| в ULP модуля эталона
+ * (особые значения — покомпонентно, как UlpError). Если часть эталона
+ * переполняется, конечная другая часть не проверяется: её значение ниже
+ * точности модуля.
+ */
+double UlpError(const Complex& got, const RefComplex& ref);
+double UlpError(const ComplexF& got, const RefComplex& ref);
+
+/**
+ * @brief Совпадение до бита, с любыми двумя NaN как равными
+ */
+bool SameValue(double a, double b);
+bool SameValue(const Complex& a, const Complex& b);
+
+// Эталонная арифметика в long double.
+inline RefComplex ToRef(const Complex& z) { return RefComplex{z.Re(), z.Im()}; }
+inline RefComplex ToRef(const ComplexF& z) { return RefComplex{z.Re(), z.Im()}; }
+inline RefComplex RefAdd(RefComplex a, RefComplex b) { return RefComplex{a.re + b.re, a.im + b.im}; }
+inline RefComplex RefSub(RefComplex a, RefComplex b) { return RefComplex{a.re - b.re, a.im - b.im}; }
+inline RefComplex RefMul(RefComplex a, RefComplex b) {
+    return RefComplex{a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+}
+/** Деление: порядки long double вмещают любые квадраты частей double без переполнения */
+inline RefComplex RefDiv(RefComplex a, RefComplex b) {
+    long double d = b.re * b.re + b.im * b.im;
+    return RefComplex{(a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d};
+}
+inline long double RefAbs(RefComplex a) { return sqrtl(a.re * a.re + a.im * a.im); }
+
+// Эталонные элементарные функции (главные ветви, как complexmath.h).
+long double RefArg(const Complex& z);
+RefComplex RefPolar(long double r, long double theta);
+RefComplex RefExp(const Complex& z);
+/** log|z| без потерь при |z| -> 1: x^2 + y^2 - 1 собирается из точных частей */
+RefComplex RefLog(const Complex& z);
+RefComplex RefSqrt(const Complex& z);
+RefComplex RefPow(const Complex& z, double p);
+
+#endif // TEST_H
@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "../allocator.h"
+#include "../complexarray.h"
+#include "../fft.h"
+
+// Выровненная память и арены: выравнивание, повторное использование блоков
+// после Reset() и Rewind(), буферы потоков и контейнеры поверх арены.
+
+namespace {
+
+bool Aligned(const void* p, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+void AlignedAllocation(TestState& state) {
+    for (size_t alignment : {size_t(16), kCacheLineAlignment, kPageAlignment}) {
+        void* p = AllocateAligned(1000, alignment);
+        EXPECT(state, p && Aligned(p, alignment));
+        FreeAligned(p, alignment);
+    }
+    void* huge = AllocateAligned(3 << 20, kCacheLineAlignment, PageMode::Huge);
+    EXPECT(state, Aligned(huge, kHugePageSize));
+    FreeAligned(huge, kCacheLineAlignment, PageMode::Huge);
+    EXPECT(state, AllocateAligned(0, 64) == nullptr);
+    bool thrown = false;
+    try {
+        AllocateAligned(16, 48);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+    ComplexVector v(1001, Complex(1, 2));
+    v.push_back(Complex(3, 4));
+    EXPECT(state, Aligned(v.data(), kCacheLineAlignment) && v.size() == 1002 && SameValue(v.back(), Complex(3, 4)));
+}
+TEST(AlignedAllocation);
+
+/** Reset() и Rewind() не возвращают память: те же адреса при повторе */
+void ArenaReuse(TestState& state) {
+    Arena arena(4096);
+    vector<void*> first;
+    for (size_t size : {size_t(1), size_t(100), size_t(4000), size_t(10000), size_t(64)}) {
+        void* p = arena.Allocate(size);
+        EXPECT(state, Aligned(p, Arena::kAlignment));
+        first.push_back(p);
+    }
+    size_t capacity = arena.Capacity();
+    EXPECT(state, arena.Used() > 0 && capacity >= 14000);
+    arena.Reset();
+    EXPECT(state, arena.Used() == 0);
+    size_t i = 0;
+    for (size_t size : {size_t(1), size_t(100), size_t(4000), size_t(10000), size_t(64)}) {
+        EXPECT(state, arena.Allocate(size) == first[i++]);
+    }
+    EXPECT(state, arena.Capacity() == capacity);
+    // Вложенные области: после выхода позиция прежняя.
+    Arena::Marker before = arena.Mark();
+    {
+        ArenaFrame frame(arena);
+        double* d = frame.Allocate<double>(5000);
+        d[4999] = 1;
+        EXPECT(state, Aligned(d, Arena::kAlignment));
+    }
+    EXPECT(state, arena.Mark().block == before.block && arena.Mark().offset == before.offset);
+    arena.Release();
+    EXPECT(state, arena.Capacity() == 0 && arena.Used() == 0);
+    EXPECT(state, Aligned(arena.Allocate(10), Arena::kAlignment));
+}
+TEST(ArenaReuse);
+
+/** Контейнеры и ComplexArray поверх арены; у каждого потока своя арена */
+void ArenaContainers(TestState& state) {
+    Arena arena;
+    {
+        vector<Complex, ArenaAllocator<Complex>> v{ArenaAllocator<Complex>(arena)};
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(Complex(i, -i));
+        }
+        EXPECT(state, SameValue(v[999], Complex(999, -999)) && Aligned(v.data(), Arena::kAlignment));
+    }
+    arena.Reset();
+    ComplexArray a = ComplexArray::FromArena(arena, 100), b(100);
+    for (size_t i = 0; i < 100; ++i) {
+        a.Set(i, Complex(double(i), 1));
+        b.Set(i, Complex(2, double(i)));
+    }
+    Mul(a, b, a);
+    EXPECT(state, SameValue(a[7], Complex(7, 1) * Complex(2, 7)) && Aligned(a.Re(), ComplexArray::kAlignment));
+    bool thrown = false;
+    try {
+        a.Resize(200);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+    Arena* other = nullptr;
+    thread worker([&] { other = &ThreadArena(); });
+    worker.join();
+    EXPECT(state, other != &ThreadArena());
+}
+TEST(ArenaContainers);
+
+/** БПФ без внешнего буфера (арена потока) — до бита как с буфером */
+void FftScratchFromArena(TestState& state) {
+    TestRandom random;
+    for (size_t n : {1000, 4096, 65536}) {
+        shared_ptr<const FftPlan> plan = FftPlan::Get(n);
+        vector<Complex> x(n), y(n), z(n), scratch(plan->ScratchSize());
+        for (Complex& v : x) {
+            v = random.UniformComplex(-1, 1);
+        }
+        size_t used = ThreadArena().Used();
+        plan->Execute(x.data(), y.data(), FftDirection::Forward);
+        plan->Execute(x.data(), z.data(), FftDirection::Forward, scratch.data());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < n; ++i) {
+            mismatches += !SameValue(y[i], z[i]);
+        }
+        EXPECT(state, mismatches == 0 && ThreadArena().Used() == used);
+    }
+}
+TEST(FftScratchFromArena);
+
+} // namespace
@@ -0,0 +1,222 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "test.h"
+#include "../convolution.h"
+
+// Свёртка и корреляция: все способы против прямой суммы в long double (в
+// единицах DBL_EPSILON * |h| * rms(x), как у КИХ-фильтра конвейера),
+// потоковая свёртка по разбиениям при любом разбиении входа, выбор способа
+// и файл настройки.
+
+namespace {
+
+vector<Complex> RandomSignal(TestRandom& random, size_t n) {
+    vector<Complex> x(n);
+    for (Complex& z : x) {
+        z = random.UniformComplex(-1, 1);
+    }
+    return x;
+}
+
+/** Ошибки out против sum x[j] * h[k - j] в единицах DBL_EPSILON * |h| * rms(x) */
+void AddErrors(ErrorStats& stats, const vector<Complex>& x, const vector<Complex>& h, const vector<Complex>& out) {
+    long double hh = 0, xx = 0;
+    for (const Complex& z : h) {
+        hh += RefAbs(ToRef(z)) * RefAbs(ToRef(z));
+    }
+    for (const Complex& z : x) {
+        xx += RefAbs(ToRef(z)) * RefAbs(ToRef(z));
+    }
+    long double scale = sqrtl(hh * xx / x.size()) * DBL_EPSILON;
+    for (size_t k = 0; k < out.size(); ++k) {
+        RefComplex sum{0, 0};
+        for (size_t j = k >= h.size() ? k - h.size() + 1 : 0; j < x.size() && j <= k; ++j) {
+            sum = RefAdd(sum, RefMul(ToRef(x[j]), ToRef(h[k - j])));
+        }
+        stats.Add(double(hypotl(out[k].Re() - sum.re, out[k].Im() - sum.im) / scale), x[0], h[0]);
+    }
+}
+
+bool Same(const vector<Complex>& a, const vector<Complex>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!SameValue(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const ConvolutionMethod kMethods[] = {ConvolutionMethod::Direct, ConvolutionMethod::OverlapAdd,
+                                      ConvolutionMethod::OverlapSave, ConvolutionMethod::Partitioned};
+const char* const kBudgets[] = {"Conv_Direct", "Conv_OverlapAdd", "Conv_OverlapSave", "Conv_Partitioned"};
+
+/** Все способы на длинах с краевыми случаями; Auto совпадает с выбранным способом */
+void ConvolveMethods(TestState& state) {
+    TestRandom random;
+    const size_t shapes[][2] = {{1, 1}, {5, 3}, {3, 5}, {1000, 1}, {700, 33}, {2000, 300}, {4000, 1000}};
+    ErrorStats errors[4];
+    for (const size_t* shape : shapes) {
+        vector<Complex> x = RandomSignal(random, shape[0]), h = RandomSignal(random, shape[1]);
+        vector<Complex> results[4];
+        for (size_t i = 0; i < 4; ++i) {
+            results[i].resize(x.size() + h.size() - 1);
+            Convolve(x.data(), x.size(), h.data(), h.size(), results[i].data(), kMethods[i]);
+            AddErrors(errors[i], x, h, results[i]);
+        }
+        vector<Complex> automatic(x.size() + h.size() - 1);
+        Convolve(x.data(), x.size(), h.data(), h.size(), automatic.data());
+        ConvolutionMethod chosen = SelectConvolutionMethod(x.size(), h.size());
+        EXPECT(state, chosen != ConvolutionMethod::Auto && chosen != ConvolutionMethod::Partitioned);
+        for (size_t i = 0; i < 4; ++i) {
+            if (kMethods[i] == chosen) {
+                EXPECT(state, Same(automatic, results[i]));
+            }
+        }
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        state.CheckBudget(kBudgets[i], errors[i]);
+    }
+    Convolve(nullptr, 0, nullptr, 3, nullptr);
+}
+TEST(ConvolveMethods);
+
+/** Корреляция против свёртки с перевёрнутым сопряжённым образцом; пик согласованного фильтра */
+void CorrelateMatched(TestState& state) {
+    TestRandom random;
+    const size_t n = 3000, m = 200, offset = 1234;
+    vector<Complex> pulse = RandomSignal(random, m), x = RandomSignal(random, n), reversed(m);
+    for (size_t j = 0; j < m; ++j) {
+        reversed[j] = Complex(pulse[m - 1 - j].Re(), -pulse[m - 1 - j].Im());
+    }
+    // Импульс в слабом шуме: наибольший модуль — на его сдвиге.
+    vector<Complex> received(n);
+    for (size_t i = 0; i < n; ++i) {
+        received[i] = 0.05 * x[i] + (i >= offset && i < offset + m ? pulse[i - offset] : Complex());
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        vector<Complex> r(n + m - 1);
+        Correlate(x.data(), n, pulse.data(), m, r.data(), kMethods[i]);
+        ErrorStats error;
+        AddErrors(error, x, reversed, r);
+        state.CheckBudget(kBudgets[i], error, " [correlate]");
+        Correlate(received.data(), n, pulse.data(), m, r.data(), kMethods[i]);
+        size_t peak = 0;
+        for (size_t k = 1; k < r.size(); ++k) {
+            if (r[k].AbsSquared() > r[peak].AbsSquared()) {
+                peak = k;
+            }
+        }
+        EXPECT(state, peak == offset + m - 1);
+    }
+}
+TEST(CorrelateMatched);
+
+/** Подаёт x в ступень кусками случайной длины до maxChunk */
+vector<Complex> Feed(StreamStage& stage, const vector<Complex>& x, TestRandom& random, size_t maxChunk) {
+    vector<Complex> y, out;
+    for (size_t done = 0; done < x.size();) {
+        size_t m = size_t(random.Next() % (maxChunk + 1));
+        m = m < x.size() - done ? m : x.size() - done;
+        out.resize(stage.MaxOutput(m));
+        size_t produced = stage.Process(x.data() + done, m, out.data());
+        y.insert(y.end(), out.begin(), out.begin() + produced);
+        done += m;
+    }
+    return y;
+}
+
+/** Потоковая свёртка по разбиениям: порции по блоку, одинаковый выход при любом разбиении входа */
+void PartitionedStream(TestState& state) {
+    TestRandom random;
+    vector<Complex> h = RandomSignal(random, 300), x = RandomSignal(random, 5000);
+    PartitionedConvolver convolver(h.data(), h.size(), 32);
+    EXPECT(state, convolver.BlockLength() == 32 && convolver.Partitions() == 10);
+    vector<Complex> a = Feed(convolver, x, random, 7);
+    convolver.Reset();
+    vector<Complex> b = Feed(convolver, x, random, 500);
+    EXPECT(state, a.size() == x.size() / 32 * 32 && Same(a, b));
+    ErrorStats error;
+    vector<Complex> head(x.begin(), x.begin() + a.size());
+    AddErrors(error, head, h, a);
+    state.CheckBudget("Conv_Partitioned", error, " [stream]");
+
+    // Выбор ступени по наибольшей порции выхода.
+    unique_ptr<StreamStage> fast = MakeConvolver(h.data(), h.size());
+    unique_ptr<StreamStage> low = MakeConvolver(h.data(), h.size(), 100);
+    PartitionedConvolver* partitioned = dynamic_cast<PartitionedConvolver*>(low.get());
+    EXPECT(state, string(fast->Name()) == "fir" && partitioned && partitioned->BlockLength() == 64);
+    vector<Complex> viaFactory = Feed(*low, x, random, 1000);
+    PartitionedConvolver reference(h.data(), h.size(), 64);
+    EXPECT(state, Same(viaFactory, Feed(reference, x, random, 64)));
+
+    bool thrown = false;
+    try {
+        PartitionedConvolver bad(h.data(), h.size(), 48);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(PartitionedStream);
+
+/** Настройка: калибровка, сохранение и чтение, неверные значения */
+void ConvolutionTuningFile(TestState& state) {
+    ConvolutionTuning saved = GetConvolutionTuning();
+    ConvolutionTuning measured = CalibrateConvolution(1e-4);
+    EXPECT(state, measured.fftBlockFactor >= 2 && (measured.fftBlockFactor & (measured.fftBlockFactor - 1)) == 0);
+    EXPECT(state, measured.blockMethod == ConvolutionMethod::OverlapAdd ||
+                      measured.blockMethod == ConvolutionMethod::OverlapSave);
+
+    ConvolutionTuning tuning;
+    tuning.directMaxTaps = 5;
+    tuning.fftBlockFactor = 16;
+    tuning.blockMethod = ConvolutionMethod::OverlapAdd;
+    const string path = "bin/testconvolution-" + to_string(TestSeed()) + ".txt";
+    SaveConvolutionTuning(tuning, path);
+    ConvolutionTuning loaded = LoadConvolutionTuning(path);
+    EXPECT(state, loaded.directMaxTaps == 5 && loaded.fftBlockFactor == 16 &&
+                      loaded.blockMethod == ConvolutionMethod::OverlapAdd);
+    SetConvolutionTuning(loaded);
+    EXPECT(state, SelectConvolutionMethod(1000, 5) == ConvolutionMethod::Direct);
+    EXPECT(state, SelectConvolutionMethod(6, 1000) == ConvolutionMethod::OverlapAdd);
+    SetConvolutionTuning(saved);
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (file) {
+        fputs("direct_max_taps 8\nfft_block_factor 3\n", file);
+        fclose(file);
+    }
+    bool thrown = false;
+    try {
+        LoadConvolutionTuning(path);
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+    remove(path.c_str());
+    thrown = false;
+    try {
+        LoadConvolutionTuning("bin/testconvolution-missing.txt");
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+    thrown = false;
+    try {
+        tuning.blockMethod = ConvolutionMethod::Direct;
+        SetConvolutionTuning(tuning);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(ConvolutionTuningFile);
+
+} // namespace
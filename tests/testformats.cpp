@@ -0,0 +1,273 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include "test.h"
+#include "../complexbatch.h"
+#include "../complexfile.h"
+#include "../complexio.h"
+#include "../complexstorage.h"
+
+// Текстовый и двоичный ввод-вывод и форматы хранения: круговые
+// преобразования без потерь, округление к ближайшему чётному и насыщение.
+
+namespace {
+
+/** Случайные числа по всему диапазону и граничные значения, кроме NaN */
+vector<Complex> Values() {
+    TestRandom random;
+    vector<Complex> z;
+    for (size_t i = 0; i < TestSamples() / 10; ++i) {
+        z.push_back(random.LogUniformComplex(-1074, 1023));
+    }
+    for (double re : EdgeValues()) {
+        for (double im : EdgeValues()) {
+            if (!isnan(re) && !isnan(im)) {
+                z.emplace_back(re, im);
+            }
+        }
+    }
+    return z;
+}
+
+/** Текст -> число -> текст: кратчайшая запись читается обратно точно */
+void TextRoundTrip(TestState& state) {
+    vector<Complex> z = Values();
+    char buffer[kMaxComplexChars];
+    for (ComplexTextFormat format : {ComplexTextFormat::Pair, ComplexTextFormat::Algebraic, ComplexTextFormat::Tuple}) {
+        size_t mismatches = 0;
+        for (const Complex& value : z) {
+            to_chars_result written = ToChars(buffer, buffer + sizeof(buffer), value, format);
+            Complex parsed;
+            from_chars_result read = FromChars(buffer, written.ptr, parsed);
+            mismatches += written.ec != errc() || read.ec != errc() || read.ptr != written.ptr ||
+                          !SameValue(parsed, value);
+        }
+        EXPECT(state, mismatches == 0);
+        // Пакетно, с разделителями.
+        vector<char> text(z.size() * kMaxComplexChars);
+        ComplexFormatResult formatted = FormatComplex(z.data(), z.size(), text.data(), text.data() + text.size(), format);
+        EXPECT(state, formatted.count == z.size());
+        vector<Complex> parsed = ParseComplexText(text.data(), formatted.ptr);
+        EXPECT(state, parsed.size() == z.size());
+        for (size_t i = 0; i < parsed.size() && i < z.size(); ++i) {
+            mismatches += !SameValue(parsed[i], z[i]);
+        }
+        EXPECT(state, mismatches == 0);
+    }
+    // Ошибка разбора указывает смещение.
+    const char bad[] = "1+2i 3-4i (5,x)";
+    size_t offset = 0;
+    try {
+        ParseComplexText(bad, bad + sizeof(bad) - 1);
+    } catch (const ComplexParseError& e) {
+        offset = e.Offset();
+    }
+    EXPECT(state, offset >= 10 && offset < sizeof(bad) - 1);
+}
+TEST(TextRoundTrip);
+
+/** Двоичный файл: f64 без потерь в обеих раскладках, f32 — округление float */
+void FileRoundTrip(TestState& state) {
+    vector<Complex> z = Values();
+    // Имя с seed: прогоны с разными seed можно запускать параллельно.
+    const string path = "bin/testformats-" + to_string(TestSeed()) + ".cplx";
+    for (ComplexLayout layout : {ComplexLayout::Interleaved, ComplexLayout::Split}) {
+        for (ComplexDType dtype : {ComplexDType::F64, ComplexDType::F32}) {
+            WriteComplexFile(path, z.data(), z.size() / 2, layout, dtype);
+            {
+                ComplexFileWriter writer(path, layout, dtype, ComplexFileMode::Append);
+                writer.Write(z.data() + z.size() / 2, z.size() - z.size() / 2);
+                writer.Close();
+            }
+            ComplexFile file(path);
+            vector<Complex> read = file.ToVector();
+            EXPECT(state, file.Count() == z.size() && read.size() == z.size());
+            size_t mismatches = 0;
+            for (size_t i = 0; i < read.size() && i < z.size(); ++i) {
+                Complex expected = dtype == ComplexDType::F64 ? z[i] : Complex(ComplexF(z[i]));
+                mismatches += !SameValue(read[i], expected);
+            }
+            EXPECT(state, mismatches == 0);
+        }
+    }
+    remove(path.c_str());
+    bool thrown = false;
+    try {
+        ComplexFile missing("bin/testformats-missing.cplx");
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(FileRoundTrip);
+
+/**
+ * @brief Файл отображается только для чтения; SplitView включает копирование
+ * при записи, и изменения не попадают на диск; смещение данных, не кратное
+ * размеру части, отвергается до приведения указателей
+ */
+void FileMapping(TestState& state) {
+    vector<Complex> z = Values();
+    const string path = "bin/testformats-map-" + to_string(TestSeed()) + ".cplx";
+    WriteComplexFile(path, z.data(), z.size(), ComplexLayout::Interleaved);
+    {
+        ComplexFile file(path);
+        ComplexView view = file.View();
+        EXPECT(state, view.Size() == z.size() && SameValue(view[1], z[1]));
+    }
+    WriteComplexFile(path, z.data(), z.size(), ComplexLayout::Split);
+    {
+        ComplexFile file(path);
+        ComplexArray a = file.SplitView();
+        EXPECT(state, a.Size() == z.size() && SameValue(a[1], z[1]));
+        a.Set(1, Complex(7, -7));
+        EXPECT(state, SameValue(file.SplitView()[1], Complex(7, -7)));
+    }
+    EXPECT(state, SameValue(ComplexFile(path).ToVector()[1], z[1]));
+
+    // Interleaved f64 с dataOffset = 68: на один элемент меньше, чтобы данные помещались.
+    WriteComplexFile(path, z.data(), z.size(), ComplexLayout::Interleaved);
+    FILE* f = fopen(path.c_str(), "r+b");
+    ComplexFileHeader header;
+    bool patched = f && fread(&header, sizeof(header), 1, f) == 1;
+    if (patched) {
+        header.count -= 1;
+        header.dataOffset = 68;
+        patched = fseek(f, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, f) == 1;
+    }
+    if (f) {
+        fclose(f);
+    }
+    EXPECT(state, patched);
+    bool thrown = false;
+    try {
+        ComplexFile misaligned(path);
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+    remove(path.c_str());
+}
+TEST(FileMapping);
+
+/** Значение binary16 по определению стандарта */
+double HalfValue(uint16_t bits) {
+    int exponent = (bits >> 10) & 0x1f;
+    int mantissa = bits & 0x3ff;
+    double sign = bits & 0x8000 ? -1 : 1;
+    if (exponent == 0x1f) {
+        return mantissa ? NAN : sign * INFINITY;
+    }
+    if (exponent == 0) {
+        return sign * ldexp(mantissa, -24);
+    }
+    return sign * ldexp(1024 + mantissa, exponent - 25);
+}
+
+/** h — ближайшее к x значение binary16, при равенстве — с чётной мантиссой */
+bool NearestHalf(double x, uint16_t h) {
+    double got = HalfValue(h);
+    if (fabs(x) >= 65520) {
+        return isinf(got) && signbit(got) == signbit(x);
+    }
+    // Соседи по модулю: отличаются на единицу в битах.
+    double below = (h & 0x7fff) ? HalfValue(uint16_t(h - 1)) : got;
+    double above = HalfValue(uint16_t(h + 1));
+    double error = fabs(got - x);
+    if (error > fabs(below - x) || error > fabs(above - x)) {
+        return false;
+    }
+    return !((error == fabs(below - x) || error == fabs(above - x)) && got != x && (h & 1));
+}
+
+/**
+ * @brief binary16: все 65536 значений переводятся во float точно и обратно
+ * без изменений; округление float и double — к ближайшему, при равенстве к
+ * чётному, у double — одно (не через float).
+ */
+void HalfConversion(TestState& state) {
+    size_t mismatches = 0;
+    for (uint32_t bits = 0; bits < 65536; ++bits) {
+        Half h = Half::FromBits(uint16_t(bits));
+        float x = h.ToFloat();
+        mismatches += !SameValue(x, HalfValue(uint16_t(bits)));
+        mismatches += !isnan(x) && Half::FromFloat(x).bits != bits;
+        mismatches += isnan(x) && !isnan(Half::FromFloat(x).ToFloat());
+    }
+    EXPECT(state, mismatches == 0);
+    // Случайные float и середины между соседними binary16.
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        float x = i % 2 ? float(random.LogUniform(-26, 16)) : float(HalfValue(uint16_t(random.Next())) * (1 + 0x1p-11));
+        if (isnan(x)) {
+            continue;
+        }
+        mismatches += !NearestHalf(x, Half::FromFloat(x).bits);
+    }
+    EXPECT(state, mismatches == 0);
+
+    // Чуть больше середины: через float (округление к ближайшему) середина
+    // стала бы точной, и второе округление ушло бы к чётному вниз.
+    EXPECT(state, Half::FromDouble(1 + 0x1p-11 + 0x1p-40).bits == 0x3c01);
+    EXPECT(state, Half::FromDouble(-(1 + 0x1p-11 + 0x1p-40)).bits == 0xbc01);
+    EXPECT(state, Half::FromDouble(1 + 0x1p-11).bits == 0x3c00);
+    EXPECT(state, Half::FromDouble(1 + 0x1p-11 - 0x1p-40).bits == 0x3c00);
+    EXPECT(state, Half::FromDouble(1 + 0x1.8p-10 - 0x1p-45).bits == 0x3c01);
+    EXPECT(state, Half::FromDouble(0x1p-25 + 0x1p-60).bits == 0x0001);
+    EXPECT(state, Half::FromDouble(65520 - 0x1p-30).bits == 0x7bff && Half::FromDouble(65520).bits == 0x7c00);
+    EXPECT(state, Half::FromDouble(1e300).bits == 0x7c00 && isnan(Half::FromDouble(NAN).ToFloat()));
+    // Середины между соседними binary16 со сдвигом в младших битах double;
+    // пакетное преобразование и ComplexCast — как Half::FromDouble.
+    vector<Complex> z;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        double middle = HalfValue(uint16_t(random.Next())) * (1 + 0x1p-11);
+        double offset = ldexp(random.Uniform(-1, 1), -int(random.Next() % 40) - 12);
+        z.emplace_back(middle * (1 + offset), i % 2 ? random.LogUniform(-26, 16) : middle);
+    }
+    vector<ComplexHalf> halves(z.size());
+    Convert(z.data(), halves.data(), z.size());
+    for (size_t i = 0; i < z.size(); ++i) {
+        ComplexHalf cast = ComplexCast<Half>(z[i]);
+        mismatches += halves[i].Re().bits != cast.Re().bits || halves[i].Im().bits != cast.Im().bits;
+        for (double x : {z[i].Re(), z[i].Im()}) {
+            mismatches += !isnan(x) && !NearestHalf(x, Half::FromDouble(x).bits);
+        }
+    }
+    EXPECT(state, mismatches == 0);
+}
+TEST(HalfConversion);
+
+/** Q15: округление к ближайшему чётному, насыщение и NaN -> 0 */
+void Q15Conversion(TestState& state) {
+    EXPECT(state, Q15::FromDouble(1.0).raw == 32767);
+    EXPECT(state, Q15::FromDouble(-1.0).raw == -32768);
+    EXPECT(state, Q15::FromDouble(1e300).raw == 32767);
+    EXPECT(state, Q15::FromDouble(-INFINITY).raw == -32768);
+    EXPECT(state, Q15::FromDouble(NAN).raw == 0);
+    EXPECT(state, Q15::FromDouble(0.5 / 32768).raw == 0);
+    EXPECT(state, Q15::FromDouble(1.5 / 32768).raw == 2);
+    EXPECT(state, Q15::FromDouble(-2.5 / 32768).raw == -2);
+    size_t mismatches = 0;
+    for (int raw = -32768; raw <= 32767; ++raw) {
+        mismatches += Q15::FromDouble(Q15::FromRaw(int16_t(raw)).ToDouble()).raw != raw;
+    }
+    EXPECT(state, mismatches == 0);
+    // Насыщающая арифметика.
+    ComplexQ15 max = ComplexQ15::FromRaw(32767, -32768);
+    EXPECT(state, (max + max).RawRe() == 32767 && (max + max).RawIm() == -32768);
+    EXPECT(state, (ComplexQ15::FromRaw(-32768, 0) * ComplexQ15::FromRaw(-32768, 0)).RawRe() == 32767);
+    // Пакетное преобразование — как ComplexCast.
+    vector<Complex> z = Values();
+    vector<ComplexQ15> q(z.size());
+    Convert(z.data(), q.data(), z.size());
+    for (size_t i = 0; i < z.size(); ++i) {
+        ComplexQ15 expected = ComplexCast<Q15>(z[i]);
+        mismatches += q[i].RawRe() != expected.RawRe() || q[i].RawIm() != expected.RawIm();
+    }
+    EXPECT(state, mismatches == 0);
+}
+TEST(Q15Conversion);
+
+} // namespace
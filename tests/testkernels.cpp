@@ -0,0 +1,546 @@
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include "test.h"
+#include "../complexmath.h"
+#include "../complexstorage.h"
+#include "../simd.h"
+
+// Векторные ядра каждого набора инструкций, который есть у процессора,
+// против скалярного Complex (где ядро обещает тот же результат — до бита)
+// и против эталона в long double. Длины нечётные, чтобы проверить и хвосты.
+
+namespace {
+
+const size_t kLength = 1027;
+
+/**
+ * @brief Комплексный массив в двух видах: раздельные re/im и чередующиеся пары.
+ */
+struct Data {
+    vector<double> re, im, pairs;
+
+    explicit Data(const vector<Complex>& z) : re(z.size()), im(z.size()), pairs(2 * z.size()) {
+        for (size_t i = 0; i < z.size(); ++i) {
+            re[i] = pairs[2 * i] = z[i].Re();
+            im[i] = pairs[2 * i + 1] = z[i].Im();
+        }
+    }
+
+    size_t Size() const { return re.size(); }
+    Complex operator[](size_t i) const { return Complex(re[i], im[i]); }
+};
+
+/** Выход ядра над раздельными массивами */
+struct Output {
+    vector<double> re, im;
+
+    explicit Output(size_t n) : re(n), im(n) {}
+    Complex operator[](size_t i) const { return Complex(re[i], im[i]); }
+};
+
+/** Наборы инструкций, поддерживаемые процессором */
+vector<SimdLevel> Levels() {
+    vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (int(level) <= int(DetectSimdLevel())) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+string Label(const SimdKernels& kernels) {
+    return string(" [") + kernels.name + "]";
+}
+
+/** Случайные числа с порядками частей в [minExp, maxExp], затем все пары граничных значений */
+vector<Complex> Inputs(TestRandom& random, int minExp, int maxExp) {
+    vector<Complex> z;
+    for (size_t i = 0; i < kLength; ++i) {
+        z.push_back(random.LogUniformComplex(minExp, maxExp));
+    }
+    for (double re : EdgeValues()) {
+        for (double im : EdgeValues()) {
+            z.emplace_back(re, im);
+        }
+    }
+    return z;
+}
+
+/** Число повторов со свежими входами, чтобы набрать TestSamples() измерений */
+size_t Rounds() {
+    return TestSamples() / kLength + 1;
+}
+
+/** Совпадение чередующихся пар с раздельными массивами */
+bool SamePairs(const vector<double>& pairs, const Output& split) {
+    for (size_t i = 0; i < split.re.size(); ++i) {
+        if (!SameValue(Complex(pairs[2 * i], pairs[2 * i + 1]), split[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SameArray(const vector<double>& a, const vector<double>& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!SameValue(a[i], b[i])) {
+            return false;
+        }
+    }
+    return a.size() == b.size();
+}
+
+/** Относительная погрешность (для приближённых режимов) */
+double RelativeError(const Complex& got, const RefComplex& ref) {
+    long double dr = got.Re() - ref.re, di = got.Im() - ref.im;
+    long double error = sqrtl(dr * dr + di * di) / RefAbs(ref);
+    return isfinite(got.Re()) && isfinite(got.Im()) ? double(error) : numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Сложение, умножение и деление совпадают со скалярными операторами
+ * до бита, включая особые значения и переход на скалярный путь.
+ */
+void KernelArithmetic(TestState& state) {
+    TestRandom random;
+    for (SimdLevel level : Levels()) {
+        const SimdKernels& k = KernelsFor(level);
+        for (size_t round = 0; round < Rounds(); ++round) {
+            Data a(Inputs(random, -1074, 1023)), b(Inputs(random, -1074, 1023));
+            size_t n = a.Size();
+            Complex s = random.LogUniformComplex(-20, 20);
+            double kr = random.LogUniform(-20, 20);
+            Output add(n), sub(n), mul(n), conjMul(n), scale(n), scaleComplex(n);
+            Output div(n), divFast(n), reciprocal(n), reciprocalFast(n);
+            k.add(a.re.data(), a.im.data(), b.re.data(), b.im.data(), add.re.data(), add.im.data(), n);
+            k.sub(a.re.data(), a.im.data(), b.re.data(), b.im.data(), sub.re.data(), sub.im.data(), n);
+            k.mul(a.re.data(), a.im.data(), b.re.data(), b.im.data(), mul.re.data(), mul.im.data(), n);
+            k.conjMul(a.re.data(), a.im.data(), b.re.data(), b.im.data(), conjMul.re.data(), conjMul.im.data(), n);
+            k.scale(a.re.data(), a.im.data(), kr, scale.re.data(), scale.im.data(), n);
+            k.scaleComplex(s.Re(), s.Im(), a.re.data(), a.im.data(), scaleComplex.re.data(), scaleComplex.im.data(), n);
+            k.div(a.re.data(), a.im.data(), b.re.data(), b.im.data(), div.re.data(), div.im.data(), n);
+            k.divFast(a.re.data(), a.im.data(), b.re.data(), b.im.data(), divFast.re.data(), divFast.im.data(), n);
+            k.reciprocal(b.re.data(), b.im.data(), reciprocal.re.data(), reciprocal.im.data(), n);
+            k.reciprocalFast(b.re.data(), b.im.data(), reciprocalFast.re.data(), reciprocalFast.im.data(), n);
+            size_t mismatches[10] = {};
+            for (size_t i = 0; i < n; ++i) {
+                Complex x = a[i], y = b[i];
+                mismatches[0] += !SameValue(add[i], x + y);
+                mismatches[1] += !SameValue(sub[i], x - y);
+                mismatches[2] += !SameValue(mul[i], x * y);
+                mismatches[3] += !SameValue(conjMul[i], x * Conj(y));
+                mismatches[4] += !SameValue(scale[i], x * kr);
+                mismatches[5] += !SameValue(scaleComplex[i], s * x);
+                mismatches[6] += !SameValue(div[i], x / y);
+                mismatches[7] += !SameValue(divFast[i], x.FastDivide(y));
+                mismatches[8] += !SameValue(reciprocal[i], y.Reciprocal());
+                mismatches[9] += !SameValue(reciprocalFast[i], y.FastReciprocal());
+            }
+            const char* names[10] = {"add", "sub", "mul", "conjMul", "scale",
+                                     "scaleComplex", "div", "divFast", "reciprocal", "reciprocalFast"};
+            for (size_t j = 0; j < 10; ++j) {
+                if (mismatches[j]) {
+                    state.Fail(string(names[j]) + Label(k) + ": " + to_string(mismatches[j]) +
+                               " элементов отличаются от скалярного Complex");
+                }
+            }
+            // Чередующиеся пары — те же результаты.
+            vector<double> out(2 * n);
+            k.mulInterleaved(a.pairs.data(), b.pairs.data(), out.data(), n);
+            EXPECT(state, SamePairs(out, mul));
+            k.divInterleaved(a.pairs.data(), b.pairs.data(), out.data(), n);
+            EXPECT(state, SamePairs(out, div));
+            k.divFastInterleaved(a.pairs.data(), b.pairs.data(), out.data(), n);
+            EXPECT(state, SamePairs(out, divFast));
+            k.reciprocalInterleaved(b.pairs.data(), out.data(), n);
+            EXPECT(state, SamePairs(out, reciprocal));
+            k.reciprocalFastInterleaved(b.pairs.data(), out.data(), n);
+            EXPECT(state, SamePairs(out, reciprocalFast));
+            k.scaleComplexInterleaved(s.Re(), s.Im(), a.pairs.data(), out.data(), n);
+            EXPECT(state, SamePairs(out, scaleComplex));
+            // На месте: выход совпадает со входом.
+            Data c = a;
+            k.mul(c.re.data(), c.im.data(), b.re.data(), b.im.data(), c.re.data(), c.im.data(), n);
+            EXPECT(state, SameArray(c.re, mul.re) && SameArray(c.im, mul.im));
+        }
+    }
+}
+TEST(KernelArithmetic);
+
+void KernelAxpyDot(TestState& state) {
+    TestRandom random;
+    for (SimdLevel level : Levels()) {
+        const SimdKernels& k = KernelsFor(level);
+        ErrorStats axpy, dot, dotCompensated;
+        for (size_t round = 0; round < Rounds(); ++round) {
+            vector<Complex> xs, ys;
+            for (size_t i = 0; i < kLength; ++i) {
+                xs.push_back(random.UniformComplex(-1, 1));
+                ys.push_back(random.UniformComplex(-1, 1));
+            }
+            Data x(xs), y(ys);
+            size_t n = x.Size();
+            Complex a = random.UniformComplex(-2, 2);
+            Output out(n);
+            out.re = y.re;
+            out.im = y.im;
+            k.axpy(a.Re(), a.Im(), x.re.data(), x.im.data(), out.re.data(), out.im.data(), n);
+            vector<double> pairs = y.pairs;
+            k.axpyInterleaved(a.Re(), a.Im(), x.pairs.data(), pairs.data(), n);
+            EXPECT(state, SamePairs(pairs, out));
+            // y + a * x сокращается, поэтому ошибка — в ULP от |y| + |a| |x|, как у Dot.
+            for (size_t i = 0; i < n; ++i) {
+                RefComplex ref = RefAdd(ToRef(y[i]), RefMul(ToRef(a), ToRef(x[i])));
+                long double dr = out.re[i] - ref.re, di = out.im[i] - ref.im;
+                long double scale = RefAbs(ToRef(y[i])) + RefAbs(ToRef(a)) * RefAbs(ToRef(x[i]));
+                axpy.Add(double(sqrtl(dr * dr + di * di) / (scale * DBL_EPSILON)), x[i], y[i]);
+            }
+            for (bool conj : {false, true}) {
+                RefComplex sum{0, 0};
+                long double magnitude = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    RefComplex yi = ToRef(y[i]);
+                    if (conj) {
+                        yi.im = -yi.im;
+                    }
+                    sum = RefAdd(sum, RefMul(ToRef(x[i]), yi));
+                    magnitude += RefAbs(ToRef(x[i])) * RefAbs(yi);
+                }
+                double fast[2], compensated[2], pairFast[2], pairCompensated[2];
+                k.dot(x.re.data(), x.im.data(), y.re.data(), y.im.data(), n, conj, false, fast);
+                k.dot(x.re.data(), x.im.data(), y.re.data(), y.im.data(), n, conj, true, compensated);
+                k.dotInterleaved(x.pairs.data(), y.pairs.data(), n, conj, false, pairFast);
+                k.dotInterleaved(x.pairs.data(), y.pairs.data(), n, conj, true, pairCompensated);
+                // Быстрая сумма — в ULP от sum |x| |y| (число обусловленности
+                // не зависит от ядра), компенсированная — в ULP самой суммы.
+                RefComplex scale{magnitude, 0};
+                const long double ulp = DBL_EPSILON;
+                for (const double* got : {fast, pairFast}) {
+                    long double dr = got[0] - sum.re, di = got[1] - sum.im;
+                    dot.Add(double(sqrtl(dr * dr + di * di) / (RefAbs(scale) * ulp)));
+                }
+                dotCompensated.Add(UlpError(Complex(compensated[0], compensated[1]), sum));
+                dotCompensated.Add(UlpError(Complex(pairCompensated[0], pairCompensated[1]), sum));
+            }
+        }
+        state.CheckBudget("Kernel_Axpy", axpy, Label(k));
+        state.CheckBudget("Kernel_Dot", dot, Label(k));
+        state.CheckBudget("Kernel_DotCompensated", dotCompensated, Label(k));
+    }
+}
+TEST(KernelAxpyDot);
+
+void KernelAbs(TestState& state) {
+    TestRandom random;
+    for (SimdLevel level : Levels()) {
+        const SimdKernels& k = KernelsFor(level);
+        ErrorStats abs, absSquared, absApprox;
+        for (size_t round = 0; round < Rounds(); ++round) {
+            Data a(Inputs(random, -1074, 1023)), b(Inputs(random, -500, 500));
+            size_t n = a.Size();
+            vector<double> out(n), approx(n), squared(n), pairs(n);
+            k.abs(a.re.data(), a.im.data(), out.data(), n);
+            k.absApprox(a.re.data(), a.im.data(), approx.data(), n);
+            k.absSquared(b.re.data(), b.im.data(), squared.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                abs.Add(UlpError(out[i], hypotl(a.re[i], a.im[i])), a[i]);
+                EXPECT(state, SameValue(out[i], a[i].Abs()));
+                long double ref = hypotl(a.re[i], a.im[i]);
+                if (isfinite(ref) && ref > 0 && isfinite(approx[i])) {
+                    absApprox.Add(double(fabsl(approx[i] - ref) / ref), a[i]);
+                }
+                if (isfinite(b.re[i]) && isfinite(b.im[i])) {
+                    long double br = b.re[i], bi = b.im[i];
+                    absSquared.Add(UlpError(squared[i], br * br + bi * bi), b[i]);
+                }
+            }
+            k.absInterleaved(a.pairs.data(), pairs.data(), n);
+            EXPECT(state, SameArray(pairs, out));
+            k.absApproxInterleaved(a.pairs.data(), pairs.data(), n);
+            EXPECT(state, SameArray(pairs, approx));
+            k.absSquaredInterleaved(b.pairs.data(), pairs.data(), n);
+            EXPECT(state, SameArray(pairs, squared));
+        }
+        state.CheckBudget("Kernel_Abs", abs, Label(k));
+        state.CheckBudget("Kernel_AbsSquared", absSquared, Label(k));
+        state.CheckBudget("Kernel_AbsApprox", absApprox, Label(k));
+    }
+}
+TEST(KernelAbs);
+
+void KernelLayout(TestState& state) {
+    TestRandom random;
+    for (SimdLevel level : Levels()) {
+        const SimdKernels& k = KernelsFor(level);
+        Data a(Inputs(random, -1074, 1023));
+        size_t n = a.Size();
+        vector<double> re(n), im(n), pairs(2 * n);
+        k.deinterleave(a.pairs.data(), re.data(), im.data(), n);
+        EXPECT(state, SameArray(re, a.re) && SameArray(im, a.im));
+        k.interleave(a.re.data(), a.im.data(), pairs.data(), n);
+        EXPECT(state, SameArray(pairs, a.pairs));
+    }
+}
+TEST(KernelLayout);
+
+/** Преобразования типов — до бита как скалярные из complexstorage.h */
+void KernelConvert(TestState& state) {
+    TestRandom random;
+    vector<double> doubles;
+    for (size_t i = 0; i < kLength; ++i) {
+        doubles.push_back(random.LogUniform(-160, 140));
+        doubles.push_back(random.Uniform(-1.5, 1.5));
+    }
+    for (double x : EdgeValues()) {
+        doubles.push_back(x);
+    }
+    // Половины шага Q15 и binary16: проверка округления к чётному.
+    for (int i = -70000; i <= 70000; i += 7) {
+        doubles.push_back((i + 0.5) / 32768.0);
+        doubles.push_back(Half::FromBits(uint16_t(i)).ToFloat() * (1 + 0x1p-11));
+        doubles.push_back(Half::FromBits(uint16_t(i)).ToFloat() * (1 + 0x1p-11 + 0x1p-40));
+    }
+    size_t n = doubles.size();
+    vector<float> floats(n);
+    for (size_t i = 0; i < n; ++i) {
+        floats[i] = float(doubles[i]);
+    }
+    vector<uint16_t> halves(65536);
+    vector<int16_t> q15(65536);
+    for (size_t i = 0; i < 65536; ++i) {
+        halves[i] = uint16_t(i);
+        q15[i] = int16_t(i);
+    }
+    for (SimdLevel level : Levels()) {
+        const SimdKernels& k = KernelsFor(level);
+        vector<float> f(n);
+        vector<double> d(n);
+        vector<int16_t> q(n);
+        vector<uint16_t> h(n);
+        size_t mismatches = 0;
+        k.f64ToF32(doubles.data(), f.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            mismatches += !SameValue(f[i], float(doubles[i]));
+        }
+        k.f32ToF64(floats.data(), d.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            mismatches += !SameValue(d[i], floats[i]);
+        }
+        k.f64ToQ15(doubles.data(), q.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            mismatches += q[i] != Q15::FromDouble(doubles[i]).raw;
+        }
+        k.f32ToQ15(floats.data(), q.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            mismatches += q[i] != Q15::FromDouble(floats[i]).raw;
+        }
+        k.f32ToF16(floats.data(), h.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            Half expected = Half::FromFloat(floats[i]);
+            mismatches += isnan(floats[i]) ? !isnan(Half::FromBits(h[i]).ToFloat()) : h[i] != expected.bits;
+        }
+        k.f64ToF16(doubles.data(), h.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            Half expected = Half::FromDouble(doubles[i]);
+            mismatches += isnan(doubles[i]) ? !isnan(Half::FromBits(h[i]).ToFloat()) : h[i] != expected.bits;
+        }
+        // Все 65536 значений binary16 и Q15.
+        vector<float> all(65536);
+        vector<double> allDouble(65536);
+        k.f16ToF32(halves.data(), all.data(), 65536);
+        for (size_t i = 0; i < 65536; ++i) {
+            mismatches += !SameValue(all[i], Half::FromBits(uint16_t(i)).ToFloat());
+        }
+        k.q15ToF32(q15.data(), all.data(), 65536);
+        k.q15ToF64(q15.data(), allDouble.data(), 65536);
+        for (size_t i = 0; i < 65536; ++i) {
+            double expected = Q15::FromRaw(int16_t(i)).ToDouble();
+            mismatches += all[i] != float(expected) || allDouble[i] != expected;
+        }
+        if (mismatches) {
+            state.Fail("преобразования" + Label(k) + ": " + to_string(mismatches) + " отличий от complexstorage.h");
+        }
+    }
+}
+TEST(KernelConvert);
+
+/**
+ * @brief Входы элементарных функций: векторный диапазон и граничные значения.
+ */
+struct MathInputs {
+    vector<Complex> general;  /**< Для Log, Sqrt: |z| в [2^-480, 2^500] и у |z| = 1.*/
+    vector<Complex> exp;      /**< Для Exp: |Re| <= 708.*/
+    vector<Complex> base;     /**< Для Pow: |z| в [1/2, 2].*/
+    vector<double> phase;     /**< Для Polar и Rotate: |фаза| <= 2^20.*/
+};
+
+MathInputs MakeMathInputs(TestRandom& random) {
+    MathInputs inputs;
+    const double kPi = 3.14159265358979323846;
+    for (size_t i = 0; i < kLength; ++i) {
+        switch (i % 3) {
+        case 0:
+            inputs.general.push_back(random.LogUniformComplex(-240, 249));
+            break;
+        case 1: {
+            // Около единичной окружности: log|z| мал, важна относительная точность.
+            double r = 1 + random.LogUniform(-60, -1);
+            inputs.general.push_back(Polar(r, random.Uniform(-kPi, kPi)));
+            break;
+        }
+        default:
+            inputs.general.push_back(random.UniformComplex(-4, 4));
+        }
+        inputs.exp.emplace_back(random.Uniform(-708, 708), i % 2 ? random.Uniform(-4, 4) : random.Uniform(-0x1p20, 0x1p20));
+        inputs.base.push_back(Polar(random.Uniform(0.5, 2), random.Uniform(-kPi, kPi)));
+        inputs.phase.push_back(i % 2 ? random.Uniform(-8, 8) : random.Uniform(-0x1p20, 0x1p20));
+    }
+    return inputs;
+}
+
+/**
+ * @brief Погрешность одной функции: ULP для Fast, относительная для Approx
+ */
+void AddError(ErrorStats& stats, bool approx, const Complex& got, const RefComplex& ref, const Complex& arg) {
+    stats.Add(approx ? RelativeError(got, ref) : UlpError(got, ref), arg);
+}
+
+void KernelMath(TestState& state) {
+    TestRandom random;
+    const double kPowers[] = {0.5, -1.5, 2, 3.25};
+    for (SimdLevel level : Levels()) {
+        const SimdKernels& k = KernelsFor(level);
+        for (bool approx : {false, true}) {
+            string suffix = approx ? "_Approx" : "_Fast";
+            ErrorStats arg, polar, rotate, exp, log, sqrt, pow;
+            for (size_t round = 0; round < Rounds(); ++round) {
+                MathInputs in = MakeMathInputs(random);
+                Data g(in.general), e(in.exp), b(in.base);
+                size_t n = g.Size();
+                vector<double> angles(n);
+                Output out(n), outPolar(n), outRotate(n), outExp(n), outLog(n), outSqrt(n);
+                vector<double> r(n), pairs(2 * n);
+                for (size_t i = 0; i < n; ++i) {
+                    r[i] = fabs(g.re[i]);
+                }
+                k.arg(g.re.data(), g.im.data(), angles.data(), n, approx);
+                k.polar(r.data(), in.phase.data(), outPolar.re.data(), outPolar.im.data(), n, approx);
+                k.rotate(g.re.data(), g.im.data(), in.phase.data(), outRotate.re.data(), outRotate.im.data(), n,
+                         approx);
+                k.exp(e.re.data(), e.im.data(), outExp.re.data(), outExp.im.data(), n, approx);
+                k.log(g.re.data(), g.im.data(), outLog.re.data(), outLog.im.data(), n, approx);
+                k.sqrt(g.re.data(), g.im.data(), outSqrt.re.data(), outSqrt.im.data(), n);
+                for (size_t i = 0; i < n; ++i) {
+                    long double refArg = RefArg(g[i]);
+                    arg.Add(approx ? RelativeError(Complex(angles[i]), RefComplex{refArg, 0}) : UlpError(angles[i], refArg),
+                            g[i]);
+                    AddError(polar, approx, outPolar[i], RefPolar(r[i], in.phase[i]), Complex(r[i], in.phase[i]));
+                    AddError(rotate, approx, outRotate[i], RefMul(ToRef(g[i]), RefPolar(1, in.phase[i])), g[i]);
+                    AddError(exp, approx, outExp[i], RefExp(e[i]), e[i]);
+                    // У логарифма части разного масштаба: каждая в своих ULP.
+                    RefComplex ref = RefLog(g[i]);
+                    double re = UlpError(outLog.re[i], ref.re), im = UlpError(outLog.im[i], ref.im);
+                    if (approx) {
+                        re = double(fabsl(outLog.re[i] - ref.re) / fabsl(ref.re));
+                        im = double(fabsl(outLog.im[i] - ref.im) / fabsl(ref.im));
+                    }
+                    log.Add(re > im ? re : im, g[i]);
+                    sqrt.Add(UlpError(outSqrt[i], RefSqrt(g[i])), g[i]);
+                }
+                for (double p : kPowers) {
+                    k.pow(b.re.data(), b.im.data(), p, out.re.data(), out.im.data(), n, approx);
+                    for (size_t i = 0; i < n; ++i) {
+                        AddError(pow, approx, out[i], RefPow(b[i], p), b[i]);
+                    }
+                    k.powInterleaved(b.pairs.data(), p, pairs.data(), n, approx);
+                    EXPECT(state, SamePairs(pairs, out));
+                }
+                // Чередующиеся пары — те же результаты.
+                vector<double> angleInterleaved(n);
+                k.argInterleaved(g.pairs.data(), angleInterleaved.data(), n, approx);
+                EXPECT(state, SameArray(angleInterleaved, angles));
+                k.polarInterleaved(r.data(), in.phase.data(), pairs.data(), n, approx);
+                EXPECT(state, SamePairs(pairs, outPolar));
+                k.rotateInterleaved(g.pairs.data(), in.phase.data(), pairs.data(), n, approx);
+                EXPECT(state, SamePairs(pairs, outRotate));
+                k.expInterleaved(e.pairs.data(), pairs.data(), n, approx);
+                EXPECT(state, SamePairs(pairs, outExp));
+                k.logInterleaved(g.pairs.data(), pairs.data(), n, approx);
+                EXPECT(state, SamePairs(pairs, outLog));
+                k.sqrtInterleaved(g.pairs.data(), pairs.data(), n);
+                EXPECT(state, SamePairs(pairs, outSqrt));
+            }
+            // Sqrt не зависит от approx: одна метрика на обе половины.
+            if (!approx) {
+                state.CheckBudget("Kernel_Sqrt", sqrt, Label(k));
+            }
+            state.CheckBudget(approx ? "Kernel_Arg_Approx" : "Kernel_Arg", arg, Label(k));
+            state.CheckBudget("Kernel_Polar" + suffix, polar, Label(k));
+            state.CheckBudget("Kernel_Rotate" + suffix, rotate, Label(k));
+            state.CheckBudget("Kernel_Exp" + suffix, exp, Label(k));
+            state.CheckBudget("Kernel_Log" + suffix, log, Label(k));
+            state.CheckBudget("Kernel_Pow" + suffix, pow, Label(k));
+        }
+    }
+}
+TEST(KernelMath);
+
+/**
+ * @brief Вне векторного диапазона и на особых значениях ядра считают
+ * скалярно — результат до бита как у complexmath.h.
+ */
+void KernelMathFallback(TestState& state) {
+    vector<Complex> z;
+    for (double re : EdgeValues()) {
+        for (double im : EdgeValues()) {
+            z.emplace_back(re, im);
+        }
+    }
+    for (Complex w : {Complex(800, 1), Complex(-800, 1), Complex(1, 0x1p30), Complex(0x1p-1000, 0x1p-1000),
+                      Complex(0x1p600, 1), Complex(-1, 0.0), Complex(-1, -0.0), Complex(0.0, -0.0)}) {
+        z.push_back(w);
+    }
+    Data a(z);
+    size_t n = a.Size();
+    vector<double> phase(n, 0x1p30), r(n);
+    for (size_t i = 0; i < n; ++i) {
+        r[i] = a.re[i];
+        phase[i] = i % 2 ? a.im[i] : phase[i];
+    }
+    for (SimdLevel level : Levels()) {
+        const SimdKernels& k = KernelsFor(level);
+        for (bool approx : {false, true}) {
+            Output polar(n), exp(n), log(n), sqrt(n), pow(n);
+            k.polar(r.data(), phase.data(), polar.re.data(), polar.im.data(), n, approx);
+            k.exp(a.re.data(), a.im.data(), exp.re.data(), exp.im.data(), n, approx);
+            k.log(a.re.data(), a.im.data(), log.re.data(), log.im.data(), n, approx);
+            k.sqrt(a.re.data(), a.im.data(), sqrt.re.data(), sqrt.im.data(), n);
+            k.pow(a.re.data(), a.im.data(), 0.5, pow.re.data(), pow.im.data(), n, approx);
+            size_t mismatches = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bool special = !isfinite(a.re[i]) || !isfinite(a.im[i]) || (a.re[i] == 0 && a.im[i] == 0);
+                if (special || fabs(a.re[i]) > 708) {
+                    mismatches += !SameValue(exp[i], Exp(a[i]));
+                }
+                if (special || a[i].Abs() < 0x1p-480 || a[i].Abs() > 0x1p500) {
+                    mismatches += !SameValue(log[i], Log(a[i]));
+                    mismatches += !SameValue(sqrt[i], Sqrt(a[i]));
+                    mismatches += !SameValue(pow[i], Pow(a[i], 0.5));
+                }
+                if (!isfinite(r[i]) || !isfinite(phase[i]) || fabs(phase[i]) > 0x1p20) {
+                    mismatches += !SameValue(polar[i], Polar(r[i], phase[i]));
+                }
+            }
+            if (mismatches) {
+                state.Fail("скалярный путь" + Label(k) + ": " + to_string(mismatches) + " отличий от complexmath.h");
+            }
+        }
+    }
+}
+TEST(KernelMathFallback);
+
+} // namespace
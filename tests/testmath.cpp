@@ -0,0 +1,204 @@
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include "test.h"
+#include "../complexarray.h"
+#include "../complexbatch.h"
+#include "../complexmath.h"
+
+// Скалярные функции complexmath.h против эталона в long double, особые
+// значения по C99 Annex G и разрезы; пакетный режим Precise — до бита как
+// скалярные функции.
+
+namespace {
+
+const double kInf = numeric_limits<double>::infinity();
+const double kNan = numeric_limits<double>::quiet_NaN();
+const double kPi = 3.14159265358979323846;
+
+/** Погрешность логарифма: каждая часть в своих ULP */
+double LogError(const Complex& got, const RefComplex& ref) {
+    double re = UlpError(got.Re(), ref.re), im = UlpError(got.Im(), ref.im);
+    return re > im ? re : im;
+}
+
+void MathScalar(TestState& state) {
+    ErrorStats arg, polar, exp, log, logUnit, sqrt, sqrtFull, pow;
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        Complex z = random.LogUniformComplex(-1074, 1023);
+        arg.Add(UlpError(Arg(z), RefArg(z)), z);
+        log.Add(LogError(Log(z), RefLog(z)), z);
+        sqrtFull.Add(UlpError(Sqrt(z), RefSqrt(z)), z);
+        Complex w = random.UniformComplex(-4, 4);
+        log.Add(LogError(Log(w), RefLog(w)), w);
+        sqrt.Add(UlpError(Sqrt(w), RefSqrt(w)), w);
+        // |z| -> 1: log|z| мал, и его относительная точность — главное.
+        Complex u = Polar(1 + random.LogUniform(-60, -1), random.Uniform(-kPi, kPi));
+        logUnit.Add(LogError(Log(u), RefLog(u)), u);
+        double r = random.LogUniform(-20, 20), theta = random.Uniform(-0x1p20, 0x1p20);
+        polar.Add(UlpError(Polar(r, theta), RefPolar(r, theta)), Complex(r, theta));
+        Complex e(random.Uniform(-745, 709.5), random.Uniform(-8, 8));
+        exp.Add(UlpError(Exp(e), RefExp(e)), e);
+        Complex b = Polar(random.Uniform(0.25, 4), random.Uniform(-kPi, kPi));
+        double p = random.Uniform(-8, 8);
+        pow.Add(UlpError(Pow(b, p), RefPow(b, p)), b, p);
+    }
+    state.CheckBudget("Math_Arg", arg);
+    state.CheckBudget("Math_Polar", polar);
+    state.CheckBudget("Math_Exp", exp);
+    state.CheckBudget("Math_Log", log);
+    state.CheckBudget("Math_LogNearUnit", logUnit);
+    state.CheckBudget("Math_Sqrt", sqrt);
+    state.CheckBudget("Math_SqrtFullRange", sqrtFull);
+    state.CheckBudget("Math_Pow", pow);
+}
+TEST(MathScalar);
+
+void MathScalarFloat(TestState& state) {
+    ErrorStats exp, log, sqrt;
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        ComplexF e(float(random.Uniform(-87, 88)), float(random.Uniform(-8, 8)));
+        ComplexF z(random.LogUniformComplex(-149, 127));
+        ComplexF u(random.UniformComplex(-2, 2));
+        exp.Add(UlpError(Exp(e), RefExp(Complex(e))), Complex(e));
+        sqrt.Add(UlpError(Sqrt(z), RefSqrt(Complex(z))), Complex(z));
+        RefComplex ref = RefLog(Complex(u));
+        ComplexF got = Log(u);
+        double re = UlpError(got.Re(), ref.re), im = UlpError(got.Im(), ref.im);
+        log.Add(re > im ? re : im, Complex(u));
+    }
+    state.CheckBudget("Math_ExpF", exp);
+    state.CheckBudget("Math_LogF", log);
+    state.CheckBudget("Math_SqrtF", sqrt);
+}
+TEST(MathScalarFloat);
+
+/** Разрезы: знак нулевой мнимой части выбирает берег */
+void MathBranchCuts(TestState& state) {
+    EXPECT(state, SameValue(Log(Complex(-1, 0.0)), Complex(0, kPi)));
+    EXPECT(state, SameValue(Log(Complex(-1, -0.0)), Complex(0, -kPi)));
+    EXPECT(state, SameValue(Sqrt(Complex(-4, 0.0)), Complex(0, 2)));
+    EXPECT(state, SameValue(Sqrt(Complex(-4, -0.0)), Complex(0, -2)));
+    EXPECT(state, SameValue(Sqrt(Complex(0.0, 0.0)), Complex(0, 0)));
+    EXPECT(state, SameValue(Sqrt(Complex(-0.0, -0.0)), Complex(0, -0.0)));
+    EXPECT(state, SameValue(Arg(Complex(-1, 0.0)), kPi));
+    EXPECT(state, SameValue(Arg(Complex(-1, -0.0)), -kPi));
+    EXPECT(state, SameValue(Arg(Complex(-0.0, 0.0)), kPi));
+    EXPECT(state, Pow(Complex(-1, 0.0), 0.5).Im() > 0 && Pow(Complex(-1, -0.0), 0.5).Im() < 0);
+    // Около разреза Sqrt не теряет точности (нет вычитаний).
+    ErrorStats nearCut;
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples() / 10; ++i) {
+        Complex z(-random.LogUniform(-100, 100), random.LogUniform(-1074, -200));
+        nearCut.Add(UlpError(Sqrt(z), RefSqrt(z)), z);
+        nearCut.Add(UlpError(Sqrt(Conj(z)), RefSqrt(Conj(z))), z);
+    }
+    state.CheckBudget("Math_SqrtNearCut", nearCut);
+}
+TEST(MathBranchCuts);
+
+/** Особые значения по C99 Annex G (G.6.3.1, G.6.3.2, G.6.4.2) */
+void MathAnnexG(TestState& state) {
+    // Экспонента.
+    EXPECT(state, SameValue(Exp(Complex(0.0, 0.0)), Complex(1, 0.0)));
+    EXPECT(state, SameValue(Exp(Complex(-0.0, -0.0)), Complex(1, -0.0)));
+    EXPECT(state, SameValue(Exp(Complex(kInf, 0.0)), Complex(kInf, 0.0)));
+    EXPECT(state, SameValue(Exp(Complex(-kInf, 1)), Complex(0, 0)));
+    EXPECT(state, SameValue(Exp(Complex(-kInf, kInf)), Complex(0, 0)));
+    EXPECT(state, SameValue(Exp(Complex(-kInf, kNan)), Complex(0, 0)));
+    EXPECT(state, isinf(Exp(Complex(kInf, kInf)).Re()) && isnan(Exp(Complex(kInf, kInf)).Im()));
+    EXPECT(state, isinf(Exp(Complex(kInf, kNan)).Re()) && isnan(Exp(Complex(kInf, kNan)).Im()));
+    EXPECT(state, SameValue(Exp(Complex(kNan, 0.0)), Complex(kNan, 0.0)));
+    EXPECT(state, SameValue(Exp(Complex(710, 1)), Complex(exp(355.0) * cos(1.0) * exp(355.0),
+                                                          exp(355.0) * sin(1.0) * exp(355.0))));
+    // Логарифм.
+    EXPECT(state, SameValue(Log(Complex(0.0, 0.0)), Complex(-kInf, 0.0)));
+    EXPECT(state, SameValue(Log(Complex(-0.0, 0.0)), Complex(-kInf, kPi)));
+    EXPECT(state, SameValue(Log(Complex(kInf, kNan)), Complex(kInf, kNan)));
+    EXPECT(state, SameValue(Log(Complex(-kInf, 1)), Complex(kInf, kPi)));
+    EXPECT(state, SameValue(Log(Complex(kInf, -1)), Complex(kInf, -0.0)));
+    EXPECT(state, SameValue(Log(Complex(kNan, kInf)), Complex(kInf, kNan)));
+    EXPECT(state, SameValue(Log(Complex(1, 0.0)), Complex(0, 0)));
+    EXPECT(state, UlpError(Log(Complex(DBL_MAX, DBL_MAX)).Re(), logl(DBL_MAX) + logl(2) / 2) <= 1);
+    // Корень.
+    EXPECT(state, SameValue(Sqrt(Complex(1, kInf)), Complex(kInf, kInf)));
+    EXPECT(state, SameValue(Sqrt(Complex(kNan, -kInf)), Complex(kInf, -kInf)));
+    EXPECT(state, SameValue(Sqrt(Complex(-kInf, 1)), Complex(0, kInf)));
+    EXPECT(state, SameValue(Sqrt(Complex(kInf, -1)), Complex(kInf, -0.0)));
+    EXPECT(state, SameValue(Sqrt(Complex(-kInf, kNan)), Complex(kNan, kInf)));
+    EXPECT(state, SameValue(Sqrt(Complex(kInf, kNan)), Complex(kInf, kNan)));
+    EXPECT(state, SameValue(Sqrt(Complex(kNan, 1)), Complex(kNan, kNan)));
+    EXPECT(state, UlpError(Sqrt(Complex(DBL_MAX, DBL_MAX)), RefSqrt(Complex(DBL_MAX, DBL_MAX))) <= 2);
+    EXPECT(state, UlpError(Sqrt(Complex(DBL_TRUE_MIN, DBL_TRUE_MIN)), RefSqrt(Complex(DBL_TRUE_MIN, DBL_TRUE_MIN))) <= 2);
+    // Степени.
+    EXPECT(state, SameValue(Pow(Complex(kNan, kNan), 0.0), Complex(1)));
+    EXPECT(state, SameValue(Pow(Complex(0, 0), Complex(2, 1)), Complex()));
+    EXPECT(state, SameValue(Pow(Complex(0, 1), 2), Complex(-1, 0)));
+    EXPECT(state, Pow(Complex(1, 1), -2).Re() == 0 && Pow(Complex(1, 1), -2).Im() == -0.5);
+}
+TEST(MathAnnexG);
+
+/** Целые степени: повторное умножение против эталона */
+void MathIntegerPow(TestState& state) {
+    ErrorStats error;
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples() / 10; ++i) {
+        Complex z = Polar(random.Uniform(0.5, 2), random.Uniform(-kPi, kPi));
+        int n = int(random.Next() % 33) - 16;
+        RefComplex ref = RefPow(z, n);
+        // log2(|n|) + 1 умножений, каждое до ~2 ULP: бюджет на одно умножение.
+        error.Add(UlpError(Pow(z, n), ref) / (log2(abs(n) + 1.0) + 1), z, n);
+    }
+    state.CheckBudget("Math_IntegerPow", error);
+}
+TEST(MathIntegerPow);
+
+/** MathAccuracy::Precise — поэлементно скалярные функции, до бита */
+void MathPreciseBatch(TestState& state) {
+    TestRandom random;
+    vector<Complex> z;
+    for (size_t i = 0; i < 1000; ++i) {
+        z.push_back(random.LogUniformComplex(-1074, 1023));
+        z.push_back(random.UniformComplex(-10, 10));
+    }
+    for (double re : EdgeValues()) {
+        for (double im : EdgeValues()) {
+            z.emplace_back(re, im);
+        }
+    }
+    size_t n = z.size();
+    vector<Complex> out(n);
+    vector<double> angles(n);
+    Exp(z.data(), out.data(), n, MathAccuracy::Precise);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT(state, SameValue(out[i], Exp(z[i])));
+    }
+    Log(z.data(), out.data(), n, MathAccuracy::Precise);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT(state, SameValue(out[i], Log(z[i])));
+    }
+    Sqrt(z.data(), out.data(), n, MathAccuracy::Precise);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT(state, SameValue(out[i], Sqrt(z[i])));
+    }
+    Pow(z.data(), 1.5, out.data(), n, MathAccuracy::Precise);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT(state, SameValue(out[i], Pow(z[i], 1.5)));
+    }
+    Arg(z.data(), angles.data(), n, MathAccuracy::Precise);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT(state, SameValue(angles[i], Arg(z[i])));
+    }
+    // ComplexArray — те же результаты, что и массивы Complex.
+    ComplexArray a(z.data(), n), b;
+    Exp(a, b, MathAccuracy::Fast);
+    Exp(z.data(), out.data(), n, MathAccuracy::Fast);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT(state, SameValue(b[i], out[i]));
+    }
+}
+TEST(MathPreciseBatch);
+
+} // namespace
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "test.h"
+#include "../matrix.h"
+#include "../simd.h"
+
+// Матрицы: Gemm (4M и 3M), Gemv и пакетные малые произведения против суммы
+// в long double; независимость результата от порядка и хранения матриц.
+// Ошибка элемента — в единицах DBL_EPSILON * (|alpha| sum |a||b| + |beta||c|),
+// то есть относительно оценки, не зависящей от сокращений в сумме.
+
+namespace {
+
+ComplexMatrix RandomMatrix(TestRandom& random, size_t rows, size_t cols, MatrixOrder order, MatrixStorage storage) {
+    ComplexMatrix m(rows, cols, order, storage);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            m.Set(r, c, random.UniformComplex(-1, 1));
+        }
+    }
+    return m;
+}
+
+long double RefModulus(const Complex& z) {
+    return RefAbs(ToRef(z));
+}
+
+/**
+ * @brief Ошибка got против alpha * sum_p x(p) y(p) + beta * c0 (x, y — строка A и столбец B)
+ */
+double ProductError(const Complex& got, const vector<Complex>& x, const vector<Complex>& y, const Complex& alpha,
+                    const Complex& beta, const Complex& c0) {
+    RefComplex sum{0, 0};
+    long double bound = 0;
+    for (size_t p = 0; p < x.size(); ++p) {
+        sum = RefAdd(sum, RefMul(ToRef(x[p]), ToRef(y[p])));
+        bound += RefModulus(x[p]) * RefModulus(y[p]);
+    }
+    RefComplex ref = RefAdd(RefMul(ToRef(alpha), sum), RefMul(ToRef(beta), ToRef(c0)));
+    bound = RefModulus(alpha) * bound + RefModulus(beta) * RefModulus(c0);
+    if (bound == 0) {
+        return got.Re() == 0 && got.Im() == 0 ? 0 : INFINITY;
+    }
+    return double(hypotl(got.Re() - ref.re, got.Im() - ref.im) / (bound * DBL_EPSILON));
+}
+
+bool SameMatrix(const ComplexMatrix& a, const ComplexMatrix& b) {
+    if (a.Rows() != b.Rows() || a.Cols() != b.Cols()) {
+        return false;
+    }
+    for (size_t r = 0; r < a.Rows(); ++r) {
+        for (size_t c = 0; c < a.Cols(); ++c) {
+            if (!SameValue(a.Get(r, c), b.Get(r, c))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const MatrixOrder kOrders[] = {MatrixOrder::RowMajor, MatrixOrder::ColMajor};
+const MatrixStorage kStorages[] = {MatrixStorage::Interleaved, MatrixStorage::Split};
+
+/** Gemm против эталона; края блоков (mc, kc, ширина плитки) и все представления */
+void MatrixGemm(TestState& state) {
+    TestRandom random;
+    const Complex alpha(0.5, -1), beta(2, 0.25);
+    const size_t shapes[][3] = {{1, 1, 1}, {5, 7, 3}, {33, 17, 65}, {70, 131, 300}};
+    for (GemmMethod method : {GemmMethod::FourM, GemmMethod::ThreeM}) {
+        ErrorStats error;
+        for (const size_t* shape : shapes) {
+            const size_t m = shape[0], n = shape[1], k = shape[2];
+            ComplexMatrix a = RandomMatrix(random, m, k, MatrixOrder::RowMajor, MatrixStorage::Interleaved);
+            ComplexMatrix b = RandomMatrix(random, k, n, MatrixOrder::RowMajor, MatrixStorage::Interleaved);
+            ComplexMatrix c0 = RandomMatrix(random, m, n, MatrixOrder::RowMajor, MatrixStorage::Interleaved);
+            ComplexMatrix expected = c0;
+            Gemm(a, b, expected, alpha, beta, method);
+            vector<Complex> row(k), col(k);
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    for (size_t p = 0; p < k; ++p) {
+                        row[p] = a.Get(i, p);
+                        col[p] = b.Get(p, j);
+                    }
+                    error.Add(ProductError(expected.Get(i, j), row, col, alpha, beta, c0.Get(i, j)), row[0], col[0]);
+                }
+            }
+            // Панели упаковываются одинаково при любом представлении, поэтому
+            // и результат одинаков до бита.
+            for (MatrixOrder order : kOrders) {
+                for (MatrixStorage storage : kStorages) {
+                    ComplexMatrix c = c0.Convert(order, storage);
+                    Gemm(a.Convert(order, storage), b.Convert(kOrders[1 - int(order)], storage), c, alpha, beta,
+                         method);
+                    EXPECT(state, SameMatrix(c, expected));
+                }
+            }
+        }
+        state.CheckBudget(method == GemmMethod::FourM ? "Matrix_Gemm4M" : "Matrix_Gemm3M", error);
+    }
+
+    // beta == 0: прежнее C не читается; пустое C создаётся.
+    ComplexMatrix a = RandomMatrix(random, 3, 4, MatrixOrder::RowMajor, MatrixStorage::Split);
+    ComplexMatrix b = ComplexMatrix::Identity(4, MatrixOrder::ColMajor);
+    ComplexMatrix c(3, 4);
+    c.Fill(Complex(NAN, NAN));
+    Gemm(a, b, c);
+    ComplexMatrix created;
+    Gemm(a, b, created);
+    EXPECT(state, SameMatrix(c, a) && SameMatrix(created, a));
+
+    bool thrown = false;
+    try {
+        Gemm(a, a, c);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+    thrown = false;
+    try {
+        ComplexMatrix square = ComplexMatrix::Identity(3);
+        Gemm(square, square, square);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(MatrixGemm);
+
+/** Gemv по строкам и по столбцам против эталона */
+void MatrixGemv(TestState& state) {
+    TestRandom random;
+    ErrorStats error;
+    const Complex alpha(-1, 0.5), beta(0.5, 0.5);
+    for (size_t m : {1, 9, 64}) {
+        for (size_t n : {1, 13, 200}) {
+            ComplexMatrix a = RandomMatrix(random, m, n, MatrixOrder::RowMajor, MatrixStorage::Interleaved);
+            vector<Complex> x(n), y0(m), row(n);
+            for (Complex& z : x) {
+                z = random.UniformComplex(-1, 1);
+            }
+            for (Complex& z : y0) {
+                z = random.UniformComplex(-1, 1);
+            }
+            for (MatrixOrder order : kOrders) {
+                for (MatrixStorage storage : kStorages) {
+                    vector<Complex> y = y0;
+                    Gemv(a.Convert(order, storage), x.data(), y.data(), alpha, beta);
+                    for (size_t i = 0; i < m; ++i) {
+                        for (size_t j = 0; j < n; ++j) {
+                            row[j] = a.Get(i, j);
+                        }
+                        error.Add(ProductError(y[i], row, x, alpha, beta, y0[i]), row[0], x[0]);
+                    }
+                }
+            }
+        }
+    }
+    state.CheckBudget("Matrix_Gemv", error);
+}
+TEST(MatrixGemv);
+
+/** Пакетные ядра всех поддерживаемых уровней; оба интерфейса GemmBatch дают одно и то же */
+void MatrixGemmBatch(TestState& state) {
+    TestRandom random;
+    const size_t count = 37;
+    for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (int(level) > int(DetectSimdLevel())) {
+            continue;
+        }
+        const SimdKernels& kernels = KernelsFor(level);
+        ErrorStats error;
+        for (size_t n = 2; n <= 8; ++n) {
+            ComplexMatrixBatch a(count, n, n), b(count, n, n), c(count, n, n);
+            for (size_t t = 0; t < count; ++t) {
+                for (size_t e = 0; e < n * n; ++e) {
+                    a.Set(t, e / n, e % n, random.UniformComplex(-1, 1));
+                    b.Set(t, e / n, e % n, random.UniformComplex(-1, 1));
+                }
+            }
+            // Ядро напрямую: по группе на вызов, последняя группа неполная.
+            const size_t group = ComplexMatrixBatch::kGroup;
+            for (size_t first = 0; first < count; first += group) {
+                size_t offset = a.Offset(first, 0, 0);
+                kernels.gemmBatch(n, n, n, a.Re() + offset, a.Im() + offset, b.Re() + offset, b.Im() + offset,
+                                  c.Re() + offset, c.Im() + offset, group, min(group, count - first));
+            }
+            vector<Complex> row(n), col(n);
+            for (size_t t = 0; t < count; ++t) {
+                for (size_t i = 0; i < n; ++i) {
+                    for (size_t j = 0; j < n; ++j) {
+                        for (size_t p = 0; p < n; ++p) {
+                            row[p] = a.Get(t, i, p);
+                            col[p] = b.Get(t, p, j);
+                        }
+                        error.Add(ProductError(c.Get(t, i, j), row, col, Complex(1.0), Complex(), Complex()),
+                                  row[0], col[0]);
+                    }
+                }
+            }
+        }
+        state.CheckBudget("Matrix_GemmBatch", error, string(" [") + kernels.name + "]");
+    }
+
+    // Прямоугольные 3x5 * 5x2: пакетное хранение против массивов Complex.
+    const size_t m = 3, k = 5, n = 2;
+    vector<Complex> a(count * m * k), b(count * k * n), c(count * m * n), unpacked(count * m * n);
+    for (Complex& z : a) {
+        z = random.UniformComplex(-1, 1);
+    }
+    for (Complex& z : b) {
+        z = random.UniformComplex(-1, 1);
+    }
+    GemmBatch(a.data(), b.data(), c.data(), m, k, n, count);
+    ComplexMatrixBatch pa(count, m, k), pb(count, k, n), pc;
+    pa.Assign(a.data());
+    pb.Assign(b.data());
+    GemmBatch(pa, pb, pc);
+    pc.CopyTo(unpacked.data());
+    size_t mismatches = 0;
+    for (size_t i = 0; i < c.size(); ++i) {
+        mismatches += !SameValue(c[i], unpacked[i]);
+    }
+    EXPECT(state, pc.Count() == count && pc.Rows() == m && pc.Cols() == n && mismatches == 0);
+    bool thrown = false;
+    try {
+        GemmBatch(pa, pa, pc);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(MatrixGemmBatch);
+
+} // namespace
@@ -0,0 +1,303 @@
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include "test.h"
+#include "../complexarray.h"
+#include "../complexbatch.h"
+#include "../mycomplex.h"
+#include "../simd.h"
+
+// Операторы Complex и ComplexF против эталона в long double: случайные
+// входы по всему диапазону порядков и граничные значения.
+
+namespace {
+
+const double kInf = numeric_limits<double>::infinity();
+
+/** Случайные пары и все пары граничных значений: fn(a, b) */
+template <class Fn>
+void ForInputs(int minExp, int maxExp, Fn fn) {
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        Complex a = random.LogUniformComplex(minExp, maxExp);
+        fn(a, random.LogUniformComplex(minExp, maxExp));
+    }
+}
+
+vector<Complex> EdgeComplex() {
+    vector<Complex> values;
+    for (double re : EdgeValues()) {
+        for (double im : EdgeValues()) {
+            values.emplace_back(re, im);
+        }
+    }
+    return values;
+}
+
+bool HasNan(const Complex& z) { return isnan(z.Re()) || isnan(z.Im()); }
+bool HasInf(const Complex& z) { return isinf(z.Re()) || isinf(z.Im()); }
+bool IsZero(const Complex& z) { return z.Re() == 0 && z.Im() == 0; }
+bool IsFinite(const Complex& z) { return isfinite(z.Re()) && isfinite(z.Im()); }
+
+void AddSub(TestState& state) {
+    ErrorStats add, sub;
+    ForInputs(-1074, 1023, [&](const Complex& a, const Complex& b) {
+        add.Add(UlpError(a + b, RefAdd(ToRef(a), ToRef(b))), a, b);
+        sub.Add(UlpError(a - b, RefSub(ToRef(a), ToRef(b))), a, b);
+    });
+    state.CheckBudget("Op_Add", add);
+    state.CheckBudget("Op_Sub", sub);
+    // Сложение по частям: особые значения и знак нуля — как у double.
+    for (const Complex& a : EdgeComplex()) {
+        for (const Complex& b : EdgeComplex()) {
+            Complex sum = a + b, difference = a - b;
+            EXPECT(state, SameValue(sum, Complex(a.Re() + b.Re(), a.Im() + b.Im())));
+            EXPECT(state, SameValue(difference, Complex(a.Re() - b.Re(), a.Im() - b.Im())));
+        }
+    }
+}
+TEST(AddSub);
+
+void Mul(TestState& state) {
+    ErrorStats mul, mulF;
+    // Произведения частей без переполнения и без потери значимости.
+    ForInputs(-500, 500, [&](const Complex& a, const Complex& b) {
+        mul.Add(UlpError(a * b, RefMul(ToRef(a), ToRef(b))), a, b);
+    });
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        ComplexF a(random.LogUniformComplex(-60, 60)), b(random.LogUniformComplex(-60, 60));
+        mulF.Add(UlpError(a * b, RefMul(ToRef(a), ToRef(b))), Complex(a), Complex(b));
+    }
+    state.CheckBudget("Op_Mul", mul);
+    state.CheckBudget("Op_MulF", mulF);
+    for (const Complex& a : EdgeComplex()) {
+        for (const Complex& b : EdgeComplex()) {
+            Complex c = a * b;
+            if (!IsFinite(a) || !IsFinite(b)) {
+                EXPECT(state, !IsFinite(c) || IsZero(c) || IsZero(a) || IsZero(b));
+            }
+            if (HasNan(a) && HasNan(b)) {
+                EXPECT(state, HasNan(c));
+            }
+        }
+    }
+}
+TEST(Mul);
+
+void Div(TestState& state) {
+    ErrorStats div, reciprocal, divF, fast, fastReciprocal;
+    // Устойчивое деление — по всему диапазону, включая субнормальные части.
+    ForInputs(-1074, 1023, [&](const Complex& a, const Complex& b) {
+        div.Add(UlpError(a / b, RefDiv(ToRef(a), ToRef(b))), a, b);
+        reciprocal.Add(UlpError(b.Reciprocal(), RefDiv(RefComplex{1, 0}, ToRef(b))), b);
+    });
+    // Быстрое — только там, где |b|^2 и произведения представимы.
+    ForInputs(-250, 250, [&](const Complex& a, const Complex& b) {
+        fast.Add(UlpError(a.FastDivide(b), RefDiv(ToRef(a), ToRef(b))), a, b);
+        fastReciprocal.Add(UlpError(b.FastReciprocal(), RefDiv(RefComplex{1, 0}, ToRef(b))), b);
+    });
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        ComplexF a(random.LogUniformComplex(-149, 127)), b(random.LogUniformComplex(-149, 127));
+        divF.Add(UlpError(a / b, RefDiv(ToRef(a), ToRef(b))), Complex(a), Complex(b));
+    }
+    state.CheckBudget("Op_Div", div);
+    state.CheckBudget("Op_Reciprocal", reciprocal);
+    state.CheckBudget("Op_DivF", divF);
+    state.CheckBudget("Op_FastDivide", fast);
+    state.CheckBudget("Op_FastReciprocal", fastReciprocal);
+}
+TEST(Div);
+
+/**
+ * @brief Особые случаи деления по C99 Annex G: конечное ненулевое / 0 = inf,
+ * конечное / inf = 0, inf / конечное = inf; конечные частные — в пределах
+ * бюджета.
+ */
+void DivSpecial(TestState& state) {
+    ErrorStats finite;
+    for (const Complex& a : EdgeComplex()) {
+        for (const Complex& b : EdgeComplex()) {
+            Complex c = a / b;
+            bool aNan = HasNan(a), bNan = HasNan(b);
+            if (HasInf(a) && !bNan && IsFinite(b)) {
+                EXPECT(state, HasInf(c));
+            } else if (IsFinite(a) && !aNan && HasInf(b) && !bNan) {
+                EXPECT(state, IsZero(c));
+            } else if (IsFinite(a) && !IsZero(a) && IsZero(b)) {
+                EXPECT(state, HasInf(c));
+            } else if (IsFinite(a) && IsFinite(b) && !IsZero(b)) {
+                finite.Add(UlpError(c, RefDiv(ToRef(a), ToRef(b))), a, b);
+            } else if (aNan && bNan) {
+                EXPECT(state, HasNan(c));
+            }
+            EXPECT(state, SameValue(Complex(a) /= b, c));
+        }
+    }
+    state.CheckBudget("Op_Div_Edge", finite);
+    EXPECT(state, HasInf(Complex(0, 0).Reciprocal()));
+    EXPECT(state, IsZero(Complex(kInf, 1).Reciprocal()));
+}
+TEST(DivSpecial);
+
+/** Деление с операндами у границ диапазона и ожидаемым частным */
+struct HugeDivCase {
+    Complex a, b, quotient;
+};
+
+/**
+ * @brief Annex G на операндах у границ диапазона: суммы частей делимого
+ * порядка DBL_MAX не должны переполняться в поправках ScaledDivide и SafeDiv
+ * (иначе 0 * inf = NaN вместо нуля). Ожидаемые значения, включая знаки
+ * нулей, — как у __divdc3 из libgcc.
+ */
+vector<HugeDivCase> HugeDivCases() {
+    return {
+        // Конечное / inf: ноль со знаком.
+        {Complex(DBL_MAX, DBL_MAX), Complex(kInf, 0), Complex(0, 0)},
+        {Complex(DBL_MAX, -DBL_MAX), Complex(kInf, kInf), Complex(0, -0.0)},
+        {Complex(-DBL_MAX, 0x1p600), Complex(0, -kInf), Complex(-0.0, -0.0)},
+        {Complex(0x1p-1060, -DBL_MAX), Complex(-kInf, 1), Complex(-0.0, 0)},
+        {Complex(-DBL_MAX, -DBL_MAX), Complex(-kInf, -kInf), Complex(0, 0)},
+        // Inf / конечное и конечное / 0: бесконечность.
+        {Complex(kInf, 1), Complex(DBL_MAX, DBL_MAX), Complex(kInf, -kInf)},
+        {Complex(DBL_MAX, 1), Complex(0, 0), Complex(kInf, kInf)},
+        {Complex(-DBL_MAX, -DBL_MAX), Complex(-0.0, 0), Complex(kInf, kInf)},
+    };
+}
+
+void DivSpecialHuge(TestState& state) {
+    for (const HugeDivCase& c : HugeDivCases()) {
+        EXPECT(state, SameValue(c.a / c.b, c.quotient));
+        EXPECT(state, SameValue(Complex(c.a) /= c.b, c.quotient));
+    }
+    EXPECT(state, SameValue(Complex(kInf, -kInf).Reciprocal(), Complex(0, 0)));
+}
+TEST(DivSpecialHuge);
+
+/**
+ * @brief Пакетное устойчивое деление и обратное число (Divide, Reciprocal,
+ * Div над ComplexArray) на каждом уровне инструкций: особые случаи — до бита
+ * как скалярные операторы, проверенные выше, а не отдельная копия правил.
+ */
+void DivBatchSpecial(TestState& state) {
+    vector<Complex> a, b, expected;
+    for (const Complex& x : EdgeComplex()) {
+        for (const Complex& y : EdgeComplex()) {
+            a.push_back(x);
+            b.push_back(y);
+            expected.push_back(x / y);
+        }
+    }
+    for (const HugeDivCase& c : HugeDivCases()) {
+        a.push_back(c.a);
+        b.push_back(c.b);
+        expected.push_back(c.quotient);
+    }
+    size_t n = a.size();
+    ComplexArray arrayA(a.data(), n), arrayB(b.data(), n), quotient, reciprocal;
+    vector<Complex> out(n), inverse(n);
+    SimdLevel active = ActiveSimdLevel();
+    for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (!SetActiveSimdLevel(level)) {
+            continue;
+        }
+        Divide(a.data(), b.data(), out.data(), n, DivMode::Robust);
+        Reciprocal(b.data(), inverse.data(), n, DivMode::Robust);
+        Div(arrayA, arrayB, quotient, DivMode::Robust);
+        Reciprocal(arrayB, reciprocal, DivMode::Robust);
+        size_t mismatches[4] = {};
+        for (size_t i = 0; i < n; ++i) {
+            mismatches[0] += !SameValue(out[i], expected[i]);
+            mismatches[1] += !SameValue(quotient[i], expected[i]);
+            mismatches[2] += !SameValue(inverse[i], b[i].Reciprocal());
+            mismatches[3] += !SameValue(reciprocal[i], b[i].Reciprocal());
+        }
+        const char* names[4] = {"Divide", "Div", "Reciprocal", "Reciprocal(ComplexArray)"};
+        for (size_t j = 0; j < 4; ++j) {
+            if (mismatches[j]) {
+                state.Fail(string(names[j]) + " [" + SimdLevelName(level) + "]: " + to_string(mismatches[j]) +
+                           " элементов отличаются от скалярного деления");
+            }
+        }
+    }
+    SetActiveSimdLevel(active);
+}
+TEST(DivBatchSpecial);
+
+void RealOperand(TestState& state) {
+    ErrorStats error;
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        Complex a = random.LogUniformComplex(-500, 500);
+        double k = random.LogUniform(-500, 500);
+        RefComplex ra = ToRef(a);
+        error.Add(UlpError(a + k, RefComplex{ra.re + k, ra.im}), a, k);
+        error.Add(UlpError(k + a, RefComplex{ra.re + k, ra.im}), a, k);
+        error.Add(UlpError(a - k, RefComplex{ra.re - k, ra.im}), a, k);
+        error.Add(UlpError(k - a, RefComplex{k - ra.re, -ra.im}), a, k);
+        error.Add(UlpError(a * k, RefComplex{ra.re * k, ra.im * k}), a, k);
+        error.Add(UlpError(k * a, RefComplex{ra.re * k, ra.im * k}), a, k);
+        error.Add(UlpError(a / k, RefComplex{ra.re / k, ra.im / k}), a, k);
+        error.Add(UlpError(k / a, RefDiv(RefComplex{(long double)k, 0}, ra)), a, k);
+    }
+    state.CheckBudget("Op_RealOperand", error);
+}
+TEST(RealOperand);
+
+/** Составные операторы совпадают с бинарными до бита, в том числе z op= z */
+void Compound(TestState& state) {
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples() / 10; ++i) {
+        Complex a = random.LogUniformComplex(-300, 300), b = random.LogUniformComplex(-300, 300);
+        double k = random.LogUniform(-300, 300);
+        Complex c;
+        EXPECT(state, SameValue(c = a, a) && SameValue(c += b, a + b));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c -= b, a - b));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c *= b, a * b));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c /= b, a / b));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c += k, a + k));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c -= k, a - k));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c *= k, a * k));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c /= k, a / k));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c *= c, a * a));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c /= c, a / a));
+        EXPECT(state, SameValue(c = a, a) && SameValue(c += c, a + a));
+    }
+}
+TEST(Compound);
+
+void AbsTest(TestState& state) {
+    ErrorStats abs, absSquared, absF;
+    TestRandom random;
+    for (size_t i = 0; i < TestSamples(); ++i) {
+        Complex a = random.LogUniformComplex(-1074, 1023);
+        abs.Add(UlpError(a.Abs(), hypotl(a.Re(), a.Im())), a);
+        Complex b = random.LogUniformComplex(-500, 500);
+        RefComplex rb = ToRef(b);
+        absSquared.Add(UlpError(b.AbsSquared(), rb.re * rb.re + rb.im * rb.im), b);
+        ComplexF f(random.LogUniformComplex(-149, 127));
+        absF.Add(UlpError(f.Abs(), hypotl(f.Re(), f.Im())), Complex(f));
+    }
+    // Abs(inf, NaN) = inf, как hypot.
+    for (const Complex& a : EdgeComplex()) {
+        abs.Add(UlpError(a.Abs(), hypotl(a.Re(), a.Im())), a);
+    }
+    state.CheckBudget("Op_Abs", abs);
+    state.CheckBudget("Op_AbsSquared", absSquared);
+    state.CheckBudget("Op_AbsF", absF);
+}
+TEST(AbsTest);
+
+void FusedMulAddTest(TestState& state) {
+    ErrorStats error;
+    ForInputs(-300, 300, [&](const Complex& a, const Complex& b) {
+        Complex c = a * Complex(0.75, -0.5);
+        error.Add(UlpError(FusedMulAdd(a, b, c), RefAdd(RefMul(ToRef(a), ToRef(b)), ToRef(c))), a, b);
+    });
+    state.CheckBudget("Op_FusedMulAdd", error);
+}
+TEST(FusedMulAddTest);
+
+} // namespace
@@ -0,0 +1,150 @@
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include "test.h"
+#include "../complexbatch.h"
+#include "../phase.h"
+
+// Фаза сигнала: ToPolar против long double и против Abs/Arg, развёртка
+// фазы и частотный дискриминатор на сигнале с известной фазой при любом
+// разбиении входа на блоки.
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const MathAccuracy kAccuracies[] = {MathAccuracy::Precise, MathAccuracy::Fast, MathAccuracy::Approx};
+
+bool SameArray(const vector<double>& a, const vector<double>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!SameValue(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Фаза со случайной частотой в (-0.9 pi, 0.9 pi) на отсчёт, начиная с phase0 */
+vector<double> RandomPhase(TestRandom& random, size_t n, double phase0) {
+    vector<double> phase(n);
+    double p = phase0;
+    for (double& x : phase) {
+        x = p;
+        p += random.Uniform(-0.9 * kPi, 0.9 * kPi);
+    }
+    return phase;
+}
+
+/** Модуль и аргумент; Fast — те же биты, что у Abs и Arg; обратно через Polar */
+void PhaseToPolar(TestState& state) {
+    TestRandom random;
+    const size_t n = 1003;
+    vector<Complex> z(n);
+    for (size_t i = 0; i < n; ++i) {
+        z[i] = i % 2 ? random.UniformComplex(-4, 4) : random.LogUniformComplex(-300, 300);
+    }
+    z[0] = Complex();
+    z[1] = Complex(-1, 0);
+    z[2] = Complex(INFINITY, 1);
+    z[3] = Complex(NAN, 0);
+    ErrorStats fast, approx;
+    for (MathAccuracy accuracy : kAccuracies) {
+        vector<double> r(n), theta(n), abs(n), arg(n);
+        ToPolar(z.data(), r.data(), theta.data(), n, accuracy);
+        Abs(z.data(), abs.data(), n);
+        Arg(z.data(), arg.data(), n, accuracy);
+        EXPECT(state, SameArray(r, abs) && SameArray(theta, arg));
+        for (size_t i = 4; i < n; ++i) {
+            long double refArg = RefArg(z[i]);
+            double error = accuracy == MathAccuracy::Approx ? double(fabsl(theta[i] - refArg) / fabsl(refArg))
+                                                            : UlpError(theta[i], refArg);
+            (accuracy == MathAccuracy::Approx ? approx : fast).Add(error, z[i]);
+        }
+        EXPECT(state, r[0] == 0 && theta[0] == 0 && theta[1] == kPi && r[2] == INFINITY && std::isnan(r[3]));
+        vector<Complex> back(n);
+        Polar(r.data(), theta.data(), back.data(), n, accuracy);
+        EXPECT(state, (back[100] - z[100]).Abs() <= 1e-8 * z[100].Abs());
+    }
+    state.CheckBudget("Phase_ToPolar", fast);
+    state.CheckBudget("Kernel_Arg_Approx", approx, " [ToPolar]");
+}
+TEST(PhaseToPolar);
+
+/**
+ * Развёртка Arg(e^(i phase)) восстанавливает phase с точностью до
+ * постоянного кратного 2pi; блоки любой длины и на месте — тот же результат
+ */
+void PhaseUnwrap(TestState& state) {
+    TestRandom random;
+    const size_t n = 5000;
+    vector<double> phase = RandomPhase(random, n, 2.5), wrapped(n);
+    for (size_t i = 0; i < n; ++i) {
+        wrapped[i] = Arg(Polar(1.0, phase[i]));
+    }
+    PhaseUnwrapper unwrapper;
+    vector<double> whole(n);
+    unwrapper.Process(wrapped.data(), whole.data(), n);
+    double worst = 0;
+    for (size_t i = 0; i < n; ++i) {
+        worst = fmax(worst, fabs(whole[i] - phase[i]) / (1 + fabs(phase[i])));
+    }
+    EXPECT(state, worst <= 64 * DBL_EPSILON);
+    EXPECT(state, whole[0] == wrapped[0]);
+
+    unwrapper.Reset();
+    vector<double> chunked = wrapped;
+    for (size_t done = 0; done < n;) {
+        size_t m = size_t(random.Next() % 700);
+        m = m < n - done ? m : n - done;
+        unwrapper.Process(chunked.data() + done, chunked.data() + done, m);
+        done += m;
+    }
+    EXPECT(state, SameArray(chunked, whole));
+    EXPECT(state, unwrapper.Turns() == round((phase[n - 1] - wrapped[n - 1]) / (2 * kPi)));
+
+    // NaN не сбивает счёт оборотов у остальных отсчётов.
+    unwrapper.Reset();
+    vector<double> gap = wrapped, out(n);
+    gap[1000] = NAN;
+    unwrapper.Process(gap.data(), out.data(), n);
+    EXPECT(state, std::isnan(out[1000]) && out[999] == whole[999]);
+    EXPECT(state, fabs(out[1001] - whole[1001]) < 1e-9 || fabs(fabs(out[1001] - whole[1001]) - 2 * kPi) < 1e-9);
+}
+TEST(PhaseUnwrap);
+
+/** Дискриминатор на сигнале с известной частотой: все точности, блоки, множитель */
+void PhaseFmDiscriminator(TestState& state) {
+    TestRandom random;
+    const size_t n = 3000;
+    vector<double> phase = RandomPhase(random, n, -1);
+    vector<Complex> z(n);
+    for (size_t i = 0; i < n; ++i) {
+        z[i] = Polar(random.Uniform(0.5, 2), phase[i]);
+    }
+    const double tolerance[] = {1e-13, 1e-13, 1e-8};
+    for (size_t a = 0; a < 3; ++a) {
+        FmDiscriminator discriminator(2.0, kAccuracies[a]);
+        vector<double> whole(n), chunked(n);
+        discriminator.Process(z.data(), whole.data(), n);
+        double worst = 0;
+        for (size_t i = 1; i < n; ++i) {
+            worst = fmax(worst, fabs(whole[i] / 2 - (phase[i] - phase[i - 1])));
+        }
+        // Первый отсчёт — arg(z[0] * conj(z[0])): с FMA мнимая часть равна
+        // ошибке округления произведения, а не нулю.
+        EXPECT(state, fabs(whole[0]) <= 4 * DBL_EPSILON && worst <= tolerance[a]);
+        discriminator.Reset();
+        for (size_t done = 0; done < n;) {
+            size_t m = size_t(random.Next() % 100);
+            m = m < n - done ? m : n - done;
+            discriminator.Process(z.data() + done, chunked.data() + done, m);
+            done += m;
+        }
+        EXPECT(state, SameArray(chunked, whole));
+    }
+}
+TEST(PhaseFmDiscriminator);
+
+} // namespace
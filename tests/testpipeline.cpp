@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "test.h"
+#include "../oscillator.h"
+#include "../pipeline.h"
+
+// Потоковый конвейер: КИХ-фильтр и дециматор против прямой свёртки в long
+// double, независимость результата от разбиения входа на блоки, поточный
+// режим против синхронного.
+
+namespace {
+
+vector<Complex> RandomSignal(TestRandom& random, size_t n) {
+    vector<Complex> x(n);
+    for (Complex& z : x) {
+        z = random.UniformComplex(-1, 1);
+    }
+    return x;
+}
+
+/** Подаёт x в ступень кусками случайной длины до maxChunk */
+vector<Complex> Feed(StreamStage& stage, const vector<Complex>& x, TestRandom& random, size_t maxChunk) {
+    vector<Complex> y, out;
+    for (size_t done = 0; done < x.size();) {
+        size_t m = size_t(random.Next() % (maxChunk + 1));
+        m = m < x.size() - done ? m : x.size() - done;
+        out.resize(stage.MaxOutput(m));
+        size_t produced = stage.Process(x.data() + done, m, out.data());
+        y.insert(y.end(), out.begin(), out.begin() + produced);
+        done += m;
+    }
+    return y;
+}
+
+/**
+ * @brief Ошибка выхода k прямой свёртки sum h[j] * x[k * factor - j] в
+ * единицах DBL_EPSILON * |h| * rms(x) (|h| — евклидова норма отводов, rms —
+ * по всему сигналу), то есть относительно типичного модуля выхода. Ошибка
+ * БПФ размазана по всему блоку, поэтому на отдельных малых отсчётах она не
+ * мала относительно них самих.
+ */
+void AddConvolutionErrors(ErrorStats& stats, const vector<Complex>& h, const vector<Complex>& x,
+                          const vector<Complex>& y, size_t factor) {
+    long double hh = 0, xx = 0;
+    for (const Complex& z : h) {
+        hh += ToRef(z).re * ToRef(z).re + ToRef(z).im * ToRef(z).im;
+    }
+    for (const Complex& z : x) {
+        xx += ToRef(z).re * ToRef(z).re + ToRef(z).im * ToRef(z).im;
+    }
+    long double scale = sqrtl(hh * xx / x.size()) * DBL_EPSILON;
+    for (size_t k = 0; k < y.size(); ++k) {
+        long double re = 0, im = 0;
+        size_t t = k * factor;
+        for (size_t j = 0; j < h.size() && j <= t; ++j) {
+            RefComplex p = RefMul(ToRef(h[j]), ToRef(x[t - j]));
+            re += p.re;
+            im += p.im;
+        }
+        long double dr = y[k].Re() - re, di = y[k].Im() - im;
+        stats.Add(double(hypotl(dr, di) / scale), y[k]);
+    }
+}
+
+bool SameSignal(const vector<Complex>& a, const vector<Complex>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!SameValue(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Перекрытие с накоплением против прямой свёртки; разбиение входа не влияет на выход */
+void PipelineFir(TestState& state) {
+    TestRandom random;
+    ErrorStats error;
+    for (size_t taps : {1, 7, 63, 200}) {
+        vector<Complex> h = RandomSignal(random, taps), x = RandomSignal(random, 20000);
+        FirFilter whole(h.data(), taps), pieces(h.data(), taps);
+        vector<Complex> y(whole.MaxOutput(x.size()));
+        y.resize(whole.Process(x.data(), x.size(), y.data()));
+        EXPECT(state, y.size() == x.size() / whole.BlockLength() * whole.BlockLength());
+        EXPECT(state, SameSignal(Feed(pieces, x, random, 3000), y));
+        AddConvolutionErrors(error, h, x, y, 1);
+        // После Reset() — снова с нулевой истории.
+        whole.Reset();
+        vector<Complex> again(y.size());
+        again.resize(whole.Process(x.data(), x.size(), again.data()));
+        EXPECT(state, SameSignal(again, y));
+    }
+    state.CheckBudget("Pipeline_Fir", error);
+    bool thrown = false;
+    try {
+        FirFilter bad(nullptr, 0);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(PipelineFir);
+
+/** Дециматор против прямой свёртки с прореживанием */
+void PipelineDecimator(TestState& state) {
+    TestRandom random;
+    ErrorStats error;
+    for (size_t factor : {1, 3, 8}) {
+        vector<double> h(48);
+        vector<Complex> hc(h.size());
+        for (size_t j = 0; j < h.size(); ++j) {
+            h[j] = random.Uniform(-1, 1);
+            hc[j] = Complex(h[j]);
+        }
+        vector<Complex> x = RandomSignal(random, 10001);
+        Decimator whole(h.data(), h.size(), factor), pieces(h.data(), h.size(), factor);
+        vector<Complex> y(whole.MaxOutput(x.size()));
+        y.resize(whole.Process(x.data(), x.size(), y.data()));
+        EXPECT(state, y.size() == (x.size() + factor - 1) / factor);
+        EXPECT(state, SameSignal(Feed(pieces, x, random, 500), y));
+        AddConvolutionErrors(error, hc, x, y, factor);
+    }
+    state.CheckBudget("Pipeline_Decimator", error);
+}
+TEST(PipelineDecimator);
+
+/** Конвейер: смеситель до бита как Oscillator::Mix, поточный режим до бита как синхронный */
+void PipelineThreaded(TestState& state) {
+    TestRandom random;
+    vector<Complex> h = RandomSignal(random, 33), x = RandomSignal(random, 100000);
+    vector<double> lowpass(40);
+    for (double& v : lowpass) {
+        v = random.Uniform(-1, 1);
+    }
+    auto build = [&](Pipeline& p) {
+        p.Emplace<Mixer>(0.3, 0.1);
+        p.Emplace<FirFilter>(h.data(), h.size());
+        p.Emplace<Decimator>(lowpass.data(), lowpass.size(), 5);
+    };
+    Pipeline mixerOnly(1000);
+    mixerOnly.Emplace<Mixer>(0.3, 0.1);
+    vector<Complex> mixed, expected(x.size());
+    mixerOnly.Push(x.data(), x.size(), [&](const Complex* y, size_t m) { mixed.insert(mixed.end(), y, y + m); });
+    Oscillator(0.3, 0.1).Mix(x.data(), expected.data(), x.size());
+    EXPECT(state, SameSignal(mixed, expected));
+
+    Pipeline sync(777), threaded(777);
+    build(sync);
+    build(threaded);
+    vector<Complex> a, b;
+    sync.Push(x.data(), x.size(), [&](const Complex* y, size_t m) { a.insert(a.end(), y, y + m); });
+    size_t pos = 0;
+    PipelineThreads threads;
+    threads.ringSlots = 2;
+    threads.cpus = {0, 1, 2};
+    threaded.Run([&](Complex* dst, size_t n) {
+        size_t m = n < x.size() - pos ? n : x.size() - pos;
+        copy(x.begin() + pos, x.begin() + pos + m, dst);
+        pos += m;
+        return m;
+    }, [&](const Complex* y, size_t m) { b.insert(b.end(), y, y + m); }, threads);
+    EXPECT(state, !a.empty() && SameSignal(a, b));
+    for (size_t i = 0; i < sync.StageCount(); ++i) {
+        const StageStats& s = sync.Stats()[i];
+        const StageStats& t = threaded.Stats()[i];
+        EXPECT(state, s.samplesIn == t.samplesIn && s.samplesOut == t.samplesOut && s.blocks > 0);
+        EXPECT(state, s.maxLatencySeconds >= s.MeanLatency() && t.Throughput() > 0);
+    }
+    EXPECT(state, sync.Stats()[0].samplesIn == x.size() && sync.Stats()[2].samplesOut == a.size());
+}
+TEST(PipelineThreaded);
+
+/** Исключение в ступени останавливает поточный конвейер и выходит наружу */
+class FailingStage : public StreamStage {
+public:
+    size_t calls = 0;
+    const char* Name() const noexcept override { return "failing"; }
+    size_t MaxOutput(size_t n) const noexcept override { return n; }
+    size_t Process(const Complex* in, size_t n, Complex* out) override {
+        if (++calls == 3) {
+            throw runtime_error("stage failed");
+        }
+        copy(in, in + n, out);
+        return n;
+    }
+    void Reset() override { calls = 0; }
+};
+
+void PipelineStageError(TestState& state) {
+    Pipeline pipeline(64);
+    pipeline.Emplace<Mixer>(0.1);
+    pipeline.Emplace<FailingStage>();
+    pipeline.Emplace<Mixer>(-0.1);
+    bool thrown = false;
+    try {
+        pipeline.Run([](Complex* dst, size_t n) {
+            fill(dst, dst + n, Complex(1));
+            return n;
+        }, [](const Complex*, size_t) {});
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown && pipeline.Stats()[2].blocks == 2);
+}
+TEST(PipelineStageError);
+
+} // namespace
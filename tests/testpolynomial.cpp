@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "test.h"
+#include "../polynomial.h"
+#include "../simd.h"
+#include "../threadpool.h"
+
+// Многочлены: значения (Горнер, Эстрин, производная) на всех уровнях
+// инструкций против Горнера в long double, произведение прямо и через БПФ,
+// корни методом Аберта — Эрлиха. Ошибка значения — в единицах
+// DBL_EPSILON * sum |c_k| |z|^k (у производной — sum k |c_k| |z|^(k-1)).
+
+namespace {
+
+const long double kTwoPiL = 6.283185307179586476925286766559L;
+
+vector<Complex> RandomVector(TestRandom& random, size_t n) {
+    vector<Complex> v(n);
+    for (Complex& z : v) {
+        z = random.UniformComplex(-1, 1);
+    }
+    return v;
+}
+
+/** Ошибка got против ref в единицах DBL_EPSILON * bound */
+double ScaledError(const Complex& got, RefComplex ref, long double bound) {
+    if (bound == 0) {
+        return got.Re() == 0 && got.Im() == 0 ? 0 : INFINITY;
+    }
+    return double(hypotl(got.Re() - ref.re, got.Im() - ref.im) / (bound * DBL_EPSILON));
+}
+
+/** Значения, производные и их оценки в long double */
+void ReferencePolynomial(const vector<Complex>& c, const Complex& z, RefComplex& p, RefComplex& dp,
+                         long double& bound, long double& derivativeBound) {
+    p = dp = RefComplex{0, 0};
+    bound = derivativeBound = 0;
+    RefComplex x = ToRef(z);
+    long double r = RefAbs(x);
+    for (size_t k = c.size(); k-- > 0;) {
+        dp = RefAdd(RefMul(dp, x), p);
+        derivativeBound = derivativeBound * r + bound;
+        p = RefAdd(RefMul(p, x), ToRef(c[k]));
+        bound = bound * r + RefAbs(ToRef(c[k]));
+    }
+}
+
+/** Ядро polyEvalInterleaved всех уровней: длины с хвостами, обе схемы, производная */
+void PolyEvaluate(TestState& state) {
+    TestRandom random;
+    const size_t points = 37;
+    for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (int(level) > int(DetectSimdLevel())) {
+            continue;
+        }
+        const SimdKernels& kernels = KernelsFor(level);
+        ErrorStats horner, estrin, derivative;
+        for (size_t count : {1, 2, 3, 4, 5, 7, 16, 33, 100, 257}) {
+            vector<Complex> c = RandomVector(random, count), z(points), p(points), dp(points), e(points);
+            for (Complex& x : z) {
+                x = random.UniformComplex(-1.1, 1.1);
+            }
+            double* zd = reinterpret_cast<double*>(z.data());
+            const double* cd = reinterpret_cast<const double*>(c.data());
+            kernels.polyEvalInterleaved(cd, count, zd, reinterpret_cast<double*>(p.data()),
+                                        reinterpret_cast<double*>(dp.data()), points, false);
+            kernels.polyEvalInterleaved(cd, count, zd, reinterpret_cast<double*>(e.data()), nullptr, points, true);
+            for (size_t i = 0; i < points; ++i) {
+                RefComplex rp, rdp;
+                long double bound, derivativeBound;
+                ReferencePolynomial(c, z[i], rp, rdp, bound, derivativeBound);
+                horner.Add(ScaledError(p[i], rp, bound), c[0], z[i]);
+                estrin.Add(ScaledError(e[i], rp, bound), c[0], z[i]);
+                derivative.Add(ScaledError(dp[i], rdp, derivativeBound), c[0], z[i]);
+            }
+        }
+        string label = string(" [") + kernels.name + "]";
+        state.CheckBudget("Poly_Horner", horner, label);
+        state.CheckBudget("Poly_Estrin", estrin, label);
+        state.CheckBudget("Poly_Derivative", derivative, label);
+    }
+
+    // Общий интерфейс: пакет на месте, одна точка, нулевой многочлен.
+    vector<Complex> c = RandomVector(random, 20), z = RandomVector(random, 11), batch = z, dp(11);
+    ErrorStats scalar;
+    EvaluatePolynomial(c.data(), c.size(), batch.data(), batch.data(), batch.size());
+    for (size_t i = 0; i < z.size(); ++i) {
+        RefComplex rp, rdp;
+        long double bound, derivativeBound;
+        ReferencePolynomial(c, z[i], rp, rdp, bound, derivativeBound);
+        scalar.Add(ScaledError(EvaluatePolynomial(c.data(), c.size(), z[i]), rp, bound), c[0], z[i]);
+        scalar.Add(ScaledError(batch[i], rp, bound), c[0], z[i]);
+    }
+    state.CheckBudget("Poly_Horner", scalar, " [Complex]");
+    EvaluatePolynomial(c.data(), 0, z.data(), batch.data(), dp.data(), z.size());
+    EXPECT(state, SameValue(batch[3], Complex()) && SameValue(dp[10], Complex()));
+    EXPECT(state, SameValue(EvaluatePolynomial(c.data(), 0, z[0]), Complex()));
+}
+TEST(PolyEvaluate);
+
+/** Произведение прямо и через БПФ против свёртки в long double */
+void PolyMultiply(TestState& state) {
+    TestRandom random;
+    const size_t sizes[][2] = {{1, 1}, {3, 7}, {64, 100}, {300, 257}, {1000, 9}};
+    ErrorStats direct, fft;
+    for (const size_t* size : sizes) {
+        vector<Complex> a = RandomVector(random, size[0]), b = RandomVector(random, size[1]);
+        vector<Complex> d = MultiplyPolynomials(a.data(), a.size(), b.data(), b.size(), PolyMultiplyMethod::Direct);
+        vector<Complex> f = MultiplyPolynomials(a.data(), a.size(), b.data(), b.size(), PolyMultiplyMethod::Fft);
+        EXPECT(state, d.size() == a.size() + b.size() - 1 && f.size() == d.size());
+        // Ошибка через БПФ — от норм множителей, а не от каждого коэффициента.
+        long double norm = 0, normA = 0, normB = 0;
+        for (const Complex& x : a) {
+            normA += RefAbs(ToRef(x)) * RefAbs(ToRef(x));
+        }
+        for (const Complex& x : b) {
+            normB += RefAbs(ToRef(x)) * RefAbs(ToRef(x));
+        }
+        norm = sqrtl(normA * normB);
+        for (size_t k = 0; k < d.size(); ++k) {
+            RefComplex sum{0, 0};
+            long double bound = 0;
+            for (size_t i = k >= b.size() ? k - b.size() + 1 : 0; i < a.size() && i <= k; ++i) {
+                sum = RefAdd(sum, RefMul(ToRef(a[i]), ToRef(b[k - i])));
+                bound += RefAbs(ToRef(a[i])) * RefAbs(ToRef(b[k - i]));
+            }
+            direct.Add(ScaledError(d[k], sum, bound), a[0], b[0]);
+            fft.Add(ScaledError(f[k], sum, norm), a[0], b[0]);
+        }
+        vector<Complex> automatic = MultiplyPolynomials(a.data(), a.size(), b.data(), b.size());
+        const vector<Complex>& chosen = min(a.size(), b.size()) >= kPolyFftThreshold ? f : d;
+        bool same = automatic.size() == chosen.size();
+        for (size_t k = 0; same && k < chosen.size(); ++k) {
+            same = SameValue(automatic[k], chosen[k]);
+        }
+        EXPECT(state, same);
+    }
+    state.CheckBudget("Poly_MultiplyDirect", direct);
+    state.CheckBudget("Poly_MultiplyFft", fft);
+    EXPECT(state, MultiplyPolynomials(nullptr, 0, nullptr, 0).empty());
+}
+TEST(PolyMultiply);
+
+/** Многочлен с заданными корнями: произведение (z - r_j), старший коэффициент 1 */
+vector<Complex> FromRoots(const vector<Complex>& roots) {
+    vector<Complex> c{Complex(1.0)};
+    for (const Complex& r : roots) {
+        Complex factor[2] = {Complex() - r, Complex(1.0)};
+        c = MultiplyPolynomials(c.data(), c.size(), factor, 2, PolyMultiplyMethod::Direct);
+    }
+    return c;
+}
+
+/** Наибольшее расстояние от найденного корня до ближайшего ожидаемого (каждый ожидаемый — один раз) */
+double MatchRoots(vector<Complex> expected, const vector<Complex>& found) {
+    if (expected.size() != found.size()) {
+        return INFINITY;
+    }
+    double worst = 0;
+    for (const Complex& z : found) {
+        size_t best = 0;
+        for (size_t j = 1; j < expected.size(); ++j) {
+            if ((expected[j] - z).Abs() < (expected[best] - z).Abs()) {
+                best = j;
+            }
+        }
+        worst = max(worst, (expected[best] - z).Abs());
+        expected.erase(expected.begin() + best);
+    }
+    return worst;
+}
+
+/**
+ * @brief Допуск каждого корня многочлена из FromRoots
+ *
+ * Первый порядок сдвига корня r при ошибках коэффициентов:
+ * (n eps prod (|r| + |r_j|) + eta sum |c_k| |r|^k) / |p'(r)|. Первое слагаемое —
+ * ошибка перемножения в FromRoots (она ограничена коэффициентами
+ * prod (z + |r_j|)), второе — обратная ошибка eta найденных корней. Близкие
+ * корни обусловлены плохо, поэтому общий допуск для случайных корней в круге
+ * не годится.
+ */
+vector<double> RootTolerances(const vector<Complex>& roots, const vector<Complex>& c, double eta) {
+    size_t n = roots.size();
+    vector<double> tolerance(n);
+    for (size_t j = 0; j < n; ++j) {
+        long double r = hypotl(roots[j].Re(), roots[j].Im());
+        long double product = 1, derivative = 1, sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            product *= r + hypotl(roots[i].Re(), roots[i].Im());
+            if (i != j) {
+                derivative *= hypotl((long double)roots[j].Re() - roots[i].Re(),
+                                     (long double)roots[j].Im() - roots[i].Im());
+            }
+        }
+        for (size_t k = c.size(); k-- > 0;) {
+            sum = sum * r + hypotl(c[k].Re(), c[k].Im());
+        }
+        tolerance[j] = double((n * DBL_EPSILON * product + eta * sum) / derivative);
+    }
+    return tolerance;
+}
+
+/**
+ * @brief Наибольшее расстояние от найденного корня до ближайшего ожидаемого
+ * (каждый ожидаемый — один раз) в единицах допуска этого ожидаемого корня
+ */
+double MatchRoots(vector<Complex> expected, vector<double> tolerance, const vector<Complex>& found) {
+    if (expected.size() != found.size()) {
+        return INFINITY;
+    }
+    double worst = 0;
+    for (const Complex& z : found) {
+        size_t best = 0;
+        for (size_t j = 1; j < expected.size(); ++j) {
+            if ((expected[j] - z).Abs() < (expected[best] - z).Abs()) {
+                best = j;
+            }
+        }
+        worst = max(worst, (expected[best] - z).Abs() / tolerance[best]);
+        expected.erase(expected.begin() + best);
+        tolerance.erase(tolerance.begin() + best);
+    }
+    return worst;
+}
+
+/** Корни: случайные в круге, корни из единицы, разные масштабы, нулевые коэффициенты */
+void PolyRoots(TestState& state) {
+    TestRandom random;
+    vector<Complex> roots(50);
+    for (Complex& r : roots) {
+        do {
+            r = random.UniformComplex(-1, 1);
+        } while (r.Abs() > 1);
+    }
+    vector<Complex> c = FromRoots(roots);
+    ThreadPool single(0), pool(3);
+    RootOptions options;
+    options.grain = 7;
+    RootResult serial = FindRoots(c.data(), c.size(), options, single);
+    RootResult parallel = FindRoots(c.data(), c.size(), options, pool);
+    EXPECT(state, serial.converged && serial.roots.size() == roots.size());
+    EXPECT(state, serial.maxBackwardError <= 4 * 50 * DBL_EPSILON && isfinite(serial.maxErrorBound));
+    EXPECT(state, MatchRoots(roots, RootTolerances(roots, c, serial.maxBackwardError), serial.roots) <= 1);
+    bool same = serial.sweeps == parallel.sweeps && parallel.roots.size() == serial.roots.size();
+    for (size_t i = 0; same && i < serial.roots.size(); ++i) {
+        same = SameValue(serial.roots[i], parallel.roots[i]) && serial.iterations[i] == parallel.iterations[i];
+    }
+    EXPECT(state, same);
+    for (size_t i = 0; i < serial.roots.size(); ++i) {
+        EXPECT(state, serial.iterations[i] > 0 && serial.iterations[i] <= serial.sweeps &&
+                          serial.backwardError[i] <= serial.maxBackwardError);
+    }
+
+    // z^n - 1: корни на единичной окружности (и вне её считаются через 1/z).
+    const size_t n = 64;
+    vector<Complex> unity(n + 1);
+    unity[0] = Complex(-1.0);
+    unity[n] = Complex(1.0);
+    vector<Complex> expected(n);
+    for (size_t k = 0; k < n; ++k) {
+        RefComplex r = RefPolar(1, kTwoPiL * k / n);
+        expected[k] = Complex(double(r.re), double(r.im));
+    }
+    RootResult circle = FindRoots(unity.data(), unity.size());
+    EXPECT(state, circle.converged && MatchRoots(expected, circle.roots) < 1e-13);
+
+    // Корни 1e-3, 1, 1e3 и 1e3 * i; нули младших и старших коэффициентов.
+    vector<Complex> scales{Complex(1e-3), Complex(1.0), Complex(1e3), Complex(0, 1e3)};
+    vector<Complex> spread = FromRoots(scales);
+    spread.insert(spread.begin(), 2, Complex());
+    spread.push_back(Complex());
+    scales.push_back(Complex());
+    scales.push_back(Complex());
+    RootResult mixed = FindRoots(spread.data(), spread.size());
+    EXPECT(state, mixed.converged && mixed.roots.size() == 6);
+    EXPECT(state, MatchRoots(scales, mixed.roots) < 1e-9);
+    EXPECT(state, SameValue(mixed.roots[4], Complex()) && mixed.iterations[5] == 0);
+
+    // Степень 1 и 0.
+    Complex linear[2] = {Complex(2, -4), Complex(0, 2)};
+    RootResult one = FindRoots(linear, 2);
+    EXPECT(state, one.converged && one.roots.size() == 1 && (one.roots[0] - Complex(2, 1)).Abs() < 1e-15);
+    EXPECT(state, FindRoots(linear + 1, 1).roots.empty());
+
+    bool thrown = false;
+    try {
+        Complex zero[3];
+        FindRoots(zero, 3);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(PolyRoots);
+
+} // namespace
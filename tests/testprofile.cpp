@@ -0,0 +1,79 @@
+#include <cstring>
+#include <string>
+#include <thread>
+#include "test.h"
+#include "../complexarray.h"
+#include "../profile.h"
+
+// Счётчики горячих путей: форматы выгрузки в любой сборке; в сборке с
+// COMPLEX_PROFILE (make PROFILE=1 test) — точные числа операций, замеры
+// пакетных функций и сложение счётчиков завершившихся потоков.
+
+namespace {
+
+void ProfileExport(TestState& state) {
+    ProfileSnapshot snapshot = CollectProfile();
+    EXPECT(state, snapshot.enabled == ProfileEnabled());
+    string json = ProfileToJson(snapshot);
+    EXPECT(state, json.find(ProfileEnabled() ? "{\"enabled\": true" : "{\"enabled\": false") == 0);
+    EXPECT(state, json.find("\"mul\": ") != string::npos && json.find("\"kernels\": [") != string::npos);
+    string text = ProfileToPrometheus(snapshot);
+    EXPECT(state, text.find("# TYPE complex_operations_total counter\n") != string::npos);
+    EXPECT(state, text.find("complex_operations_total{op=\"write\"} ") != string::npos);
+    EXPECT(state, strcmp(ProfileOpName(ProfileOp::Abs), "abs") == 0);
+    if (!ProfileEnabled()) {
+        EXPECT(state, snapshot.threads == 0 && snapshot.kernels.empty());
+    }
+}
+TEST(ProfileExport);
+
+#ifdef COMPLEX_PROFILE
+
+const ProfileKernelStats* FindKernel(const ProfileSnapshot& snapshot, const char* name) {
+    for (const ProfileKernelStats& kernel : snapshot.kernels) {
+        if (kernel.name == name) {
+            return &kernel;
+        }
+    }
+    return nullptr;
+}
+
+void ProfileCounts(TestState& state) {
+    ResetProfile();
+    Complex a(1, 2), b(3, -1);
+    Complex c = a * b;
+    c *= a;
+    c = c + b - a;
+    double m = c.Abs() + a.AbsSquared();
+    // Поток завершается до CollectProfile: его счётчики не теряются.
+    thread worker([] {
+        Complex z;
+        for (int i = 0; i < 5; ++i) {
+            z += Complex(i, 1);
+        }
+        ComplexArray x(100), y(100), out;
+        Add(x, y, out);
+    });
+    worker.join();
+    ProfileSnapshot snapshot = CollectProfile();
+    EXPECT(state, m > 0);
+    EXPECT(state, snapshot.ops[size_t(ProfileOp::Mul)] == 2);
+    EXPECT(state, snapshot.ops[size_t(ProfileOp::Add)] == 7);
+    EXPECT(state, snapshot.ops[size_t(ProfileOp::Abs)] == 2);
+    EXPECT(state, snapshot.threads >= 2);
+    const ProfileKernelStats* add = FindKernel(snapshot, "array.add");
+    EXPECT(state, add && add->calls == 1 && add->items == 100 && add->cycles > 0);
+    string text = ProfileToPrometheus(snapshot);
+    EXPECT(state, text.find("complex_operations_total{op=\"mul\"} 2\n") != string::npos);
+    EXPECT(state, text.find("complex_kernel_items_total{kernel=\"array.add\"} 100\n") != string::npos);
+
+    // После сброса — с нуля.
+    ResetProfile();
+    snapshot = CollectProfile();
+    EXPECT(state, snapshot.ops[size_t(ProfileOp::Mul)] == 0 && snapshot.kernels.empty());
+}
+TEST(ProfileCounts);
+
+#endif // COMPLEX_PROFILE
+
+} // namespace
@@ -0,0 +1,166 @@
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "test.h"
+#include "../reductions.h"
+#include "../threadpool.h"
+
+// Редукции: суммы против long double (быстрая — в единицах DBL_EPSILON от
+// суммы модулей, компенсированная — в ULP результата), совпадение бит в бит
+// однопоточной версии и версий на пулах разного размера, выбор первого из
+// равных по модулю, пропуск NaN и пустые массивы.
+
+namespace {
+
+const size_t kLengths[] = {0, 1, 7, 4095, 4096, 4097, 20000, 100003};
+
+/** Случайные числа около center: среднее велико по сравнению с разбросом */
+vector<Complex> RandomSignal(TestRandom& random, size_t n, const Complex& center) {
+    vector<Complex> x(n);
+    for (Complex& z : x) {
+        z = center + random.UniformComplex(-1, 1);
+    }
+    return x;
+}
+
+bool Same(const MagnitudeExtremum& a, const MagnitudeExtremum& b) {
+    return a.index == b.index && SameValue(a.magnitude, b.magnitude);
+}
+
+/** Суммы, энергия и дисперсия обоих режимов */
+void ReduceSums(TestState& state) {
+    TestRandom random;
+    ErrorStats sum, sumCompensated, energy, energyCompensated, variance;
+    for (size_t n : kLengths) {
+        vector<Complex> x = RandomSignal(random, n, Complex(30, -40));
+        RefComplex ref{0, 0};
+        long double magnitude = 0, squares = 0;
+        for (const Complex& z : x) {
+            ref = RefAdd(ref, ToRef(z));
+            magnitude += RefAbs(ToRef(z));
+            squares += RefAbs(ToRef(z)) * RefAbs(ToRef(z));
+        }
+        Complex fast = Sum(x.data(), n), exact = Sum(x.data(), n, SumMode::Compensated);
+        energyCompensated.Add(UlpError(SumAbsSquared(x.data(), n, SumMode::Compensated), squares));
+        sumCompensated.Add(UlpError(exact, ref));
+        if (n == 0) {
+            EXPECT(state, SameValue(fast, Complex()) && SumAbsSquared(x.data(), n) == 0);
+            continue;
+        }
+        long double dr = fast.Re() - ref.re, di = fast.Im() - ref.im;
+        sum.Add(double(sqrtl(dr * dr + di * di) / (magnitude * DBL_EPSILON)), x[0]);
+        energy.Add(double(fabsl(SumAbsSquared(x.data(), n) - squares) / (squares * DBL_EPSILON)), x[0]);
+
+        // Дисперсия — относительно эталонной (в единицах DBL_EPSILON): среднее
+        // в 50 раз больше разброса, однопроходная формула потеряла бы 3 знака.
+        RefComplex mean{ref.re / n, ref.im / n};
+        long double deviation = 0;
+        for (const Complex& z : x) {
+            long double r = RefAbs(RefSub(ToRef(z), mean));
+            deviation += r * r;
+        }
+        deviation /= n;
+        if (n == 1) {
+            EXPECT(state, Variance(x.data(), n) == 0);
+            continue;
+        }
+        for (SumMode mode : {SumMode::Fast, SumMode::Compensated}) {
+            variance.Add(double(fabsl(Variance(x.data(), n, mode) - deviation) / (deviation * DBL_EPSILON)), x[0]);
+        }
+        EXPECT(state, SameValue(Mean(x.data(), n, SumMode::Compensated), exact / double(n)));
+    }
+    state.CheckBudget("Reduce_Sum", sum);
+    state.CheckBudget("Reduce_SumCompensated", sumCompensated);
+    state.CheckBudget("Reduce_Energy", energy);
+    state.CheckBudget("Reduce_EnergyCompensated", energyCompensated);
+    state.CheckBudget("Reduce_Variance", variance);
+
+    for (bool mean : {true, false}) {
+        bool thrown = false;
+        try {
+            if (mean) {
+                Mean(nullptr, 0);
+            } else {
+                Variance(nullptr, 0);
+            }
+        } catch (const invalid_argument&) {
+            thrown = true;
+        }
+        EXPECT(state, thrown);
+    }
+}
+TEST(ReduceSums);
+
+/** Пулы из 1, 2 и 5 потоков дают тот же результат, что и однопоточная версия */
+void ReduceThreads(TestState& state) {
+    TestRandom random;
+    vector<Complex> x = RandomSignal(random, 300007, Complex(1, 2));
+    ThreadPool one(0), two(1), many(4);
+    for (ThreadPool* pool : {&one, &two, &many, &ThreadPool::Default()}) {
+        for (SumMode mode : {SumMode::Fast, SumMode::Compensated}) {
+            EXPECT(state, SameValue(Sum(x.data(), x.size(), mode, *pool), Sum(x.data(), x.size(), mode)));
+            EXPECT(state, SameValue(Mean(x.data(), x.size(), mode, *pool), Mean(x.data(), x.size(), mode)));
+            EXPECT(state, SameValue(SumAbsSquared(x.data(), x.size(), mode, *pool),
+                                    SumAbsSquared(x.data(), x.size(), mode)));
+            EXPECT(state, SameValue(Variance(x.data(), x.size(), mode, *pool), Variance(x.data(), x.size(), mode)));
+        }
+        EXPECT(state, Same(MaxMagnitude(x.data(), x.size(), *pool), MaxMagnitude(x.data(), x.size())));
+        EXPECT(state, Same(MinMagnitude(x.data(), x.size(), *pool), MinMagnitude(x.data(), x.size())));
+    }
+}
+TEST(ReduceThreads);
+
+/** Наибольший и наименьший модуль против перебора; равные, NaN, бесконечности */
+void ReduceExtremum(TestState& state) {
+    TestRandom random;
+    for (size_t n : kLengths) {
+        vector<Complex> x = RandomSignal(random, n, Complex());
+        MagnitudeExtremum top = MaxMagnitude(x.data(), n), bottom = MinMagnitude(x.data(), n);
+        if (n == 0) {
+            EXPECT(state, top.index == 0 && std::isnan(top.magnitude) && bottom.index == 0);
+            continue;
+        }
+        size_t maxIndex = 0, minIndex = 0;
+        for (size_t i = 1; i < n; ++i) {
+            maxIndex = x[i].AbsSquared() > x[maxIndex].AbsSquared() ? i : maxIndex;
+            minIndex = x[i].AbsSquared() < x[minIndex].AbsSquared() ? i : minIndex;
+        }
+        // |z|^2 ядра (через FMA) и AbsSquared могут разойтись в последнем
+        // бите: тогда выбранный элемент не хуже эталонного с точностью до ulp.
+        EXPECT(state, top.index == maxIndex ||
+                          fabs(x[top.index].AbsSquared() - x[maxIndex].AbsSquared()) <=
+                              4 * DBL_EPSILON * x[maxIndex].AbsSquared());
+        EXPECT(state, bottom.index == minIndex ||
+                          fabs(x[bottom.index].AbsSquared() - x[minIndex].AbsSquared()) <=
+                              4 * DBL_EPSILON * (x[minIndex].AbsSquared() + DBL_MIN));
+        EXPECT(state, SameValue(top.magnitude, x[top.index].Abs()));
+
+        // Одинаковые по модулю пики в разных блоках и дорожках: выбирается первый.
+        if (n > 5000) {
+            x[4999] = Complex(0, 7);
+            x[n - 1] = Complex(-7, 0);
+            x[n / 3] = Complex(1e-200, 0);
+            x[n / 2] = Complex(0, -1e-200);
+            EXPECT(state, MaxMagnitude(x.data(), n).index == 4999);
+            EXPECT(state, MinMagnitude(x.data(), n).index == n / 3);
+            x[17] = Complex(NAN, 0);
+            x[18] = Complex(0, NAN);
+            EXPECT(state, MaxMagnitude(x.data(), n).index == 4999);
+            EXPECT(state, MinMagnitude(x.data(), n).index == n / 3);
+        }
+    }
+    vector<Complex> special(20, Complex(NAN, 1));
+    EXPECT(state, MaxMagnitude(special.data(), special.size()).index == special.size());
+    EXPECT(state, MinMagnitude(special.data(), special.size()).index == special.size());
+    special[13] = Complex(INFINITY, 0);
+    special[15] = Complex(0, -INFINITY);
+    EXPECT(state, MinMagnitude(special.data(), special.size()).index == 13);
+    EXPECT(state, MaxMagnitude(special.data(), special.size()).index == 13);
+    special[11] = Complex(1e300, 1e300);
+    MagnitudeExtremum huge = MinMagnitude(special.data(), special.size());
+    EXPECT(state, huge.index == 11 && huge.magnitude == Complex(1e300, 1e300).Abs());
+}
+TEST(ReduceExtremum);
+
+} // namespace
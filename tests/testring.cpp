@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "../ringbuffer.h"
+
+// Кольца без блокировок: порядок и целостность данных при передаче между
+// потоками кусками случайной длины, закрытие кольца, оба способа ожидания.
+
+namespace {
+
+/** Один писатель и один читатель: поток 0, 1, 2, ... доходит целиком и по порядку */
+void SpscTransfer(TestState& state) {
+    const size_t n = 300000;
+    for (WaitPolicy policy : {WaitPolicy::Spin, WaitPolicy::Futex}) {
+        SpscRing ring(1000, policy);
+        EXPECT(state, ring.Capacity() == 1024);
+        TestRandom writerRandom(TestSeed()), readerRandom(TestSeed() + 1);
+        thread writer([&] {
+            for (size_t done = 0; done < n;) {
+                size_t want = 1 + size_t(writerRandom.Next() % 700);
+                SpscRing::Region region = ring.ClaimWrite(min(want, n - done));
+                for (size_t k = 0; k < region.count; ++k) {
+                    region.data[k] = Complex(double(done + k), -double(done + k));
+                }
+                ring.CommitWrite(region.count);
+                done += region.count;
+            }
+            ring.Close();
+        });
+        size_t received = 0, errors = 0;
+        vector<Complex> copied(500);
+        for (;;) {
+            if (readerRandom.Next() % 2) {
+                SpscRing::Region region = ring.ClaimRead(1 + size_t(readerRandom.Next() % 900));
+                if (region.count == 0) {
+                    break;
+                }
+                for (size_t k = 0; k < region.count; ++k) {
+                    errors += !SameValue(region.data[k], Complex(double(received + k), -double(received + k)));
+                }
+                ring.CommitRead(region.count);
+                received += region.count;
+            } else {
+                size_t count = ring.Read(copied.data(), copied.size());
+                for (size_t k = 0; k < count; ++k) {
+                    errors += !SameValue(copied[k], Complex(double(received + k), -double(received + k)));
+                }
+                received += count;
+                if (count < copied.size()) {
+                    break;
+                }
+            }
+        }
+        writer.join();
+        EXPECT(state, received == n && errors == 0 && ring.Size() == 0);
+        EXPECT(state, ring.ClaimWrite(10).count == 0 && ring.ClaimRead(10).count == 0);
+    }
+    bool thrown = false;
+    try {
+        SpscRing bad(0);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    EXPECT(state, thrown);
+}
+TEST(SpscTransfer);
+
+/** Участки непрерывны: у конца буфера участок короче, затем — с начала */
+void SpscRegions(TestState& state) {
+    SpscRing ring(8);
+    SpscRing::Region w = ring.ClaimWrite(6);
+    EXPECT(state, w.count == 6);
+    ring.CommitWrite(6);
+    SpscRing::Region r = ring.ClaimRead(100);
+    EXPECT(state, r.count == 6 && r.data == w.data);
+    ring.CommitRead(4);
+    w = ring.TryClaimWrite(100);
+    EXPECT(state, w.count == 2 && w.data == r.data + 6);
+    ring.CommitWrite(2);
+    w = ring.TryClaimWrite(100);
+    EXPECT(state, w.count == 4 && w.data == r.data);
+    ring.CommitWrite(4);
+    EXPECT(state, ring.TryClaimWrite(1).count == 0 && ring.Size() == 8);
+}
+TEST(SpscRegions);
+
+/** Два писателя и два читателя: каждый блок получен ровно один раз */
+void MpmcTransfer(TestState& state) {
+    const size_t perWriter = 20000, blockSize = 37;
+    for (WaitPolicy policy : {WaitPolicy::Spin, WaitPolicy::Futex}) {
+        MpmcBlockRing ring(5, blockSize, policy);
+        EXPECT(state, ring.Slots() == 8 && ring.BlockSize() == blockSize);
+        vector<vector<size_t>> seen(2, vector<size_t>(2 * perWriter, 0));
+        vector<size_t> corrupt(2, 0);
+        vector<thread> threads;
+        for (size_t w = 0; w < 2; ++w) {
+            threads.emplace_back([&, w] {
+                for (size_t i = 0; i < perWriter; ++i) {
+                    MpmcBlockRing::Block block = ring.ClaimWrite();
+                    size_t id = w * perWriter + i, count = 1 + id % blockSize;
+                    for (size_t k = 0; k < count; ++k) {
+                        block.data[k] = Complex(double(id), double(k));
+                    }
+                    ring.CommitWrite(block, count);
+                }
+            });
+        }
+        for (size_t r = 0; r < 2; ++r) {
+            threads.emplace_back([&, r] {
+                for (;;) {
+                    MpmcBlockRing::Block block = ring.ClaimRead();
+                    if (!block.data) {
+                        break;
+                    }
+                    size_t id = size_t(block.data[0].Re());
+                    corrupt[r] += id >= 2 * perWriter || block.count != 1 + id % blockSize;
+                    for (size_t k = 0; k < block.count && id < 2 * perWriter; ++k) {
+                        corrupt[r] += !SameValue(block.data[k], Complex(double(id), double(k)));
+                    }
+                    if (id < 2 * perWriter) {
+                        ++seen[r][id];
+                    }
+                    ring.CommitRead(block);
+                }
+            });
+        }
+        threads[0].join();
+        threads[1].join();
+        ring.Close();
+        threads[2].join();
+        threads[3].join();
+        size_t wrong = corrupt[0] + corrupt[1];
+        for (size_t id = 0; id < 2 * perWriter; ++id) {
+            wrong += seen[0][id] + seen[1][id] != 1;
+        }
+        EXPECT(state, wrong == 0);
+        EXPECT(state, ring.ClaimWrite().data == nullptr && ring.ClaimRead().data == nullptr);
+    }
+}
+TEST(MpmcTransfer);
+
+} // namespace
@@ -0,0 +1,299 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "test.h"
+#include "../complexarray.h"
+#include "../complexexpr.h"
+#include "../fft.h"
+#include "../oscillator.h"
+#include "../parallel.h"
+#include "../simd.h"
+#include "../threadpool.h"
+
+// БПФ против ДПФ в long double и на всех уровнях инструкций, генератор несущей против точной фазы,
+// ленивые выражения и многопоточные версии против однопоточных.
+
+namespace {
+
+const long double kTwoPiL = 6.283185307179586476925286766559L;
+
+/** ДПФ в long double; поворотные множители — из таблицы по (j * k) mod n */
+vector<RefComplex> ReferenceDft(const vector<Complex>& x, int sign) {
+    size_t n = x.size();
+    vector<RefComplex> twiddle(n), out(n);
+    for (size_t k = 0; k < n; ++k) {
+        twiddle[k] = RefPolar(1, sign * kTwoPiL * k / n);
+    }
+    for (size_t k = 0; k < n; ++k) {
+        RefComplex sum{0, 0};
+        for (size_t j = 0; j < n; ++j) {
+            sum = RefAdd(sum, RefMul(ToRef(x[j]), twiddle[(j * k) % n]));
+        }
+        out[k] = sum;
+    }
+    return out;
+}
+
+/** Норма ошибки относительно нормы эталона, в единицах DBL_EPSILON */
+double RelativeRms(const vector<Complex>& got, const vector<RefComplex>& ref) {
+    long double error = 0, norm = 0;
+    for (size_t i = 0; i < got.size(); ++i) {
+        long double dr = got[i].Re() - ref[i].re, di = got[i].Im() - ref[i].im;
+        error += dr * dr + di * di;
+        norm += ref[i].re * ref[i].re + ref[i].im * ref[i].im;
+    }
+    return norm > 0 ? double(sqrtl(error / norm) / DBL_EPSILON) : double(sqrtl(error));
+}
+
+void FftAccuracy(TestState& state) {
+    ErrorStats forward, inverse, roundTrip;
+    TestRandom random;
+    // Степени двойки (radix-4, четырёхшаговая схема) и Блюстейн.
+    for (size_t n : {1, 2, 3, 4, 5, 8, 16, 64, 100, 127, 256, 1000, 1024, 2187, 4096}) {
+        vector<Complex> x(n);
+        for (Complex& z : x) {
+            z = random.UniformComplex(-1, 1);
+        }
+        vector<Complex> y = x;
+        Fft(y.data(), n);
+        forward.Add(RelativeRms(y, ReferenceDft(x, -1)), Complex(double(n)));
+        vector<Complex> back = y;
+        InverseFft(back.data(), n);
+        vector<RefComplex> original(n);
+        for (size_t i = 0; i < n; ++i) {
+            original[i] = ToRef(x[i]);
+        }
+        roundTrip.Add(RelativeRms(back, original), Complex(double(n)));
+        vector<Complex> z = x;
+        InverseFft(z.data(), n);
+        vector<RefComplex> ref = ReferenceDft(x, 1);
+        for (RefComplex& r : ref) {
+            r.re /= n;
+            r.im /= n;
+        }
+        inverse.Add(RelativeRms(z, ref), Complex(double(n)));
+    }
+    state.CheckBudget("Fft_Forward", forward);
+    state.CheckBudget("Fft_Inverse", inverse);
+    state.CheckBudget("Fft_RoundTrip", roundTrip);
+}
+TEST(FftAccuracy);
+
+/** Пакетное БПФ на пуле потоков — до бита как последовательное */
+void FftBatchMatchesSerial(TestState& state) {
+    TestRandom random;
+    const size_t n = 1024, count = 9;
+    vector<Complex> data(n * count);
+    for (Complex& z : data) {
+        z = random.UniformComplex(-1, 1);
+    }
+    vector<Complex> serial = data;
+    shared_ptr<const FftPlan> plan = FftPlan::Get(n);
+    for (size_t i = 0; i < count; ++i) {
+        plan->Forward(serial.data() + i * n);
+    }
+    ThreadPool pool(3);
+    FftBatch(*plan, data.data(), count, FftDirection::Forward, pool);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        mismatches += !SameValue(data[i], serial[i]);
+    }
+    EXPECT(state, mismatches == 0);
+}
+TEST(FftBatchMatchesSerial);
+
+/** Этапы radix-4 на каждом поддерживаемом уровне инструкций дают одно и то же до бита */
+void FftSameOnEveryLevel(TestState& state) {
+    TestRandom random;
+    const SimdLevel active = ActiveSimdLevel();
+    // Все h от 1 до 4^7 (и с этапом radix-2, и без), четырёхшаговая схема, Блюстейн.
+    for (size_t n : {4, 8, 16, 32, 64, 128, 1024, 2048, 32768, 65536, 131072, 1000}) {
+        vector<Complex> x(n);
+        for (Complex& z : x) {
+            z = random.UniformComplex(-1, 1);
+        }
+        for (FftDirection direction : {FftDirection::Forward, FftDirection::Inverse}) {
+            vector<Complex> expected(n), got(n);
+            EXPECT(state, SetActiveSimdLevel(SimdLevel::Sse2));
+            FftPlan::Get(n)->Execute(x.data(), expected.data(), direction);
+            for (SimdLevel level : {SimdLevel::Avx2, SimdLevel::Avx512}) {
+                if (!SetActiveSimdLevel(level)) {
+                    continue;
+                }
+                FftPlan::Get(n)->Execute(x.data(), got.data(), direction);
+                size_t mismatches = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    mismatches += !SameValue(got[i], expected[i]);
+                }
+                if (mismatches) {
+                    state.Fail(string("БПФ ") + to_string(n) + " [" + SimdLevelName(level) + "]: " +
+                               to_string(mismatches) + " отличий от sse2");
+                }
+            }
+        }
+    }
+    SetActiveSimdLevel(active);
+    EXPECT(state, ActiveSimdLevel() == active);
+    SimdLevel parsed = SimdLevel::Sse2;
+    EXPECT(state, ParseSimdLevel("avx512", parsed) && parsed == SimdLevel::Avx512 && !ParseSimdLevel("avx", parsed));
+}
+TEST(FftSameOnEveryLevel);
+
+/** Радианы -> доли оборота * 2^64, как в oscillator.cpp */
+uint64_t Steps(double radians) {
+    const double kTwoPi = 6.283185307179586476925286766559;
+    double turns = radians / kTwoPi;
+    turns -= nearbyint(turns);
+    double steps = nearbyint(turns * 0x1p64);
+    return uint64_t(int64_t(steps >= 0x1p63 ? steps - 0x1p64 : steps));
+}
+
+/**
+ * @brief Несущая: фаза по точному целому аккумулятору, результат не
+ * зависит от разбиения на блоки и от способа получения (Next, Generate, Mix).
+ */
+void OscillatorPhase(TestState& state) {
+    const double kFrequency = 0.1234567;
+    Oscillator reference(kFrequency, 0.5);
+    Oscillator blocks(kFrequency, 0.5), split(kFrequency, 0.5);
+    // Точная фаза n-го отсчёта: шаг и начало — целые числа долей 2^-64
+    // оборота, переведённые из радиан так же, как в генераторе (в double).
+    uint64_t step = Steps(kFrequency), start = Steps(0.5);
+    ErrorStats error;
+    TestRandom random;
+    const size_t n = 1 << 20;
+    vector<Complex> generated(n), pieces(n), ones(n, Complex(1)), mixed(n);
+    blocks.Generate(generated.data(), n);
+    for (size_t done = 0; done < n;) {
+        size_t m = size_t(random.Next() % 300);
+        m = m < n - done ? m : n - done;
+        split.Generate(pieces.data() + done, m);
+        done += m;
+    }
+    Oscillator mixer(kFrequency, 0.5);
+    mixer.Mix(ones.data(), mixed.data(), n);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Complex next = reference.Next();
+        mismatches += !SameValue(next, generated[i]) || !SameValue(pieces[i], generated[i]) ||
+                      !SameValue(mixed[i], generated[i]);
+        // Аккумулятор переполняется по модулю 2^64 — целые обороты уходят сами.
+        long double phase = (long double)int64_t(start + step * i) * kTwoPiL / 0x1p64L;
+        error.Add(UlpError(next, RefPolar(1, phase)), Complex(double(i)));
+    }
+    EXPECT(state, mismatches == 0);
+    state.CheckBudget("Oscillator_Phase", error);
+    // Перестройка частоты продолжает фазу без скачка.
+    Oscillator retuned(0.25);
+    retuned.Generate(generated.data(), 1000);
+    double before = retuned.Phase();
+    retuned.SetFrequency(-0.5);
+    EXPECT(state, fabs(retuned.Phase() - before) < 1e-15);
+    EXPECT(state, UlpError(retuned.Next(), RefPolar(1, before)) < 4);
+}
+TEST(OscillatorPhase);
+
+/** Ленивые выражения — до бита как поэлементные функции по шагам */
+void ExpressionMatchesEager(TestState& state) {
+    TestRandom random;
+    const size_t n = 1001;
+    vector<Complex> za(n), zb(n), zc(n);
+    for (size_t i = 0; i < n; ++i) {
+        za[i] = random.LogUniformComplex(-100, 100);
+        zb[i] = random.LogUniformComplex(-100, 100);
+        zc[i] = random.LogUniformComplex(-100, 100);
+    }
+    ComplexArray a(za.data(), n), b(zb.data(), n), c(zc.data(), n);
+    ComplexArray lazy = a * b + c / a - Conj(b) * 0.5;
+    ComplexArray product, quotient, scaled, conjugate(n), eager;
+    Mul(a, b, product);
+    Div(c, a, quotient);
+    for (size_t i = 0; i < n; ++i) {
+        conjugate.Set(i, Complex(b[i].Re(), -b[i].Im()));
+    }
+    Scale(conjugate, 0.5, scaled);
+    Add(product, quotient, eager);
+    Sub(eager, scaled, eager);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; ++i) {
+        mismatches += !SameValue(lazy[i], eager[i]);
+    }
+    EXPECT(state, mismatches == 0);
+}
+TEST(ExpressionMatchesEager);
+
+/**
+ * @brief Пустой массив в выражении — массив длины 0, а не скаляр: с
+ * непустым операндом это ошибка размеров, как у поэлементных функций
+ */
+void ExpressionEmptyOperand(TestState& state) {
+    ComplexArray a(10), empty, y(5);
+    int thrown = 0;
+    try {
+        ComplexArray sum = a + empty;
+    } catch (const invalid_argument&) {
+        ++thrown;
+    }
+    try {
+        ComplexArray product = empty * a;
+    } catch (const invalid_argument&) {
+        ++thrown;
+    }
+    try {
+        y = a - Conj(empty) * 2.0;
+    } catch (const invalid_argument&) {
+        ++thrown;
+    }
+    try {
+        ComplexArray out;
+        Add(a, empty, out);
+    } catch (const invalid_argument&) {
+        ++thrown;
+    }
+    EXPECT(state, thrown == 4 && y.Size() == 5);
+    // Выражение только над пустыми массивами и скалярами — пустой результат.
+    y = empty * 2.0;
+    EXPECT(state, y.Size() == 0);
+    y = empty + empty - Complex(1, 1);
+    EXPECT(state, y.Size() == 0);
+    ComplexArray z = -empty;
+    EXPECT(state, z.Size() == 0);
+}
+TEST(ExpressionEmptyOperand);
+
+/** Многопоточные поэлементные функции — до бита как однопоточные при любом пуле */
+void ParallelMatchesSerial(TestState& state) {
+    TestRandom random;
+    const size_t n = 3 * kParallelGrain + 17;
+    vector<Complex> za(n), zb(n);
+    for (size_t i = 0; i < n; ++i) {
+        za[i] = random.LogUniformComplex(-300, 300);
+        zb[i] = random.LogUniformComplex(-300, 300);
+    }
+    ComplexArray a(za.data(), n), b(zb.data(), n), serial, parallel;
+    for (size_t workers : {1, 2, 5}) {
+        ThreadPool pool(workers);
+        Mul(a, b, serial);
+        Mul(a, b, parallel, pool);
+        bool same = true;
+        for (size_t i = 0; i < n; ++i) {
+            same = same && SameValue(serial[i], parallel[i]);
+        }
+        ConjMul(a, b, serial);
+        ConjMul(a, b, parallel, pool);
+        for (size_t i = 0; i < n; ++i) {
+            same = same && SameValue(serial[i], parallel[i]);
+        }
+        Scale(a, 0.3, serial);
+        Scale(a, 0.3, parallel, pool);
+        for (size_t i = 0; i < n; ++i) {
+            same = same && SameValue(serial[i], parallel[i]);
+        }
+        EXPECT(state, same);
+    }
+}
+TEST(ParallelMatchesSerial);
+
+} // namespace
@@ -0,0 +1,195 @@
+#include <exception>
+#include "threadpool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Пул и номер рабочего потока, в котором выполняется текущий код.
+thread_local ThreadPool* tlsPool = nullptr;
+thread_local size_t tlsWorker = 0;
+
+/**
+ * @brief Общее состояние одного вызова ParallelFor.
+ */
+struct ForJob {
+    const function<void(size_t, size_t)>* body;  /**< Тело цикла.*/
+    size_t grain;                                /**< Размер куска.*/
+    atomic<size_t> remaining;                    /**< Сколько кусков ещё не выполнено.*/
+    mutex errorLock;                             /**< Защита error.*/
+    exception_ptr error;                         /**< Первое исключение из тела.*/
+};
+
+} // namespace
+
+/**
+ * @brief Конструктор: запускает рабочие потоки
+ * @param workers Число рабочих потоков
+ */
+ThreadPool::ThreadPool(size_t workers) : queued_(0), stop_(false) {
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.push_back(unique_ptr<Worker>(new Worker));
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        workers_[i]->handle = thread(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Деструктор: рабочие потоки дорабатывают очереди и завершаются
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(sleepLock_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (unique_ptr<Worker>& worker : workers_) {
+        worker->handle.join();
+    }
+}
+
+ThreadPool& ThreadPool::Default() {
+    static ThreadPool pool(thread::hardware_concurrency() > 1 ? thread::hardware_concurrency() - 1 : 0);
+    return pool;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    tlsPool = this;
+    tlsWorker = index;
+    for (;;) {
+        if (RunOneTask()) {
+            continue;
+        }
+        unique_lock<mutex> lock(sleepLock_);
+        if (stop_ && queued_ == 0) {
+            break;
+        }
+        wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+    }
+}
+
+// Задачи из рабочего потока идут в его собственную очередь, остальные — во внешнюю.
+void ThreadPool::Push(function<void()> task) {
+    Worker& target = (tlsPool == this) ? *workers_[tlsWorker] : external_;
+    {
+        lock_guard<mutex> lock(target.lock);
+        target.tasks.push_back(move(task));
+    }
+    ++queued_;
+    // Пустой захват sleepLock_ не даёт уведомлению проскочить между
+    // проверкой условия и засыпанием рабочего потока.
+    { lock_guard<mutex> lock(sleepLock_); }
+    wake_.notify_one();
+}
+
+bool ThreadPool::TryPop(Worker& worker, function<void()>& task, bool back) {
+    lock_guard<mutex> lock(worker.lock);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    if (back) {
+        task = move(worker.tasks.back());
+        worker.tasks.pop_back();
+    } else {
+        task = move(worker.tasks.front());
+        worker.tasks.pop_front();
+    }
+    --queued_;
+    return true;
+}
+
+// Своя очередь с конца, затем внешняя и чужие с начала (кража).
+bool ThreadPool::RunOneTask() {
+    function<void()> task;
+    bool own = tlsPool == this;
+    size_t start = own ? tlsWorker : 0;
+    bool found = (own && TryPop(*workers_[start], task, true)) || TryPop(external_, task, false);
+    for (size_t i = 1; !found && i <= workers_.size(); ++i) {
+        found = TryPop(*workers_[(start + i) % workers_.size()], task, false);
+    }
+    if (found) {
+        task();
+    }
+    return found;
+}
+
+/**
+ * @brief Ставит задачу в очередь без ожидания результата
+ */
+void ThreadPool::Submit(function<void()> task) {
+    Push(move(task));
+}
+
+/**
+ * @brief Параллельный цикл по [begin, end) кусками по grain элементов.
+ *
+ * Диапазон рекурсивно делится пополам по границам кусков: правая половина
+ * уходит в очередь (её могут украсть), левая делится дальше на месте.
+ */
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, const function<void(size_t, size_t)>& body) {
+    if (end <= begin) {
+        return;
+    }
+    ForJob job;
+    job.body = &body;
+    job.grain = grain ? grain : 1;
+    job.remaining = (end - begin + job.grain - 1) / job.grain;
+
+    // Рекурсивное разбиение; последнее обращение к job — уменьшение remaining.
+    function<void(size_t, size_t)> split = [this, &job, &split](size_t lo, size_t hi) {
+        while (hi - lo > job.grain) {
+            size_t chunks = (hi - lo + job.grain - 1) / job.grain;
+            size_t mid = lo + (chunks / 2) * job.grain;
+            Push([&split, mid, hi] { split(mid, hi); });
+            hi = mid;
+        }
+        try {
+            (*job.body)(lo, hi);
+        } catch (...) {
+            lock_guard<mutex> lock(job.errorLock);
+            if (!job.error) {
+                job.error = current_exception();
+            }
+        }
+        --job.remaining;
+    };
+    split(begin, end);
+    while (job.remaining > 0) {
+        if (!RunOneTask()) {
+            this_thread::yield();
+        }
+    }
+    if (job.error) {
+        rethrow_exception(job.error);
+    }
+}
+
+bool PinCurrentThread(int cpu) noexcept {
+    if (cpu < 0) {
+        return false;
+    }
+#ifdef _WIN32
+    if (cpu >= int(sizeof(DWORD_PTR) * 8)) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,99 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Пул потоков с перехватом работы (work stealing).
+ *
+ * У каждого рабочего потока своя очередь: владелец берёт задачи с конца
+ * (последние добавленные, они ещё горячие в кэше), остальные крадут с
+ * начала. Поток, вызвавший ParallelFor, тоже выполняет задачи, поэтому
+ * пул из 0 рабочих потоков — корректный однопоточный режим.
+ */
+class ThreadPool {
+private:
+    struct Worker {
+        deque<function<void()>> tasks;  /**< Очередь задач потока.*/
+        mutex lock;                     /**< Защита очереди.*/
+        thread handle;                  /**< Сам поток.*/
+    };
+
+    vector<unique_ptr<Worker>> workers_;  /**< Рабочие потоки.*/
+    Worker external_;                     /**< Очередь для задач от сторонних потоков.*/
+    atomic<size_t> queued_;               /**< Задач в очередях (для засыпания).*/
+    atomic<bool> stop_;                   /**< Сигнал остановки.*/
+    mutex sleepLock_;                     /**< Для condition variable.*/
+    condition_variable wake_;             /**< Будит спящие потоки.*/
+
+    void WorkerLoop(size_t index);
+    void Push(function<void()> task);
+    bool TryPop(Worker& worker, function<void()>& task, bool back);
+    bool RunOneTask();
+
+public:
+    /**
+    * @brief Конструктор
+    * @param workers Число рабочих потоков (вызывающий поток помогает им)
+    */
+    explicit ThreadPool(size_t workers);
+
+    /**
+    * @brief Деструктор: дожидается завершения рабочих потоков
+    */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+    * @brief Общий пул на все ядра (hardware_concurrency - 1 рабочих + вызывающий)
+    */
+    static ThreadPool& Default();
+
+    /**
+    * @brief Число потоков, которые выполняют работу (рабочие + вызывающий)
+    */
+    size_t Concurrency() const noexcept { return workers_.size() + 1; }
+
+    /**
+    * @brief Ставит задачу в очередь без ожидания результата
+    * @param task Задача
+    */
+    void Submit(function<void()> task);
+
+    /**
+    * @brief Параллельный цикл по [begin, end) кусками по grain элементов.
+    *
+    * Границы кусков зависят только от begin, end и grain (не от числа
+    * потоков): body(lo, hi) вызывается ровно для [begin + k*grain,
+    * min(end, begin + (k+1)*grain)). Поэтому результат детерминирован при
+    * любом числе потоков. Первое исключение из body пробрасывается наружу
+    * после завершения всех кусков.
+    * @param begin Начало диапазона
+    * @param end Конец диапазона
+    * @param grain Размер куска (0 считается за 1)
+    * @param body Тело цикла body(lo, hi)
+    */
+    void ParallelFor(size_t begin, size_t end, size_t grain, const function<void(size_t, size_t)>& body);
+};
+
+/**
+ * @brief Привязывает текущий поток к одному ядру (Linux и Windows; в других
+ * ОС ничего не делает)
+ * @param cpu Номер логического процессора
+ * @return true, если привязка удалась
+ */
+bool PinCurrentThread(int cpu) noexcept;
+
+#endif // THREAD_POOL_H